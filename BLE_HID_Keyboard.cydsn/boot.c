@@ -0,0 +1,157 @@
+/*******************************************************************************
+* File Name: boot.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the boot phase profiler. Each phase from main() entry
+*  to the first HID report is timestamped with a free-running LFCLK counter.
+*  The record is kept in RAM that the startup code does not clear, so the
+*  phases of a boot that never reached its first report can still be read
+*  after the next reset.
+*
+* Hardware Dependency:
+*  CY8CKIT-149 PSoC 4100S Plus Prototyping Kit
+*
+*******************************************************************************/
+
+#include "common.h"
+#include "boot.h"
+#include "bas.h"
+
+CY_NOINIT BOOT_RECORD_T bootRecord;
+static BOOT_RECORD_T bootPrevious;
+static uint8 bootPeripheralsStarted = DISABLED;
+
+static void BootShow(const BOOT_RECORD_T *record);
+
+
+/*******************************************************************************
+* Function Name: BootInit()
+********************************************************************************
+*
+* Summary:
+*   Starts the timestamp counter and a new record. A record left by the
+*   previous boot is kept for BootShowPrevious(). Called first in main().
+*
+*******************************************************************************/
+void BootInit(void)
+{
+    uint8 phase;
+
+    CySysWdtUnlock();
+    CySysWdtWriteMode(BOOT_COUNTER, CY_SYS_WDT_MODE_NONE);
+    CySysWdtResetCounters(BOOT_COUNTER_RESET);
+    CySysWdtEnable(BOOT_COUNTER_MASK);
+    CySysWdtLock();
+
+    bootPrevious = bootRecord;
+    bootRecord.magic = BOOT_RECORD_MAGIC;
+    for(phase = 0u; phase < BOOT_PHASE_COUNT; phase++)
+    {
+        bootRecord.time[phase] = BOOT_TIME_NONE;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: BootShowPrevious()
+********************************************************************************
+*
+* Summary:
+*   Prints the phases of the previous boot, when its record survived and
+*   the boot did not reach the first HID report. A finished boot was
+*   printed by BootMark() already.
+*
+*******************************************************************************/
+void BootShowPrevious(void)
+{
+    if((bootPrevious.magic == BOOT_RECORD_MAGIC) &&
+       (bootPrevious.time[BOOT_PHASE_FIRST_REPORT] == BOOT_TIME_NONE))
+    {
+        DBG_PRINTF("Previous boot: ");
+        BootShow(&bootPrevious);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: BootMark()
+********************************************************************************
+*
+* Summary:
+*   Records the first time a phase is reached. The record is printed once
+*   the first HID report has been sent.
+*
+* Parameters:
+*  phase - one of the BOOT_PHASE_xxx values
+*
+*******************************************************************************/
+void BootMark(uint8 phase)
+{
+    if((phase < BOOT_PHASE_COUNT) && (bootRecord.time[phase] == BOOT_TIME_NONE))
+    {
+        bootRecord.time[phase] = CySysWdtGetCount(BOOT_COUNTER);
+        if(phase == BOOT_PHASE_FIRST_REPORT)
+        {
+            DBG_PRINTF("Boot: ");
+            BootShow(&bootRecord);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: BootStartPeripherals()
+********************************************************************************
+*
+* Summary:
+*   Starts the peripherals that are not needed for advertising. Called
+*   before advertising, or on the first connection with BOOT_FAST_START.
+*
+*******************************************************************************/
+void BootStartPeripherals(void)
+{
+    if(bootPeripheralsStarted == DISABLED)
+    {
+        bootPeripheralsStarted = ENABLED;
+        /* Begin I2C master component operation */
+        I2CHW_Start();
+    #if (BAS_MEASURE_ENABLE != 0)
+        ADC_Start();
+    #endif /* BAS_MEASURE_ENABLE != 0 */
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: BootShow()
+********************************************************************************
+*
+* Summary:
+*   Prints the time of each phase reached in milliseconds since main() entry.
+*
+* Parameters:
+*  record - the boot record to print
+*
+*******************************************************************************/
+static void BootShow(const BOOT_RECORD_T *record)
+{
+    uint8 phase;
+
+    for(phase = 0u; phase < BOOT_PHASE_COUNT; phase++)
+    {
+        if(record->time[phase] != BOOT_TIME_NONE)
+        {
+            DBG_PRINTF("%lu ", (uint32)(((uint64)record->time[phase] * 1000u) / BOOT_LFCLK_HZ));
+        }
+        else
+        {
+            DBG_PRINTF("- ");
+        }
+    }
+    DBG_PRINTF("ms \r\n");
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,75 @@
+/*******************************************************************************
+* File Name: boot.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the boot phase profiler
+*  and of the fast-path startup.
+*
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*  Conditional Compilation Parameters
+***************************************/
+
+/* Set to 1 to start the I2C master and the ADC on the first connection
+*  instead of before advertising. Use with DEBUG_UART_ENABLED set to DISABLED
+*  for the shortest wake-to-advertising time. */
+#if !defined(BOOT_FAST_START)
+#define BOOT_FAST_START             (0)
+#endif /* !defined(BOOT_FAST_START) */
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Phases in the order they are reached after a reset or a wakeup from Hibernate */
+#define BOOT_PHASE_DEBUG            (0u)        /* Debug UART started */
+#define BOOT_PHASE_STACK_START      (1u)        /* CyBle_Start() returned */
+#define BOOT_PHASE_STACK_ON         (2u)        /* CYBLE_EVT_STACK_ON */
+#define BOOT_PHASE_ADVERTISING      (3u)        /* First advertisement started */
+#define BOOT_PHASE_CONNECTED        (4u)        /* First connection */
+#define BOOT_PHASE_FIRST_REPORT     (5u)        /* First HID report sent */
+#define BOOT_PHASE_COUNT            (6u)
+
+/* Free-running LFCLK counter of the phase timestamps */
+#define BOOT_COUNTER                (CY_SYS_WDT_COUNTER2)
+#define BOOT_COUNTER_MASK           (CY_SYS_WDT_COUNTER2_MASK)
+#define BOOT_COUNTER_RESET          (CY_SYS_WDT_COUNTER2_RESET)
+#define BOOT_LFCLK_HZ               (32768u)
+
+#define BOOT_RECORD_MAGIC           (0xB0075EC5u)
+#define BOOT_TIME_NONE              (0xFFFFFFFFu)
+
+
+/***************************************
+*        Data Types
+***************************************/
+typedef struct
+{
+    uint32 magic;                       /* BOOT_RECORD_MAGIC once the record is initialized */
+    uint32 time[BOOT_PHASE_COUNT];      /* LFCLK counts since main() entry, BOOT_TIME_NONE if not reached */
+} BOOT_RECORD_T;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+void BootInit(void);
+void BootShowPrevious(void);
+void BootMark(uint8 phase);
+void BootStartPeripherals(void);
+
+
+/***************************************
+* External data references
+***************************************/
+extern BOOT_RECORD_T bootRecord;
+
+
+/* [] END OF FILE */
@@ -1,61 +1,96 @@
-/*******************************************************************************
-* File Name: common.h
-*
-* Version 1.0
-*
-* Description:
-*  Contains the function prototypes and constants available to the example
-*  project.
-*
-********************************************************************************
-* Copyright 2016, Cypress Semiconductor Corporation.  All rights reserved.
-* You may use this file only in accordance with the license, terms, conditions,
-* disclaimers, and limitations in the end user license agreement accompanying
-* the software package with which this file was provided.
-*******************************************************************************/
-
-#include <project.h>
-#include <stdio.h>
-
-#define ENABLED                     (1u)
-#define DISABLED                    (0u)
-
-/***************************************
-* Conditional Compilation Parameters
-***************************************/
-#define DEBUG_UART_ENABLED          ENABLED
-
-
-/***************************************
-*           API Constants
-***************************************/
-#define LED_ON                      (0u)
-#define LED_OFF                     (1u)
-
-#define LED_TIMEOUT                 (10u)              /* Сounts in hundreds of seconds */
-
-#define WDT_COUNTER                                   (CY_SYS_WDT_COUNTER1)
-#define WDT_COUNTER_MASK                              (CY_SYS_WDT_COUNTER1_MASK)
-#define WDT_INTERRUPT_SOURCE                          (CY_SYS_WDT_COUNTER1_INT) 
-#define WDT_COUNTER_ENABLE                            (1u)
-#define WDT_TIMEOUT                                   (32767u/10u) /* 100 ms @ 32.768kHz clock */
-
-
-/***************************************
-*        External Function Prototypes
-***************************************/
-void ShowValue(CYBLE_GATT_VALUE_T *value);
-void Set32ByPtr(uint8 ptr[], uint32 value);
-void ShowError(void);
-
-/***************************************
-*        Macros
-***************************************/
-#if (DEBUG_UART_ENABLED == ENABLED)
-    #define DBG_PRINTF(...)          (printf(__VA_ARGS__))
-#else
-    #define DBG_PRINTF(...)
-#endif /* (DEBUG_UART_ENABLED == ENABLED) */
-
-
-/* [] END OF FILE */
+/*******************************************************************************
+* File Name: common.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants available to the example
+*  project.
+*
+********************************************************************************
+* Copyright 2016, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <project.h>
+#include <stdio.h>
+
+#define ENABLED                     (1u)
+#define DISABLED                    (0u)
+
+/***************************************
+* Conditional Compilation Parameters
+***************************************/
+#define DEBUG_UART_ENABLED          ENABLED
+
+/* Touch filter profile requested from the CapSense MCU */
+#define CAPSENSE_FILTER_LOW_LATENCY (0x00u)    /* Lowest first-touch latency for clean environments */
+#define CAPSENSE_FILTER_HIGH_NOISE  (0x01u)    /* Median filter and noise-adaptive thresholds */
+#define CAPSENSE_FILTER_PROFILE     CAPSENSE_FILTER_LOW_LATENCY
+
+/* Scan period tier of the CapSense MCU, selected by the power profile */
+#define CAPSENSE_SCAN_CONTINUOUS    (0x00u)    /* Next scan starts right after processing */
+#define CAPSENSE_SCAN_20MS          (0x01u)
+#define CAPSENSE_SCAN_50MS          (0x02u)
+#define CAPSENSE_SCAN_TIER_SHIFT    (1u)
+#define CAPSENSE_SCAN_TIER_MASK     (0x06u)
+#define CAPSENSE_LED_OFF            (0x08u)    /* Touch and gesture feedback LEDs stay dark */
+#define CAPSENSE_CONFIG_WRITTEN     (0x80u)    /* Set in every write, clear in the power-on value of the slave */
+
+
+/***************************************
+*           API Constants
+***************************************/
+#define LED_ON                      (0u)
+#define LED_OFF                     (1u)
+
+#define LED_TIMEOUT                 (10u)              /* Сounts in hundreds of seconds */
+
+#define WDT_COUNTER                                   (CY_SYS_WDT_COUNTER1)
+#define WDT_COUNTER_MASK                              (CY_SYS_WDT_COUNTER1_MASK)
+#define WDT_INTERRUPT_SOURCE                          (CY_SYS_WDT_COUNTER1_INT) 
+#define WDT_COUNTER_ENABLE                            (1u)
+#define WDT_TIMEOUT                                   (32767u/10u) /* 100 ms @ 32.768kHz clock */
+
+/* Pending work bits, set from interrupts and callbacks and serviced by the main loop */
+#define WORK_CAPSENSE               (0x01u)     /* Connection event or timer tick: poll the CapSense MCU */
+#define WORK_I2C                    (0x02u)     /* I2C master transfer finished */
+#define WORK_HID                    (0x04u)     /* HID reports queued or stack became free */
+#define WORK_BATTERY                (0x08u)     /* Battery level update period elapsed */
+#define WORK_FLASH                  (0x10u)     /* Bonding data has to be stored */
+#define WORK_LINK                   (0x20u)     /* RSSI sample period elapsed */
+#define WORK_STACK                  (0x40u)     /* BLE hardware error, restart the stack */
+#define WORK_KEYS                   (0x80u)     /* Timer tick: generate or store the key pair while idle */
+
+
+/***************************************
+*        External Function Prototypes
+***************************************/
+void ShowValue(CYBLE_GATT_VALUE_T *value);
+void Set32ByPtr(uint8 ptr[], uint32 value);
+void ShowError(void);
+void AppCallBack(uint32 event, void* eventParam);
+void SetPendingWork(uint32 work);
+uint32 TakePendingWork(void);
+
+
+/***************************************
+* External data references
+***************************************/
+extern volatile uint32 timerTicks;
+extern uint8 capSenseConfig;
+extern uint8 capSenseConfigPending;
+
+/***************************************
+*        Macros
+***************************************/
+#if (DEBUG_UART_ENABLED == ENABLED)
+    #define DBG_PRINTF(...)          (printf(__VA_ARGS__))
+#else
+    #define DBG_PRINTF(...)
+#endif /* (DEBUG_UART_ENABLED == ENABLED) */
+
+
+/* [] END OF FILE */
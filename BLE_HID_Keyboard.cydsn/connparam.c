@@ -0,0 +1,156 @@
+/*******************************************************************************
+* File Name: connparam.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the connection parameter policy. A short connection
+*  interval is requested as soon as the CapSense MCU reports an approaching
+*  hand, so the parameter update completes before the first touch lands.
+*  The long, low power interval is requested once the hand has gone.
+*
+* Hardware Dependency:
+*  CY8CKIT-149 PSoC 4100S Plus Prototyping Kit
+*
+*******************************************************************************/
+
+#include "common.h"
+#include "connparam.h"
+#include "power.h"
+
+uint8 connParamActive = CONN_PARAM_NONE;        /* Parameters the controller runs the link with */
+static uint8 connParamRequested = CONN_PARAM_NONE;
+static uint8 connParamPending = DISABLED;       /* L2CAP request waiting for a response */
+static uint32 connParamRequestedAt;             /* timerTicks when the pending request was sent */
+
+
+/*******************************************************************************
+* Function Name: ConnParamInit()
+********************************************************************************
+*
+* Summary:
+*   Resets the policy for a new connection.
+*
+*******************************************************************************/
+void ConnParamInit(void)
+{
+    connParamActive = CONN_PARAM_NONE;
+    connParamRequested = CONN_PARAM_NONE;
+    connParamPending = DISABLED;
+}
+
+
+/*******************************************************************************
+* Function Name: ConnParamUpdate()
+********************************************************************************
+*
+* Summary:
+*   Requests the connection parameters matching the proximity state and the
+*   power profile. Only one request is outstanding at a time; a change of
+*   state during a request is picked up on the next call after the response,
+*   or after CONN_PARAM_RESPONSE_TIMEOUT when the central never answers.
+*
+* Parameters:
+*  approach - non-zero while a hand is near the sensors
+*
+*******************************************************************************/
+void ConnParamUpdate(uint8 approach)
+{
+    CYBLE_GAP_CONN_UPDATE_PARAM_T connParam;
+    CYBLE_API_RESULT_T apiResult;
+    const POWER_PROFILE_T *profile = PowerGetProfile();
+    uint8 wanted;
+
+    wanted = ((approach != 0u) && (profile->fastOnApproach != 0u)) ? CONN_PARAM_FAST : CONN_PARAM_SLOW;
+    if((connParamPending == ENABLED) && ((timerTicks - connParamRequestedAt) >= CONN_PARAM_RESPONSE_TIMEOUT))
+    {
+        DBG_PRINTF("Connection parameter response timeout \r\n");
+        connParamPending = DISABLED;
+    }
+    if((connParamPending == DISABLED) && (wanted != connParamRequested))
+    {
+        if(wanted == CONN_PARAM_FAST)
+        {
+            connParam.connIntvMin = CONN_FAST_INTERVAL_MIN;
+            connParam.connIntvMax = CONN_FAST_INTERVAL_MAX;
+            connParam.connLatency = CONN_FAST_LATENCY;
+            connParam.supervisionTO = CONN_FAST_TIMEOUT;
+        }
+        else
+        {
+            connParam.connIntvMin = profile->slowIntervalMin;
+            connParam.connIntvMax = profile->slowIntervalMax;
+            connParam.connLatency = profile->slowLatency;
+            connParam.supervisionTO = CONN_SLOW_TIMEOUT;
+        }
+
+        apiResult = CyBle_L2capLeConnectionParamUpdateRequest(cyBle_connHandle.bdHandle, &connParam);
+        DBG_PRINTF("Connection parameter request %x, status: %x \r\n", wanted, apiResult);
+        if(apiResult == CYBLE_ERROR_OK)
+        {
+            connParamRequested = wanted;
+            connParamPending = ENABLED;
+            connParamRequestedAt = timerTicks;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ConnParamRefresh()
+********************************************************************************
+*
+* Summary:
+*   Forgets the last request, so the next update requests the parameters of
+*   the current power profile even if the proximity state did not change.
+*
+*******************************************************************************/
+void ConnParamRefresh(void)
+{
+    connParamRequested = CONN_PARAM_NONE;
+}
+
+
+/*******************************************************************************
+* Function Name: ConnParamEventHandler()
+********************************************************************************
+*
+* Summary:
+*   Tracks the result of connection parameter requests. Any response ends
+*   the pending request; the central may apply accepted parameters later,
+*   or not at all when they are already in use. The parameters in use are
+*   taken from the update complete event alone. Called from the generic
+*   event handler.
+*
+* Parameters:
+*  event - the event code
+*  *eventParam - the event parameters
+*
+*******************************************************************************/
+void ConnParamEventHandler(uint32 event, void *eventParam)
+{
+    CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T *updated;
+
+    switch(event)
+    {
+        case CYBLE_EVT_L2CAP_CONN_PARAM_UPDATE_RSP:
+            /* A rejected request is not repeated until the proximity state changes */
+            connParamPending = DISABLED;
+            break;
+        case CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE:
+            updated = (CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T *)eventParam;
+            if(updated->status == 0u)
+            {
+                connParamActive = (updated->connIntv <= CONN_FAST_INTERVAL_MAX) ? CONN_PARAM_FAST : CONN_PARAM_SLOW;
+            }
+            break;
+        case CYBLE_EVT_GAP_DEVICE_DISCONNECTED:
+            ConnParamInit();
+            break;
+        default:
+            break;
+    }
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,59 @@
+/*******************************************************************************
+* File Name: connparam.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the connection parameter
+*  policy.
+*
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Connection parameters while a hand is near the sensors */
+#define CONN_FAST_INTERVAL_MIN      (6u)        /* 7.5 ms in 1.25 ms units */
+#define CONN_FAST_INTERVAL_MAX      (6u)
+#define CONN_FAST_LATENCY           (0u)
+#define CONN_FAST_TIMEOUT           (200u)      /* 2 s in 10 ms units */
+
+/* Connection parameters while no hand is near, in the normal power band. The
+*  parameter sweep of the host tests builds the firmware with other values. */
+#if !defined(CONN_SLOW_INTERVAL_MIN)
+#define CONN_SLOW_INTERVAL_MIN      (24u)       /* 30 ms in 1.25 ms units */
+#define CONN_SLOW_INTERVAL_MAX      (40u)       /* 50 ms in 1.25 ms units */
+#endif /* !defined(CONN_SLOW_INTERVAL_MIN) */
+#if !defined(CONN_SLOW_LATENCY)
+#define CONN_SLOW_LATENCY           (4u)
+#endif /* !defined(CONN_SLOW_LATENCY) */
+#define CONN_SLOW_TIMEOUT           (500u)      /* 5 s in 10 ms units */
+
+/* Timer ticks a request may wait for its response before another one is sent */
+#define CONN_PARAM_RESPONSE_TIMEOUT (300u)      /* 30 s, the L2CAP signalling timeout */
+
+#define CONN_PARAM_NONE             (0u)
+#define CONN_PARAM_FAST             (1u)
+#define CONN_PARAM_SLOW             (2u)
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+void ConnParamInit(void);
+void ConnParamUpdate(uint8 approach);
+void ConnParamRefresh(void);
+void ConnParamEventHandler(uint32 event, void *eventParam);
+
+
+/***************************************
+* External data references
+***************************************/
+extern uint8 connParamActive;
+
+
+/* [] END OF FILE */
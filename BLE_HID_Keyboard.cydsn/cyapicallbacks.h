@@ -1,21 +1,25 @@
-/* ========================================
- *
- * Copyright YOUR COMPANY, THE YEAR
- * All Rights Reserved
- * UNPUBLISHED, LICENSED SOFTWARE.
- *
- * CONFIDENTIAL AND PROPRIETARY INFORMATION
- * WHICH IS THE PROPERTY OF your company.
- *
- * ========================================
-*/
-#ifndef CYAPICALLBACKS_H
-#define CYAPICALLBACKS_H
-    
-
-    /*Define your macro callbacks here */
-    /*For more information, refer to the Writing Code topic in the PSoC Creator Help.*/
-
-    
-#endif /* CYAPICALLBACKS_H */   
-/* [] */
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef CYAPICALLBACKS_H
+#define CYAPICALLBACKS_H
+    
+
+    /*Define your macro callbacks here */
+    /*For more information, refer to the Writing Code topic in the PSoC Creator Help.*/
+
+    /* Signals I2C master transfer completion to the main loop */
+    #define I2CHW_I2C_ISR_EXIT_CALLBACK
+    void I2CHW_I2C_ISR_ExitCallback(void);
+
+    
+#endif /* CYAPICALLBACKS_H */   
+/* [] */
@@ -0,0 +1,79 @@
+/*******************************************************************************
+* File Name: hidreport.h
+*
+* Version 1.0
+*
+* Description:
+*  Layout of the keyboard input report. Plain C without the component APIs,
+*  so the host tools that build a report map from it can include it too.
+*
+*******************************************************************************/
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Main item flags of an Input item, HID 1.11 section 6.2.2.5 */
+#define HID_INPUT_DATA_ARRAY        (0x00u)
+#define HID_INPUT_CONSTANT          (0x01u)
+#define HID_INPUT_DATA_VARIABLE     (0x02u)
+
+/* Keyboard input report, identical in Boot and Report protocol mode.
+*  X(field, offset, size, bits, count, usageMin, usageMax, logicalMax, input)
+*  with offset and size in bytes, in report order. bits, count and the rest
+*  are the Report Size, Report Count, Keyboard/Keypad page usages, Logical
+*  Maximum and Input flags that describe the field in a report map. The
+*  report map of the BLE component must describe the same layout.
+*/
+#define HID_KEYBOARD_REPORT(X) \
+    X(MODIFIERS,    0u,     1u,     1u,     8u,     0xE0u,  0xE7u,  0x01u,  HID_INPUT_DATA_VARIABLE) \
+    X(RESERVED,     1u,     1u,     8u,     1u,     0x00u,  0x00u,  0x00u,  HID_INPUT_CONSTANT) \
+    X(KEYCODES,     2u,     6u,     8u,     6u,     0x00u,  0x65u,  0x65u,  HID_INPUT_DATA_ARRAY)
+
+#define HID_REPORT_FIELD_SIZE(field, offset, size, bits, count, usageMin, usageMax, logicalMax, input) \
+    + (size)
+#define KEYBOARD_DATA_SIZE          (0u HID_KEYBOARD_REPORT(HID_REPORT_FIELD_SIZE))
+
+/* Report map items of a field, after a Usage Page (Keyboard) item */
+#define HID_REPORT_FIELD_ITEMS(field, offset, size, bits, count, usageMin, usageMax, logicalMax, input) \
+    0x19u, (usageMin),          /* Usage Minimum */ \
+    0x29u, (usageMax),          /* Usage Maximum */ \
+    0x15u, 0x00u,               /* Logical Minimum (0) */ \
+    0x25u, (logicalMax),        /* Logical Maximum */ \
+    0x75u, (bits),              /* Report Size */ \
+    0x95u, (count),             /* Report Count */ \
+    0x81u, (input),             /* Input */
+
+
+/***************************************
+*        Data Types
+***************************************/
+#define HID_REPORT_FIELD_OFFSET(field, offset, size, bits, count, usageMin, usageMax, logicalMax, input) \
+    HID_KEYBOARD_##field##_OFFSET = (offset),
+#define HID_REPORT_FIELD_LENGTH(field, offset, size, bits, count, usageMin, usageMax, logicalMax, input) \
+    HID_KEYBOARD_##field##_SIZE = (size),
+#define HID_REPORT_FIELD_END(field, offset, size, bits, count, usageMin, usageMax, logicalMax, input) \
+    HID_KEYBOARD_##field##_END = (offset) + (size),
+
+enum
+{
+    HID_KEYBOARD_REPORT(HID_REPORT_FIELD_OFFSET)
+    HID_KEYBOARD_REPORT(HID_REPORT_FIELD_LENGTH)
+    HID_KEYBOARD_REPORT(HID_REPORT_FIELD_END)
+};
+
+/* Compile time checks: fields are packed in order and fill the report, and
+*  the report items of each field cover its bytes exactly */
+#define HID_REPORT_FIELD_BITS(field, offset, size, bits, count, usageMin, usageMax, logicalMax, input) \
+    typedef char HID_KEYBOARD_##field##_BITS_CHECK[(((bits) * (count)) == ((size) * 8u)) ? 1 : -1];
+
+HID_KEYBOARD_REPORT(HID_REPORT_FIELD_BITS)
+typedef char HID_KEYBOARD_MODIFIERS_CHECK[(HID_KEYBOARD_MODIFIERS_OFFSET == 0u) ? 1 : -1];
+typedef char HID_KEYBOARD_RESERVED_CHECK[(HID_KEYBOARD_RESERVED_OFFSET == HID_KEYBOARD_MODIFIERS_END) ? 1 : -1];
+typedef char HID_KEYBOARD_KEYCODES_CHECK[(HID_KEYBOARD_KEYCODES_OFFSET == HID_KEYBOARD_RESERVED_END) ? 1 : -1];
+typedef char HID_KEYBOARD_SIZE_CHECK[(HID_KEYBOARD_KEYCODES_END == KEYBOARD_DATA_SIZE) ? 1 : -1];
+typedef char HID_KEYBOARD_BOOT_SIZE_CHECK[(KEYBOARD_DATA_SIZE == 8u) ? 1 : -1];
+
+
+/* [] END OF FILE */
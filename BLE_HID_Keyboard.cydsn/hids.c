@@ -1,338 +1,490 @@
-/*******************************************************************************
-* File Name: hids.c
-*
-* Version: 1.0
-*
-* Description:
-*  This file contains HIDS callback handler function.
-*
-* Hardware Dependency:
-*  CY8CKIT-042 BLE
-* 
-********************************************************************************
-* Copyright 2016, Cypress Semiconductor Corporation.  All rights reserved.
-* You may use this file only in accordance with the license, terms, conditions,
-* disclaimers, and limitations in the end user license agreement accompanying
-* the software package with which this file was provided.
-*******************************************************************************/
-
-#include "common.h"
-#include "hids.h"
-
-uint16 keyboardSimulation;
-uint8 protocol = CYBLE_HIDS_PROTOCOL_MODE_REPORT;   /* Boot or Report protocol mode */
-uint8 suspend = CYBLE_HIDS_CP_EXIT_SUSPEND;         /* Suspend to enter into deep sleep mode */
-
-
-/*******************************************************************************
-* Function Name: HidsCallBack()
-********************************************************************************
-*
-* Summary:
-*   This is an event callback function to receive service specific events from 
-*   HID Service.
-*
-* Parameters:
-*  event - the event code
-*  *eventParam - the event parameters
-*
-* Return:
-*  None.
-*
-********************************************************************************/
-void HidsCallBack(uint32 event, void *eventParam)
-{
-    CYBLE_HIDS_CHAR_VALUE_T *locEventParam = (CYBLE_HIDS_CHAR_VALUE_T *)eventParam;
-
-    DBG_PRINTF("HIDS event: %lx, ", event);
-
-    switch(event)
-    {
-        case CYBLE_EVT_HIDSS_NOTIFICATION_ENABLED:
-            DBG_PRINTF("CYBLE_EVT_HIDSS_NOTIFICATION_ENABLED: serv=%x, char=%x\r\n", 
-                locEventParam->serviceIndex,
-                locEventParam->charIndex);
-            if(CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX == locEventParam->serviceIndex)
-            {
-                keyboardSimulation = ENABLED;
-            }
-            break;
-        case CYBLE_EVT_HIDSS_NOTIFICATION_DISABLED:
-            DBG_PRINTF("CYBLE_EVT_HIDSS_NOTIFICATION_DISABLED: serv=%x, char=%x\r\n", 
-                locEventParam->serviceIndex,
-                locEventParam->charIndex);
-            if(CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX == locEventParam->serviceIndex)
-            {
-                keyboardSimulation = DISABLED;
-            }
-            break;
-        case CYBLE_EVT_HIDSS_BOOT_MODE_ENTER:
-            DBG_PRINTF("CYBLE_EVT_HIDSS_BOOT_MODE_ENTER \r\n");
-            protocol = CYBLE_HIDS_PROTOCOL_MODE_BOOT;
-            break;
-        case CYBLE_EVT_HIDSS_REPORT_MODE_ENTER:
-            DBG_PRINTF("CYBLE_EVT_HIDSS_REPORT_MODE_ENTER \r\n");
-            protocol = CYBLE_HIDS_PROTOCOL_MODE_REPORT;
-            break;
-        case CYBLE_EVT_HIDSS_SUSPEND:
-            DBG_PRINTF("CYBLE_EVT_HIDSS_SUSPEND \r\n");
-            suspend = CYBLE_HIDS_CP_SUSPEND;
-        #if (DEBUG_UART_ENABLED == ENABLED)
-            /* Reduce power consumption, power down logic that is not required to wake up the system */
-            UART_DEB_Stop();
-        #endif /* (DEBUG_UART_ENABLED == ENABLED) */
-            break;
-        case CYBLE_EVT_HIDSS_EXIT_SUSPEND:
-        #if (DEBUG_UART_ENABLED == ENABLED)    
-            /* Power up all circuitry previously shut down */
-            UART_DEB_Start();
-        #endif /* (DEBUG_UART_ENABLED == ENABLED) */
-            DBG_PRINTF("CYBLE_EVT_HIDSS_EXIT_SUSPEND \r\n");
-            suspend = CYBLE_HIDS_CP_EXIT_SUSPEND;
-            break;
-        case CYBLE_EVT_HIDSS_REPORT_CHAR_WRITE:
-            if(CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX == locEventParam->serviceIndex)
-            {
-                /* Write request to Keyboard Output Report characteristic. 
-                *  Handle Boot and Report protocol. 
-                */
-                if( ((CYBLE_HIDS_PROTOCOL_MODE_REPORT == protocol) && 
-                     (CYBLE_HUMAN_INTERFACE_DEVICE_REPORT_OUT == locEventParam->charIndex)) ||
-                    ((CYBLE_HIDS_PROTOCOL_MODE_BOOT == protocol) && 
-                     (CYBLE_HIDS_BOOT_KYBRD_OUT_REP == locEventParam->charIndex)) )
-                {
-                    if( (CAPS_LOCK_LED & locEventParam->value->val[0u]) != 0u)
-                    {
-                        CapsLock_LED_Write(LED_ON);
-                    }
-                    else
-                    {
-                        CapsLock_LED_Write(LED_OFF);
-                    }
-                }
-            }
-            DBG_PRINTF("CYBLE_EVT_HIDSS_REPORT_CHAR_WRITE: serv=%x, char=%x, value=", 
-                locEventParam->serviceIndex,
-                locEventParam->charIndex);
-                ShowValue(locEventParam->value);
-            break;
-        case CYBLE_EVT_HIDSC_NOTIFICATION:
-            break;
-        case CYBLE_EVT_HIDSC_READ_CHAR_RESPONSE:
-            break;
-        case CYBLE_EVT_HIDSC_WRITE_CHAR_RESPONSE:
-            break;
-        case CYBLE_EVT_HIDSC_READ_DESCR_RESPONSE:
-            break;
-        case CYBLE_EVT_HIDSC_WRITE_DESCR_RESPONSE:           
-            break;
-		default:
-            DBG_PRINTF("Not supported event\r\n");
-			break;
-    }
-}
-
-
-/*******************************************************************************
-* Function Name: HidsInit()
-********************************************************************************
-*
-* Summary:
-*   Initializes the HID service.
-*
-*******************************************************************************/
-void HidsInit(void)
-{
-    CYBLE_API_RESULT_T apiResult;
-    uint16 cccdValue;
-    
-    /* Register service specific callback function */
-    CyBle_HidsRegisterAttrCallback(HidsCallBack);
-    keyboardSimulation = DISABLED;
-    /* Read CCCD configurations from flash */
-    apiResult = CyBle_HidssGetCharacteristicDescriptor(CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX, 
-        CYBLE_HUMAN_INTERFACE_DEVICE_REPORT_IN, CYBLE_HIDS_REPORT_CCCD, CYBLE_CCCD_LEN, (uint8 *)&cccdValue);
-    if((apiResult == CYBLE_ERROR_OK) && (cccdValue != 0u))
-    {
-        keyboardSimulation |= ENABLED;
-    }
-    apiResult = CyBle_HidssGetCharacteristicDescriptor(CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX, 
-        CYBLE_HIDS_BOOT_KYBRD_IN_REP, CYBLE_HIDS_REPORT_CCCD, CYBLE_CCCD_LEN, (uint8 *)&cccdValue);
-    if((apiResult == CYBLE_ERROR_OK) && (cccdValue != 0u))
-    {
-        keyboardSimulation |= ENABLED;
-    }
-}
-
-    
-/*******************************************************************************
-* Function Name: SimulateKeyboard()
-********************************************************************************
-*
-* Summary:
-*   The custom function to simulate CapsLock key pressing
-*
-*******************************************************************************/
-void SimulateKeyboard(void)
-{
-    static uint8 keyboard_data[KEYBOARD_DATA_SIZE]={0,0,0,0,0,0,0,0};
-    CYBLE_API_RESULT_T apiResult;
-    static uint32 keyboardTimer = KEYBOARD_TIMEOUT;
-    static uint8 simKey; 
-    uint8 i;
-
-    if((CyBle_GattGetBusyStatus() == CYBLE_STACK_STATE_FREE) && (--keyboardTimer == 0u))
-    {
-        keyboardTimer = KEYBOARD_TIMEOUT;
-    
-        simKey++;
-        if(simKey > SIM_KEY_MAX)
-        {
-            simKey = SIM_KEY_MIN; 
-        }
-        keyboard_data[3u] = simKey;              
-        
-        apiResult = CyBle_HidssGetCharacteristicValue(CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX, 
-            CYBLE_HIDS_PROTOCOL_MODE, sizeof(protocol), &protocol);
-        if(apiResult == CYBLE_ERROR_OK)
-        {
-            DBG_PRINTF("HID notification: ");
-            for(i = 0; i < KEYBOARD_DATA_SIZE; i++)
-            {
-                DBG_PRINTF("%2.2x,", keyboard_data[i]);
-            }
-            DBG_PRINTF("\r\n");
-            
-            if(protocol == CYBLE_HIDS_PROTOCOL_MODE_BOOT)
-            {
-                apiResult = CyBle_HidssSendNotification(cyBle_connHandle, CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX,
-                    CYBLE_HIDS_BOOT_KYBRD_IN_REP, KEYBOARD_DATA_SIZE, keyboard_data);
-            }
-            else
-            {
-                apiResult = CyBle_HidssSendNotification(cyBle_connHandle, CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX, 
-                    CYBLE_HUMAN_INTERFACE_DEVICE_REPORT_IN, KEYBOARD_DATA_SIZE, keyboard_data);
-            }
-            
-            if(apiResult == CYBLE_ERROR_OK)
-            {
-                keyboard_data[2u] = 0u;                       /* Set up keyboard data*/
-                keyboard_data[3u] = 0u;                       /* Set up keyboard data*/
-                if(protocol == CYBLE_HIDS_PROTOCOL_MODE_BOOT)
-                {
-                    apiResult = CyBle_HidssSendNotification(cyBle_connHandle, CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX,
-                        CYBLE_HIDS_BOOT_KYBRD_IN_REP, KEYBOARD_DATA_SIZE, keyboard_data);
-                }
-                else
-                {
-                    apiResult = CyBle_HidssSendNotification(cyBle_connHandle, CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX, 
-                        CYBLE_HUMAN_INTERFACE_DEVICE_REPORT_IN, KEYBOARD_DATA_SIZE, keyboard_data);
-                }
-            }
-            if(apiResult != CYBLE_ERROR_OK)
-            {
-                DBG_PRINTF("HID notification API Error: %x \r\n", apiResult);
-                keyboardSimulation = DISABLED;
-            }
-        }
-    }
-}
-
-void SendKeyboard(uint8 CapsKey, uint8 SimKey)
-{
-    static uint8 keyboard_data[KEYBOARD_DATA_SIZE]={0,0,0,0,0,0,0,0};
-    CYBLE_API_RESULT_T apiResult;
-    uint8 i;
-    
-    if(CapsKey == 1u)
-    {
-        keyboard_data[2u] = CAPS_LOCK;
-    }
-    keyboard_data[3u] = SimKey;
-
-    if(CyBle_GattGetBusyStatus() == CYBLE_STACK_STATE_FREE)
-    {
-        apiResult = CyBle_HidssGetCharacteristicValue(CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX, 
-            CYBLE_HIDS_PROTOCOL_MODE, sizeof(protocol), &protocol);
-        if(apiResult == CYBLE_ERROR_OK)
-        {
-            DBG_PRINTF("HID notification: ");
-            for(i = 0; i < KEYBOARD_DATA_SIZE; i++)
-            {
-                DBG_PRINTF("%2.2x,", keyboard_data[i]);
-            }
-            DBG_PRINTF("\r\n");
-
-            if(protocol == CYBLE_HIDS_PROTOCOL_MODE_BOOT)
-            {
-                apiResult = CyBle_HidssSendNotification(cyBle_connHandle, CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX,
-                    CYBLE_HIDS_BOOT_KYBRD_IN_REP, KEYBOARD_DATA_SIZE, keyboard_data);
-            }
-            else
-            {
-                apiResult = CyBle_HidssSendNotification(cyBle_connHandle, CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX, 
-                    CYBLE_HUMAN_INTERFACE_DEVICE_REPORT_IN, KEYBOARD_DATA_SIZE, keyboard_data);
-            }
-
-            if(apiResult == CYBLE_ERROR_OK)
-            {
-                keyboard_data[2u] = 0u;                       /* Set up keyboard data*/
-                keyboard_data[3u] = 0u;                       /* Set up keyboard data*/
-                if(protocol == CYBLE_HIDS_PROTOCOL_MODE_BOOT)
-                {
-                    apiResult = CyBle_HidssSendNotification(cyBle_connHandle, CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX,
-                        CYBLE_HIDS_BOOT_KYBRD_IN_REP, KEYBOARD_DATA_SIZE, keyboard_data);
-                }
-                else
-                {
-                    apiResult = CyBle_HidssSendNotification(cyBle_connHandle, CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX, 
-                        CYBLE_HUMAN_INTERFACE_DEVICE_REPORT_IN, KEYBOARD_DATA_SIZE, keyboard_data);
-                }
-            }
-            if(apiResult != CYBLE_ERROR_OK)
-            {
-                DBG_PRINTF("HID notification API Error: %x \r\n", apiResult);
-                keyboardSimulation = DISABLED;
-            }
-        }
-    }
-}
-
-void SendPageCtrl(uint8 PageCtrl)
-{
-    if (PageCtrl == 0u)
-    {
-        SendKeyboard(0u, PAGE_DOWN);
-    }
-    else
-    {
-        SendKeyboard(0u, PAGE_UP);
-    }
-}
-
-void SendSoundCtrl(uint8 SoundCtrl)
-{
-    if (SoundCtrl == 0u)
-    {
-        SendKeyboard(0u, SOUND_LOW);
-    }
-    else
-    {
-        SendKeyboard(0u, SOUND_HIGH);
-    }
-}
-
-void SendLightCtrl(uint8 LightCtrl)
-{
-    if (LightCtrl == 0u)
-    {
-        SendKeyboard(0u, LIGHT_LOW);
-    }
-    else
-    {
-        SendKeyboard(0u, LIGHT_HIGH);
-    }
-}
-
-
-/* [] END OF FILE */
+/*******************************************************************************
+* File Name: hids.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains HIDS callback handler function.
+*
+* Hardware Dependency:
+*  CY8CKIT-042 BLE
+* 
+********************************************************************************
+* Copyright 2016, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "common.h"
+#include "hids.h"
+#include "stats.h"
+#include "host.h"
+#include "boot.h"
+#include "led.h"
+#include "profile.h"
+
+uint16 keyboardSimulation;
+uint8 protocol = CYBLE_HIDS_PROTOCOL_MODE_REPORT;   /* Boot or Report protocol mode */
+uint8 suspend = CYBLE_HIDS_CP_EXIT_SUSPEND;         /* Suspend to enter into deep sleep mode */
+
+/* Reports waiting for the stack, head and tail run freely and wrap by mask */
+static uint8 hidQueue[HID_QUEUE_SIZE][KEYBOARD_DATA_SIZE];
+static uint8 hidQueueHead = 0u;
+static uint8 hidQueueTail = 0u;
+
+/* Characteristic that carries the input reports in the current protocol mode */
+static CYBLE_HIDS_CHAR_INDEX_T hidInputReport = CYBLE_HUMAN_INTERFACE_DEVICE_REPORT_IN;
+
+#if (STATS_ENABLE != 0)
+static uint32 hidQueueTime[HID_QUEUE_SIZE];     /* StatsTimeNow() when the report was queued */
+#endif /* (STATS_ENABLE != 0) */
+
+static void HidsSetProtocol(uint8 mode);
+
+
+/*******************************************************************************
+* Function Name: HidsCallBack()
+********************************************************************************
+*
+* Summary:
+*   This is an event callback function to receive service specific events from 
+*   HID Service.
+*
+* Parameters:
+*  event - the event code
+*  *eventParam - the event parameters
+*
+* Return:
+*  None.
+*
+********************************************************************************/
+void HidsCallBack(uint32 event, void *eventParam)
+{
+    CYBLE_HIDS_CHAR_VALUE_T *locEventParam = (CYBLE_HIDS_CHAR_VALUE_T *)eventParam;
+
+    STATS_INC(attRequests);
+    DBG_PRINTF("HIDS event: %lx, ", event);
+
+    switch(event)
+    {
+        case CYBLE_EVT_HIDSS_NOTIFICATION_ENABLED:
+            DBG_PRINTF("CYBLE_EVT_HIDSS_NOTIFICATION_ENABLED: serv=%x, char=%x\r\n", 
+                locEventParam->serviceIndex,
+                locEventParam->charIndex);
+            if(CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX == locEventParam->serviceIndex)
+            {
+                keyboardSimulation = ENABLED;
+            #if (STATS_ENABLE != 0)
+                StatsNotificationsEnabled();
+            #endif /* (STATS_ENABLE != 0) */
+            }
+            break;
+        case CYBLE_EVT_HIDSS_NOTIFICATION_DISABLED:
+            DBG_PRINTF("CYBLE_EVT_HIDSS_NOTIFICATION_DISABLED: serv=%x, char=%x\r\n", 
+                locEventParam->serviceIndex,
+                locEventParam->charIndex);
+            if(CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX == locEventParam->serviceIndex)
+            {
+                keyboardSimulation = DISABLED;
+            }
+            break;
+        case CYBLE_EVT_HIDSS_BOOT_MODE_ENTER:
+            DBG_PRINTF("CYBLE_EVT_HIDSS_BOOT_MODE_ENTER \r\n");
+            HidsSetProtocol(CYBLE_HIDS_PROTOCOL_MODE_BOOT);
+            break;
+        case CYBLE_EVT_HIDSS_REPORT_MODE_ENTER:
+            DBG_PRINTF("CYBLE_EVT_HIDSS_REPORT_MODE_ENTER \r\n");
+            HidsSetProtocol(CYBLE_HIDS_PROTOCOL_MODE_REPORT);
+            break;
+        case CYBLE_EVT_HIDSS_SUSPEND:
+            DBG_PRINTF("CYBLE_EVT_HIDSS_SUSPEND \r\n");
+            suspend = CYBLE_HIDS_CP_SUSPEND;
+        #if (DEBUG_UART_ENABLED == ENABLED)
+            /* Reduce power consumption, power down logic that is not required to wake up the system */
+            UART_DEB_Stop();
+        #endif /* (DEBUG_UART_ENABLED == ENABLED) */
+            break;
+        case CYBLE_EVT_HIDSS_EXIT_SUSPEND:
+        #if (DEBUG_UART_ENABLED == ENABLED)    
+            /* Power up all circuitry previously shut down */
+            UART_DEB_Start();
+        #endif /* (DEBUG_UART_ENABLED == ENABLED) */
+            DBG_PRINTF("CYBLE_EVT_HIDSS_EXIT_SUSPEND \r\n");
+            suspend = CYBLE_HIDS_CP_EXIT_SUSPEND;
+            break;
+        case CYBLE_EVT_HIDSS_REPORT_CHAR_WRITE:
+            if(CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX == locEventParam->serviceIndex)
+            {
+                /* Write request to Keyboard Output Report characteristic. 
+                *  Handle Boot and Report protocol. 
+                */
+                if( ((CYBLE_HIDS_PROTOCOL_MODE_REPORT == protocol) && 
+                     (CYBLE_HUMAN_INTERFACE_DEVICE_REPORT_OUT == locEventParam->charIndex)) ||
+                    ((CYBLE_HIDS_PROTOCOL_MODE_BOOT == protocol) && 
+                     (CYBLE_HIDS_BOOT_KYBRD_OUT_REP == locEventParam->charIndex)) )
+                {
+                    if( (CAPS_LOCK_LED & locEventParam->value->val[0u]) != 0u)
+                    {
+                        LedSet(LED_CAPS_LOCK, LED_PATTERN_ON, 0u);
+                    }
+                    else
+                    {
+                        LedSet(LED_CAPS_LOCK, LED_PATTERN_OFF, 0u);
+                    }
+                }
+            }
+            DBG_PRINTF("CYBLE_EVT_HIDSS_REPORT_CHAR_WRITE: serv=%x, char=%x, value=", 
+                locEventParam->serviceIndex,
+                locEventParam->charIndex);
+                ShowValue(locEventParam->value);
+            break;
+        case CYBLE_EVT_HIDSC_NOTIFICATION:
+            break;
+        case CYBLE_EVT_HIDSC_READ_CHAR_RESPONSE:
+            break;
+        case CYBLE_EVT_HIDSC_WRITE_CHAR_RESPONSE:
+            break;
+        case CYBLE_EVT_HIDSC_READ_DESCR_RESPONSE:
+            break;
+        case CYBLE_EVT_HIDSC_WRITE_DESCR_RESPONSE:           
+            break;
+		default:
+            DBG_PRINTF("Not supported event\r\n");
+			break;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: HidsInit()
+********************************************************************************
+*
+* Summary:
+*   Initializes the HID service. Called once when the stack is on.
+*
+*******************************************************************************/
+void HidsInit(void)
+{
+    /* Register service specific callback function */
+    CyBle_HidsRegisterAttrCallback(HidsCallBack);
+}
+
+
+/*******************************************************************************
+* Function Name: HidsRestore()
+********************************************************************************
+*
+* Summary:
+*   Picks up the protocol mode and the CCCD values of a new connection. The
+*   stack has restored the CCCDs of a bonded host into the GATT database, 
+*   so the reads are local and need no ATT exchange.
+*
+*******************************************************************************/
+void HidsRestore(void)
+{
+    CYBLE_API_RESULT_T apiResult;
+    uint16 cccdValue;
+    uint8 mode;
+    
+    keyboardSimulation = DISABLED;
+    /* Read the protocol mode once, later changes arrive as events */
+    apiResult = CyBle_HidssGetCharacteristicValue(CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX, 
+        CYBLE_HIDS_PROTOCOL_MODE, sizeof(mode), &mode);
+    HidsSetProtocol((apiResult == CYBLE_ERROR_OK) ? mode : CYBLE_HIDS_PROTOCOL_MODE_REPORT);
+    /* Read CCCD configurations */
+    apiResult = CyBle_HidssGetCharacteristicDescriptor(CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX, 
+        CYBLE_HUMAN_INTERFACE_DEVICE_REPORT_IN, CYBLE_HIDS_REPORT_CCCD, CYBLE_CCCD_LEN, (uint8 *)&cccdValue);
+    if((apiResult == CYBLE_ERROR_OK) && (cccdValue != 0u))
+    {
+        keyboardSimulation |= ENABLED;
+    }
+    apiResult = CyBle_HidssGetCharacteristicDescriptor(CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX, 
+        CYBLE_HIDS_BOOT_KYBRD_IN_REP, CYBLE_HIDS_REPORT_CCCD, CYBLE_CCCD_LEN, (uint8 *)&cccdValue);
+    if((apiResult == CYBLE_ERROR_OK) && (cccdValue != 0u))
+    {
+        keyboardSimulation |= ENABLED;
+    }
+}
+
+    
+/*******************************************************************************
+* Function Name: SimulateKeyboard()
+********************************************************************************
+*
+* Summary:
+*   The custom function to simulate CapsLock key pressing
+*
+*******************************************************************************/
+void SimulateKeyboard(void)
+{
+    static uint32 keyboardTimer = KEYBOARD_TIMEOUT;
+    static uint8 simKey; 
+
+    if(--keyboardTimer == 0u)
+    {
+        keyboardTimer = KEYBOARD_TIMEOUT;
+    
+        simKey++;
+        if(simKey > SIM_KEY_MAX)
+        {
+            simKey = SIM_KEY_MIN; 
+        }
+        SendKeyboard(0u, simKey);
+    }
+}
+
+/*******************************************************************************
+* Function Name: SendKeyboard()
+********************************************************************************
+*
+* Summary:
+*   Queues a key press report followed by the release report. The main loop
+*   sends them as soon as the stack is free.
+*
+* Parameters:
+*  CapsKey - 1 to add the Caps Lock key to the press report
+*  SimKey - key code of the press report
+*
+*******************************************************************************/
+void SendKeyboard(uint8 CapsKey, uint8 SimKey)
+{
+    uint8 keyboard_data[KEYBOARD_DATA_SIZE];
+    uint8 keys[2u];
+    uint8 count = 0u;
+    
+    if((uint8)(hidQueueHead - hidQueueTail) > (HID_QUEUE_SIZE - 2u))
+    {
+        STATS_ADD(reportsDropped, 2u);
+        DBG_PRINTF("HID queue full, key %x dropped \r\n", SimKey);
+        return;
+    }
+
+    PROFILE_BEGIN(PROFILE_SEND_KEYBOARD);
+    if(CapsKey == 1u)
+    {
+        keys[count++] = CAPS_LOCK;
+    }
+    keys[count++] = SimKey;
+    HidsEncodeKeyboard(keyboard_data, 0u, keys, count);
+    (void)HidsQueueReport(keyboard_data);
+
+    HidsEncodeKeyboard(keyboard_data, 0u, keys, 0u);    /* Release all keys */
+    (void)HidsQueueReport(keyboard_data);
+    PROFILE_END(PROFILE_SEND_KEYBOARD);
+}
+
+
+/*******************************************************************************
+* Function Name: HidsEncodeKeyboard()
+********************************************************************************
+*
+* Summary:
+*   Builds a keyboard input report with the layout of HID_KEYBOARD_REPORT.
+*   Key slots beyond count are cleared. With more keys than slots every slot
+*   reports ErrorRollOver, the phantom state of HID 1.11 appendix C, and the
+*   modifiers stay valid.
+*
+* Parameters:
+*  report - KEYBOARD_DATA_SIZE bytes to fill
+*  modifiers - modifier key bits
+*  keys - key codes of the pressed keys, NULL for none
+*  count - number of key codes
+*
+*******************************************************************************/
+void HidsEncodeKeyboard(uint8 report[], uint8 modifiers, const uint8 keys[], uint8 count)
+{
+    uint8 i;
+
+    report[HID_KEYBOARD_MODIFIERS_OFFSET] = modifiers;
+    report[HID_KEYBOARD_RESERVED_OFFSET] = 0u;
+    for(i = 0u; i < HID_KEYBOARD_KEYCODES_SIZE; i++)
+    {
+        if(count > HID_KEYBOARD_KEYCODES_SIZE)
+        {
+            report[HID_KEYBOARD_KEYCODES_OFFSET + i] = KEY_ERROR_ROLL_OVER;
+        }
+        else
+        {
+            report[HID_KEYBOARD_KEYCODES_OFFSET + i] = ((keys != NULL) && (i < count)) ? keys[i] : 0u;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: HidsQueueReport()
+********************************************************************************
+*
+* Summary:
+*   Copies a keyboard report to the transmit queue and schedules the main loop.
+*
+* Parameters:
+*  report - KEYBOARD_DATA_SIZE bytes of report data
+*
+* Return:
+*  ENABLED if the report was queued, DISABLED if the queue is full.
+*
+*******************************************************************************/
+uint8 HidsQueueReport(const uint8 report[])
+{
+    uint8 i;
+    
+    if((uint8)(hidQueueHead - hidQueueTail) >= HID_QUEUE_SIZE)
+    {
+        STATS_INC(reportsDropped);
+        return (DISABLED);
+    }
+    for(i = 0u; i < KEYBOARD_DATA_SIZE; i++)
+    {
+        hidQueue[hidQueueHead & (HID_QUEUE_SIZE - 1u)][i] = report[i];
+    }
+#if (STATS_ENABLE != 0)
+    hidQueueTime[hidQueueHead & (HID_QUEUE_SIZE - 1u)] = StatsTimeNow();
+    stats.reportsQueued++;
+#endif /* (STATS_ENABLE != 0) */
+    hidQueueHead++;
+    SetPendingWork(WORK_HID);
+    
+    return (ENABLED);
+}
+
+
+/*******************************************************************************
+* Function Name: HidsQueueFree()
+********************************************************************************
+*
+* Summary:
+*   Returns the number of reports that can still be queued.
+*
+*******************************************************************************/
+uint8 HidsQueueFree(void)
+{
+    return (HID_QUEUE_SIZE - (uint8)(hidQueueHead - hidQueueTail));
+}
+
+
+/*******************************************************************************
+* Function Name: HidsProcessQueue()
+********************************************************************************
+*
+* Summary:
+*   Sends queued reports until the queue is empty or the stack is busy. 
+*   A busy stack reports CYBLE_EVT_STACK_BUSY_STATUS when it is free again, 
+*   which schedules the next call. A report the stack has no buffer for 
+*   stays queued and is retried then, or at the next timer tick. The queue
+*   is dropped only when the host disabled notifications or the link is
+*   gone.
+*
+*******************************************************************************/
+void HidsProcessQueue(void)
+{
+    CYBLE_API_RESULT_T apiResult;
+    uint8 *report;
+
+    while((hidQueueHead != hidQueueTail) && (CyBle_GattGetBusyStatus() == CYBLE_STACK_STATE_FREE))
+    {
+        report = hidQueue[hidQueueTail & (HID_QUEUE_SIZE - 1u)];
+        
+        /* KEYBOARD_DATA_SIZE is checked to be 8 bytes */
+        DBG_PRINTF("HID notification @%lu: %2.2x,%2.2x,%2.2x,%2.2x,%2.2x,%2.2x,%2.2x,%2.2x\r\n", timerTicks,
+            report[0u], report[1u], report[2u], report[3u], report[4u], report[5u], report[6u], report[7u]);
+
+        apiResult = CyBle_HidssSendNotification(cyBle_connHandle, CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX,
+            hidInputReport, KEYBOARD_DATA_SIZE, report);
+        if(apiResult == CYBLE_ERROR_MEMORY_ALLOCATION_FAILED)
+        {
+            /* Out of buffers for now, keep the report */
+            DBG_PRINTF("HID notification deferred \r\n");
+            break;
+        }
+        else if((apiResult == CYBLE_ERROR_NTF_DISABLED) || (apiResult == CYBLE_ERROR_INVALID_STATE))
+        {
+            DBG_PRINTF("HID notification API Error: %x \r\n", apiResult);
+            keyboardSimulation = DISABLED;
+            STATS_ADD(reportsDropped, (uint8)(hidQueueHead - hidQueueTail));
+            hidQueueTail = hidQueueHead;
+        }
+        else if(apiResult != CYBLE_ERROR_OK)
+        {
+            /* The stack rejected this report, the following ones may pass */
+            DBG_PRINTF("HID notification API Error: %x \r\n", apiResult);
+            STATS_INC(reportsDropped);
+            hidQueueTail++;
+        }
+        else
+        {
+            HostReportSent();
+            BootMark(BOOT_PHASE_FIRST_REPORT);
+        #if (STATS_ENABLE != 0)
+            StatsReportSent(hidQueueTime[hidQueueTail & (HID_QUEUE_SIZE - 1u)]);
+        #endif /* (STATS_ENABLE != 0) */
+            hidQueueTail++;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: HidsSetProtocol()
+********************************************************************************
+*
+* Summary:
+*   Caches the protocol mode and the input report characteristic used in it.
+*
+* Parameters:
+*  mode - CYBLE_HIDS_PROTOCOL_MODE_BOOT or CYBLE_HIDS_PROTOCOL_MODE_REPORT
+*
+*******************************************************************************/
+static void HidsSetProtocol(uint8 mode)
+{
+    protocol = mode;
+    if(mode == CYBLE_HIDS_PROTOCOL_MODE_BOOT)
+    {
+        hidInputReport = CYBLE_HIDS_BOOT_KYBRD_IN_REP;
+    }
+    else
+    {
+        hidInputReport = CYBLE_HUMAN_INTERFACE_DEVICE_REPORT_IN;
+    }
+}
+
+
+void SendPageCtrl(uint8 PageCtrl)
+{
+    if (PageCtrl == 0u)
+    {
+        SendKeyboard(0u, PAGE_DOWN);
+    }
+    else
+    {
+        SendKeyboard(0u, PAGE_UP);
+    }
+}
+
+void SendSoundCtrl(uint8 SoundCtrl)
+{
+    if (SoundCtrl == 0u)
+    {
+        SendKeyboard(0u, SOUND_LOW);
+    }
+    else
+    {
+        SendKeyboard(0u, SOUND_HIGH);
+    }
+}
+
+void SendLightCtrl(uint8 LightCtrl)
+{
+    if (LightCtrl == 0u)
+    {
+        SendKeyboard(0u, LIGHT_LOW);
+    }
+    else
+    {
+        SendKeyboard(0u, LIGHT_HIGH);
+    }
+}
+
+
+/* [] END OF FILE */
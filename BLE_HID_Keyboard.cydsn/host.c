@@ -0,0 +1,246 @@
+/*******************************************************************************
+* File Name: host.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the host selection. The bonded devices of the stack are
+*  used as host slots. Selecting a slot drops the current link and advertises
+*  directed to the selected host, which reconnects without a scan. Undirected
+*  advertising resumes when the host does not answer.
+*
+* Hardware Dependency:
+*  CY8CKIT-149 PSoC 4100S Plus Prototyping Kit
+*
+*******************************************************************************/
+
+#include "common.h"
+#include "host.h"
+#include "power.h"
+#include <string.h>
+
+static CYBLE_GAP_BD_ADDR_T hostTarget;              /* Address of the selected host */
+static uint8 hostSwitchPending = DISABLED;          /* Advertise directed to hostTarget next */
+static uint8 hostDirected = DISABLED;               /* Directed advertising in progress */
+uint8 hostFirstReport = DISABLED;                   /* First report after a switch not sent yet */
+static uint32 hostConnectTicks;
+static uint8 hostAdvStarts;                         /* Advertising starts since HostStartAdvertisement() */
+
+
+/*******************************************************************************
+* Function Name: HostSlot()
+********************************************************************************
+*
+* Summary:
+*   Maps a slider position to its host slot. The positions 0 to
+*   HOST_SLIDER_RESOLUTION are split into HOST_SLOT_COUNT zones of equal
+*   width.
+*
+* Parameters:
+*  position - slider position
+*  bondedCount - bonded devices, the slots in use
+*
+* Return:
+*  The slot, HOST_SLOT_NONE when the position is off the slider or the slot
+*  has no bonded host.
+*
+*******************************************************************************/
+uint8 HostSlot(uint8 position, uint8 bondedCount)
+{
+    uint8 slot;
+
+    if(position > HOST_SLIDER_RESOLUTION)
+    {
+        return (HOST_SLOT_NONE);
+    }
+    slot = (uint8)(((uint16)position * HOST_SLOT_COUNT) / (HOST_SLIDER_RESOLUTION + 1u));
+    return ((slot < bondedCount) ? slot : HOST_SLOT_NONE);
+}
+
+
+/*******************************************************************************
+* Function Name: HostSelect()
+********************************************************************************
+*
+* Summary:
+*   Switches to the host bonded in the slot under the slider position. 
+*   Nothing happens if the slot is empty or already connected.
+*
+* Parameters:
+*  position - slider position of the selecting tap
+*
+*******************************************************************************/
+void HostSelect(uint8 position)
+{
+    CYBLE_GAP_BONDED_DEV_ADDR_LIST_T bondedList;
+    CYBLE_GAP_BD_ADDR_T peerAddr;
+    uint8 slot = HOST_SLOT_NONE;
+
+    if(CyBle_GapGetBondedDevicesList(&bondedList) == CYBLE_ERROR_OK)
+    {
+        slot = HostSlot(position, bondedList.count);
+    }
+    if(slot == HOST_SLOT_NONE)
+    {
+        DBG_PRINTF("Host slot at %u is empty \r\n", position);
+        return;
+    }
+    if((CyBle_GetState() == CYBLE_STATE_CONNECTED) &&
+       (CyBle_GapGetPeerBdAddr(cyBle_connHandle.bdHandle, &peerAddr) == CYBLE_ERROR_OK) &&
+       (memcmp(bondedList.bdAddrList[slot].bdAddr, peerAddr.bdAddr, CYBLE_GAP_BD_ADDR_SIZE) == 0))
+    {
+        DBG_PRINTF("Host slot %u is connected \r\n", slot);
+        return;
+    }
+
+    DBG_PRINTF("Switch to host slot %u \r\n", slot);
+    hostTarget = bondedList.bdAddrList[slot];
+    hostSwitchPending = ENABLED;
+    if(CyBle_GetState() == CYBLE_STATE_CONNECTED)
+    {
+        /* Advertising restarts from the disconnect event */
+        (void)CyBle_GapDisconnect(cyBle_connHandle.bdHandle);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: HostStartAdvertisement()
+********************************************************************************
+*
+* Summary:
+*   Starts advertising, directed to the selected host after a switch and
+*   undirected otherwise.
+*
+* Return:
+*  Result of CyBle_GappStartAdvertisement().
+*
+*******************************************************************************/
+CYBLE_API_RESULT_T HostStartAdvertisement(void)
+{
+    CYBLE_GAPP_DISC_PARAM_T *advParam = cyBle_discoveryModeInfo.advParam;
+
+    hostAdvStarts = 0u;
+    if(hostSwitchPending == ENABLED)
+    {
+        hostSwitchPending = DISABLED;
+        hostDirected = ENABLED;
+        advParam->advType = CYBLE_GAPP_CONNECTABLE_HIGH_DC_DIRECTED_ADV;
+        advParam->directAddrType = hostTarget.type;
+        (void)memcpy(advParam->directAddr, hostTarget.bdAddr, CYBLE_GAP_BD_ADDR_SIZE);
+    }
+    else
+    {
+        hostDirected = DISABLED;
+        advParam->advType = CYBLE_GAPP_CONNECTABLE_UNDIRECTED_ADV;
+    }
+
+    return (CyBle_GappStartAdvertisement(CYBLE_ADVERTISING_FAST));
+}
+
+
+/*******************************************************************************
+* Function Name: HostAdvertisementStarted()
+********************************************************************************
+*
+* Summary:
+*   The first start is fast advertising, a later one is the slow advertising
+*   the component continues with. The power profile may skip it to go to
+*   hibernate earlier.
+*
+*******************************************************************************/
+void HostAdvertisementStarted(void)
+{
+    hostAdvStarts++;
+    if((hostAdvStarts > 1u) && (hostDirected == DISABLED) && (PowerGetProfile()->slowAdvertising == 0u))
+    {
+        DBG_PRINTF("Skip slow advertising \r\n");
+        (void)CyBle_GappStopAdvertisement();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: HostAdvertisementStopped()
+********************************************************************************
+*
+* Summary:
+*   Falls back to undirected advertising when directed advertising ended 
+*   without a connection.
+*
+* Return:
+*  ENABLED if advertising was restarted, DISABLED if advertising is over.
+*
+*******************************************************************************/
+uint8 HostAdvertisementStopped(void)
+{
+    uint8 restarted = DISABLED;
+
+    if(hostDirected == ENABLED)
+    {
+        DBG_PRINTF("Host did not answer directed advertising \r\n");
+        if(HostStartAdvertisement() == CYBLE_ERROR_OK)
+        {
+            restarted = ENABLED;
+        }
+    }
+
+    return (restarted);
+}
+
+
+/*******************************************************************************
+* Function Name: HostSlowAdvertising()
+********************************************************************************
+*
+* Summary:
+*   Tells whether the component advertises with the slow interval.
+*
+* Return:
+*  ENABLED during slow advertising, DISABLED otherwise.
+*
+*******************************************************************************/
+uint8 HostSlowAdvertising(void)
+{
+    return (((CyBle_GetState() == CYBLE_STATE_ADVERTISING) && (hostAdvStarts > 1u) &&
+             (hostDirected == DISABLED)) ? ENABLED : DISABLED);
+}
+
+
+/*******************************************************************************
+* Function Name: HostConnected()
+********************************************************************************
+*
+* Summary:
+*   Starts measuring the time to the first report when the selected host
+*   answered the directed advertising. Called on connection, after the
+*   timer was started.
+*
+*******************************************************************************/
+void HostConnected(void)
+{
+    hostFirstReport = hostDirected;
+    hostDirected = DISABLED;
+    hostConnectTicks = timerTicks;
+}
+
+
+/*******************************************************************************
+* Function Name: HostReportSent()
+********************************************************************************
+*
+* Summary:
+*   Reports the time from connection to the first report after a switch.
+*
+*******************************************************************************/
+void HostReportSent(void)
+{
+    if(hostFirstReport == ENABLED)
+    {
+        hostFirstReport = DISABLED;
+        DBG_PRINTF("First report after host switch: %lu ticks \r\n", timerTicks - hostConnectTicks);
+    }
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,46 @@
+/*******************************************************************************
+* File Name: host.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the host selection
+*  between bonded central devices.
+*
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* The slider is split into HOST_SLOT_COUNT zones, left to right. A tap in a
+*  zone while BTN0 is held switches to the host bonded in that slot. The BLE
+*  component must allow at least this many bonded devices. */
+#define HOST_SLOT_COUNT             (3u)
+#define HOST_SLIDER_RESOLUTION      (100u)      /* Slider positions, as configured on the CapSense MCU */
+#define HOST_SLOT_NONE              (0xFFu)     /* No slot under the position, or the slot is empty */
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+uint8 HostSlot(uint8 position, uint8 bondedCount);
+void HostSelect(uint8 position);
+CYBLE_API_RESULT_T HostStartAdvertisement(void);
+void HostAdvertisementStarted(void);
+uint8 HostAdvertisementStopped(void);
+uint8 HostSlowAdvertising(void);
+void HostConnected(void);
+void HostReportSent(void);
+
+
+/***************************************
+* External data references
+***************************************/
+extern uint8 hostFirstReport;
+
+
+/* [] END OF FILE */
@@ -0,0 +1,254 @@
+/*******************************************************************************
+* File Name: keys.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the LE Secure Connections key store. Generating the
+*  P-256 key pair takes the Cortex-M0 far longer than the rest of a pairing,
+*  so the stack generates it while the keyboard is idle and the record of
+*  the pair is kept in flash, where the chip protection closes it to the
+*  debug port. A pairing then starts with the pair already set in the stack.
+*  After KEYS_MAX_USES pairings, failed ones included, the next idle period
+*  replaces the pair. A record is used only when its CRC agrees with it.
+*
+* Hardware Dependency:
+*  CY8CKIT-149 PSoC 4100S Plus Prototyping Kit
+*
+*******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+#include "common.h"
+#include "keys.h"
+
+#if (KEYS_ENABLE != 0)
+/* Flash rows holding the record, zero in a freshly programmed device */
+static const volatile uint8 CY_ALIGN(CY_FLASH_SIZEOF_ROW) keysFlash[KEYS_ROWS * CY_FLASH_SIZEOF_ROW] = {0u};
+
+/* RAM image of the flash rows */
+static union
+{
+    KEYS_RECORD_T record;
+    uint8 bytes[KEYS_ROWS * CY_FLASH_SIZEOF_ROW];
+} keysImage;
+
+uint8 keysState = KEYS_STATE_NONE;
+uint8 keysPairingReady = DISABLED;      /* The current or last pairing found a key pair set */
+static uint8 keysPairing = DISABLED;
+
+
+/*******************************************************************************
+* Function Name: KeysStart()
+********************************************************************************
+*
+* Summary:
+*   Sets the stored key pair in the stack when its record is valid. Called
+*   on CYBLE_EVT_STACK_ON, so a restarted stack gets the pair again.
+*
+*******************************************************************************/
+void KeysStart(void)
+{
+    uint32 index;
+
+    for(index = 0u; index < sizeof(keysImage); index++)
+    {
+        keysImage.bytes[index] = keysFlash[index];
+    }
+
+    keysPairing = DISABLED;
+    keysState = KEYS_STATE_NONE;
+    if(KeysValidate(&keysImage.record) != 0u)
+    {
+        if(CyBle_GapSetLocalP256Keys(&keysImage.record.pair) == CYBLE_ERROR_OK)
+        {
+            keysState = KEYS_STATE_READY;
+        }
+    }
+    else
+    {
+        /* No record yet, the next key pair is the first */
+        keysImage.record.generation = 0u;
+    }
+    DBG_PRINTF("Key pair %u, state %u, uses %u \r\n", keysImage.record.generation, keysState,
+               keysImage.record.uses);
+}
+
+
+/*******************************************************************************
+* Function Name: KeysProcess()
+********************************************************************************
+*
+* Summary:
+*   Starts the generation of a key pair when there is none or the stored
+*   one is used up, and writes a changed record to flash. Nothing is started
+*   during a pairing. Called on every timer tick.
+*
+* Parameters:
+*  idle - non-zero when no hand is near and no report waits, a generation
+*         only starts then
+*
+*******************************************************************************/
+void KeysProcess(uint8 idle)
+{
+    CYBLE_API_RESULT_T apiResult;
+
+    if(keysPairing != DISABLED)
+    {
+        return;
+    }
+
+    switch(keysState)
+    {
+        case KEYS_STATE_NONE:
+        case KEYS_STATE_READY:
+            if((idle != 0u) && ((keysState == KEYS_STATE_NONE) || (keysImage.record.uses >= KEYS_MAX_USES)))
+            {
+                apiResult = CyBle_GapGenerateLocalP256Keys();
+                DBG_PRINTF("Generate key pair, status: %x \r\n", apiResult);
+                if(apiResult == CYBLE_ERROR_OK)
+                {
+                    keysState = KEYS_STATE_GENERATING;
+                }
+            }
+            break;
+
+        case KEYS_STATE_STORING:
+            /* The bonding data has the flash first */
+            if(cyBle_pendingFlashWrite == 0u)
+            {
+                apiResult = CyBle_StoreAppData(keysImage.bytes, (const uint8 *)keysFlash, sizeof(keysImage), 0u);
+                if(apiResult == CYBLE_ERROR_OK)
+                {
+                    keysState = KEYS_STATE_READY;
+                }
+                else if(apiResult != CYBLE_ERROR_FLASH_WRITE_NOT_PERMITTED)
+                {
+                    DBG_PRINTF("Store key pair, status: %x \r\n", apiResult);
+                }
+                else
+                {
+                    /* Row-by-row write is not finished yet */
+                }
+            }
+            break;
+
+        default:
+            /* Waiting for CYBLE_EVT_GAP_GEN_SET_LOCAL_P256_KEYS_COMPLETE */
+            break;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: KeysGenerated()
+********************************************************************************
+*
+* Summary:
+*   Takes a key pair the stack generated and set, on
+*   CYBLE_EVT_GAP_GEN_SET_LOCAL_P256_KEYS_COMPLETE, into a new record.
+*
+* Parameters:
+*  pair - the generated key pair
+*
+*******************************************************************************/
+void KeysGenerated(const CYBLE_GAP_SMP_LOCAL_P256_KEYS *pair)
+{
+    uint16 generation = keysImage.record.generation + 1u;
+
+    /* Cleared first, so the padding bytes under the CRC are defined */
+    (void)memset(&keysImage, 0, sizeof(keysImage));
+    keysImage.record.magic = KEYS_MAGIC;
+    keysImage.record.generation = generation;
+    keysImage.record.pair = *pair;
+    keysImage.record.crc = KeysCrc(&keysImage.record);
+    keysState = KEYS_STATE_STORING;
+    DBG_PRINTF("Key pair %u generated \r\n", generation);
+}
+
+
+/*******************************************************************************
+* Function Name: KeysPairingStart(), KeysPairingEnd()
+********************************************************************************
+*
+* Summary:
+*   Called on CYBLE_EVT_GAP_AUTH_REQ and on CYBLE_EVT_GAP_AUTH_COMPLETE or
+*   CYBLE_EVT_GAP_AUTH_FAILED. A pairing that found a key pair set counts as
+*   one of its uses.
+*
+*******************************************************************************/
+void KeysPairingStart(void)
+{
+    keysPairing = ENABLED;
+    keysPairingReady = ((keysState == KEYS_STATE_STORING) || (keysState == KEYS_STATE_READY)) ? ENABLED : DISABLED;
+    DBG_PRINTF("Pairing with %s key pair \r\n", (keysPairingReady != DISABLED) ? "a precomputed" : "no");
+}
+
+void KeysPairingEnd(void)
+{
+    if((keysPairing != DISABLED) && (keysPairingReady != DISABLED))
+    {
+        keysImage.record.uses++;
+        keysImage.record.crc = KeysCrc(&keysImage.record);
+        keysState = KEYS_STATE_STORING;
+    }
+    keysPairing = DISABLED;
+}
+
+
+/*******************************************************************************
+* Function Name: KeysValidate()
+********************************************************************************
+*
+* Summary:
+*   Checks that a record holds a key pair and is intact.
+*
+* Parameters:
+*  record - the record to check
+*
+* Return:
+*  Non-zero when the key pair may be used.
+*
+*******************************************************************************/
+uint8 KeysValidate(const KEYS_RECORD_T *record)
+{
+    return (uint8)((record->magic == KEYS_MAGIC) && (record->crc == KeysCrc(record)));
+}
+
+
+/*******************************************************************************
+* Function Name: KeysCrc()
+********************************************************************************
+*
+* Summary:
+*   Computes the CRC-16-CCITT of a record, over everything that follows the
+*   crc field.
+*
+* Parameters:
+*  record - the record to compute the CRC of
+*
+* Return:
+*  The CRC.
+*
+*******************************************************************************/
+uint16 KeysCrc(const KEYS_RECORD_T *record)
+{
+    const uint8 *data = (const uint8 *)&record->uses;
+    uint32 size = sizeof(KEYS_RECORD_T) - offsetof(KEYS_RECORD_T, uses);
+    uint16 crc = KEYS_CRC_INIT;
+    uint8 bit;
+
+    while(size-- != 0u)
+    {
+        crc ^= (uint16)((uint16)*data++ << 8u);
+        for(bit = 0u; bit < 8u; bit++)
+        {
+            crc = ((crc & 0x8000u) != 0u) ? (uint16)((crc << 1u) ^ KEYS_CRC_POLY) : (uint16)(crc << 1u);
+        }
+    }
+    return crc;
+}
+#endif /* (KEYS_ENABLE != 0) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,76 @@
+/*******************************************************************************
+* File Name: keys.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the LE Secure
+*  Connections key store, which keeps a P-256 key pair generated while the
+*  keyboard is idle in flash.
+*
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*  Conditional Compilation Parameters
+***************************************/
+#if !defined(KEYS_ENABLE)
+#define KEYS_ENABLE                 (0)     /* Set to 1 with LE Secure Connections enabled in the BLE component */
+#endif /* !defined(KEYS_ENABLE) */
+
+
+#if (KEYS_ENABLE != 0)
+/***************************************
+*          Constants
+***************************************/
+
+#define KEYS_MAX_USES               (1u)            /* Pairings a key pair is used for before it is replaced */
+#define KEYS_MAGIC                  (0x4B455953u)   /* "KEYS" */
+#define KEYS_ROWS                   ((sizeof(KEYS_RECORD_T) + CY_FLASH_SIZEOF_ROW - 1u) / CY_FLASH_SIZEOF_ROW)
+
+#define KEYS_CRC_INIT               (0xFFFFu)
+#define KEYS_CRC_POLY               (0x1021u)       /* CRC-16-CCITT */
+
+/* keysState values */
+#define KEYS_STATE_NONE             (0u)    /* No key pair, the stack generates one during a pairing */
+#define KEYS_STATE_GENERATING       (1u)    /* The stack generates a key pair */
+#define KEYS_STATE_STORING          (2u)    /* The key pair is set in the stack, its record waits for flash */
+#define KEYS_STATE_READY            (3u)    /* The key pair is set in the stack and stored */
+
+
+/***************************************
+*        Data Types
+***************************************/
+typedef struct
+{
+    uint16 crc;                             /* CRC over all fields below */
+    uint16 uses;                            /* Pairings that used the key pair */
+    uint32 magic;                           /* KEYS_MAGIC */
+    uint16 generation;                      /* Key pairs generated on this device, the first is 1 */
+    CYBLE_GAP_SMP_LOCAL_P256_KEYS pair;
+} KEYS_RECORD_T;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+void KeysStart(void);
+void KeysProcess(uint8 idle);
+void KeysGenerated(const CYBLE_GAP_SMP_LOCAL_P256_KEYS *pair);
+void KeysPairingStart(void);
+void KeysPairingEnd(void);
+uint8 KeysValidate(const KEYS_RECORD_T *record);
+uint16 KeysCrc(const KEYS_RECORD_T *record);
+
+
+/***************************************
+* External data references
+***************************************/
+extern uint8 keysState;
+extern uint8 keysPairingReady;
+#endif /* (KEYS_ENABLE != 0) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,193 @@
+/*******************************************************************************
+* File Name: led.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the LED manager. The LEDs are driven from the 100 ms
+*  step of the timer interrupt: each LED follows a blink pattern until its
+*  timeout expires. The timer keeps running while an indication is active,
+*  also outside a connection. All LEDs share an energy budget, and feedback
+*  LEDs stay dark in the power bands that do not allow them. The charge
+*  drawn by the LEDs is accumulated in ledCharge.
+*
+* Hardware Dependency:
+*  CY8CKIT-149 PSoC 4100S Plus Prototyping Kit
+*
+*******************************************************************************/
+
+#include "common.h"
+#include "led.h"
+#include "bas.h"
+#include "power.h"
+
+/* Non-zero for indications that are only feedback and give way to power saving */
+static const uint8 ledFeedback[LED_COUNT] = {1u, 0u};
+
+static uint8 ledPattern[LED_COUNT];
+static uint8 ledTimeout[LED_COUNT];     /* Hundreds of ms until the LED turns off, 0 for no timeout */
+static uint8 ledStep;
+static uint8 ledLit;                    /* One bit per LED that is on */
+static uint32 ledBudget = LED_BUDGET_MAX;
+volatile uint32 ledCharge = 0u;         /* Charge drawn by the LEDs, uA times 100 ms */
+
+static void LedWrite(uint8 led, uint8 state);
+
+
+/*******************************************************************************
+* Function Name: LedSet()
+********************************************************************************
+*
+* Summary:
+*   Starts an indication. It takes effect on the next timer step.
+*
+* Parameters:
+*  led - one of the LED_xxx indications
+*  pattern - LED_PATTERN_xxx or any other 8 step pattern
+*  timeout - hundreds of ms until the LED turns off, 0 for no timeout
+*
+*******************************************************************************/
+void LedSet(uint8 led, uint8 pattern, uint8 timeout)
+{
+    uint8 interruptStatus;
+
+    if(led < LED_COUNT)
+    {
+        if((ledFeedback[led] != 0u) && (PowerGetProfile()->ledFeedback == 0u))
+        {
+            pattern = LED_PATTERN_OFF;
+        }
+        interruptStatus = CyEnterCriticalSection();
+        ledPattern[led] = pattern;
+        ledTimeout[led] = timeout;
+        CyExitCriticalSection(interruptStatus);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: LedTick()
+********************************************************************************
+*
+* Summary:
+*   Advances the blink patterns and timeouts by one 100 ms step and charges
+*   the lit LEDs to the budget. Called from the timer interrupt.
+*
+*******************************************************************************/
+void LedTick(void)
+{
+    uint8 led;
+    uint8 lit;
+
+    ledBudget += LED_BUDGET_RATE;
+    if(ledBudget > LED_BUDGET_MAX)
+    {
+        ledBudget = LED_BUDGET_MAX;
+    }
+    ledStep = (ledStep + 1u) % LED_PATTERN_STEPS;
+
+    for(led = 0u; led < LED_COUNT; led++)
+    {
+        lit = ledPattern[led] & (uint8)(1u << ledStep);
+        if((lit != 0u) && (ledBudget >= LED_CURRENT))
+        {
+            ledBudget -= LED_CURRENT;
+            ledCharge += LED_CURRENT;
+            ledLit |= (uint8)(1u << led);
+            LedWrite(led, LED_ON);
+        }
+        else
+        {
+            ledLit &= (uint8)~(1u << led);
+            LedWrite(led, LED_OFF);
+        }
+
+        if((ledTimeout[led] != 0u) && (--ledTimeout[led] == 0u))
+        {
+            ledPattern[led] = LED_PATTERN_OFF;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: LedAllOff()
+********************************************************************************
+*
+* Summary:
+*   Ends all indications and turns the LEDs off at once. Called when the
+*   link is lost and before Hibernate.
+*
+*******************************************************************************/
+void LedAllOff(void)
+{
+    uint8 led;
+
+    for(led = 0u; led < LED_COUNT; led++)
+    {
+        LedSet(led, LED_PATTERN_OFF, 0u);
+        LedWrite(led, LED_OFF);
+    }
+    ledLit = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: LedActive()
+********************************************************************************
+*
+* Summary:
+*   Tells whether the LEDs still need timer steps: an indication is running
+*   or an LED has not been turned off yet.
+*
+* Return:
+*  ENABLED while the LEDs need the timer, DISABLED otherwise.
+*
+*******************************************************************************/
+uint8 LedActive(void)
+{
+    uint8 led;
+    uint8 active = (ledLit != 0u) ? ENABLED : DISABLED;
+
+    for(led = 0u; led < LED_COUNT; led++)
+    {
+        if(ledPattern[led] != LED_PATTERN_OFF)
+        {
+            active = ENABLED;
+        }
+    }
+    return (active);
+}
+
+
+/*******************************************************************************
+* Function Name: LedWrite()
+********************************************************************************
+*
+* Summary:
+*   Drives the pin of an LED. LEDs without a pin in this build are skipped.
+*
+* Parameters:
+*  led - one of the LED_xxx indications
+*  state - LED_ON or LED_OFF
+*
+*******************************************************************************/
+static void LedWrite(uint8 led, uint8 state)
+{
+    switch(led)
+    {
+        case LED_CAPS_LOCK:
+            CapsLock_LED_Write(state);
+            break;
+    #if (BAS_MEASURE_LP_LED != 0u)
+        case LED_LOW_POWER:
+            LowPower_LED_Write(state);
+            break;
+    #endif /* (BAS_MEASURE_LP_LED != 0u) */
+        default:
+            break;
+    }
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,56 @@
+/*******************************************************************************
+* File Name: led.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the LED manager.
+*
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Managed LEDs */
+#define LED_CAPS_LOCK               (0u)        /* Feedback: Caps Lock state written by the host, no timeout */
+#define LED_LOW_POWER               (1u)        /* Status: battery below LOW_BATTERY_LIMIT */
+#define LED_COUNT                   (2u)
+
+/* Blink patterns, one bit per 100 ms step, LSB first. Patterns with few
+*  bits set dim the indication to their duty cycle of the 800 ms cycle. */
+#define LED_PATTERN_OFF             (0x00u)
+#define LED_PATTERN_ON              (0xFFu)
+#define LED_PATTERN_BLINK           (0x0Fu)     /* 50 % */
+#define LED_PATTERN_FLASH           (0x01u)     /* 12.5 % */
+#define LED_PATTERN_STEPS           (8u)
+
+/* Energy budget, as a token bucket in microamps times 100 ms. Each lit LED
+*  takes LED_CURRENT per step; the bucket refills by LED_BUDGET_RATE per
+*  step up to LED_BUDGET_MAX. An empty bucket keeps the LEDs dark, so an
+*  LED that stays on, such as Caps Lock, is lit steadily for 3 s and then
+*  flashes for one step in every ten. */
+#define LED_CURRENT                 (2000u)     /* Estimated current of one lit LED, uA */
+#define LED_BUDGET_RATE             (200u)      /* Average LED current allowed, uA */
+#define LED_BUDGET_MAX              (60000u)    /* 3 s of one lit LED */
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+void LedSet(uint8 led, uint8 pattern, uint8 timeout);
+void LedTick(void);
+void LedAllOff(void);
+uint8 LedActive(void);
+
+
+/***************************************
+* External data references
+***************************************/
+extern volatile uint32 ledCharge;
+
+
+/* [] END OF FILE */
@@ -0,0 +1,177 @@
+/*******************************************************************************
+* File Name: link.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the link monitor. It samples the RSSI of the connection
+*  and steps the TX power of the connection channel down while the host is
+*  close and up again when the link degrades. The power configured in the
+*  BLE component is the ceiling.
+*
+* Hardware Dependency:
+*  CY8CKIT-149 PSoC 4100S Plus Prototyping Kit
+*
+*******************************************************************************/
+
+#include "common.h"
+#include "link.h"
+
+/* TX power steps, lowest first */
+static const CYBLE_BLESS_PWR_LVL_T linkPowerLevels[] =
+{
+    CYBLE_LL_PWR_LVL_NEG_18_DBM,
+    CYBLE_LL_PWR_LVL_NEG_12_DBM,
+    CYBLE_LL_PWR_LVL_NEG_6_DBM,
+    CYBLE_LL_PWR_LVL_NEG_3_DBM,
+    CYBLE_LL_PWR_LVL_0_DBM,
+    CYBLE_LL_PWR_LVL_3_DBM,
+};
+#define LINK_POWER_STEPS            (sizeof(linkPowerLevels) / sizeof(linkPowerLevels[0u]))
+
+int8 linkRssi;                          /* Filtered RSSI in dBm */
+uint8 linkPowerStep;                    /* Current index into linkPowerLevels */
+static uint8 linkPowerMax;              /* Index of the configured power */
+static CYBLE_BLESS_PWR_LVL_T linkPowerConfigured;
+static uint8 linkConfigRead = DISABLED;
+static int16 linkRssiFilter;            /* Filter state, LINK_RSSI_SHIFT fractional bits */
+static uint8 linkHold;
+static uint8 linkValid = DISABLED;
+
+static void LinkSetPower(uint8 step);
+
+
+/*******************************************************************************
+* Function Name: LinkStart()
+********************************************************************************
+*
+* Summary:
+*   Reads the configured TX power of the connection channel, the ceiling of
+*   the power steps. Called on CYBLE_EVT_STACK_ON; only the first call reads
+*   it, later ones would see a power lowered by LinkSetPower().
+*
+*******************************************************************************/
+void LinkStart(void)
+{
+    CYBLE_BLESS_PWR_IN_DB_T power;
+    uint8 step;
+
+    if(linkConfigRead == DISABLED)
+    {
+        power.bleSsChId = CYBLE_LL_CONN_CH_TYPE;
+        power.blePwrLevelInDbm = linkPowerLevels[LINK_POWER_STEPS - 1u];
+        (void)CyBle_GetTxPowerLevel(&power);
+        linkPowerConfigured = power.blePwrLevelInDbm;
+        linkPowerMax = 0u;
+        for(step = 0u; step < LINK_POWER_STEPS; step++)
+        {
+            if(linkPowerLevels[step] <= linkPowerConfigured)
+            {
+                linkPowerMax = step;
+            }
+        }
+        linkConfigRead = ENABLED;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: LinkInit()
+********************************************************************************
+*
+* Summary:
+*   Starts a new connection at the configured TX power, whatever power the
+*   previous connection ended with.
+*
+*******************************************************************************/
+void LinkInit(void)
+{
+    CYBLE_BLESS_PWR_IN_DB_T power;
+
+    power.bleSsChId = CYBLE_LL_CONN_CH_TYPE;
+    power.blePwrLevelInDbm = linkPowerConfigured;
+    (void)CyBle_SetTxPowerLevel(&power);
+    linkPowerStep = linkPowerMax;
+    linkValid = DISABLED;
+    linkHold = LINK_HOLD_SAMPLES;
+}
+
+
+/*******************************************************************************
+* Function Name: LinkProcess()
+********************************************************************************
+*
+* Summary:
+*   Samples and filters the RSSI and adjusts the TX power. Called by the 
+*   main loop every LINK_TIMEOUT while connected.
+*
+*******************************************************************************/
+void LinkProcess(void)
+{
+    int8 rssi = CyBle_GetRssi();
+
+    if(linkValid == DISABLED)
+    {
+        linkRssiFilter = (int16)rssi << LINK_RSSI_SHIFT;
+        linkValid = ENABLED;
+    }
+    else
+    {
+        linkRssiFilter += (int16)rssi - (linkRssiFilter >> LINK_RSSI_SHIFT);
+    }
+    linkRssi = (int8)(linkRssiFilter >> LINK_RSSI_SHIFT);
+
+    if(linkRssi < LINK_RSSI_CRITICAL)
+    {
+        /* Do not risk the link, go to full power without waiting */
+        LinkSetPower(linkPowerMax);
+    }
+    else if(linkHold != 0u)
+    {
+        linkHold--;
+    }
+    else if((linkRssi > LINK_RSSI_HIGH) && (linkPowerStep > 0u))
+    {
+        LinkSetPower(linkPowerStep - 1u);
+    }
+    else if((linkRssi < LINK_RSSI_LOW) && (linkPowerStep < linkPowerMax))
+    {
+        LinkSetPower(linkPowerStep + 1u);
+    }
+    else
+    {
+        /* Inside the window */
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: LinkSetPower()
+********************************************************************************
+*
+* Summary:
+*   Sets the TX power of the connection channel and restarts the hold time.
+*
+* Parameters:
+*  step - index into linkPowerLevels
+*
+*******************************************************************************/
+static void LinkSetPower(uint8 step)
+{
+    CYBLE_BLESS_PWR_IN_DB_T power;
+
+    if(step != linkPowerStep)
+    {
+        power.bleSsChId = CYBLE_LL_CONN_CH_TYPE;
+        power.blePwrLevelInDbm = linkPowerLevels[step];
+        if(CyBle_SetTxPowerLevel(&power) == CYBLE_ERROR_OK)
+        {
+            DBG_PRINTF("TX power step %u, RSSI %d \r\n", step, linkRssi);
+            linkPowerStep = step;
+        }
+    }
+    linkHold = LINK_HOLD_SAMPLES;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,45 @@
+/*******************************************************************************
+* File Name: link.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the link monitor that
+*  adapts the TX power of the connection to the received signal strength.
+*
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+
+#define LINK_TIMEOUT                (10u)       /* RSSI sample period, counts in hundreds of ms */
+
+/* Filtered RSSI window in dBm. Above the window the TX power is lowered one
+*  step, below it raised one step. The window width is the hysteresis. */
+#define LINK_RSSI_HIGH              (-55)
+#define LINK_RSSI_LOW               (-75)
+#define LINK_RSSI_CRITICAL          (-85)       /* Jump to full power at once */
+#define LINK_RSSI_SHIFT             (2u)        /* RSSI filter coefficient 1/2^n */
+#define LINK_HOLD_SAMPLES           (4u)        /* Samples between two power steps */
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+void LinkStart(void);
+void LinkInit(void);
+void LinkProcess(void);
+
+
+/***************************************
+* External data references
+***************************************/
+extern int8 linkRssi;
+extern uint8 linkPowerStep;
+
+
+/* [] END OF FILE */
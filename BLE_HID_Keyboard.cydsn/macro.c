@@ -0,0 +1,196 @@
+/*******************************************************************************
+* File Name: macro.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the text macro playback. A macro is typed into the HID
+*  report queue as fast as the queue drains, so the link rate sets the typing
+*  speed. A key press replaces the previous key in the next report; a release
+*  report is only sent before a repeated key and at the end of the text.
+*
+* Hardware Dependency:
+*  CY8CKIT-149 PSoC 4100S Plus Prototyping Kit
+*
+*******************************************************************************/
+
+#include "common.h"
+#include "hids.h"
+#include "macro.h"
+
+static const char8 * const macroText[MACRO_COUNT] =
+{
+    MACRO_TEXT_STATION_ID,
+};
+
+static const char8 *macroPos = NULL;        /* Next character to type, NULL when idle */
+static uint8 macroLastKey;                  /* Key held by the last queued report */
+
+static uint8 MacroKeyCode(char8 c, uint8 *modifiers);
+
+
+/*******************************************************************************
+* Function Name: MacroStart()
+********************************************************************************
+*
+* Summary:
+*   Starts typing a macro. A macro that is still playing is replaced.
+*
+* Parameters:
+*  macro - MACRO_xxx index
+*
+*******************************************************************************/
+void MacroStart(uint8 macro)
+{
+    if(macro < MACRO_COUNT)
+    {
+        macroPos = macroText[macro];
+        macroLastKey = 0u;
+        SetPendingWork(WORK_HID);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: MacroStop()
+********************************************************************************
+*
+* Summary:
+*   Aborts the macro. Reports already queued are still sent.
+*
+*******************************************************************************/
+void MacroStop(void)
+{
+    macroPos = NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: MacroProcess()
+********************************************************************************
+*
+* Summary:
+*   Fills the free HID queue slots with the next characters of the macro.
+*   Called by the main loop whenever the queue may have drained. One slot is
+*   kept for the final release report.
+*
+*******************************************************************************/
+void MacroProcess(void)
+{
+    uint8 report[KEYBOARD_DATA_SIZE];
+    uint8 modifiers;
+    uint8 key;
+
+    if(macroPos == NULL)
+    {
+        return;
+    }
+    if((keyboardSimulation != ENABLED) || (CyBle_GetState() != CYBLE_STATE_CONNECTED))
+    {
+        MacroStop();
+        return;
+    }
+
+    while(HidsQueueFree() > 1u)
+    {
+        if(*macroPos == '\0')
+        {
+            HidsEncodeKeyboard(report, 0u, NULL, 0u);   /* Release all keys */
+            (void)HidsQueueReport(report);
+            MacroStop();
+            break;
+        }
+
+        key = MacroKeyCode(*macroPos, &modifiers);
+        if(key == 0u)
+        {
+            /* Not typeable */
+            macroPos++;
+        }
+        else if(key == macroLastKey)
+        {
+            /* The host only sees a new key press after a release */
+            HidsEncodeKeyboard(report, 0u, NULL, 0u);
+            (void)HidsQueueReport(report);
+            macroLastKey = 0u;
+        }
+        else
+        {
+            HidsEncodeKeyboard(report, modifiers, &key, 1u);
+            (void)HidsQueueReport(report);
+            macroLastKey = key;
+            macroPos++;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: MacroKeyCode()
+********************************************************************************
+*
+* Summary:
+*   Translates an ASCII character to a Keyboard/Keypad page usage.
+*
+* Parameters:
+*  c - character
+*  modifiers - returns the modifier keys required for the character
+*
+* Return:
+*  Usage code, zero for characters that are not supported.
+*
+*******************************************************************************/
+static uint8 MacroKeyCode(char8 c, uint8 *modifiers)
+{
+    uint8 key = 0u;
+
+    *modifiers = 0u;
+    if((c >= 'a') && (c <= 'z'))
+    {
+        key = KEY_USAGE_A + (uint8)(c - 'a');
+    }
+    else if((c >= 'A') && (c <= 'Z'))
+    {
+        key = KEY_USAGE_A + (uint8)(c - 'A');
+        *modifiers = KEY_MODIFIER_LEFT_SHIFT;
+    }
+    else if((c >= '1') && (c <= '9'))
+    {
+        key = KEY_USAGE_1 + (uint8)(c - '1');
+    }
+    else
+    {
+        switch(c)
+        {
+            case '0':
+                key = KEY_USAGE_0;
+                break;
+            case '\n':
+                key = KEY_USAGE_ENTER;
+                break;
+            case ' ':
+                key = KEY_USAGE_SPACE;
+                break;
+            case '-':
+                key = KEY_USAGE_MINUS;
+                break;
+            case '_':
+                key = KEY_USAGE_MINUS;
+                *modifiers = KEY_MODIFIER_LEFT_SHIFT;
+                break;
+            case '.':
+                key = KEY_USAGE_DOT;
+                break;
+            case '/':
+                key = KEY_USAGE_SLASH;
+                break;
+            default:
+                break;
+        }
+    }
+
+    return (key);
+}
+
+
+/* [] END OF FILE */
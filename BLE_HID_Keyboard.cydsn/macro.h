@@ -0,0 +1,46 @@
+/*******************************************************************************
+* File Name: macro.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the text macro playback.
+*
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Macro texts, stored in flash. Letters, digits, space, newline and 
+*  "-_./" are typed, other characters are skipped. */
+#define MACRO_STATION_ID            (0u)
+#if !defined(MACRO_TEXT_STATION_ID)
+#define MACRO_TEXT_STATION_ID       "CY8CKIT-149\n"
+#endif /* !defined(MACRO_TEXT_STATION_ID) */
+#define MACRO_COUNT                 (1u)
+
+/* Keyboard/Keypad page usages used by the ASCII translation */
+#define KEY_USAGE_A                 (0x04u)
+#define KEY_USAGE_1                 (0x1Eu)
+#define KEY_USAGE_0                 (0x27u)
+#define KEY_USAGE_ENTER             (0x28u)
+#define KEY_USAGE_SPACE             (0x2Cu)
+#define KEY_USAGE_MINUS             (0x2Du)
+#define KEY_USAGE_DOT               (0x37u)
+#define KEY_USAGE_SLASH             (0x38u)
+#define KEY_MODIFIER_LEFT_SHIFT     (0x02u)
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+void MacroStart(uint8 macro);
+void MacroStop(void);
+void MacroProcess(void);
+
+
+/* [] END OF FILE */
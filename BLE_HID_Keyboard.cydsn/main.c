@@ -1,444 +1,1124 @@
-/*******************************************************************************
-* File Name: main.c
-*
-* Version: 1.0
-*
-* Description:
-*  BLE HID keyboard example project that supports both input and output reports
-*  in boot and protocol mode. The example also demonstrates handling suspend 
-*  event from the central device and enters low power mode when suspended.
-*
-* References:
-*  BLUETOOTH SPECIFICATION Version 4.1
-*  HID Usage Tables spec ver 1.12
-*
-* Hardware Dependency:
-*  CY8CKIT-042 BLE
-*
-********************************************************************************
-* Copyright 2016, Cypress Semiconductor Corporation.  All rights reserved.
-* You may use this file only in accordance with the license, terms, conditions,
-* disclaimers, and limitations in the end user license agreement accompanying
-* the software package with which this file was provided.
-*******************************************************************************/
-
-#include "common.h"
-#include "hids.h"
-#include "bas.h"
-#include "scps.h"
-
-/* I2C read buffer size */
-#define I2C_BUF_SIZE		        (4u)
-
-/* I2C slave address */
-#define I2C_SLAVE_ADDRESS           (0x08u)
-
-/* Sets the boundary between the read/write and read only areas.
-*  The read/write area is first, followed by the read only area. */
-#define I2C_RW_SIZE                 (0u)
-
-/* EZI2C address offset */
-#define I2C_ADDRESS_OFFSET          (0u)
-
-#define SLIDER_GESTURE_INDEX        (0u)
-#define BUTTON_COUNT_INDEX          (1u)
-#define BUTTON_STATUS_INDEX1        (2u)
-#define BUTTON_STATUS_INDEX2        (3u)
-#define SLIDER_FLICK_RIGHT          (0x54u)
-#define SLIDER_FLICK_LEFT           (0x5Cu)
-
-/* I2C buffer for storing the data read from I2C slave device */
-uint8 i2cBuffer[] = {0, 0, 0, 0};
-
-void HandleCapSense(void);
-
-/*******************************************************************************
-* Function Name: AppCallBack()
-********************************************************************************
-*
-* Summary:
-*   This is an event callback function to receive events from the BLE Component.
-*
-*******************************************************************************/
-void AppCallBack(uint32 event, void* eventParam)
-{
-    CYBLE_API_RESULT_T apiResult;
-    CYBLE_GAP_BD_ADDR_T localAddr;
-    CYBLE_GAP_AUTH_INFO_T *authInfo;
-    uint8 i;
-    
-    switch (event)
-    {
-        /**********************************************************
-        *                       General Events
-        ***********************************************************/
-        case CYBLE_EVT_STACK_ON: /* This event is received when the component is Started */
-            /* Enter into discoverable mode so that remote can search it. */
-            apiResult = CyBle_GappStartAdvertisement(CYBLE_ADVERTISING_FAST);
-            if(apiResult != CYBLE_ERROR_OK)
-            {
-                DBG_PRINTF("StartAdvertisement API Error: %d \r\n", apiResult);
-            }
-            DBG_PRINTF("Bluetooth On, StartAdvertisement with addr: ");
-            localAddr.type = 0u;
-            CyBle_GetDeviceAddress(&localAddr);
-            for(i = CYBLE_GAP_BD_ADDR_SIZE; i > 0u; i--)
-            {
-                DBG_PRINTF("%2.2x", localAddr.bdAddr[i-1]);
-            }
-            DBG_PRINTF("\r\n");
-            break;
-        case CYBLE_EVT_TIMEOUT: 
-            break;
-        case CYBLE_EVT_HARDWARE_ERROR:    /* This event indicates that some internal HW error has occurred. */
-            DBG_PRINTF("CYBLE_EVT_HARDWARE_ERROR \r\n");
-            break;
-            
-        /* This event will be triggered by host stack if BLE stack is busy or not busy.
-         *  Parameter corresponding to this event will be the state of BLE stack.
-         *  BLE stack busy = CYBLE_STACK_STATE_BUSY,
-         *  BLE stack not busy = CYBLE_STACK_STATE_FREE 
-         */
-        case CYBLE_EVT_STACK_BUSY_STATUS:
-            DBG_PRINTF("CYBLE_EVT_STACK_BUSY_STATUS: %x\r\n", *(uint8 *)eventParam);
-            break;
-        case CYBLE_EVT_HCI_STATUS:
-            DBG_PRINTF("CYBLE_EVT_HCI_STATUS: %x \r\n", *(uint8 *)eventParam);
-            break;
-            
-        /**********************************************************
-        *                       GAP Events
-        ***********************************************************/
-        case CYBLE_EVT_GAP_AUTH_REQ:
-            DBG_PRINTF("CYBLE_EVT_AUTH_REQ: security=%x, bonding=%x, ekeySize=%x, err=%x \r\n", 
-                (*(CYBLE_GAP_AUTH_INFO_T *)eventParam).security, 
-                (*(CYBLE_GAP_AUTH_INFO_T *)eventParam).bonding, 
-                (*(CYBLE_GAP_AUTH_INFO_T *)eventParam).ekeySize, 
-                (*(CYBLE_GAP_AUTH_INFO_T *)eventParam).authErr);
-            break;
-        case CYBLE_EVT_GAP_PASSKEY_ENTRY_REQUEST:
-            DBG_PRINTF("CYBLE_EVT_PASSKEY_ENTRY_REQUEST press 'p' to enter passkey \r\n");
-            break;
-        case CYBLE_EVT_GAP_PASSKEY_DISPLAY_REQUEST:
-            DBG_PRINTF("CYBLE_EVT_PASSKEY_DISPLAY_REQUEST %6.6ld \r\n", *(uint32 *)eventParam);
-            break;
-        case CYBLE_EVT_GAP_KEYINFO_EXCHNGE_CMPLT:
-            DBG_PRINTF("CYBLE_EVT_GAP_KEYINFO_EXCHNGE_CMPLT \r\n");
-            break;
-        case CYBLE_EVT_GAP_AUTH_COMPLETE:
-            authInfo = (CYBLE_GAP_AUTH_INFO_T *)eventParam;
-            (void)authInfo;
-            DBG_PRINTF("AUTH_COMPLETE: security:%x, bonding:%x, ekeySize:%x, authErr %x \r\n", 
-                                    authInfo->security, authInfo->bonding, authInfo->ekeySize, authInfo->authErr);
-            break;
-        case CYBLE_EVT_GAP_AUTH_FAILED:
-            DBG_PRINTF("CYBLE_EVT_AUTH_FAILED: %x \r\n", *(uint8 *)eventParam);
-            break;
-        case CYBLE_EVT_GAPP_ADVERTISEMENT_START_STOP:
-            DBG_PRINTF("CYBLE_EVT_ADVERTISING, state: %x \r\n", CyBle_GetState());
-            if(CYBLE_STATE_DISCONNECTED == CyBle_GetState())
-            {   
-                /* Fast and slow advertising period complete, go to low power  
-                 * mode (Hibernate mode) and wait for an external
-                 * user event to wake up the device again */
-                DBG_PRINTF("Hibernate \r\n");
-                Advertising_LED_Write(LED_OFF);
-                Disconnect_LED_Write(LED_ON);
-                CapsLock_LED_Write(LED_OFF);
-            #if (DEBUG_UART_ENABLED == ENABLED)
-                /* Wait until debug info is sent */
-                while((UART_DEB_SpiUartGetTxBufferSize() + UART_DEB_GET_TX_FIFO_SR_VALID) != 0);
-            #endif /* (DEBUG_UART_ENABLED == ENABLED) */
-                CySysPmHibernate();
-            }
-            break;
-        case CYBLE_EVT_GAP_DEVICE_CONNECTED:
-            DBG_PRINTF("CYBLE_EVT_GAP_DEVICE_CONNECTED \r\n");
-            Advertising_LED_Write(LED_OFF);
-            break;
-        case CYBLE_EVT_GAP_DEVICE_DISCONNECTED:
-            DBG_PRINTF("CYBLE_EVT_GAP_DEVICE_DISCONNECTED\r\n");
-            apiResult = CyBle_GappStartAdvertisement(CYBLE_ADVERTISING_FAST);
-            if(apiResult != CYBLE_ERROR_OK)
-            {
-                DBG_PRINTF("StartAdvertisement API Error: %d \r\n", apiResult);
-            }
-            break;
-        case CYBLE_EVT_GATTS_XCNHG_MTU_REQ:
-            { 
-                uint16 mtu;
-                CyBle_GattGetMtuSize(&mtu);
-                DBG_PRINTF("CYBLE_EVT_GATTS_XCNHG_MTU_REQ, final mtu= %d \r\n", mtu);
-            }
-            break;
-        case CYBLE_EVT_GATTS_WRITE_REQ:
-            DBG_PRINTF("CYBLE_EVT_GATT_WRITE_REQ: %x = ",((CYBLE_GATTS_WRITE_REQ_PARAM_T *)eventParam)->handleValPair.attrHandle);
-            ShowValue(&((CYBLE_GATTS_WRITE_REQ_PARAM_T *)eventParam)->handleValPair.value);
-            (void)CyBle_GattsWriteRsp(((CYBLE_GATTS_WRITE_REQ_PARAM_T *)eventParam)->connHandle);
-            break;
-        case CYBLE_EVT_GAP_ENCRYPT_CHANGE:
-            DBG_PRINTF("CYBLE_EVT_GAP_ENCRYPT_CHANGE: %x \r\n", *(uint8 *)eventParam);
-            break;
-        case CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE:
-            DBG_PRINTF("CYBLE_EVT_CONNECTION_UPDATE_COMPLETE: %x \r\n", *(uint8 *)eventParam);
-            break;
-            
-        /**********************************************************
-        *                       GATT Events
-        ***********************************************************/
-        case CYBLE_EVT_GATT_CONNECT_IND:
-            DBG_PRINTF("CYBLE_EVT_GATT_CONNECT_IND: %x, %x \r\n", cyBle_connHandle.attId, cyBle_connHandle.bdHandle);
-            /* Register service specific callback functions */
-            HidsInit();
-            BasInit();
-            ScpsInit();
-            break;
-        case CYBLE_EVT_GATT_DISCONNECT_IND:
-            DBG_PRINTF("CYBLE_EVT_GATT_DISCONNECT_IND \r\n");
-            break;
-        case CYBLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ:
-            /* Triggered on server side when client sends read request and when
-            * characteristic has CYBLE_GATT_DB_ATTR_CHAR_VAL_RD_EVENT property set.
-            * This event could be ignored by application unless it need to response
-            * by error response which needs to be set in gattErrorCode field of
-            * event parameter. */
-            DBG_PRINTF("CYBLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ: handle: %x \r\n", 
-                ((CYBLE_GATTS_CHAR_VAL_READ_REQ_T *)eventParam)->attrHandle);
-            break;
-            
-        /**********************************************************
-        *                       Other Events
-        ***********************************************************/
-        case CYBLE_EVT_PENDING_FLASH_WRITE:
-            /* Inform application that flash write is pending. Stack internal data 
-            * structures are modified and require to be stored in Flash using 
-            * CyBle_StoreBondingData() */
-            DBG_PRINTF("CYBLE_EVT_PENDING_FLASH_WRITE\r\n");
-            break;
-
-        default:
-            DBG_PRINTF("OTHER event: %lx \r\n", event);
-            break;
-    }
-}
-
-
-/*******************************************************************************
-* Function Name: LowPowerImplementation()
-********************************************************************************
-* Summary:
-* Implements low power in the project.
-*
-* Parameters:
-* None
-*
-* Return:
-* None
-*
-* Theory:
-* The function tries to enter deep sleep as much as possible - whenever the 
-* BLE is idle and the UART transmission/reception is not happening. At all other
-* times, the function tries to enter CPU sleep.
-*
-*******************************************************************************/
-static void LowPowerImplementation(void)
-{
-    CYBLE_LP_MODE_T bleMode;
-    uint8 interruptStatus;
-    
-    /* For advertising and connected states, implement deep sleep 
-     * functionality to achieve low power in the system. For more details
-     * on the low power implementation, refer to the Low Power Application 
-     * Note.
-     */
-    if((CyBle_GetState() == CYBLE_STATE_ADVERTISING) || 
-       (CyBle_GetState() == CYBLE_STATE_CONNECTED))
-    {
-        /* Request BLE subsystem to enter into Deep-Sleep mode between connection and advertising intervals */
-        bleMode = CyBle_EnterLPM(CYBLE_BLESS_DEEPSLEEP);
-        /* Disable global interrupts */
-        interruptStatus = CyEnterCriticalSection();
-        /* When BLE subsystem has been put into Deep-Sleep mode */
-        if(bleMode == CYBLE_BLESS_DEEPSLEEP)
-        {
-            /* And it is still there or ECO is on */
-            if((CyBle_GetBleSsState() == CYBLE_BLESS_STATE_ECO_ON) || 
-               (CyBle_GetBleSsState() == CYBLE_BLESS_STATE_DEEPSLEEP))
-            {
-            #if (DEBUG_UART_ENABLED == ENABLED)
-                /* Put the CPU into the Deep-Sleep mode when all debug information has been sent */
-                if((UART_DEB_SpiUartGetTxBufferSize() + UART_DEB_GET_TX_FIFO_SR_VALID) == 0u)
-                {
-                    CySysPmDeepSleep();
-                }
-                else /* Put the CPU into Sleep mode and let SCB to continue sending debug data */
-                {
-                    CySysPmSleep();
-                }
-            #else
-                CySysPmDeepSleep();
-            #endif /* (DEBUG_UART_ENABLED == ENABLED) */
-            }
-        }
-        else /* When BLE subsystem has been put into Sleep mode or is active */
-        {
-            /* And hardware doesn't finish Tx/Rx opeation - put the CPU into Sleep mode */
-            if(CyBle_GetBleSsState() != CYBLE_BLESS_STATE_EVENT_CLOSE)
-            {
-                CySysPmSleep();
-            }
-        }
-        /* Enable global interrupt */
-        CyExitCriticalSection(interruptStatus);
-    }
-}
-
-
-/*******************************************************************************
-* Function Name: main()
-********************************************************************************
-* Summary:
-*  Main function for the project.
-*
-* Parameters:
-*  None
-*
-* Return:
-*  None
-*
-* Theory:
-*  The function starts BLE and UART components.
-*  This function process all BLE events and also implements the low power 
-*  functionality.
-*
-*******************************************************************************/
-int main()
-{
-    CyGlobalIntEnable;  
-
-#if (DEBUG_UART_ENABLED == ENABLED)
-    UART_DEB_Start();
-#endif /* (DEBUG_UART_ENABLED == ENABLED) */
-    DBG_PRINTF("BLE HID Keyboard Example Project \r\n");
-
-    Disconnect_LED_Write(LED_OFF);
-    Advertising_LED_Write(LED_OFF);
-    CapsLock_LED_Write(LED_OFF);
-
-    /* Start CYBLE component and register generic event handler */
-    CyBle_Start(AppCallBack);
-
-    /* Begin I2C master component operation */
-    I2CHW_Start();
-
-#if (BAS_MEASURE_ENABLE != 0)
-    ADC_Start();
-#endif /* BAS_MEASURE_ENABLE != 0 */
-
-    while(1) 
-    {           
-        /* CyBle_ProcessEvents() allows BLE stack to process pending events */
-        CyBle_ProcessEvents();
-
-        /* To achieve low power in the device */
-        LowPowerImplementation();
-
-        if((CyBle_GetState() == CYBLE_STATE_CONNECTED) && (suspend != CYBLE_HIDS_CP_SUSPEND))
-        {            
-            #if (BAS_SIMULATE_ENABLE != 0)
-                SimulateBattery();
-                CyBle_ProcessEvents();
-            #endif /* BAS_SIMULATE_ENABLE != 0 */    
-            #if (BAS_MEASURE_ENABLE != 0)
-                MeasureBattery();
-                CyBle_ProcessEvents();
-            #endif /* BAS_MEASURE_ENABLE != 0 */
-            if((CyBle_GetBleSsState() == CYBLE_BLESS_STATE_ECO_STABLE) &&
-               (keyboardSimulation == ENABLED))
-            {
-                /*Check for CapSense data change and report to BLE central device*/
-                HandleCapSense();
-            }
-            /* Store bonding data to flash only when all debug information has been sent */
-        #if(CYBLE_BONDING_REQUIREMENT == CYBLE_BONDING_YES)
-        #if (DEBUG_UART_ENABLED == ENABLED)
-            if((cyBle_pendingFlashWrite != 0u) &&
-               ((UART_DEB_SpiUartGetTxBufferSize() + UART_DEB_GET_TX_FIFO_SR_VALID) == 0u))
-            
-        #else
-            if(cyBle_pendingFlashWrite != 0u)
-        #endif /* (DEBUG_UART_ENABLED == ENABLED) */
-            {
-                CYBLE_API_RESULT_T apiResult;
-
-                apiResult = CyBle_StoreBondingData(0u);
-                (void)apiResult;
-                DBG_PRINTF("Store bonding data, status: %x \r\n", apiResult);
-            }
-        #endif /* CYBLE_BONDING_REQUIREMENT == CYBLE_BONDING_YES */    
-        }
-    }   
-}  
-
-/*******************************************************************************
-* Function Name: HandleCapSense
-********************************************************************************
-* Summary:
-*       Read the Slider and Buttons data from the sensor and update the BLE
-*		custom notification value.
-*
-* Parameters:
-*  void
-*
-* Return:
-*  void
-*
-*******************************************************************************/
-void HandleCapSense(void)
-{
-    static uint8 sliderGesture = 0;
-    static uint8 buttonValue = 0; 
-    static uint8 prevButtonStat = 0;
-
-    /* Read entire data buffer from the slave device */
-    I2CHW_I2CMasterReadBuf(I2C_SLAVE_ADDRESS, i2cBuffer, I2C_BUF_SIZE, 
-                    I2CHW_I2C_MODE_COMPLETE_XFER);    
-    while (0u == (I2CHW_I2CMasterStatus() & I2CHW_I2C_MSTAT_RD_CMPLT))
-    {
-        CyBle_ProcessEvents();
-    }
-
-    sliderGesture = i2cBuffer[SLIDER_GESTURE_INDEX];
-    DBG_PRINTF("Slider moved: %u \r\n", sliderGesture);
-
-    if(sliderGesture == SLIDER_FLICK_LEFT)
-    {
-        SendPageCtrl(1u); // page up
-    }
-    else if(sliderGesture == SLIDER_FLICK_RIGHT)
-    {
-        SendPageCtrl(0u); // page down
-    }
-
-    buttonValue = i2cBuffer[BUTTON_STATUS_INDEX1];
-    if(prevButtonStat != buttonValue)
-    {
-        DBG_PRINTF("Button moved: %u -> %u\r\n", prevButtonStat, buttonValue);
-        prevButtonStat = buttonValue;
-
-        if(buttonValue & 0x01)  // btn0
-        {
-            SendLightCtrl(1u);  // light brighter
-        }
-        if(buttonValue & 0x02)  // btn1
-        {
-            SendLightCtrl(0u);  // light lower
-        }
-        if(buttonValue & 0x04)  // btn2
-        {
-            SendSoundCtrl(1u);  // sound higher
-        }
-    }
-}
-
-/* [] END OF FILE */
+/*******************************************************************************
+* File Name: main.c
+*
+* Version: 1.0
+*
+* Description:
+*  BLE HID keyboard example project that supports both input and output reports
+*  in boot and protocol mode. The example also demonstrates handling suspend 
+*  event from the central device and enters low power mode when suspended.
+*
+* References:
+*  BLUETOOTH SPECIFICATION Version 4.1
+*  HID Usage Tables spec ver 1.12
+*
+* Hardware Dependency:
+*  CY8CKIT-042 BLE
+*
+********************************************************************************
+* Copyright 2016, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "common.h"
+#include "hids.h"
+#include "bas.h"
+#include "scps.h"
+#include "connparam.h"
+#include "stats.h"
+#include "macro.h"
+#include "host.h"
+#include "link.h"
+#include "recovery.h"
+#include "boot.h"
+#include "led.h"
+#include "profile.h"
+#include "power.h"
+#include "keys.h"
+
+/* I2C read buffer size */
+#define I2C_BUF_SIZE		        (9u)
+
+/* I2C slave address */
+#define I2C_SLAVE_ADDRESS           (0x08u)
+
+/* Sets the boundary between the read/write and read only areas.
+*  The read/write area is first, followed by the read only area. */
+#define I2C_RW_SIZE                 (1u)
+
+/* EZI2C address offset */
+#define I2C_ADDRESS_OFFSET          (0u)
+
+/* The configuration byte is the read/write area. The slave publishes the
+*  mailbox generation to both ends of the read only area. Equal copies mean
+*  the read did not overlap a publication. */
+#define CONFIG_INDEX                (0u)
+#define MAILBOX_GEN_HEAD_INDEX      (1u)
+#define SLIDER_GESTURE_INDEX        (2u)
+#define BUTTON_COUNT_INDEX          (3u)
+#define BUTTON_STATUS_INDEX1        (4u)
+#define STATUS_FLAGS_INDEX          (5u)
+#define SLIDER_PARAM_INDEX          (6u)
+#define SLIDER_SEQUENCE_INDEX       (7u)
+#define MAILBOX_GEN_TAIL_INDEX      (I2C_BUF_SIZE - 1u)
+#define MAILBOX_READ_RETRIES        (3u)
+#define STATUS_FLAG_APPROACH        (0x01u)
+
+/* Slider gesture codes reported by the CapSense gesture engine */
+#define SLIDER_TAP                  (0x10u)
+#define SLIDER_DOUBLE_TAP           (0x11u)
+#define SLIDER_LONG_PRESS           (0x12u)
+#define SLIDER_FLICK_RIGHT          (0x54u)
+#define SLIDER_FLICK_LEFT           (0x5Cu)
+
+/* I2C buffer for storing the data read from I2C slave device */
+uint8 i2cBuffer[I2C_BUF_SIZE] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+/* Configuration for the CapSense MCU and whether it still has to be written */
+uint8 capSenseConfig = CAPSENSE_FILTER_PROFILE | (POWER_NORMAL_SCAN_TIER << CAPSENSE_SCAN_TIER_SHIFT) |
+                       CAPSENSE_CONFIG_WRITTEN;
+uint8 capSenseConfigPending = ENABLED;
+
+/* I2C master transfer in progress */
+#define I2C_XFER_IDLE               (0u)
+#define I2C_XFER_CONFIG             (1u)
+#define I2C_XFER_MAILBOX            (2u)
+
+static uint8 i2cTransfer = I2C_XFER_IDLE;
+static uint8 i2cReadRetries;
+static uint8 i2cErrorsInRow;
+static uint32 i2cStartedAt;
+static uint8 i2cWriteBuf[2u];
+
+/* Work requested by interrupts and callbacks, serviced by the main loop */
+volatile uint32 pendingWork = 0u;
+
+/* WDT_TIMEOUT periods since the timer was started */
+volatile uint32 timerTicks = 0u;
+
+/* Timer tick of the pairing request, for the pairing duration */
+static uint32 pairingStart;
+
+/* The CapSense MCU has been polled in the current connection event */
+static uint8 connEventPolled = DISABLED;
+
+void PollCapSense(void);
+void HandleI2CComplete(void);
+void HandleI2CError(void);
+void HandleCapSense(void);
+void TimerStart(void);
+void TimerStop(void);
+void TimerUpdate(void);
+
+/* The timer and the liveness watchdog are running */
+static uint8 timerRunning = DISABLED;
+
+/*******************************************************************************
+* Function Name: AppCallBack()
+********************************************************************************
+*
+* Summary:
+*   This is an event callback function to receive events from the BLE Component.
+*
+*******************************************************************************/
+void AppCallBack(uint32 event, void* eventParam)
+{
+    CYBLE_API_RESULT_T apiResult;
+    CYBLE_GAP_BD_ADDR_T localAddr;
+    CYBLE_GAP_AUTH_INFO_T *authInfo;
+    uint8 i;
+    
+    switch (event)
+    {
+        /**********************************************************
+        *                       General Events
+        ***********************************************************/
+        case CYBLE_EVT_STACK_ON: /* This event is received when the component is Started */
+            BootMark(BOOT_PHASE_STACK_ON);
+            /* Register service specific callback functions */
+            HidsInit();
+            BasInit();
+            ScpsInit();
+            LinkStart();
+        #if (KEYS_ENABLE != 0)
+            KeysStart();
+        #endif /* (KEYS_ENABLE != 0) */
+            /* Enter into discoverable mode so that remote can search it. */
+            apiResult = CyBle_GappStartAdvertisement(CYBLE_ADVERTISING_FAST);
+            if(apiResult != CYBLE_ERROR_OK)
+            {
+                DBG_PRINTF("StartAdvertisement API Error: %d \r\n", apiResult);
+            }
+            DBG_PRINTF("Bluetooth On, StartAdvertisement with addr: ");
+            localAddr.type = 0u;
+            CyBle_GetDeviceAddress(&localAddr);
+            for(i = CYBLE_GAP_BD_ADDR_SIZE; i > 0u; i--)
+            {
+                DBG_PRINTF("%2.2x", localAddr.bdAddr[i-1]);
+            }
+            DBG_PRINTF("\r\n");
+            break;
+        case CYBLE_EVT_TIMEOUT: 
+            break;
+        case CYBLE_EVT_HARDWARE_ERROR:    /* This event indicates that some internal HW error has occurred. */
+            DBG_PRINTF("CYBLE_EVT_HARDWARE_ERROR \r\n");
+            /* The stack cannot be restarted from its own callback */
+            SetPendingWork(WORK_STACK);
+            break;
+            
+        /* This event will be triggered by host stack if BLE stack is busy or not busy.
+         *  Parameter corresponding to this event will be the state of BLE stack.
+         *  BLE stack busy = CYBLE_STACK_STATE_BUSY,
+         *  BLE stack not busy = CYBLE_STACK_STATE_FREE 
+         */
+        case CYBLE_EVT_STACK_BUSY_STATUS:
+            DBG_PRINTF("CYBLE_EVT_STACK_BUSY_STATUS: %x\r\n", *(uint8 *)eventParam);
+            if(*(uint8 *)eventParam == CYBLE_STACK_STATE_FREE)
+            {
+                /* Continue sending reports held back while the stack was busy */
+                SetPendingWork(WORK_HID);
+            }
+            break;
+        case CYBLE_EVT_HCI_STATUS:
+            DBG_PRINTF("CYBLE_EVT_HCI_STATUS: %x \r\n", *(uint8 *)eventParam);
+            break;
+            
+        /**********************************************************
+        *                       GAP Events
+        ***********************************************************/
+        case CYBLE_EVT_GAP_AUTH_REQ:
+            DBG_PRINTF("CYBLE_EVT_AUTH_REQ: security=%x, bonding=%x, ekeySize=%x, err=%x \r\n", 
+                (*(CYBLE_GAP_AUTH_INFO_T *)eventParam).security, 
+                (*(CYBLE_GAP_AUTH_INFO_T *)eventParam).bonding, 
+                (*(CYBLE_GAP_AUTH_INFO_T *)eventParam).ekeySize, 
+                (*(CYBLE_GAP_AUTH_INFO_T *)eventParam).authErr);
+            pairingStart = timerTicks;
+        #if (KEYS_ENABLE != 0)
+            KeysPairingStart();
+        #endif /* (KEYS_ENABLE != 0) */
+            break;
+        case CYBLE_EVT_GAP_PASSKEY_ENTRY_REQUEST:
+            DBG_PRINTF("CYBLE_EVT_PASSKEY_ENTRY_REQUEST press 'p' to enter passkey \r\n");
+            break;
+        case CYBLE_EVT_GAP_PASSKEY_DISPLAY_REQUEST:
+            DBG_PRINTF("CYBLE_EVT_PASSKEY_DISPLAY_REQUEST %6.6ld \r\n", *(uint32 *)eventParam);
+            break;
+        case CYBLE_EVT_GAP_KEYINFO_EXCHNGE_CMPLT:
+            DBG_PRINTF("CYBLE_EVT_GAP_KEYINFO_EXCHNGE_CMPLT \r\n");
+            break;
+        case CYBLE_EVT_GAP_AUTH_COMPLETE:
+            authInfo = (CYBLE_GAP_AUTH_INFO_T *)eventParam;
+            (void)authInfo;
+            DBG_PRINTF("AUTH_COMPLETE: security:%x, bonding:%x, ekeySize:%x, authErr %x \r\n", 
+                                    authInfo->security, authInfo->bonding, authInfo->ekeySize, authInfo->authErr);
+            DBG_PRINTF("Pairing time: %lu ticks \r\n", timerTicks - pairingStart);
+        #if (STATS_ENABLE != 0)
+            stats.pairingTime = timerTicks - pairingStart;
+        #endif /* (STATS_ENABLE != 0) */
+        #if (KEYS_ENABLE != 0)
+            KeysPairingEnd();
+        #endif /* (KEYS_ENABLE != 0) */
+            break;
+        case CYBLE_EVT_GAP_AUTH_FAILED:
+            DBG_PRINTF("CYBLE_EVT_AUTH_FAILED: %x, after %lu ticks \r\n", *(uint8 *)eventParam, 
+                       timerTicks - pairingStart);
+        #if (KEYS_ENABLE != 0)
+            KeysPairingEnd();
+        #endif /* (KEYS_ENABLE != 0) */
+            break;
+    #if (KEYS_ENABLE != 0)
+        case CYBLE_EVT_GAP_GEN_SET_LOCAL_P256_KEYS_COMPLETE:
+            KeysGenerated((CYBLE_GAP_SMP_LOCAL_P256_KEYS *)eventParam);
+            break;
+    #endif /* (KEYS_ENABLE != 0) */
+        case CYBLE_EVT_GAPP_ADVERTISEMENT_START_STOP:
+            DBG_PRINTF("CYBLE_EVT_ADVERTISING, state: %x \r\n", CyBle_GetState());
+            if(CYBLE_STATE_ADVERTISING == CyBle_GetState())
+            {
+                BootMark(BOOT_PHASE_ADVERTISING);
+                HostAdvertisementStarted();
+            }
+            else if((CYBLE_STATE_DISCONNECTED == CyBle_GetState()) && (HostAdvertisementStopped() == DISABLED))
+            {   
+                /* Fast and slow advertising period complete, go to low power  
+                 * mode (Hibernate mode) and wait for an external
+                 * user event to wake up the device again */
+                DBG_PRINTF("Hibernate \r\n");
+                /* No LED stays lit through Hibernate */
+                Advertising_LED_Write(LED_OFF);
+                Disconnect_LED_Write(LED_OFF);
+                LedAllOff();
+            #if (DEBUG_UART_ENABLED == ENABLED)
+                /* Wait until debug info is sent */
+                while((UART_DEB_SpiUartGetTxBufferSize() + UART_DEB_GET_TX_FIFO_SR_VALID) != 0);
+            #endif /* (DEBUG_UART_ENABLED == ENABLED) */
+                TimerStop();
+                CySysPmHibernate();
+            }
+            break;
+        case CYBLE_EVT_GAP_DEVICE_CONNECTED:
+            DBG_PRINTF("CYBLE_EVT_GAP_DEVICE_CONNECTED \r\n");
+            BootMark(BOOT_PHASE_CONNECTED);
+            BootStartPeripherals();
+            Advertising_LED_Write(LED_OFF);
+            capSenseConfigPending = ENABLED;
+            TimerStart();
+            HostConnected();
+            LinkInit();
+            RecoveryConnected();
+        #if (STATS_ENABLE != 0)
+            StatsReset();
+        #endif /* (STATS_ENABLE != 0) */
+            break;
+        case CYBLE_EVT_GAP_DEVICE_DISCONNECTED:
+            DBG_PRINTF("CYBLE_EVT_GAP_DEVICE_DISCONNECTED\r\n");
+            ConnParamEventHandler(event, eventParam);
+            LedAllOff();
+            apiResult = HostStartAdvertisement();
+            if(apiResult != CYBLE_ERROR_OK)
+            {
+                DBG_PRINTF("StartAdvertisement API Error: %d \r\n", apiResult);
+            }
+            break;
+        case CYBLE_EVT_GATTS_XCNHG_MTU_REQ:
+            STATS_INC(attRequests);
+            { 
+                uint16 mtu;
+                CyBle_GattGetMtuSize(&mtu);
+                DBG_PRINTF("CYBLE_EVT_GATTS_XCNHG_MTU_REQ, final mtu= %d \r\n", mtu);
+            }
+            break;
+        case CYBLE_EVT_GATTS_WRITE_REQ:
+            STATS_INC(attRequests);
+            DBG_PRINTF("CYBLE_EVT_GATT_WRITE_REQ: %x = ",((CYBLE_GATTS_WRITE_REQ_PARAM_T *)eventParam)->handleValPair.attrHandle);
+            ShowValue(&((CYBLE_GATTS_WRITE_REQ_PARAM_T *)eventParam)->handleValPair.value);
+            (void)CyBle_GattsWriteRsp(((CYBLE_GATTS_WRITE_REQ_PARAM_T *)eventParam)->connHandle);
+            break;
+        case CYBLE_EVT_GAP_ENCRYPT_CHANGE:
+            DBG_PRINTF("CYBLE_EVT_GAP_ENCRYPT_CHANGE: %x \r\n", *(uint8 *)eventParam);
+            break;
+        case CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE:
+            DBG_PRINTF("CYBLE_EVT_CONNECTION_UPDATE_COMPLETE: %x \r\n", *(uint8 *)eventParam);
+            ConnParamEventHandler(event, eventParam);
+            break;
+        case CYBLE_EVT_L2CAP_CONN_PARAM_UPDATE_RSP:
+            DBG_PRINTF("CYBLE_EVT_L2CAP_CONN_PARAM_UPDATE_RSP: %x \r\n", *(uint16 *)eventParam);
+            ConnParamEventHandler(event, eventParam);
+            break;
+            
+        /**********************************************************
+        *                       GATT Events
+        ***********************************************************/
+        case CYBLE_EVT_GATT_CONNECT_IND:
+            DBG_PRINTF("CYBLE_EVT_GATT_CONNECT_IND: %x, %x \r\n", cyBle_connHandle.attId, cyBle_connHandle.bdHandle);
+            /* Pick up the notification state of the connected host */
+            HidsRestore();
+            BasRestore();
+            ScpsRestore();
+            break;
+        case CYBLE_EVT_GATT_DISCONNECT_IND:
+            DBG_PRINTF("CYBLE_EVT_GATT_DISCONNECT_IND \r\n");
+            break;
+        case CYBLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ:
+            STATS_INC(attRequests);
+            /* Triggered on server side when client sends read request and when
+            * characteristic has CYBLE_GATT_DB_ATTR_CHAR_VAL_RD_EVENT property set.
+            * This event could be ignored by application unless it need to response
+            * by error response which needs to be set in gattErrorCode field of
+            * event parameter. */
+            DBG_PRINTF("CYBLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ: handle: %x \r\n", 
+                ((CYBLE_GATTS_CHAR_VAL_READ_REQ_T *)eventParam)->attrHandle);
+            break;
+            
+        /**********************************************************
+        *                       Other Events
+        ***********************************************************/
+        case CYBLE_EVT_PENDING_FLASH_WRITE:
+            /* Inform application that flash write is pending. Stack internal data 
+            * structures are modified and require to be stored in Flash using 
+            * CyBle_StoreBondingData() */
+            DBG_PRINTF("CYBLE_EVT_PENDING_FLASH_WRITE\r\n");
+            SetPendingWork(WORK_FLASH);
+            break;
+
+        default:
+            DBG_PRINTF("OTHER event: %lx \r\n", event);
+            break;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: CpuSleep()
+********************************************************************************
+* Summary:
+* Puts the CPU into Sleep mode. Called with interrupts disabled.
+*
+*******************************************************************************/
+static void CpuSleep(void)
+{
+    STATS_INC(sleepEntries);
+    CySysPmSleep();
+}
+
+/*******************************************************************************
+* Function Name: CpuDeepSleep()
+********************************************************************************
+* Summary:
+* Puts the CPU into Deep-Sleep mode and accounts the time spent there. 
+* Called with interrupts disabled.
+*
+*******************************************************************************/
+static void CpuDeepSleep(void)
+{
+#if (STATS_ENABLE != 0)
+    uint32 sleepStart = StatsTimeNow();
+
+    stats.deepSleepEntries++;
+    CySysPmDeepSleep();
+    stats.deepSleepTime += StatsTimeNow() - sleepStart;
+#else
+    CySysPmDeepSleep();
+#endif /* (STATS_ENABLE != 0) */
+}
+
+/*******************************************************************************
+* Function Name: LowPowerImplementation()
+********************************************************************************
+* Summary:
+* Implements low power in the project.
+*
+* Parameters:
+* None
+*
+* Return:
+* None
+*
+* Theory:
+* The function tries to enter deep sleep as much as possible - whenever the 
+* BLE is idle and the UART transmission/reception and I2C transfer are not 
+* happening. At all other times, the function tries to enter CPU sleep. It
+* returns without sleeping when work is pending.
+*
+*******************************************************************************/
+static void LowPowerImplementation(void)
+{
+    CYBLE_LP_MODE_T bleMode;
+    uint8 interruptStatus;
+    
+    /* For advertising and connected states, implement deep sleep 
+     * functionality to achieve low power in the system. For more details
+     * on the low power implementation, refer to the Low Power Application 
+     * Note.
+     */
+    if((CyBle_GetState() == CYBLE_STATE_ADVERTISING) || 
+       (CyBle_GetState() == CYBLE_STATE_CONNECTED))
+    {
+        /* Request BLE subsystem to enter into Deep-Sleep mode between connection and advertising intervals */
+        bleMode = CyBle_EnterLPM(CYBLE_BLESS_DEEPSLEEP);
+        /* Disable global interrupts */
+        interruptStatus = CyEnterCriticalSection();
+        /* Work raised by an interrupt since the main loop checked is served first */
+        if(pendingWork != 0u)
+        {
+            /* Do not sleep */
+        }
+        /* When BLE subsystem has been put into Deep-Sleep mode */
+        else if(bleMode == CYBLE_BLESS_DEEPSLEEP)
+        {
+            /* The I2C master does not run in Deep-Sleep, wait for the transfer in Sleep */
+            if(0u != (I2CHW_I2CMasterStatus() & I2CHW_I2C_MSTAT_XFER_INP))
+            {
+                CpuSleep();
+            }
+            /* And it is still there or ECO is on */
+            else if((CyBle_GetBleSsState() == CYBLE_BLESS_STATE_ECO_ON) || 
+                    (CyBle_GetBleSsState() == CYBLE_BLESS_STATE_DEEPSLEEP))
+            {
+            #if (DEBUG_UART_ENABLED == ENABLED)
+                /* Put the CPU into the Deep-Sleep mode when all debug information has been sent */
+                if((UART_DEB_SpiUartGetTxBufferSize() + UART_DEB_GET_TX_FIFO_SR_VALID) == 0u)
+                {
+                    CpuDeepSleep();
+                }
+                else /* Put the CPU into Sleep mode and let SCB to continue sending debug data */
+                {
+                    CpuSleep();
+                }
+            #else
+                CpuDeepSleep();
+            #endif /* (DEBUG_UART_ENABLED == ENABLED) */
+            }
+        }
+        else /* When BLE subsystem has been put into Sleep mode or is active */
+        {
+            /* And hardware doesn't finish Tx/Rx opeation - put the CPU into Sleep mode */
+            if(CyBle_GetBleSsState() != CYBLE_BLESS_STATE_EVENT_CLOSE)
+            {
+                CpuSleep();
+            }
+        }
+        /* Enable global interrupt */
+        CyExitCriticalSection(interruptStatus);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: main()
+********************************************************************************
+* Summary:
+*  Main function for the project.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+* Theory:
+*  The function starts BLE and UART components.
+*  This function process all BLE events and also implements the low power 
+*  functionality. Interrupts and callbacks set WORK_xxx bits, the loop 
+*  services only the bits that are set and sleeps once none is left.
+*
+*******************************************************************************/
+int main()
+{
+    BootInit();
+    CyGlobalIntEnable;  
+
+#if (DEBUG_UART_ENABLED == ENABLED)
+    UART_DEB_Start();
+    BootMark(BOOT_PHASE_DEBUG);
+#endif /* (DEBUG_UART_ENABLED == ENABLED) */
+    DBG_PRINTF("BLE HID Keyboard Example Project \r\n");
+    BootShowPrevious();
+    RecoveryInit();
+    /* The liveness watchdog covers the startup as well */
+    TimerStart();
+#if (PROFILE_ENABLE != 0)
+    ProfileInit();
+#endif /* (PROFILE_ENABLE != 0) */
+
+    Disconnect_LED_Write(LED_OFF);
+    Advertising_LED_Write(LED_OFF);
+    CapsLock_LED_Write(LED_OFF);
+
+    /* Start CYBLE component and register generic event handler */
+    CyBle_Start(AppCallBack);
+    BootMark(BOOT_PHASE_STACK_START);
+
+#if (BOOT_FAST_START == 0)
+    /* Begin I2C master and ADC operation, with fast start on the first connection */
+    BootStartPeripherals();
+#endif /* (BOOT_FAST_START == 0) */
+
+    while(1) 
+    {           
+        uint32 work;
+
+        /* CyBle_ProcessEvents() allows BLE stack to process pending events */
+        CyBle_ProcessEvents();
+
+        work = TakePendingWork();
+
+        /* Poll the CapSense MCU once per connection event, the CPU is awake 
+        *  for it anyway. The timer tick polls between sparse events. */
+        if(CyBle_GetBleSsState() == CYBLE_BLESS_STATE_ECO_STABLE)
+        {
+            if(connEventPolled == DISABLED)
+            {
+                connEventPolled = ENABLED;
+                work |= WORK_CAPSENSE;
+            }
+        }
+        else if((CyBle_GetBleSsState() == CYBLE_BLESS_STATE_ECO_ON) ||
+                (CyBle_GetBleSsState() == CYBLE_BLESS_STATE_DEEPSLEEP))
+        {
+            connEventPolled = DISABLED;
+        }
+        else
+        {
+            /* The event is in progress */
+        }
+
+        if(work != 0u)
+        {
+            STATS_INC(loopPasses);
+        }
+        RecoveryWatchdogFeed();
+
+        if((work & WORK_STACK) != 0u)
+        {
+            RecoveryStackRestart();
+        }
+
+        if((work & WORK_I2C) != 0u)
+        {
+            /* Check the transfer result and report CapSense changes */
+            HandleI2CComplete();
+        }
+        if((work & WORK_CAPSENSE) != 0u)
+        {
+            /* Start the next mailbox read or configuration write */
+            PollCapSense();
+        }
+        if((work & WORK_HID) != 0u)
+        {
+            /* Refill the queue from a playing macro, then send queued HID 
+            *  reports while the stack accepts them */
+            PROFILE_BEGIN(PROFILE_PROCESS_QUEUE);
+            MacroProcess();
+            HidsProcessQueue();
+            PROFILE_END(PROFILE_PROCESS_QUEUE);
+        }
+        if(((work & WORK_BATTERY) != 0u) && 
+           (CyBle_GetState() == CYBLE_STATE_CONNECTED) && (suspend != CYBLE_HIDS_CP_SUSPEND))
+        {
+        #if (BAS_SIMULATE_ENABLE != 0)
+            SimulateBattery();
+        #endif /* BAS_SIMULATE_ENABLE != 0 */    
+        #if (BAS_MEASURE_ENABLE != 0)
+            MeasureBattery();
+        #endif /* BAS_MEASURE_ENABLE != 0 */
+        #if (STATS_ENABLE != 0)
+            StatsShow();
+        #endif /* (STATS_ENABLE != 0) */
+        #if (PROFILE_ENABLE != 0)
+            ProfileShow();
+        #endif /* (PROFILE_ENABLE != 0) */
+        }
+        if(((work & WORK_LINK) != 0u) && (CyBle_GetState() == CYBLE_STATE_CONNECTED))
+        {
+            /* Adapt the TX power to the link quality */
+            LinkProcess();
+        }
+    #if (KEYS_ENABLE != 0)
+        if((work & WORK_KEYS) != 0u)
+        {
+            /* Generate the next key pair while no hand is near and no report waits */
+            KeysProcess((uint8)(((i2cBuffer[STATUS_FLAGS_INDEX] & STATUS_FLAG_APPROACH) == 0u) &&
+                                (HidsQueueFree() == HID_QUEUE_SIZE)));
+        }
+    #endif /* (KEYS_ENABLE != 0) */
+    #if(CYBLE_BONDING_REQUIREMENT == CYBLE_BONDING_YES)
+        if((work & WORK_FLASH) != 0u)
+        {
+            /* Store bonding data to flash only when all debug information has been sent */
+        #if (DEBUG_UART_ENABLED == ENABLED)
+            if((UART_DEB_SpiUartGetTxBufferSize() + UART_DEB_GET_TX_FIFO_SR_VALID) != 0u)
+            {
+                SetPendingWork(WORK_FLASH);
+            }
+            else
+        #endif /* (DEBUG_UART_ENABLED == ENABLED) */
+            if(cyBle_pendingFlashWrite != 0u)
+            {
+                CYBLE_API_RESULT_T apiResult;
+
+                apiResult = CyBle_StoreBondingData(0u);
+                (void)apiResult;
+                DBG_PRINTF("Store bonding data, status: %x \r\n", apiResult);
+                if(cyBle_pendingFlashWrite != 0u)
+                {
+                    /* Row-by-row write is not finished yet */
+                    SetPendingWork(WORK_FLASH);
+                }
+            }
+        }
+    #endif /* CYBLE_BONDING_REQUIREMENT == CYBLE_BONDING_YES */    
+
+        TimerUpdate();
+
+        /* Sleep as soon as there is nothing left to do */
+        if(pendingWork == 0u)
+        {
+            PROFILE_BEGIN(PROFILE_LOW_POWER);
+            LowPowerImplementation();
+            PROFILE_END(PROFILE_LOW_POWER);
+        }
+    }   
+}  
+
+/*******************************************************************************
+* Function Name: SetPendingWork
+********************************************************************************
+* Summary:
+*       Marks work for the main loop. Safe to call from interrupts.
+*
+* Parameters:
+*  work - WORK_xxx bits to set
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void SetPendingWork(uint32 work)
+{
+    uint8 interruptStatus;
+
+    interruptStatus = CyEnterCriticalSection();
+    pendingWork |= work;
+    CyExitCriticalSection(interruptStatus);
+}
+
+/*******************************************************************************
+* Function Name: TakePendingWork
+********************************************************************************
+* Summary:
+*       Returns and clears all pending work bits in one step.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  WORK_xxx bits that were pending
+*
+*******************************************************************************/
+uint32 TakePendingWork(void)
+{
+    uint8 interruptStatus;
+    uint32 work;
+
+    interruptStatus = CyEnterCriticalSection();
+    work = pendingWork;
+    pendingWork = 0u;
+    CyExitCriticalSection(interruptStatus);
+
+    return (work);
+}
+
+/*******************************************************************************
+* Function Name: Timer_Interrupt
+********************************************************************************
+* Summary:
+*       WDT counter interrupt, raised every WDT_TIMEOUT (100 ms) while the
+*		timer runs. Schedules a CapSense poll on every tick, the battery 
+*		update every BATTERY_TIMEOUT and the RSSI sample every LINK_TIMEOUT 
+*		ticks, and retries queued HID reports. Steps the LED patterns.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void Timer_Interrupt(void)
+{
+    static uint32 batteryTimer = BATTERY_TIMEOUT;
+    static uint32 linkTimer = LINK_TIMEOUT;
+    uint32 work = WORK_CAPSENSE;
+
+    timerTicks++;
+    LedTick();
+    if(--batteryTimer == 0u)
+    {
+        batteryTimer = BATTERY_TIMEOUT;
+        work |= WORK_BATTERY;
+    }
+    if(--linkTimer == 0u)
+    {
+        linkTimer = LINK_TIMEOUT;
+        work |= WORK_LINK;
+    }
+    if(HidsQueueFree() != HID_QUEUE_SIZE)
+    {
+        /* Retry reports the stack had no buffer for */
+        work |= WORK_HID;
+    }
+#if (KEYS_ENABLE != 0)
+    work |= WORK_KEYS;
+#endif /* (KEYS_ENABLE != 0) */
+    SetPendingWork(work);
+}
+
+/*******************************************************************************
+* Function Name: TimerStart
+********************************************************************************
+* Summary:
+*       Starts the WDT counter that paces the main loop work, and the
+*		liveness watchdog fed by that main loop. Does nothing when the timer
+*		already runs.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void TimerStart(void)
+{
+    if(timerRunning == ENABLED)
+    {
+        return;
+    }
+    timerRunning = ENABLED;
+    /* Unlock the WDT registers for modification */
+    CySysWdtUnlock(); 
+    /* Write the mode to generate interrupt on match */
+    CySysWdtWriteMode(WDT_COUNTER, CY_SYS_WDT_MODE_INT);
+    /* Configure the WDT counter clear on a match setting */
+    CySysWdtWriteClearOnMatch(WDT_COUNTER, WDT_COUNTER_ENABLE);
+    /* Configure the WDT counter match comparison value */
+    CySysWdtWriteMatch(WDT_COUNTER, WDT_TIMEOUT);
+    /* Setup ISR callback */
+    CySysWdtSetInterruptCallback(WDT_COUNTER, Timer_Interrupt);
+    CySysWdtEnableCounterIsr(WDT_COUNTER);
+    /* Reset WDT counter */
+    CySysWdtResetCounters(WDT_COUNTER);
+    /* Enable the specified WDT counter */
+    CySysWdtEnable(WDT_COUNTER_MASK);
+    /* Lock out configuration changes to the Watchdog timer registers */
+    CySysWdtLock();    
+    RecoveryWatchdogStart();
+}
+
+/*******************************************************************************
+* Function Name: TimerStop
+********************************************************************************
+* Summary:
+*       Stops the WDT counter and the liveness watchdog before windows
+*		without ticks: slow advertising and Hibernate. Does nothing when the
+*		timer is already stopped.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void TimerStop(void)
+{
+    if(timerRunning == DISABLED)
+    {
+        return;
+    }
+    timerRunning = DISABLED;
+    CySysWdtUnlock(); 
+    CySysWdtDisable(WDT_COUNTER_MASK);
+    CySysWdtLock();    
+    RecoveryWatchdogStop();
+}
+
+/*******************************************************************************
+* Function Name: TimerUpdate
+********************************************************************************
+* Summary:
+*       Keeps the timer, and with it the liveness watchdog, running in every
+*		active state: startup, advertising, connected. Only slow advertising 
+*		stops it, since its interval may be longer than RECOVERY_WDT_TIMEOUT
+*		and 100 ms ticks would cost more than the advertising itself. An
+*		active LED indication keeps it running there as well.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void TimerUpdate(void)
+{
+    if((HostSlowAdvertising() == ENABLED) && (LedActive() == DISABLED))
+    {
+        TimerStop();
+    }
+    else
+    {
+        TimerStart();
+    }
+}
+
+/*******************************************************************************
+* Function Name: I2CHW_I2C_ISR_ExitCallback
+********************************************************************************
+* Summary:
+*       Called at the end of the I2C master interrupt. Hands a finished 
+*		transfer over to the main loop.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void I2CHW_I2C_ISR_ExitCallback(void)
+{
+    if((i2cTransfer != I2C_XFER_IDLE) &&
+       (0u != (I2CHW_I2CMasterStatus() & (I2CHW_I2C_MSTAT_RD_CMPLT | I2CHW_I2C_MSTAT_WR_CMPLT))))
+    {
+        SetPendingWork(WORK_I2C);
+    }
+}
+
+/*******************************************************************************
+* Function Name: PollCapSense
+********************************************************************************
+* Summary:
+*       Starts the next transfer with the CapSense MCU: the configuration 
+*		write when it is pending, otherwise a read of the mailbox. A 
+*		transfer that has not completed within RECOVERY_I2C_TIMEOUT is 
+*		abandoned and the bus is cleared.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void PollCapSense(void)
+{
+    if((i2cTransfer != I2C_XFER_IDLE) && ((timerTicks - i2cStartedAt) >= RECOVERY_I2C_TIMEOUT))
+    {
+        /* The completion never came, the slave may hold the bus */
+        recovery.i2cTimeouts++;
+        DBG_PRINTF("I2C transfer %u timeout, status: %lx \r\n", i2cTransfer, I2CHW_I2CMasterStatus());
+        i2cTransfer = I2C_XFER_IDLE;
+        RecoveryI2CBusClear();
+    }
+    if((i2cTransfer != I2C_XFER_IDLE) ||
+       (CyBle_GetState() != CYBLE_STATE_CONNECTED) || (suspend == CYBLE_HIDS_CP_SUSPEND))
+    {
+        return;
+    }
+
+    I2CHW_I2CMasterClearStatus();
+    i2cStartedAt = timerTicks;
+    if(capSenseConfigPending == ENABLED)
+    {
+        /* First byte is the EZI2C sub-address, the following one is written there */
+        i2cWriteBuf[0u] = I2C_ADDRESS_OFFSET + CONFIG_INDEX;
+        i2cWriteBuf[1u] = capSenseConfig;
+        i2cTransfer = I2C_XFER_CONFIG;
+        I2CHW_I2CMasterWriteBuf(I2C_SLAVE_ADDRESS, i2cWriteBuf, sizeof(i2cWriteBuf), 
+                        I2CHW_I2C_MODE_COMPLETE_XFER);
+    }
+    else if(keyboardSimulation == ENABLED)
+    {
+        i2cReadRetries = 0u;
+        i2cTransfer = I2C_XFER_MAILBOX;
+        I2CHW_I2CMasterReadBuf(I2C_SLAVE_ADDRESS, i2cBuffer, I2C_BUF_SIZE, 
+                        I2CHW_I2C_MODE_COMPLETE_XFER);    
+    }
+    else
+    {
+        /* Nothing to report until the host enables notifications */
+    }
+}
+
+/*******************************************************************************
+* Function Name: HandleI2CComplete
+********************************************************************************
+* Summary:
+*       Evaluates a finished I2C transfer. A configuration write that was not
+*		acknowledged is repeated on the next poll. A mailbox read that 
+*		overlapped an update on the slave side is retried at once.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void HandleI2CComplete(void)
+{
+    uint32 status = I2CHW_I2CMasterStatus();
+    uint8 transfer = i2cTransfer;
+
+    i2cTransfer = I2C_XFER_IDLE;
+    if(transfer == I2C_XFER_CONFIG)
+    {
+        if(0u == (status & I2CHW_I2C_MSTAT_ERR_XFER))
+        {
+            i2cErrorsInRow = 0u;
+            capSenseConfigPending = DISABLED;
+        }
+        else
+        {
+            HandleI2CError();
+        }
+        DBG_PRINTF("CapSense config: %x, status: %lx \r\n", capSenseConfig, status);
+    }
+    else if(transfer == I2C_XFER_MAILBOX)
+    {
+        if(0u != (status & I2CHW_I2C_MSTAT_ERR_XFER))
+        {
+            DBG_PRINTF("Mailbox read error: %lx \r\n", status);
+            HandleI2CError();
+        }
+        else if(i2cBuffer[MAILBOX_GEN_HEAD_INDEX] == i2cBuffer[MAILBOX_GEN_TAIL_INDEX])
+        {
+            i2cErrorsInRow = 0u;
+            STATS_INC(mailboxReads);
+            PROFILE_BEGIN(PROFILE_HANDLE_CAPSENSE);
+            HandleCapSense();
+            PROFILE_END(PROFILE_HANDLE_CAPSENSE);
+        }
+        else if(++i2cReadRetries < MAILBOX_READ_RETRIES)
+        {
+            STATS_INC(mailboxTorn);
+            I2CHW_I2CMasterClearStatus();
+            i2cStartedAt = timerTicks;
+            i2cTransfer = I2C_XFER_MAILBOX;
+            I2CHW_I2CMasterReadBuf(I2C_SLAVE_ADDRESS, i2cBuffer, I2C_BUF_SIZE, 
+                            I2CHW_I2C_MODE_COMPLETE_XFER);    
+        }
+        else
+        {
+            DBG_PRINTF("Mailbox read torn: %u/%u \r\n", i2cBuffer[MAILBOX_GEN_HEAD_INDEX], 
+                       i2cBuffer[MAILBOX_GEN_TAIL_INDEX]);
+        }
+    }
+    else
+    {
+        /* No transfer was started by the application */
+    }
+}
+
+/*******************************************************************************
+* Function Name: HandleI2CError
+********************************************************************************
+* Summary:
+*       Counts a failed transfer. After RECOVERY_I2C_ERROR_LIMIT failures in
+*		a row the bus is cleared, a slave holding SDA low fails every 
+*		transfer with a bus error.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void HandleI2CError(void)
+{
+    STATS_INC(i2cErrors);
+    if(++i2cErrorsInRow >= RECOVERY_I2C_ERROR_LIMIT)
+    {
+        i2cErrorsInRow = 0u;
+        RecoveryI2CBusClear();
+    }
+}
+
+/*******************************************************************************
+* Function Name: HandleCapSense
+********************************************************************************
+* Summary:
+*       Reports the Slider and Buttons data of a consistent mailbox read to 
+*		the BLE central device. BTN1 and BTN2 report on press. BTN0 is also
+*		the modifier of the host select chord, so it reports on release, and
+*		only when no host was selected while it was held.
+*		A configuration byte without CAPSENSE_CONFIG_WRITTEN means the 
+*		CapSense MCU was reset or reprogrammed: the configuration is written
+*		again and the generation and gesture sequence restart from their 
+*		power-on values.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void HandleCapSense(void)
+{
+    static uint8 sliderGesture = 0;
+    static uint8 prevSliderSequence = 0;
+    static uint8 buttonValue = 0; 
+    static uint8 prevButtonStat = 0;
+    static uint8 prevGeneration = 0;
+    static uint8 btn0Chord = DISABLED;
+    uint8 pressed;
+    uint8 released;
+
+    if((i2cBuffer[CONFIG_INDEX] & CAPSENSE_CONFIG_WRITTEN) == 0u)
+    {
+        DBG_PRINTF("CapSense restarted, config: %x \r\n", i2cBuffer[CONFIG_INDEX]);
+        capSenseConfigPending = ENABLED;
+        prevGeneration = 0u;
+        prevSliderSequence = 0u;
+    }
+
+    /* Ask for a short connection interval while a hand is near the sensors */
+    ConnParamUpdate(i2cBuffer[STATUS_FLAGS_INDEX] & STATUS_FLAG_APPROACH);
+
+    if(i2cBuffer[MAILBOX_GEN_HEAD_INDEX] == prevGeneration)
+    {
+        /* Nothing new has been published since the last read */
+        return;
+    }
+    prevGeneration = i2cBuffer[MAILBOX_GEN_HEAD_INDEX];
+
+    /* Every new gesture increments the sequence number, so each one is
+    *  reported exactly once */
+    if(prevSliderSequence != i2cBuffer[SLIDER_SEQUENCE_INDEX])
+    {
+        prevSliderSequence = i2cBuffer[SLIDER_SEQUENCE_INDEX];
+        sliderGesture = i2cBuffer[SLIDER_GESTURE_INDEX];
+        DBG_PRINTF("Slider gesture: %x, param: %u @%lu\r\n", sliderGesture, i2cBuffer[SLIDER_PARAM_INDEX], 
+                   timerTicks);
+
+        /* A tap while BTN0 is held selects the host under the tap position */
+        if((sliderGesture == SLIDER_TAP) && ((i2cBuffer[BUTTON_STATUS_INDEX1] & 0x01u) != 0u))
+        {
+            sliderGesture = 0u;
+            btn0Chord = ENABLED;
+            HostSelect(i2cBuffer[SLIDER_PARAM_INDEX]);
+        }
+
+        switch(sliderGesture)
+        {
+            case SLIDER_FLICK_LEFT:
+                SendPageCtrl(1u);   // page up
+                break;
+            case SLIDER_FLICK_RIGHT:
+                SendPageCtrl(0u);   // page down
+                break;
+            case SLIDER_LONG_PRESS:
+                SendSoundCtrl(0u);  // sound lower
+                break;
+            case SLIDER_DOUBLE_TAP:
+                MacroStart(MACRO_STATION_ID);   // type the station ID
+                break;
+            default:
+                break;
+        }
+    }
+
+    buttonValue = i2cBuffer[BUTTON_STATUS_INDEX1];
+    if(prevButtonStat != buttonValue)
+    {
+        DBG_PRINTF("Button moved: %u -> %u @%lu\r\n", prevButtonStat, buttonValue, timerTicks);
+        pressed = buttonValue & (uint8)~prevButtonStat;
+        released = prevButtonStat & (uint8)~buttonValue;
+        prevButtonStat = buttonValue;
+
+        if(released & 0x01)     // btn0
+        {
+            if(btn0Chord == DISABLED)
+            {
+                SendLightCtrl(1u);  // light brighter
+            }
+            btn0Chord = DISABLED;
+        }
+        if(pressed & 0x02)      // btn1
+        {
+            SendLightCtrl(0u);  // light lower
+        }
+        if(pressed & 0x04)      // btn2
+        {
+            SendSoundCtrl(1u);  // sound higher
+        }
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,122 @@
+/*******************************************************************************
+* File Name: power.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the battery power profile manager. The filtered battery
+*  level selects a power band, and every band has a profile for the idle
+*  connection parameters, the CapSense scan period, the advertising time
+*  before hibernate and the battery level notifications. Lower bands give
+*  up responsiveness to stretch the remaining charge.
+*
+* Hardware Dependency:
+*  CY8CKIT-149 PSoC 4100S Plus Prototyping Kit
+*
+*******************************************************************************/
+
+#include "common.h"
+#include "power.h"
+#include "connparam.h"
+
+static const POWER_PROFILE_T powerProfiles[POWER_BAND_COUNT] =
+{
+    /* POWER_BAND_NORMAL: 30-50 ms idle, fast interval on approach, continuous scan */
+    {CONN_SLOW_INTERVAL_MIN, CONN_SLOW_INTERVAL_MAX, CONN_SLOW_LATENCY, 1u, POWER_NORMAL_SCAN_TIER, 1u, 1u, 1u},
+    /* POWER_BAND_SAVER: 50-75 ms idle, scan every 20 ms, no feedback LEDs,
+    *  battery level notified on change only */
+    {40u, 60u, 6u, 1u, CAPSENSE_SCAN_20MS, 1u, 0u, 0u},
+    /* POWER_BAND_CRITICAL: 100-125 ms idle, no fast interval, scan every 50 ms, 
+    *  hibernate after fast advertising, no feedback LEDs, battery level 
+    *  notified on change only */
+    {80u, 100u, 4u, 0u, CAPSENSE_SCAN_50MS, 0u, 0u, 0u},
+};
+
+uint8 powerBand = POWER_BAND_NORMAL;
+static uint16 powerLevelFilter = 0u;     /* Filtered level, POWER_LEVEL_SHIFT fractional bits */
+
+
+/*******************************************************************************
+* Function Name: PowerUpdate()
+********************************************************************************
+*
+* Summary:
+*   Filters a new battery level and switches the power band when the level
+*   crosses a band threshold. A band change is applied at once: the idle
+*   connection parameters are requested again and the new scan period and
+*   LED setting are written to the CapSense MCU.
+*
+* Parameters:
+*  batteryLevel - battery level in percent
+*
+*******************************************************************************/
+void PowerUpdate(uint8 batteryLevel)
+{
+    uint8 level;
+    uint8 band = powerBand;
+
+    if(powerLevelFilter == 0u)
+    {
+        powerLevelFilter = (uint16)batteryLevel << POWER_LEVEL_SHIFT;
+    }
+    else
+    {
+        powerLevelFilter = powerLevelFilter - (powerLevelFilter >> POWER_LEVEL_SHIFT) + batteryLevel;
+    }
+    level = (uint8)(powerLevelFilter >> POWER_LEVEL_SHIFT);
+
+    if(level < POWER_CRITICAL_LEVEL)
+    {
+        band = POWER_BAND_CRITICAL;
+    }
+    else if(level < POWER_SAVER_LEVEL)
+    {
+        if((band != POWER_BAND_CRITICAL) || (level >= (POWER_CRITICAL_LEVEL + POWER_HYSTERESIS)))
+        {
+            band = POWER_BAND_SAVER;
+        }
+    }
+    else if(level >= (POWER_SAVER_LEVEL + POWER_HYSTERESIS))
+    {
+        band = POWER_BAND_NORMAL;
+    }
+    else if(band == POWER_BAND_CRITICAL)
+    {
+        band = POWER_BAND_SAVER;
+    }
+    else
+    {
+        /* Stay in the band until the level has risen past the hysteresis */
+    }
+
+    if(band != powerBand)
+    {
+        DBG_PRINTF("Power band %u -> %u, battery %u%% \r\n", powerBand, band, level);
+        powerBand = band;
+        ConnParamRefresh();
+        capSenseConfig = (capSenseConfig & (uint8)~(CAPSENSE_SCAN_TIER_MASK | CAPSENSE_LED_OFF)) | 
+                         (uint8)(powerProfiles[band].capSenseScanTier << CAPSENSE_SCAN_TIER_SHIFT);
+        if(powerProfiles[band].ledFeedback == 0u)
+        {
+            capSenseConfig |= CAPSENSE_LED_OFF;
+        }
+        capSenseConfigPending = ENABLED;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: PowerGetProfile()
+********************************************************************************
+*
+* Summary:
+*   Returns the profile of the current power band.
+*
+*******************************************************************************/
+const POWER_PROFILE_T *PowerGetProfile(void)
+{
+    return (&powerProfiles[powerBand]);
+}
+
+
+/* [] END OF FILE */
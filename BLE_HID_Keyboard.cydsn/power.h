@@ -0,0 +1,66 @@
+/*******************************************************************************
+* File Name: power.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the battery power
+*  profile manager.
+*
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+
+#define POWER_BAND_NORMAL           (0u)
+#define POWER_BAND_SAVER            (1u)
+#define POWER_BAND_CRITICAL         (2u)
+#define POWER_BAND_COUNT            (3u)
+
+/* Battery percentage below which a band is entered. A band is left once the
+*  level is POWER_HYSTERESIS above its threshold. */
+#define POWER_SAVER_LEVEL           (30u)
+#define POWER_CRITICAL_LEVEL        (10u)
+#define POWER_HYSTERESIS            (3u)
+#define POWER_LEVEL_SHIFT           (2u)        /* Battery level filter coefficient 1/2^n */
+
+/* CAPSENSE_SCAN_xxx tier of the normal band */
+#if !defined(POWER_NORMAL_SCAN_TIER)
+#define POWER_NORMAL_SCAN_TIER      CAPSENSE_SCAN_CONTINUOUS
+#endif /* !defined(POWER_NORMAL_SCAN_TIER) */
+
+
+/***************************************
+*        Data Types
+***************************************/
+typedef struct
+{
+    uint16 slowIntervalMin;     /* Idle connection interval, 1.25 ms units */
+    uint16 slowIntervalMax;
+    uint16 slowLatency;         /* Idle slave latency */
+    uint8 fastOnApproach;       /* Non-zero to request the fast interval on approach */
+    uint8 capSenseScanTier;     /* CAPSENSE_SCAN_xxx period of the CapSense MCU */
+    uint8 slowAdvertising;      /* Non-zero to continue with slow advertising before hibernate */
+    uint8 ledFeedback;          /* Non-zero to show feedback LEDs on both MCUs */
+    uint8 batteryRepeat;        /* Non-zero to notify the battery level even when it did not change */
+} POWER_PROFILE_T;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+void PowerUpdate(uint8 batteryLevel);
+const POWER_PROFILE_T *PowerGetProfile(void);
+
+
+/***************************************
+* External data references
+***************************************/
+extern uint8 powerBand;
+
+
+/* [] END OF FILE */
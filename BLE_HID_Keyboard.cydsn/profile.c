@@ -0,0 +1,118 @@
+/*******************************************************************************
+* File Name: profile.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the micro-profiler. The Cortex-M0 has no cycle
+*  counter, so SysTick runs free over its full 24-bit range as the time
+*  base. A scope costs two register reads and one ProfileAdd() call, which
+*  keeps the count, minimum, maximum and sum of its durations.
+*
+* Hardware Dependency:
+*  CY8CKIT-149 PSoC 4100S Plus Prototyping Kit
+*
+*******************************************************************************/
+
+#include "common.h"
+#include "profile.h"
+
+#if (PROFILE_ENABLE != 0)
+
+PROFILE_SCOPE_T profileScopes[PROFILE_SCOPE_COUNT];
+static const PROFILE_SCOPE_T profileCleared = {0u, 0xFFFFFFFFu, 0u, 0u};
+
+static const char8 * const profileNames[PROFILE_SCOPE_COUNT] =
+{
+    "HandleCapSense",
+    "SendKeyboard",
+    "HID work",
+    "LowPowerImplementation",
+};
+
+
+/*******************************************************************************
+* Function Name: ProfileInit()
+********************************************************************************
+*
+* Summary:
+*   Starts SysTick as a free-running down counter without interrupt and
+*   clears all scopes.
+*
+*******************************************************************************/
+void ProfileInit(void)
+{
+    uint8 scope;
+
+    CySysTickInit();
+    CySysTickSetReload(PROFILE_COUNTER_MASK);
+    CySysTickClear();
+    CySysTickEnable();
+    CySysTickDisableInterrupt();
+
+    for(scope = 0u; scope < PROFILE_SCOPE_COUNT; scope++)
+    {
+        profileScopes[scope] = profileCleared;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ProfileAdd()
+********************************************************************************
+*
+* Summary:
+*   Adds one measured duration to a scope. Called by PROFILE_END().
+*
+* Parameters:
+*  scope - one of the PROFILE_xxx scopes
+*  cycles - duration in HFCLK cycles
+*
+*******************************************************************************/
+void ProfileAdd(uint8 scope, uint32 cycles)
+{
+    PROFILE_SCOPE_T *entry = &profileScopes[scope];
+
+    entry->calls++;
+    entry->total += cycles;
+    if(cycles < entry->min)
+    {
+        entry->min = cycles;
+    }
+    if(cycles > entry->max)
+    {
+        entry->max = cycles;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ProfileShow()
+********************************************************************************
+*
+* Summary:
+*   Prints the calls and the minimum, mean and maximum cycles of every scope
+*   that ran, then starts a new measurement period.
+*
+*******************************************************************************/
+void ProfileShow(void)
+{
+    PROFILE_SCOPE_T *entry;
+    uint8 scope;
+
+    for(scope = 0u; scope < PROFILE_SCOPE_COUNT; scope++)
+    {
+        entry = &profileScopes[scope];
+        if(entry->calls != 0u)
+        {
+            DBG_PRINTF("Profile %s: calls %lu, cycles min %lu mean %lu max %lu \r\n", profileNames[scope],
+                entry->calls, entry->min, (uint32)(entry->total / entry->calls), entry->max);
+        }
+        *entry = profileCleared;
+    }
+}
+
+#endif /* (PROFILE_ENABLE != 0) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,81 @@
+/*******************************************************************************
+* File Name: profile.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the scope macros, function prototypes and constants of the
+*  SysTick based micro-profiler.
+*
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*  Conditional Compilation Parameters
+***************************************/
+#if !defined(PROFILE_ENABLE)
+#define PROFILE_ENABLE              (0)     /* Set to 1 to time the profiled scopes and print them every BATTERY_TIMEOUT */
+#endif /* !defined(PROFILE_ENABLE) */
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Profiled scopes */
+#define PROFILE_HANDLE_CAPSENSE     (0u)
+#define PROFILE_SEND_KEYBOARD       (1u)
+#define PROFILE_PROCESS_QUEUE       (2u)    /* MacroProcess() and HidsProcessQueue() */
+#define PROFILE_LOW_POWER           (3u)    /* Includes Sleep; SysTick stops in Deep-Sleep */
+#define PROFILE_SCOPE_COUNT         (4u)
+
+/* SysTick runs free at HFCLK and counts down through 24 bits */
+#define PROFILE_COUNTER_MASK        (0x00FFFFFFu)
+
+
+/***************************************
+*        Data Types
+***************************************/
+typedef struct
+{
+    uint32 calls;
+    uint32 min;                 /* HFCLK cycles */
+    uint32 max;
+    uint64 total;
+} PROFILE_SCOPE_T;
+
+
+/***************************************
+*        Macros
+***************************************/
+#if (PROFILE_ENABLE != 0)
+    #define PROFILE_NOW()           (CY_SYS_SYST_CVR_REG)
+    #define PROFILE_BEGIN(scope)    uint32 profileStart##scope = PROFILE_NOW()
+    #define PROFILE_END(scope)      ProfileAdd((scope), (profileStart##scope - PROFILE_NOW()) & PROFILE_COUNTER_MASK)
+#else
+    #define PROFILE_BEGIN(scope)
+    #define PROFILE_END(scope)
+#endif /* (PROFILE_ENABLE != 0) */
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+#if (PROFILE_ENABLE != 0)
+void ProfileInit(void);
+void ProfileAdd(uint8 scope, uint32 cycles);
+void ProfileShow(void);
+#endif /* (PROFILE_ENABLE != 0) */
+
+
+/***************************************
+* External data references
+***************************************/
+#if (PROFILE_ENABLE != 0)
+extern PROFILE_SCOPE_T profileScopes[PROFILE_SCOPE_COUNT];
+#endif /* (PROFILE_ENABLE != 0) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,183 @@
+/*******************************************************************************
+* File Name: recovery.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the fault recovery. Every action is bounded in time:
+*  a stuck I2C transfer is abandoned after RECOVERY_I2C_TIMEOUT and the bus
+*  is cleared, a main loop that stops running is reset by the liveness
+*  watchdog within RECOVERY_WDT_TIMEOUT, and a BLE hardware error restarts
+*  the stack, escalating to a device reset when restarts do not help.
+*
+* Hardware Dependency:
+*  CY8CKIT-149 PSoC 4100S Plus Prototyping Kit
+*
+*******************************************************************************/
+
+#include "common.h"
+#include "recovery.h"
+
+RECOVERY_T recovery;
+static uint32 watchdogFedAt;
+static uint8 stackRestartsInRow;
+
+
+/*******************************************************************************
+* Function Name: RecoveryInit()
+********************************************************************************
+*
+* Summary:
+*   Reports a reset by the liveness watchdog. Called once at startup.
+*
+*******************************************************************************/
+void RecoveryInit(void)
+{
+    if(CySysGetResetReason(CY_SYS_RESET_WDT) != 0u)
+    {
+        recovery.watchdogReset = ENABLED;
+        DBG_PRINTF("Recovered from a main loop hang \r\n");
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: RecoveryI2CBusClear()
+********************************************************************************
+*
+* Summary:
+*   Restarts the I2C master. While it is stopped, SCL is clocked until the
+*   slave releases SDA, followed by a STOP condition. Takes at most
+*   RECOVERY_BUS_CLEAR_PULSES SCL periods.
+*
+*******************************************************************************/
+void RecoveryI2CBusClear(void)
+{
+    uint8 pulse;
+
+    recovery.busClears++;
+    /* The stopped SCB hands the pins back to their GPIO data registers */
+    I2CHW_Stop();
+    for(pulse = 0u; (pulse < RECOVERY_BUS_CLEAR_PULSES) && (I2CHW_sda_Read() == 0u); pulse++)
+    {
+        I2CHW_scl_Write(0u);
+        CyDelayUs(RECOVERY_BUS_CLEAR_DELAY);
+        I2CHW_scl_Write(1u);
+        CyDelayUs(RECOVERY_BUS_CLEAR_DELAY);
+    }
+    I2CHW_sda_Write(0u);
+    CyDelayUs(RECOVERY_BUS_CLEAR_DELAY);
+    I2CHW_sda_Write(1u);
+    I2CHW_Start();
+    DBG_PRINTF("I2C bus cleared, pulses: %u \r\n", pulse);
+}
+
+
+/*******************************************************************************
+* Function Name: RecoveryWatchdogStart()
+********************************************************************************
+*
+* Summary:
+*   Arms the liveness watchdog. The device resets when the main loop does
+*   not feed it for RECOVERY_WDT_TIMEOUT. Armed together with the timer,
+*   whose ticks keep the main loop running in every active state.
+*
+*******************************************************************************/
+void RecoveryWatchdogStart(void)
+{
+    CySysWdtUnlock();
+    CySysWdtWriteMode(RECOVERY_WDT_COUNTER, CY_SYS_WDT_MODE_RESET);
+    CySysWdtWriteMatch(RECOVERY_WDT_COUNTER, RECOVERY_WDT_TIMEOUT);
+    CySysWdtResetCounters(RECOVERY_WDT_COUNTER_RESET);
+    CySysWdtEnable(RECOVERY_WDT_COUNTER_MASK);
+    CySysWdtLock();
+    watchdogFedAt = timerTicks;
+}
+
+
+/*******************************************************************************
+* Function Name: RecoveryWatchdogStop()
+********************************************************************************
+*
+* Summary:
+*   Disarms the liveness watchdog. Stopped together with the timer before
+*   windows without ticks to feed it: slow advertising and Hibernate.
+*
+*******************************************************************************/
+void RecoveryWatchdogStop(void)
+{
+    CySysWdtUnlock();
+    CySysWdtDisable(RECOVERY_WDT_COUNTER_MASK);
+    CySysWdtLock();
+}
+
+
+/*******************************************************************************
+* Function Name: RecoveryWatchdogFeed()
+********************************************************************************
+*
+* Summary:
+*   Restarts the watchdog count. Called on every main loop pass; the
+*   counter reset, which takes a few LFCLK cycles, is done only every
+*   RECOVERY_WDT_FEED_TICKS.
+*
+*******************************************************************************/
+void RecoveryWatchdogFeed(void)
+{
+    if((timerTicks - watchdogFedAt) >= RECOVERY_WDT_FEED_TICKS)
+    {
+        watchdogFedAt = timerTicks;
+        CySysWdtUnlock();
+        CySysWdtResetCounters(RECOVERY_WDT_COUNTER_RESET);
+        CySysWdtLock();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: RecoveryStackRestart()
+********************************************************************************
+*
+* Summary:
+*   Restarts the BLE stack after a hardware error. The stack comes back with
+*   CYBLE_EVT_STACK_ON and advertises again. When RECOVERY_STACK_RESTART_LIMIT
+*   restarts in a row did not lead to a connection, the device is reset.
+*   Must not be called from the BLE event callback.
+*
+*******************************************************************************/
+void RecoveryStackRestart(void)
+{
+    CYBLE_API_RESULT_T apiResult;
+
+    recovery.stackRestarts++;
+    if(++stackRestartsInRow > RECOVERY_STACK_RESTART_LIMIT)
+    {
+        DBG_PRINTF("BLE stack does not recover, reset \r\n");
+        CySoftwareReset();
+    }
+
+    CyBle_Stop();
+    apiResult = CyBle_Start(AppCallBack);
+    DBG_PRINTF("BLE stack restart %u, status: %x \r\n", stackRestartsInRow, apiResult);
+    if(apiResult != CYBLE_ERROR_OK)
+    {
+        CySoftwareReset();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: RecoveryConnected()
+********************************************************************************
+*
+* Summary:
+*   A connection proves the stack works again: clears the restart count.
+*
+*******************************************************************************/
+void RecoveryConnected(void)
+{
+    stackRestartsInRow = 0u;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,66 @@
+/*******************************************************************************
+* File Name: recovery.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the fault recovery:
+*  I2C bus clear, main loop liveness watchdog and BLE stack restart.
+*
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* I2C master */
+#define RECOVERY_I2C_TIMEOUT        (2u)        /* Timer ticks a transfer may take before it is abandoned */
+#define RECOVERY_I2C_ERROR_LIMIT    (10u)       /* Failed transfers in a row that clear the bus */
+#define RECOVERY_BUS_CLEAR_PULSES   (9u)        /* SCL pulses that release a slave holding SDA */
+#define RECOVERY_BUS_CLEAR_DELAY    (5u)        /* Half SCL period of the bus clear, in us */
+
+/* Main loop liveness watchdog on WDT counter 0, running together with the timer */
+#define RECOVERY_WDT_COUNTER        (CY_SYS_WDT_COUNTER0)
+#define RECOVERY_WDT_COUNTER_MASK   (CY_SYS_WDT_COUNTER0_MASK)
+#define RECOVERY_WDT_COUNTER_RESET  (CY_SYS_WDT_COUNTER0_RESET)
+#define RECOVERY_WDT_TIMEOUT        (32767u)    /* 1 s @ 32.768kHz clock, device reset on match */
+#define RECOVERY_WDT_FEED_TICKS     (1u)        /* Timer ticks between two watchdog feeds */
+
+/* BLE stack restarts without a connection in between before the device resets */
+#define RECOVERY_STACK_RESTART_LIMIT (3u)
+
+
+/***************************************
+*        Data Types
+***************************************/
+typedef struct
+{
+    uint16 i2cTimeouts;         /* I2C transfers abandoned after RECOVERY_I2C_TIMEOUT */
+    uint16 busClears;           /* I2C bus clear sequences */
+    uint16 stackRestarts;       /* BLE stack restarts after a hardware error */
+    uint8 watchdogReset;        /* Non-zero when the last reset came from the liveness watchdog */
+} RECOVERY_T;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+void RecoveryInit(void);
+void RecoveryI2CBusClear(void);
+void RecoveryWatchdogStart(void);
+void RecoveryWatchdogStop(void);
+void RecoveryWatchdogFeed(void);
+void RecoveryStackRestart(void);
+void RecoveryConnected(void);
+
+
+/***************************************
+* External data references
+***************************************/
+extern RECOVERY_T recovery;
+
+
+/* [] END OF FILE */
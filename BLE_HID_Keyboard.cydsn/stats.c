@@ -0,0 +1,163 @@
+/*******************************************************************************
+* File Name: stats.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the run-time statistics of the BLE firmware. They are
+*  collected on the target while connected and printed on the debug UART, so
+*  the effect of a change on report latency and sleep residency can be
+*  compared on the kit.
+*
+* Hardware Dependency:
+*  CY8CKIT-149 PSoC 4100S Plus Prototyping Kit
+*
+*******************************************************************************/
+
+#include "common.h"
+#include "stats.h"
+#include "link.h"
+#include "power.h"
+#include "recovery.h"
+#include "led.h"
+
+#if (STATS_ENABLE != 0)
+
+STATS_T stats;
+static const STATS_T statsCleared = {0u};
+static uint32 statsStart;
+
+
+/*******************************************************************************
+* Function Name: StatsReset()
+********************************************************************************
+*
+* Summary:
+*   Clears all counters and restarts the measurement period.
+*
+*******************************************************************************/
+void StatsReset(void)
+{
+    stats = statsCleared;
+    statsStart = StatsTimeNow();
+}
+
+
+/*******************************************************************************
+* Function Name: StatsTimeNow()
+********************************************************************************
+*
+* Summary:
+*   Returns the time since the timer was started in LFCLK counts. A match
+*   that is pending because interrupts are disabled is accounted for.
+*
+* Return:
+*  Time in LFCLK counts, about 30.5 us each.
+*
+*******************************************************************************/
+uint32 StatsTimeNow(void)
+{
+    uint8 interruptStatus;
+    uint32 ticks;
+    uint32 count;
+
+    interruptStatus = CyEnterCriticalSection();
+    ticks = timerTicks;
+    count = CySysWdtGetCount(WDT_COUNTER);
+    if((CySysWdtGetInterruptSource() & WDT_INTERRUPT_SOURCE) != 0u)
+    {
+        ticks++;
+    }
+    CyExitCriticalSection(interruptStatus);
+
+    return ((ticks * (WDT_TIMEOUT + 1u)) + count);
+}
+
+
+/*******************************************************************************
+* Function Name: StatsReportSent()
+********************************************************************************
+*
+* Summary:
+*   Counts a sent report and the time it waited in the queue.
+*
+* Parameters:
+*  queuedAt - StatsTimeNow() when the report was queued
+*
+*******************************************************************************/
+void StatsReportSent(uint32 queuedAt)
+{
+    uint32 latency = StatsTimeNow() - queuedAt;
+
+    stats.reportsSent++;
+    stats.reportLatencySum += latency;
+    if(latency > stats.reportLatencyMax)
+    {
+        stats.reportLatencyMax = latency;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: StatsNotificationsEnabled()
+********************************************************************************
+*
+* Summary:
+*   Prints the time and the ATT requests from connection until the host
+*   enabled the keyboard notifications.
+*
+*******************************************************************************/
+void StatsNotificationsEnabled(void)
+{
+    DBG_PRINTF("Stats: notifications enabled %lu ticks after connection, %lu ATT requests \r\n",
+        (StatsTimeNow() - statsStart) / (WDT_TIMEOUT + 1u), stats.attRequests);
+}
+
+
+/*******************************************************************************
+* Function Name: StatsShow()
+********************************************************************************
+*
+* Summary:
+*   Prints the counters of the current measurement period. Deep-Sleep
+*   residency is printed in tenths of a percent of the period, the CPU
+*   current estimate as the residency weighted STATS_xxx_CURRENT values.
+*   Together with the report latency it places the current parameter set
+*   on the latency/current trade-off.
+*
+*******************************************************************************/
+void StatsShow(void)
+{
+    uint32 period = StatsTimeNow() - statsStart;
+    uint32 residency = 0u;
+    uint32 meanLatency = 0u;
+    uint32 current;
+
+    if(period != 0u)
+    {
+        residency = (uint32)(((uint64)stats.deepSleepTime * 1000u) / period);
+    }
+    current = ((residency * STATS_DEEP_SLEEP_CURRENT) + ((1000u - residency) * STATS_ACTIVE_CURRENT)) / 1000u;
+    if(stats.reportsSent != 0u)
+    {
+        meanLatency = stats.reportLatencySum / stats.reportsSent;
+    }
+
+    DBG_PRINTF("Stats: loop %lu, sleep %lu, deep sleep %lu, residency %lu/1000, CPU current %lu uA \r\n",
+        stats.loopPasses, stats.sleepEntries, stats.deepSleepEntries, residency, current);
+    DBG_PRINTF("Stats: mailbox %lu, torn %lu, I2C errors %lu, ATT requests %lu \r\n",
+        stats.mailboxReads, stats.mailboxTorn, stats.i2cErrors, stats.attRequests);
+    DBG_PRINTF("Stats: reports queued %lu, sent %lu, dropped %lu, latency mean %lu max %lu ms \r\n",
+        stats.reportsQueued, stats.reportsSent, stats.reportsDropped, STATS_COUNTS_TO_MS(meanLatency),
+        STATS_COUNTS_TO_MS(stats.reportLatencyMax));
+    DBG_PRINTF("Stats: RSSI %d dBm, TX power step %u, power band %u, pairing %lu ticks \r\n",
+        linkRssi, linkPowerStep, powerBand, stats.pairingTime);
+    DBG_PRINTF("Stats: I2C timeouts %u, bus clears %u, stack restarts %u, watchdog reset %u \r\n",
+        recovery.i2cTimeouts, recovery.busClears, recovery.stackRestarts, recovery.watchdogReset);
+    DBG_PRINTF("Stats: LED charge %lu uAs \r\n", ledCharge / 10u);
+}
+
+#endif /* (STATS_ENABLE != 0) */
+
+
+/* [] END OF FILE */
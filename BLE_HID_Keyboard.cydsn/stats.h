@@ -0,0 +1,89 @@
+/*******************************************************************************
+* File Name: stats.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the run-time statistics:
+*  report counts, queuing latency and sleep residency of the main loop.
+*
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*  Conditional Compilation Parameters
+***************************************/
+#if !defined(STATS_ENABLE)
+#define STATS_ENABLE                (0)     /* Set to 1 to collect statistics and print them every BATTERY_TIMEOUT */
+#endif /* !defined(STATS_ENABLE) */
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Typical supply currents for the CPU current estimate, in microamps. The
+*  estimate excludes the radio and counts CPU Sleep as active time. */
+#define STATS_ACTIVE_CURRENT        (2500u)
+#define STATS_DEEP_SLEEP_CURRENT    (2u)
+
+
+/***************************************
+*        Data Types
+***************************************/
+typedef struct
+{
+    uint32 loopPasses;          /* Main loop passes that found work */
+    uint32 sleepEntries;        /* CPU Sleep entries */
+    uint32 deepSleepEntries;    /* CPU Deep-Sleep entries */
+    uint32 deepSleepTime;       /* Time spent in Deep-Sleep, LFCLK counts */
+    uint32 mailboxReads;        /* Consistent CapSense mailbox reads */
+    uint32 mailboxTorn;         /* Mailbox reads repeated because of a concurrent update */
+    uint32 i2cErrors;           /* Failed I2C transfers */
+    uint32 reportsQueued;
+    uint32 reportsSent;
+    uint32 reportsDropped;      /* Reports lost to a full queue or a send error */
+    uint32 reportLatencySum;    /* LFCLK counts from queuing to sending, summed over all sent reports */
+    uint32 reportLatencyMax;
+    uint32 attRequests;         /* ATT requests from the host that reached the application */
+    uint32 pairingTime;         /* Timer ticks from the pairing request to its completion */
+} STATS_T;
+
+
+/***************************************
+*        Macros
+***************************************/
+#define STATS_COUNTS_TO_MS(counts)  (((counts) * 1000u) / 32768u)   /* LFCLK counts to milliseconds */
+
+#if (STATS_ENABLE != 0)
+    #define STATS_INC(counter)      (stats.counter++)
+    #define STATS_ADD(counter, n)   (stats.counter += (n))
+#else
+    #define STATS_INC(counter)
+    #define STATS_ADD(counter, n)
+#endif /* (STATS_ENABLE != 0) */
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+#if (STATS_ENABLE != 0)
+void StatsReset(void);
+uint32 StatsTimeNow(void);
+void StatsReportSent(uint32 queuedAt);
+void StatsNotificationsEnabled(void);
+void StatsShow(void);
+#endif /* (STATS_ENABLE != 0) */
+
+
+/***************************************
+* External data references
+***************************************/
+#if (STATS_ENABLE != 0)
+extern STATS_T stats;
+#endif /* (STATS_ENABLE != 0) */
+
+
+/* [] END OF FILE */
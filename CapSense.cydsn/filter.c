@@ -0,0 +1,157 @@
+/*******************************************************************************
+* File Name: filter.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the adaptive touch filter that runs on the sensor
+*  difference counts between CapSense_ProcessWidget() and the button and
+*  gesture logic.
+*
+* Hardware Dependency:
+*  CY8CKIT-149 PSoC 4100S Plus Prototyping Kit
+*
+*******************************************************************************/
+
+#include "filter.h"
+
+static const FILTER_PROFILE_T filterProfiles[FILTER_PROFILE_COUNT] =
+{
+    /* FILTER_PROFILE_LOW_LATENCY: raw sample passes on the first rising scan */
+    {0u, 0u, 2u, 2u},
+    /* FILTER_PROFILE_HIGH_NOISE: one extra scan of delay for median and attack */
+    {1u, 1u, 3u, 4u},
+};
+
+static const FILTER_PROFILE_T *activeProfile = &filterProfiles[FILTER_DEFAULT_PROFILE];
+static uint8 activeProfileId = FILTER_DEFAULT_PROFILE;
+
+static uint16 Filter_Median3(uint16 a, uint16 b, uint16 c);
+
+
+/*******************************************************************************
+* Function Name: Filter_SetProfile()
+********************************************************************************
+*
+* Summary:
+*   Selects the latency/noise trade-off used by all filter channels. Unknown
+*   profile numbers are ignored.
+*
+* Parameters:
+*  profile - FILTER_PROFILE_LOW_LATENCY or FILTER_PROFILE_HIGH_NOISE
+*
+*******************************************************************************/
+void Filter_SetProfile(uint8 profile)
+{
+    if(profile < FILTER_PROFILE_COUNT)
+    {
+        activeProfileId = profile;
+        activeProfile = &filterProfiles[profile];
+    }
+}
+
+
+uint8 Filter_GetProfile(void)
+{
+    return (activeProfileId);
+}
+
+
+/*******************************************************************************
+* Function Name: Filter_InitChannel()
+********************************************************************************
+*
+* Summary:
+*   Clears the state of a filter channel.
+*
+*******************************************************************************/
+void Filter_InitChannel(FILTER_CHANNEL_T *channel)
+{
+    channel->history[0u] = 0u;
+    channel->history[1u] = 0u;
+    channel->level = 0;
+    channel->noise = 0;
+    channel->touched = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Filter_Process()
+********************************************************************************
+*
+* Summary:
+*   Runs one sample through the channel: optional median of 3, fast-attack/
+*   slow-release IIR, then a touch decision. The touch threshold is the
+*   finger threshold raised by the noise measured while the channel is
+*   released and quiet. Release happens at 3/4 of that threshold.
+*
+* Parameters:
+*  channel - filter channel state
+*  sample - sensor difference count
+*  fingerTh - finger threshold of the widget
+*
+* Return:
+*  Non-zero while the channel is touched.
+*
+*******************************************************************************/
+uint8 Filter_Process(FILTER_CHANNEL_T *channel, uint16 sample, uint16 fingerTh)
+{
+    int32 input;
+    int32 delta;
+    int32 onTh;
+    int32 quietTh;
+
+    input = (int32)sample;
+    if(activeProfile->medianEnable != 0u)
+    {
+        input = (int32)Filter_Median3(channel->history[0u], channel->history[1u], sample);
+    }
+    channel->history[0u] = channel->history[1u];
+    channel->history[1u] = sample;
+
+    delta = (input << FILTER_FRAC_SHIFT) - channel->level;
+    if(delta > 0)
+    {
+        channel->level += delta >> activeProfile->attackShift;
+    }
+    else
+    {
+        channel->level += delta >> activeProfile->releaseShift;
+    }
+
+    onTh = ((int32)fingerTh << FILTER_FRAC_SHIFT) + (channel->noise * activeProfile->noiseGain);
+    if(channel->touched == 0u)
+    {
+        /* Track the noise only while released and quiet: an approaching
+        *  finger or a drifting proximity signal would inflate it */
+        delta = (delta < 0) ? -delta : delta;
+        quietTh = ((int32)fingerTh << FILTER_FRAC_SHIFT) >> FILTER_NOISE_FREEZE_SHIFT;
+        if((delta <= quietTh) && (channel->level <= quietTh))
+        {
+            channel->noise += (delta - channel->noise) >> FILTER_NOISE_SHIFT;
+        }
+        if(channel->level >= onTh)
+        {
+            channel->touched = 1u;
+        }
+    }
+    else if(channel->level < (onTh - (onTh >> 2u)))
+    {
+        channel->touched = 0u;
+    }
+
+    return (channel->touched);
+}
+
+
+static uint16 Filter_Median3(uint16 a, uint16 b, uint16 c)
+{
+    uint16 lo = (a < b) ? a : b;
+    uint16 hi = (a < b) ? b : a;
+
+    hi = (hi < c) ? hi : c;
+    return ((lo > hi) ? lo : hi);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,66 @@
+/*******************************************************************************
+* File Name: filter.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the adaptive touch filter.
+*
+*******************************************************************************/
+
+#if !defined(FILTER_H)
+#define FILTER_H
+
+#include "project.h"
+
+
+/***************************************
+*  Conditional Compilation Parameters
+***************************************/
+#define FILTER_PROFILE_LOW_LATENCY  (0u)    /* Fast attack, no median, thresholds close to the finger threshold */
+#define FILTER_PROFILE_HIGH_NOISE   (1u)    /* Median of 3, slower attack, thresholds follow the noise level */
+#define FILTER_PROFILE_COUNT        (2u)
+
+#define FILTER_DEFAULT_PROFILE      FILTER_PROFILE_LOW_LATENCY
+
+
+/***************************************
+*          Constants
+***************************************/
+#define FILTER_FRAC_SHIFT           (4u)    /* Fractional bits of the filter state */
+#define FILTER_NOISE_SHIFT          (4u)    /* Noise estimate averages over 16 samples */
+#define FILTER_NOISE_FREEZE_SHIFT   (2u)    /* Noise estimate frozen above 1/4 of the finger threshold */
+
+
+/***************************************
+*        Data Types
+***************************************/
+typedef struct
+{
+    uint8 medianEnable;     /* Non-zero to run the median of 3 before the IIR */
+    uint8 attackShift;      /* IIR coefficient 1/2^n for a rising signal */
+    uint8 releaseShift;     /* IIR coefficient 1/2^n for a falling signal */
+    uint8 noiseGain;        /* Multiple of the noise estimate added to the touch threshold */
+} FILTER_PROFILE_T;
+
+typedef struct
+{
+    uint16 history[2u];     /* Two previous raw samples for the median */
+    int32 level;            /* Filtered signal, FILTER_FRAC_SHIFT fractional bits */
+    int32 noise;            /* Mean absolute deviation while released, same format */
+    uint8 touched;
+} FILTER_CHANNEL_T;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+void Filter_SetProfile(uint8 profile);
+uint8 Filter_GetProfile(void);
+void Filter_InitChannel(FILTER_CHANNEL_T *channel);
+uint8 Filter_Process(FILTER_CHANNEL_T *channel, uint16 sample, uint16 fingerTh);
+
+#endif /* FILTER_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,241 @@
+/*******************************************************************************
+* File Name: gesture.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the slider gesture engine. It recognizes tap, double tap,
+*  long press and swipe with velocity from the slider centroid stream.
+*
+* Hardware Dependency:
+*  CY8CKIT-149 PSoC 4100S Plus Prototyping Kit
+*
+*******************************************************************************/
+
+#include "gesture.h"
+
+/* Engine states */
+#define GESTURE_STATE_IDLE          (0u)    /* No touch */
+#define GESTURE_STATE_TOUCH         (1u)    /* Touch down, nothing decided yet */
+#define GESTURE_STATE_TAP_PENDING   (2u)    /* A tap was released, waiting for a second one */
+#define GESTURE_STATE_LOCKED        (3u)    /* Event reported, waiting for release */
+
+static uint8 state = GESTURE_STATE_IDLE;
+static int32 filteredPos;                   /* Touch position, GESTURE_POS_SHIFT fractional bits */
+static uint16 startPos;
+static uint32 startTime;
+static uint32 releaseTime;
+static uint8 tapPos;
+
+static void Gesture_Start(uint16 position, uint32 timestamp);
+static uint8 Gesture_Saturate(uint32 value);
+static uint16 Gesture_Travel(uint16 pos);
+
+
+/*******************************************************************************
+* Function Name: Gesture_Init()
+********************************************************************************
+*
+* Summary:
+*   Resets the gesture engine to the idle state.
+*
+*******************************************************************************/
+void Gesture_Init(void)
+{
+    state = GESTURE_STATE_IDLE;
+    filteredPos = 0;
+}
+
+
+/*******************************************************************************
+* Function Name: Gesture_Process()
+********************************************************************************
+*
+* Summary:
+*   Feeds one slider sample into the gesture engine. Every call runs a fixed
+*   number of shift and add operations; the only division is the velocity of
+*   a completed swipe. An event is reported as soon as it is unambiguous:
+*   swipe once the travel is reached, long press once the hold time is reached
+*   and double tap on the second touch down, when it comes within the double
+*   tap gap and near the first tap. A single tap is reported on release, or
+*   after the double tap gap when double tap is enabled.
+*
+* Parameters:
+*  position - slider centroid or CapSense_SLIDER_NO_TOUCH
+*  timestamp - current time in milliseconds
+*  event - receives the detected gesture
+*
+* Return:
+*  Non-zero when an event has been written to *event.
+*
+*******************************************************************************/
+uint8 Gesture_Process(uint16 position, uint32 timestamp, GESTURE_EVENT_T *event)
+{
+    uint8 detected = 0u;
+    uint16 pos;
+    uint16 travel;
+    uint32 elapsed;
+    uint8 tapDistance;
+
+    if(position == CapSense_SLIDER_NO_TOUCH)
+    {
+        switch(state)
+        {
+            case GESTURE_STATE_TOUCH:
+                pos = (uint16)(filteredPos >> GESTURE_POS_SHIFT);
+                if(((timestamp - startTime) <= GESTURE_TAP_MAX_TIME) &&
+                   (Gesture_Travel(pos) <= GESTURE_TAP_MAX_MOVE))
+                {
+                    tapPos = Gesture_Saturate(startPos);
+                #if (GESTURE_DOUBLE_TAP_ENABLE != 0u)
+                    releaseTime = timestamp;
+                    state = GESTURE_STATE_TAP_PENDING;
+                #else
+                    event->type = GESTURE_TAP;
+                    event->param = tapPos;
+                    detected = 1u;
+                    state = GESTURE_STATE_IDLE;
+                #endif /* (GESTURE_DOUBLE_TAP_ENABLE != 0u) */
+                }
+                else
+                {
+                    state = GESTURE_STATE_IDLE;
+                }
+                break;
+            case GESTURE_STATE_TAP_PENDING:
+                if((timestamp - releaseTime) > GESTURE_DOUBLE_TAP_GAP)
+                {
+                    event->type = GESTURE_TAP;
+                    event->param = tapPos;
+                    detected = 1u;
+                    state = GESTURE_STATE_IDLE;
+                }
+                break;
+            case GESTURE_STATE_LOCKED:
+                state = GESTURE_STATE_IDLE;
+                break;
+            default:
+                break;
+        }
+    }
+    else
+    {
+        switch(state)
+        {
+            case GESTURE_STATE_IDLE:
+                Gesture_Start(position, timestamp);
+                break;
+            case GESTURE_STATE_TAP_PENDING:
+                /* A slow scan tier may deliver the second touch after the gap,
+                *  so the gap is checked here as well as on release frames */
+                pos = Gesture_Saturate(position);
+                tapDistance = (pos > tapPos) ? (uint8)(pos - tapPos) : (uint8)(tapPos - pos);
+                event->param = tapPos;
+                detected = 1u;
+                if(((timestamp - releaseTime) <= GESTURE_DOUBLE_TAP_GAP) &&
+                   (tapDistance <= GESTURE_DOUBLE_TAP_MAX_MOVE))
+                {
+                    event->type = GESTURE_DOUBLE_TAP;
+                    state = GESTURE_STATE_LOCKED;
+                }
+                else
+                {
+                    /* Report the first tap and take this touch as a new one */
+                    event->type = GESTURE_TAP;
+                    Gesture_Start(position, timestamp);
+                }
+                break;
+            case GESTURE_STATE_TOUCH:
+                /* Single pole low-pass, coefficient 1/2 */
+                filteredPos += (((int32)position << GESTURE_POS_SHIFT) - filteredPos) >> 1;
+                pos = (uint16)(filteredPos >> GESTURE_POS_SHIFT);
+                travel = Gesture_Travel(pos);
+                elapsed = timestamp - startTime;
+                if(travel >= GESTURE_SWIPE_MIN_MOVE)
+                {
+                    event->type = (pos > startPos) ? GESTURE_SWIPE_RIGHT : GESTURE_SWIPE_LEFT;
+                    event->param = (elapsed == 0u) ? GESTURE_VELOCITY_MAX :
+                                   Gesture_Saturate(((uint32)travel * GESTURE_VELOCITY_SCALE) / elapsed);
+                    detected = 1u;
+                    state = GESTURE_STATE_LOCKED;
+                }
+                else if((elapsed >= GESTURE_LONG_PRESS_TIME) && (travel <= GESTURE_TAP_MAX_MOVE))
+                {
+                    event->type = GESTURE_LONG_PRESS;
+                    event->param = Gesture_Saturate(startPos);
+                    detected = 1u;
+                    state = GESTURE_STATE_LOCKED;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    return (detected);
+}
+
+
+/*******************************************************************************
+* Function Name: Gesture_Start()
+********************************************************************************
+*
+* Summary:
+*   Starts a touch at its first sample: the position filter, the start
+*   position and time that travel and hold time are measured from.
+*
+* Parameters:
+*  position - slider centroid of the first sample
+*  timestamp - time of the first sample in milliseconds
+*
+*******************************************************************************/
+static void Gesture_Start(uint16 position, uint32 timestamp)
+{
+    filteredPos = (int32)position << GESTURE_POS_SHIFT;
+    startPos = position;
+    startTime = timestamp;
+    state = GESTURE_STATE_TOUCH;
+}
+
+
+/*******************************************************************************
+* Function Name: Gesture_Saturate()
+********************************************************************************
+*
+* Summary:
+*   Clamps a position or velocity to the 8-bit event parameter.
+*
+* Parameters:
+*  value - slider position or swipe velocity
+*
+* Return:
+*  value, or GESTURE_VELOCITY_MAX when it does not fit.
+*
+*******************************************************************************/
+static uint8 Gesture_Saturate(uint32 value)
+{
+    return ((value > GESTURE_VELOCITY_MAX) ? GESTURE_VELOCITY_MAX : (uint8)value);
+}
+
+
+/*******************************************************************************
+* Function Name: Gesture_Travel()
+********************************************************************************
+*
+* Summary:
+*   Distance of a position from the start of the touch, in either direction.
+*
+* Parameters:
+*  pos - filtered slider position
+*
+* Return:
+*  Slider units between pos and the start position.
+*
+*******************************************************************************/
+static uint16 Gesture_Travel(uint16 pos)
+{
+    return ((pos > startPos) ? (pos - startPos) : (startPos - pos));
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,75 @@
+/*******************************************************************************
+* File Name: gesture.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the slider gesture engine.
+*
+*******************************************************************************/
+
+#if !defined(GESTURE_H)
+#define GESTURE_H
+
+#include "project.h"
+
+
+/***************************************
+*  Conditional Compilation Parameters
+***************************************/
+#define GESTURE_DOUBLE_TAP_ENABLE   (1u)    /* Set to 0 to report taps on release, without double tap wait */
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Gesture codes published in the I2C buffer. Swipe codes keep the values of
+*  the CapSense component flick gestures used by earlier firmware. */
+#define GESTURE_NONE                (0x00u)
+#define GESTURE_TAP                 (0x10u)
+#define GESTURE_DOUBLE_TAP          (0x11u)
+#define GESTURE_LONG_PRESS          (0x12u)
+#define GESTURE_SWIPE_RIGHT         (0x54u)
+#define GESTURE_SWIPE_LEFT          (0x5Cu)
+
+/* Timings in milliseconds of the CapSense gesture timestamp */
+#define GESTURE_TAP_MAX_TIME        (200u)  /* Longest touch that is still a tap */
+#if !defined(GESTURE_DOUBLE_TAP_GAP)
+#define GESTURE_DOUBLE_TAP_GAP      (250u)  /* Longest release between the taps of a double tap */
+#endif /* !defined(GESTURE_DOUBLE_TAP_GAP) */
+#define GESTURE_LONG_PRESS_TIME     (600u)  /* Hold time of a long press */
+
+/* Distances in slider position units */
+#define GESTURE_TAP_MAX_MOVE        (8u)    /* Largest travel of a tap or long press */
+#define GESTURE_SWIPE_MIN_MOVE      (20u)   /* Travel that completes a swipe */
+#define GESTURE_DOUBLE_TAP_MAX_MOVE (16u)   /* Largest distance between the taps of a double tap */
+
+/* Swipe velocity is reported in position units per 100 ms, saturated to 8 bits */
+#define GESTURE_VELOCITY_SCALE      (100u)
+#define GESTURE_VELOCITY_MAX        (0xFFu)
+
+/* Fractional bits of the filtered touch position */
+#define GESTURE_POS_SHIFT           (4u)
+
+
+/***************************************
+*        Data Types
+***************************************/
+typedef struct
+{
+    uint8 type;     /* One of the GESTURE_xxx codes */
+    uint8 param;    /* Position for taps and long press, velocity for swipes */
+} GESTURE_EVENT_T;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+void Gesture_Init(void);
+uint8 Gesture_Process(uint16 position, uint32 timestamp, GESTURE_EVENT_T *event);
+
+#endif /* GESTURE_H */
+
+
+/* [] END OF FILE */
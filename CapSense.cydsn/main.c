@@ -1,266 +1,769 @@
-/*******************************************************************************
-* File Name: main.c
-*
-* Version: 1.10
-*
-* Description:
-* This code example demonstrates the PSoC 4 CapSense Component with the
-* use of both gestures and the CapSense tuner. It also shows multiple ways
-* to set the timestamp that is used by the gestures.
-*
-******************************************************************************
-* Copyright (2018-2019), Cypress Semiconductor Corporation.
-******************************************************************************
-* This software, including source code, documentation and related materials
-* ("Software") is owned by Cypress Semiconductor Corporation (Cypress) and is
-* protected by and subject to worldwide patent protection (United States and 
-* foreign), United States copyright laws and international treaty provisions. 
-* Cypress hereby grants to licensee a personal, non-exclusive, non-transferable
-* license to copy, use, modify, create derivative works of, and compile the 
-* Cypress source code and derivative works for the sole purpose of creating 
-* custom software in support of licensee product, such licensee product to be
-* used only in conjunction with Cypress's integrated circuit as specified in the
-* applicable agreement. Any reproduction, modification, translation, compilation,
-* or representation of this Software except as specified above is prohibited 
-* without the express written permission of Cypress.
-* 
-* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, 
-* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED 
-* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
-* Cypress reserves the right to make changes to the Software without notice. 
-* Cypress does not assume any liability arising out of the application or use
-* of Software or any product or circuit described in the Software. Cypress does
-* not authorize its products for use as critical components in any products 
-* where a malfunction or failure may reasonably be expected to result in 
-* significant injury or death ("ACTIVE Risk Product"). By including Cypress's 
-* product in a ACTIVE Risk Product, the manufacturer of such system or application
-* assumes all risk of such use and in doing so indemnifies Cypress against all
-* liability. Use of this Software may be limited by and subject to the applicable
-* Cypress software license agreement.
-*******************************************************************************/
-
-#include "project.h"
-
-#define LED_ON                      (0u)
-#define LED_OFF                     (1u)
-
-/* Timestamp must be updated for gestures, there are three
-   main ways to do this */
-#define USING_SYS_TICK_CALLBACK     (1u)
-#define USING_MAIN_LOOP             (2u)
-#define USING_APP_TIMESTAMP         (3u)
-
-/* Select the method for timestamp implementation */
-#define TIMESTAMP_METHOD USING_SYS_TICK_CALLBACK
-
-/*I2C Buffer size = 4 bytes
-  BYTE0 = CapSense linear slider touch position
-  BYTE1 = No of buttons on CY8CKIT-149 PSoC 4100S Plus Prototyping Kit
-  BYTE2 = bit0= BTN0 status, bit1 = BTN1 status, bit2 = BTN2 status
-  BYTE3 = dummy for this project, for future expansion */
-#define BUFFER_SIZE                 (4u)
-#define READ_ONLY_OFFSET            (0u)
-#define TOTAL_CAPSENSE_BUTTONS      (3u)
-
-/* I2C buffer index */
-#define SLIDER_GESTURE_INDEX        (0u)
-#define BUTTON_COUNT_INDEX          (1u)
-#define BUTTON_STATUS_INDEX1        (2u)
-#define BUTTON_STATUS_INDEX2        (3u)
-#define INITIALIZED_VAL             (0u)
-#define SET_BIT(data, bitPosition)  ((data) |= (1 << (bitPosition)))
-#define CLEAR_BIT(data, bitPosition)((data) &= (~(1 << (bitPosition))))
-
-#define GESTURE_TIMEOUT             (180u)
-
-/* Holds value for time stamp count */
-#if (TIMESTAMP_METHOD == USING_APP_TIMESTAMP)
-    uint32 appTimestamp;
-#endif
-
-uint8 i2cBuffer[] = {INITIALIZED_VAL,TOTAL_CAPSENSE_BUTTONS,INITIALIZED_VAL,INITIALIZED_VAL};
-
-/* Function declaration */
-void LED_Control(void);
-void timeStampSetup(void);
-void timeStampUpdate(void);
-
-/*******************************************************************************
-* Function Name: main
-********************************************************************************
-* Summary:
-*  The main function performs the following actions:
-*   1. Starts all hardware Components
-*   2. Starts the timestamp
-*   3. Scans all CapSense widgets and waits until scan is done
-*   4. Process all data and update time stamp
-*   5. Checks if there was a gesture
-*
-* Parameters:
-*  None
-*
-* Return:
-*  None
-*
-*******************************************************************************/
-int main(void)
-{
-    /* Stores the current gesture */
-    uint32 detectedGesture = CapSense_SLIDER_NO_TOUCH;
-    uint8 widgetID = 0;
-    uint8 buttonStatus = 0;
-    uint8 gestureDetected = 0;
-    uint32 cnt = 0;
-
-    CyGlobalIntEnable; /* Enable global interrupts. */
-
-    /* Starts all Components in hardware */
-    EZI2C_Start();
-    CapSense_Start();
-
-    /* Start user selected timestamp */
-    timeStampSetup();
-
-    /* Set up communication data buffer with CapSense slider centroid 
-        position and button status to be exposed to EZ-BLE Module on CY8CKIT-149 PSoC 4100S Plus Prototyping Kit */
-    EZI2C_EzI2CSetBuffer1(sizeof(i2cBuffer), sizeof(i2cBuffer), i2cBuffer);
-
-    CapSense_ScanAllWidgets();
-
-    for(;;)
-    { 
-        /* Checks to make sure that the scan is done before processing data */
-        if(CapSense_NOT_BUSY == CapSense_IsBusy())
-        {  
-            /* Process data */
-            CapSense_ProcessAllWidgets();
-
-            /* Updates the selected timestamp */
-            timeStampUpdate();
-
-            /* Stores the current detected gesture */
-            detectedGesture = CapSense_DecodeWidgetGestures(CapSense_LINEARSLIDER0_WDGT_ID);
-
-            /* Turns a specific LED on or off depending on the gesture */
-            if((detectedGesture == CapSense_ONE_FINGER_FLICK_RIGHT) || 
-                (detectedGesture == CapSense_ONE_FINGER_FLICK_LEFT))
-            {
-                gestureDetected = 1;
-                cnt = 0;
-                i2cBuffer[SLIDER_GESTURE_INDEX] = (uint8) detectedGesture;
-                /* If LED is on turn it off, or if off turn it on */
-                if(detectedGesture == CapSense_ONE_FINGER_FLICK_RIGHT)
-                {
-                    Right_LED_Write((Right_LED_Read() == LED_ON) ? LED_OFF : LED_ON);
-                }
-                else
-                {
-                    Left_LED_Write((Left_LED_Read() == LED_ON) ? LED_OFF : LED_ON);
-                }
-            }
-            if(gestureDetected == 1)
-            {
-                if(cnt >= GESTURE_TIMEOUT)
-                {
-                    gestureDetected = 0;
-                    cnt = 0;
-                    i2cBuffer[SLIDER_GESTURE_INDEX] = (uint8) CapSense_NO_GESTURE;
-                }
-                cnt++;
-            }
-
-            LED_Control();
-
-            /* Calculate the button status mask and update the I2C buffer
-                bit0= BTN0 status, bit1 = BTN1 status, bit2 = BTN2 status */
-            for(widgetID = 0; widgetID < TOTAL_CAPSENSE_BUTTONS; widgetID++)
-            {
-                if(CapSense_IsWidgetActive(widgetID))
-                {
-                    SET_BIT(buttonStatus, widgetID);
-                }
-                else
-                {
-                    CLEAR_BIT(buttonStatus, widgetID);
-                }
-            }                     
-            i2cBuffer[BUTTON_STATUS_INDEX1] = buttonStatus;
-
-            /* Initiates next scan of the slider widget */
-            CapSense_ScanAllWidgets();
-        }
-    }
-}
-
-/*******************************************************************************
-* Function Name: timeStampSetup
-********************************************************************************
-* Summary:
-*  The timeStampSetup function performs the following actions:
-*   1. Checks which timestamp method is used
-*   2. Starts selected timestamp
-*
-* Parameters:
-*  None
-*
-* Return:
-*  None
-*
-*******************************************************************************/
-void timeStampSetup()
-{
-    /* Sets up a callback function using sysTick timer isr */
-    #if(TIMESTAMP_METHOD == USING_SYS_TICK_CALLBACK)
-        CapSense_dsRam.timestampInterval = 1u;
-        CySysTickStart();
-        CySysTickSetCallback(0u, CapSense_IncrementGestureTimestamp);
-    #endif
-
-    /* Update the timestamp interval depending on mainloop period */
-    #if(TIMESTAMP_METHOD == USING_MAIN_LOOP)
-        CapSense_dsRam.timestampInterval = 2u;
-    #endif
-
-    /* Creates a counter to keep track of current time */
-    #if(TIMESTAMP_METHOD == USING_APP_TIMESTAMP)
-        appTimestamp = 0;
-    #endif
-}
-
-/*******************************************************************************
-* Function Name: timeStampUpdate
-********************************************************************************
-* Summary:
-*  The timeStampUpdate function performs the following actions:
-*   1. Update user selected timestamp
-*
-* Parameters:
-*  None
-*
-* Return:
-*  None
-*
-*******************************************************************************/
-void timeStampUpdate()
-{
-    /* Update component timestamp using mainloop */
-    #if(TIMESTAMP_METHOD == USING_MAIN_LOOP)
-        CapSense_IncrementGestureTimestamp();
-    #endif
-
-    /* Update the counter and set the timestamp with component function */
-    #if(TIMESTAMP_METHOD == USING_APP_TIMESTAMP)
-        appTimestamp += 3u;
-        CapSense_SetGestureTimestamp(appTimestamp);
-    #endif
-}
-
-
-void LED_Control()
-{
-    /* Turn ON/OFF LEDs based on the status of the corresponding CapSense buttons */
-    LED_11_Write(CapSense_IsWidgetActive(CapSense_BTN0_WDGT_ID) ? LED_ON : LED_OFF );
-    LED_12_Write(CapSense_IsWidgetActive(CapSense_BTN1_WDGT_ID) ? LED_ON : LED_OFF );
-    LED_13_Write(CapSense_IsWidgetActive(CapSense_BTN2_WDGT_ID) ? LED_ON : LED_OFF );
-    CapSense_Sleep();
-}
+/*******************************************************************************
+* File Name: main.c
+*
+* Version: 1.10
+*
+* Description:
+* This code example demonstrates the PSoC 4 CapSense Component with the
+* use of both gestures and the CapSense tuner. It also shows multiple ways
+* to set the timestamp that is used by the gestures.
+*
+******************************************************************************
+* Copyright (2018-2019), Cypress Semiconductor Corporation.
+******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software") is owned by Cypress Semiconductor Corporation (Cypress) and is
+* protected by and subject to worldwide patent protection (United States and 
+* foreign), United States copyright laws and international treaty provisions. 
+* Cypress hereby grants to licensee a personal, non-exclusive, non-transferable
+* license to copy, use, modify, create derivative works of, and compile the 
+* Cypress source code and derivative works for the sole purpose of creating 
+* custom software in support of licensee product, such licensee product to be
+* used only in conjunction with Cypress's integrated circuit as specified in the
+* applicable agreement. Any reproduction, modification, translation, compilation,
+* or representation of this Software except as specified above is prohibited 
+* without the express written permission of Cypress.
+* 
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, 
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED 
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+* Cypress reserves the right to make changes to the Software without notice. 
+* Cypress does not assume any liability arising out of the application or use
+* of Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use as critical components in any products 
+* where a malfunction or failure may reasonably be expected to result in 
+* significant injury or death ("ACTIVE Risk Product"). By including Cypress's 
+* product in a ACTIVE Risk Product, the manufacturer of such system or application
+* assumes all risk of such use and in doing so indemnifies Cypress against all
+* liability. Use of this Software may be limited by and subject to the applicable
+* Cypress software license agreement.
+*******************************************************************************/
+
+#include "project.h"
+#include "gesture.h"
+#include "filter.h"
+#include "profile.h"
+#include "tuning.h"
+
+#define LED_ON                      (0u)
+#define LED_OFF                     (1u)
+
+/* Timestamp must be updated for gestures, there are three
+   main ways to do this */
+#define USING_SYS_TICK_CALLBACK     (1u)
+#define USING_MAIN_LOOP             (2u)
+#define USING_APP_TIMESTAMP         (3u)
+
+/* Select the method for timestamp implementation */
+#define TIMESTAMP_METHOD USING_SYS_TICK_CALLBACK
+
+/* Set to 1 to append scan loop statistics to the I2C buffer */
+#define LOOP_STATS_ENABLE           (0u)
+
+/* Set to 0 to scan all widgets at once and process them after the scan,
+   the order before the pipelined scans */
+#if !defined(SCAN_PIPELINE_ENABLE)
+#define SCAN_PIPELINE_ENABLE        (1u)
+#endif /* !defined(SCAN_PIPELINE_ENABLE) */
+
+/*I2C Buffer size = 9 bytes of mailbox, followed by the optional loop statistics
+  BYTE0 = Configuration written by the master, bit0 = filter profile, bit1..2 = idle scan period tier,
+          bit3 = feedback LEDs off
+  BYTE1 = Mailbox generation, head copy (written last on publication)
+  BYTE2 = Last CapSense linear slider gesture (GESTURE_xxx code)
+  BYTE3 = No of buttons on CY8CKIT-149 PSoC 4100S Plus Prototyping Kit
+  BYTE4 = bit0= BTN0 status, bit1 = BTN1 status, bit2 = BTN2 status
+  BYTE5 = Status flags, bit0 = hand approaching (proximity on the ganged sensors)
+  BYTE6 = Last gesture parameter: position for taps and long press, velocity for swipes
+  BYTE7 = Gesture sequence number, incremented for every new gesture
+  BYTE8 = Mailbox generation, tail copy (written first on publication)
+  With LOOP_STATS_ENABLE, outside the mailbox, 16-bit little endian:
+  BYTE9..10  = Scans completed in the last second
+  BYTE11..12 = Mailbox publications in the last second
+  BYTE13..14 = Milliseconds from touch down to the last reported gesture
+  BYTE15..16 = Milliseconds from the CapSense start to the first processed scan */
+#define MAILBOX_SIZE                (9u)
+#if (LOOP_STATS_ENABLE != 0u)
+    #define LOOP_STATS_SIZE         (8u)
+#else
+    #define LOOP_STATS_SIZE         (0u)
+#endif /* (LOOP_STATS_ENABLE != 0u) */
+#define BUFFER_SIZE                 (MAILBOX_SIZE + LOOP_STATS_SIZE)
+#define READ_ONLY_OFFSET            (1u)
+#define TOTAL_CAPSENSE_BUTTONS      (3u)
+#define SLIDER_SENSOR_COUNT         (6u)
+
+/* I2C buffer index */
+#define CONFIG_INDEX                (0u)
+#define MAILBOX_GEN_HEAD_INDEX      (1u)
+#define SLIDER_GESTURE_INDEX        (2u)
+#define BUTTON_COUNT_INDEX          (3u)
+#define BUTTON_STATUS_INDEX1        (4u)
+#define STATUS_FLAGS_INDEX          (5u)
+#define SLIDER_PARAM_INDEX          (6u)
+#define SLIDER_SEQUENCE_INDEX       (7u)
+#define MAILBOX_GEN_TAIL_INDEX      (MAILBOX_SIZE - 1u)
+#define STATS_SCAN_RATE_INDEX       (MAILBOX_SIZE)
+#define STATS_PUBLISH_RATE_INDEX    (MAILBOX_SIZE + 2u)
+#define STATS_GESTURE_LATENCY_INDEX (MAILBOX_SIZE + 4u)
+#define STATS_STARTUP_TIME_INDEX    (MAILBOX_SIZE + 6u)
+
+/* Stores one byte of a publication. The host tests replace it to interleave
+*  master reads with the publication. */
+#if !defined(MAILBOX_STORE)
+    #define MAILBOX_STORE(index, value) (i2cBuffer[(index)] = (value))
+#endif /* !defined(MAILBOX_STORE) */
+
+/* Statistics measurement period in milliseconds */
+#define STATS_PERIOD                (1000u)
+
+/* Configuration byte fields */
+#define CONFIG_FILTER_PROFILE_MASK  (0x01u)
+#define CONFIG_SCAN_TIER_MASK       (0x06u) /* Scan period while idle: 0 = continuous, 1 = 20 ms, 2 = 50 ms */
+#define CONFIG_SCAN_TIER_SHIFT      (1u)
+#define CONFIG_LED_OFF_MASK         (0x08u)
+#define CONFIG_WRITTEN_MASK         (0x80u) /* Set by the master in every write, clear after power-on */
+
+/* Milliseconds the LED of a swipe direction stays lit */
+#define SWIPE_LED_TIME              (500u)
+
+/* Status flags */
+#define STATUS_FLAG_APPROACH        (0x01u)
+
+/* Proximity detection on the sum of all sensor difference counts */
+#define PROXIMITY_THRESHOLD         (30u)   /* Summed difference counts that signal an approaching hand */
+#define PROXIMITY_HOLD_TIME         (2000u) /* Milliseconds the flag is held after the hand has gone */
+
+/* Watchdog compares only the low 12 bits of the ILO count: a match every
+*  102 ms, the device resets after the third unserviced match */
+#define WATCHDOG_IGNORE_BITS        (4u)
+#define INITIALIZED_VAL             (0u)
+#define SET_BIT(data, bitPosition)  ((data) |= (1 << (bitPosition)))
+#define CLEAR_BIT(data, bitPosition)((data) &= (~(1 << (bitPosition))))
+
+/* Holds value for time stamp count */
+#if (TIMESTAMP_METHOD == USING_APP_TIMESTAMP)
+    uint32 appTimestamp;
+#endif
+
+/* Buffer exposed to the I2C master. Only PublishMailbox() writes it. */
+volatile uint8 i2cBuffer[BUFFER_SIZE] = {FILTER_DEFAULT_PROFILE,INITIALIZED_VAL,INITIALIZED_VAL,
+                                         TOTAL_CAPSENSE_BUTTONS,INITIALIZED_VAL,INITIALIZED_VAL,
+                                         INITIALIZED_VAL,INITIALIZED_VAL,INITIALIZED_VAL};
+
+/* Snapshot of the current scan, built by the main loop before publication */
+uint8 mailboxSnapshot[MAILBOX_SIZE] = {FILTER_DEFAULT_PROFILE,INITIALIZED_VAL,INITIALIZED_VAL,
+                                      TOTAL_CAPSENSE_BUTTONS,INITIALIZED_VAL,INITIALIZED_VAL,
+                                      INITIALIZED_VAL,INITIALIZED_VAL,INITIALIZED_VAL};
+
+/* Milliseconds from one scan start to the next while no hand is near */
+static const uint8 scanPeriods[] = {0u, 20u, 50u, 50u};
+uint8 scanPeriod = 0u;
+uint32 frameStart = INITIALIZED_VAL;    /* Timestamp of the scan start of the first widget */
+
+/* Feedback LEDs enabled by the master, and start of the last swipe indication */
+uint8 ledFeedback = 1u;
+uint32 swipeLedTime = INITIALIZED_VAL;
+
+/* Adaptive filter state of the buttons and of the slider peak signal */
+FILTER_CHANNEL_T buttonFilter[TOTAL_CAPSENSE_BUTTONS];
+FILTER_CHANNEL_T sliderFilter;
+FILTER_CHANNEL_T proximityFilter;
+
+/* Function declaration */
+void LED_Control(uint8 buttonStatus, uint32 timestamp);
+uint8 FilterButtons(void);
+uint8 FilterSlider(void);
+uint8 DetectApproach(uint32 timestamp);
+void ApplyConfig(void);
+void WaitScanPeriod(uint8 active);
+void StartScan(uint8 widgetId);
+uint8 PublishMailbox(void);
+#if (LOOP_STATS_ENABLE != 0u)
+void UpdateLoopStats(uint32 timestamp, uint8 published);
+void WriteStat(uint8 index, uint32 value);
+#endif /* (LOOP_STATS_ENABLE != 0u) */
+void timeStampSetup(void);
+void timeStampUpdate(void);
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  The main function performs the following actions:
+*   1. Starts all hardware Components
+*   2. Starts the timestamp
+*   3. Scans the CapSense widgets one after another, each widget is
+*      processed while the next one scans
+*   4. Once the last widget is processed, starts the scan of the next
+*      frame and updates the time stamp
+*   5. Runs the adaptive filter on buttons and slider
+*   6. Checks if there was a gesture
+*   7. Publishes the complete scan snapshot to the I2C buffer
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+int main(void)
+{
+    /* Stores the current gesture */
+    GESTURE_EVENT_T detectedGesture;
+    uint8 widgetID = 0;
+    uint8 buttonStatus = 0;
+    uint16 sliderPosition;
+    uint8 published;
+    uint8 gestureFound;
+    uint8 scanWidget = 0u;
+    uint8 frameActive = 1u;
+#if (LOOP_STATS_ENABLE != 0u)
+    uint32 touchStart = 0u;
+    uint8 touched = 0u;
+#endif /* (LOOP_STATS_ENABLE != 0u) */
+
+    CyGlobalIntEnable; /* Enable global interrupts. */
+
+    /* Starts all Components in hardware */
+    EZI2C_Start();
+    Tuning_Start();
+
+    /* Start user selected timestamp */
+    timeStampSetup();
+#if (PROFILE_ENABLE != 0u)
+    Profile_Init();
+#endif /* (PROFILE_ENABLE != 0u) */
+    Gesture_Init();
+    for(widgetID = 0; widgetID < TOTAL_CAPSENSE_BUTTONS; widgetID++)
+    {
+        Filter_InitChannel(&buttonFilter[widgetID]);
+    }
+    Filter_InitChannel(&sliderFilter);
+    Filter_InitChannel(&proximityFilter);
+
+    /* Set up communication data buffer with CapSense slider centroid 
+        position and button status to be exposed to EZ-BLE Module on CY8CKIT-149 PSoC 4100S Plus Prototyping Kit */
+    EZI2C_EzI2CSetBuffer1(sizeof(i2cBuffer), READ_ONLY_OFFSET, i2cBuffer);
+
+    StartScan(scanWidget);
+
+    /* Resets the MCU when scans stop completing; the BLE MCU restores the configuration */
+    CySysWdtSetIgnoreBits(WATCHDOG_IGNORE_BITS);
+    CySysWdtEnable();
+
+    for(;;)
+    { 
+        /* Checks to make sure that the scan is done before processing data */
+        if(CapSense_NOT_BUSY == CapSense_IsBusy())
+        {  
+            CySysWdtClearInterrupt();
+
+        #if (SCAN_PIPELINE_ENABLE != 0u)
+            /* Scans the next widget while the one just scanned is processed. The
+                first widget of the next frame scans during the frame work below,
+                unless an idle scan period has to pass first. */
+            widgetID = scanWidget++;
+            if((scanWidget < CapSense_TOTAL_WIDGETS) || (frameActive != 0u) || (scanPeriod == 0u))
+            {
+                scanWidget %= CapSense_TOTAL_WIDGETS;
+                StartScan(scanWidget);
+            }
+
+            PROFILE_BEGIN(PROFILE_PROCESS_WIDGET);
+            CapSense_ProcessWidget(widgetID);
+            PROFILE_END(PROFILE_PROCESS_WIDGET);
+            if(widgetID != (CapSense_TOTAL_WIDGETS - 1u))
+            {
+                continue;
+            }
+        #else
+            /* Processes the frame of CapSense_ScanAllWidgets(), the next one
+                starts after the frame work */
+            PROFILE_BEGIN(PROFILE_PROCESS_WIDGET);
+            (void)CapSense_ProcessAllWidgets();
+            PROFILE_END(PROFILE_PROCESS_WIDGET);
+            scanWidget = CapSense_TOTAL_WIDGETS;
+        #endif /* (SCAN_PIPELINE_ENABLE != 0u) */
+
+            /* Updates the selected timestamp */
+            timeStampUpdate();
+            Tuning_FirstScan();
+
+            /* Picks up a filter profile change requested by the master */
+            ApplyConfig();
+
+            /* Signals an approaching hand before the touch lands */
+            mailboxSnapshot[STATUS_FLAGS_INDEX] = DetectApproach(CapSense_dsRam.timestamp);
+
+            /* Feeds the slider centroid to the gesture engine while the filter reports a touch */
+            sliderPosition = CapSense_SLIDER_NO_TOUCH;
+            if(FilterSlider() != 0u)
+            {
+                sliderPosition = CapSense_GetCentroidPos(CapSense_LINEARSLIDER0_WDGT_ID);
+            }
+        #if (LOOP_STATS_ENABLE != 0u)
+            if((sliderPosition != CapSense_SLIDER_NO_TOUCH) && (touched == 0u))
+            {
+                touchStart = CapSense_dsRam.timestamp;
+            }
+            touched = (sliderPosition != CapSense_SLIDER_NO_TOUCH) ? 1u : 0u;
+        #endif /* (LOOP_STATS_ENABLE != 0u) */
+            PROFILE_BEGIN(PROFILE_GESTURE);
+            gestureFound = Gesture_Process(sliderPosition, CapSense_dsRam.timestamp, &detectedGesture);
+            PROFILE_END(PROFILE_GESTURE);
+            if(gestureFound != 0u)
+            {
+                mailboxSnapshot[SLIDER_GESTURE_INDEX] = detectedGesture.type;
+                mailboxSnapshot[SLIDER_PARAM_INDEX] = detectedGesture.param;
+                mailboxSnapshot[SLIDER_SEQUENCE_INDEX]++;
+            #if (LOOP_STATS_ENABLE != 0u)
+                WriteStat(STATS_GESTURE_LATENCY_INDEX, CapSense_dsRam.timestamp - touchStart);
+            #endif /* (LOOP_STATS_ENABLE != 0u) */
+
+                /* Lights the LED of the swipe direction for SWIPE_LED_TIME */
+                if((ledFeedback != 0u) && (detectedGesture.type == GESTURE_SWIPE_RIGHT))
+                {
+                    Right_LED_Write(LED_ON);
+                    swipeLedTime = CapSense_dsRam.timestamp;
+                }
+                else if((ledFeedback != 0u) && (detectedGesture.type == GESTURE_SWIPE_LEFT))
+                {
+                    Left_LED_Write(LED_ON);
+                    swipeLedTime = CapSense_dsRam.timestamp;
+                }
+                else
+                {
+                    /* No LED for this gesture */
+                }
+            }
+
+            /* Calculate the button status mask from the filtered signals
+                bit0= BTN0 status, bit1 = BTN1 status, bit2 = BTN2 status */
+            buttonStatus = FilterButtons();
+
+            LED_Control(buttonStatus, CapSense_dsRam.timestamp);
+
+            mailboxSnapshot[BUTTON_STATUS_INDEX1] = buttonStatus;
+
+            /* Make the gesture and button status of this scan visible to the master at once */
+            published = PublishMailbox();
+        #if (LOOP_STATS_ENABLE != 0u)
+            UpdateLoopStats(CapSense_dsRam.timestamp, published);
+        #else
+            (void)published;
+        #endif /* (LOOP_STATS_ENABLE != 0u) */
+
+            frameActive = mailboxSnapshot[STATUS_FLAGS_INDEX] | buttonStatus |
+                          (uint8)(sliderPosition != CapSense_SLIDER_NO_TOUCH);
+            if(scanWidget == CapSense_TOTAL_WIDGETS)
+            {
+                /* Slows down scanning while idle in the power saving tiers */
+                WaitScanPeriod(frameActive);
+                scanWidget = 0u;
+                StartScan(scanWidget);
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: timeStampSetup
+********************************************************************************
+* Summary:
+*  The timeStampSetup function performs the following actions:
+*   1. Checks which timestamp method is used
+*   2. Starts selected timestamp
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void timeStampSetup()
+{
+    /* Sets up a callback function using sysTick timer isr */
+    #if(TIMESTAMP_METHOD == USING_SYS_TICK_CALLBACK)
+        CapSense_dsRam.timestampInterval = 1u;
+        CySysTickStart();
+        CySysTickSetCallback(0u, CapSense_IncrementGestureTimestamp);
+    #endif
+
+    /* Update the timestamp interval depending on mainloop period */
+    #if(TIMESTAMP_METHOD == USING_MAIN_LOOP)
+        CapSense_dsRam.timestampInterval = 2u;
+    #endif
+
+    /* Creates a counter to keep track of current time */
+    #if(TIMESTAMP_METHOD == USING_APP_TIMESTAMP)
+        appTimestamp = 0;
+    #endif
+}
+
+/*******************************************************************************
+* Function Name: timeStampUpdate
+********************************************************************************
+* Summary:
+*  The timeStampUpdate function performs the following actions:
+*   1. Update user selected timestamp
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void timeStampUpdate()
+{
+    /* Update component timestamp using mainloop */
+    #if(TIMESTAMP_METHOD == USING_MAIN_LOOP)
+        CapSense_IncrementGestureTimestamp();
+    #endif
+
+    /* Update the counter and set the timestamp with component function */
+    #if(TIMESTAMP_METHOD == USING_APP_TIMESTAMP)
+        appTimestamp += 3u;
+        CapSense_SetGestureTimestamp(appTimestamp);
+    #endif
+}
+
+
+/*******************************************************************************
+* Function Name: PublishMailbox
+********************************************************************************
+* Summary:
+*  Copies the scan snapshot into the I2C buffer when it has changed. The EZI2C
+*  interrupt may serve a master read at any time, so the generation is written
+*  to the tail first and to the head last. The master reads the buffer from 
+*  head to tail and sees equal copies only if no publication overlapped its
+*  read; otherwise it retries.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Non-zero if the snapshot was published.
+*
+*******************************************************************************/
+uint8 PublishMailbox(void)
+{
+    static uint8 generation = INITIALIZED_VAL;
+    uint8 index;
+    uint8 changed = 0u;
+
+    for(index = MAILBOX_GEN_HEAD_INDEX + 1u; index < MAILBOX_GEN_TAIL_INDEX; index++)
+    {
+        if(i2cBuffer[index] != mailboxSnapshot[index])
+        {
+            changed = 1u;
+        }
+    }
+
+    if(changed != 0u)
+    {
+        generation++;
+        MAILBOX_STORE(MAILBOX_GEN_TAIL_INDEX, generation);
+        for(index = MAILBOX_GEN_HEAD_INDEX + 1u; index < MAILBOX_GEN_TAIL_INDEX; index++)
+        {
+            MAILBOX_STORE(index, mailboxSnapshot[index]);
+        }
+        MAILBOX_STORE(MAILBOX_GEN_HEAD_INDEX, generation);
+    }
+
+    return (changed);
+}
+
+#if (LOOP_STATS_ENABLE != 0u)
+/*******************************************************************************
+* Function Name: UpdateLoopStats
+********************************************************************************
+* Summary:
+*  Counts scans and publications and writes their rate to the statistics area
+*  of the I2C buffer once per STATS_PERIOD. The statistics are not covered by
+*  the mailbox generation; a master read may see one value half updated.
+*
+* Parameters:
+*  timestamp - current time in milliseconds
+*  published - non-zero if this scan published the mailbox
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void UpdateLoopStats(uint32 timestamp, uint8 published)
+{
+    static uint32 periodStart = INITIALIZED_VAL;
+    static uint32 scans = INITIALIZED_VAL;
+    static uint32 publications = INITIALIZED_VAL;
+
+    scans++;
+    if(published != 0u)
+    {
+        publications++;
+    }
+    if((timestamp - periodStart) >= STATS_PERIOD)
+    {
+        WriteStat(STATS_SCAN_RATE_INDEX, scans);
+        WriteStat(STATS_PUBLISH_RATE_INDEX, publications);
+        WriteStat(STATS_STARTUP_TIME_INDEX, Tuning_startupTime);
+        periodStart = timestamp;
+        scans = INITIALIZED_VAL;
+        publications = INITIALIZED_VAL;
+    }
+}
+
+/*******************************************************************************
+* Function Name: WriteStat
+********************************************************************************
+* Summary:
+*  Writes a statistics value to the I2C buffer, saturated to 16 bits.
+*
+* Parameters:
+*  index - buffer index of the low byte
+*  value - value to write
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void WriteStat(uint8 index, uint32 value)
+{
+    if(value > 0xFFFFu)
+    {
+        value = 0xFFFFu;
+    }
+    i2cBuffer[index] = (uint8)value;
+    i2cBuffer[index + 1u] = (uint8)(value >> 8u);
+}
+#endif /* (LOOP_STATS_ENABLE != 0u) */
+
+
+/*******************************************************************************
+* Function Name: FilterButtons
+********************************************************************************
+* Summary:
+*  Runs the difference counts of the buttons through the adaptive filter.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Button status mask: bit0= BTN0 status, bit1 = BTN1 status, bit2 = BTN2 status
+*
+*******************************************************************************/
+uint8 FilterButtons(void)
+{
+    uint8 buttonStatus = 0u;
+
+    if(Filter_Process(&buttonFilter[CapSense_BTN0_WDGT_ID], CapSense_dsRam.snsList.btn0[0u].diff,
+                      CapSense_dsRam.wdgtList.btn0.fingerTh) != 0u)
+    {
+        SET_BIT(buttonStatus, CapSense_BTN0_WDGT_ID);
+    }
+    if(Filter_Process(&buttonFilter[CapSense_BTN1_WDGT_ID], CapSense_dsRam.snsList.btn1[0u].diff,
+                      CapSense_dsRam.wdgtList.btn1.fingerTh) != 0u)
+    {
+        SET_BIT(buttonStatus, CapSense_BTN1_WDGT_ID);
+    }
+    if(Filter_Process(&buttonFilter[CapSense_BTN2_WDGT_ID], CapSense_dsRam.snsList.btn2[0u].diff,
+                      CapSense_dsRam.wdgtList.btn2.fingerTh) != 0u)
+    {
+        SET_BIT(buttonStatus, CapSense_BTN2_WDGT_ID);
+    }
+
+    return (buttonStatus);
+}
+
+/*******************************************************************************
+* Function Name: FilterSlider
+********************************************************************************
+* Summary:
+*  Runs the strongest slider segment through the adaptive filter.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Non-zero while the slider is touched.
+*
+*******************************************************************************/
+uint8 FilterSlider(void)
+{
+    uint16 peak = 0u;
+    uint8 sensor;
+
+    for(sensor = 0u; sensor < SLIDER_SENSOR_COUNT; sensor++)
+    {
+        if(CapSense_dsRam.snsList.linearslider0[sensor].diff > peak)
+        {
+            peak = CapSense_dsRam.snsList.linearslider0[sensor].diff;
+        }
+    }
+
+    return (Filter_Process(&sliderFilter, peak, CapSense_dsRam.wdgtList.linearslider0.fingerTh));
+}
+
+/*******************************************************************************
+* Function Name: DetectApproach
+********************************************************************************
+* Summary:
+*  Gangs all button and slider sensors into one proximity channel. The sum of
+*  their difference counts rises when a hand approaches, well before any
+*  single sensor reaches its finger threshold. The flag is held for
+*  PROXIMITY_HOLD_TIME after the signal has gone to avoid toggling it while
+*  the hand hovers at the edge of the range.
+*
+* Parameters:
+*  timestamp - current time in milliseconds
+*
+* Return:
+*  STATUS_FLAG_APPROACH while a hand is near, otherwise zero.
+*
+*******************************************************************************/
+uint8 DetectApproach(uint32 timestamp)
+{
+    static uint32 lastSeen = INITIALIZED_VAL;
+    static uint8 approach = INITIALIZED_VAL;
+    uint32 sum;
+    uint8 sensor;
+
+    sum = (uint32)CapSense_dsRam.snsList.btn0[0u].diff + CapSense_dsRam.snsList.btn1[0u].diff +
+          CapSense_dsRam.snsList.btn2[0u].diff;
+    for(sensor = 0u; sensor < SLIDER_SENSOR_COUNT; sensor++)
+    {
+        sum += CapSense_dsRam.snsList.linearslider0[sensor].diff;
+    }
+    if(sum > 0xFFFFu)
+    {
+        sum = 0xFFFFu;
+    }
+
+    if(Filter_Process(&proximityFilter, (uint16)sum, PROXIMITY_THRESHOLD) != 0u)
+    {
+        lastSeen = timestamp;
+        approach = STATUS_FLAG_APPROACH;
+    }
+    else if((timestamp - lastSeen) > PROXIMITY_HOLD_TIME)
+    {
+        approach = INITIALIZED_VAL;
+    }
+
+    return (approach);
+}
+
+/*******************************************************************************
+* Function Name: ApplyConfig
+********************************************************************************
+* Summary:
+*  Applies the configuration byte written by the I2C master.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void ApplyConfig(void)
+{
+    uint8 config = i2cBuffer[CONFIG_INDEX];
+
+    if((config & CONFIG_FILTER_PROFILE_MASK) != Filter_GetProfile())
+    {
+        Filter_SetProfile(config & CONFIG_FILTER_PROFILE_MASK);
+    }
+    scanPeriod = scanPeriods[(config & CONFIG_SCAN_TIER_MASK) >> CONFIG_SCAN_TIER_SHIFT];
+    ledFeedback = ((config & CONFIG_LED_OFF_MASK) == 0u) ? 1u : 0u;
+}
+
+/*******************************************************************************
+* Function Name: WaitScanPeriod
+********************************************************************************
+* Summary:
+*  Sleeps until scanPeriod has passed since the previous frame start. The
+*  SysTick timestamp interrupt wakes the CPU every millisecond. Scanning
+*  continues at full rate while a hand is near or a sensor is touched.
+*
+* Parameters:
+*  active - non-zero while a hand is near or a sensor is touched
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void WaitScanPeriod(uint8 active)
+{
+    if(active == 0u)
+    {
+        while((CapSense_dsRam.timestamp - frameStart) < scanPeriod)
+        {
+            CySysPmSleep();
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: StartScan
+********************************************************************************
+* Summary:
+*  Starts the scan of one widget. The scan of the first widget starts a frame.
+*  Without SCAN_PIPELINE_ENABLE the frame scans all widgets at once.
+*
+* Parameters:
+*  widgetId - widget to scan, 0 without SCAN_PIPELINE_ENABLE
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void StartScan(uint8 widgetId)
+{
+    if(widgetId == 0u)
+    {
+        frameStart = CapSense_dsRam.timestamp;
+    }
+#if (SCAN_PIPELINE_ENABLE != 0u)
+    (void)CapSense_SetupWidget(widgetId);
+    (void)CapSense_Scan();
+#else
+    (void)CapSense_ScanAllWidgets();
+#endif /* (SCAN_PIPELINE_ENABLE != 0u) */
+}
+
+
+/*******************************************************************************
+* Function Name: LED_Control
+********************************************************************************
+* Summary:
+*  Lights the LEDs of the touched buttons while the master allows feedback
+*  LEDs and turns the swipe LEDs off once SWIPE_LED_TIME has passed.
+*
+* Parameters:
+*  buttonStatus - touched button mask
+*  timestamp - CapSense timestamp in milliseconds
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void LED_Control(uint8 buttonStatus, uint32 timestamp)
+{
+    if(ledFeedback == 0u)
+    {
+        buttonStatus = 0u;
+    }
+
+    /* Turn ON/OFF LEDs based on the status of the corresponding CapSense buttons */
+    LED_11_Write((buttonStatus & (1u << CapSense_BTN0_WDGT_ID)) ? LED_ON : LED_OFF );
+    LED_12_Write((buttonStatus & (1u << CapSense_BTN1_WDGT_ID)) ? LED_ON : LED_OFF );
+    LED_13_Write((buttonStatus & (1u << CapSense_BTN2_WDGT_ID)) ? LED_ON : LED_OFF );
+    if((ledFeedback == 0u) || ((timestamp - swipeLedTime) >= SWIPE_LED_TIME))
+    {
+        Left_LED_Write(LED_OFF);
+        Right_LED_Write(LED_OFF);
+    }
+}
@@ -0,0 +1,105 @@
+/*******************************************************************************
+* File Name: profile.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the micro-profiler. The Cortex-M0+ has no cycle
+*  counter and SysTick already runs the 1 ms gesture timestamp, so the time
+*  base combines the timestamp with the SysTick count inside the current
+*  millisecond. The results stay in Profile_scopes[] for the debugger.
+*
+* Hardware Dependency:
+*  CY8CKIT-149 PSoC 4100S Plus Prototyping Kit
+*
+*******************************************************************************/
+
+#include "profile.h"
+
+#if (PROFILE_ENABLE != 0u)
+
+PROFILE_SCOPE_T Profile_scopes[PROFILE_SCOPE_COUNT];
+
+static uint32 profilePeriod;    /* HFCLK cycles per SysTick period */
+
+
+/*******************************************************************************
+* Function Name: Profile_Init()
+********************************************************************************
+*
+* Summary:
+*   Clears all scopes. Called after the SysTick timestamp has been started.
+*
+*******************************************************************************/
+void Profile_Init(void)
+{
+    uint8 scope;
+
+    profilePeriod = CySysTickGetReload() + 1u;
+    for(scope = 0u; scope < PROFILE_SCOPE_COUNT; scope++)
+    {
+        Profile_scopes[scope].calls = 0u;
+        Profile_scopes[scope].min = 0xFFFFFFFFu;
+        Profile_scopes[scope].max = 0u;
+        Profile_scopes[scope].total = 0u;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Profile_Now()
+********************************************************************************
+*
+* Summary:
+*   Returns the time in HFCLK cycles, modulo 2^32. The read is repeated when
+*   the timestamp interrupt ran in between.
+*
+*******************************************************************************/
+uint32 Profile_Now(void)
+{
+    uint32 ms;
+    uint32 count;
+
+    do
+    {
+        ms = CapSense_dsRam.timestamp;
+        count = CY_SYS_SYST_CVR_REG;
+    }
+    while(ms != CapSense_dsRam.timestamp);
+
+    return ((ms * profilePeriod) + (profilePeriod - 1u - count));
+}
+
+
+/*******************************************************************************
+* Function Name: Profile_Add()
+********************************************************************************
+*
+* Summary:
+*   Adds one measured duration to a scope. Called by PROFILE_END().
+*
+* Parameters:
+*  scope - one of the PROFILE_xxx scopes
+*  cycles - duration in HFCLK cycles
+*
+*******************************************************************************/
+void Profile_Add(uint8 scope, uint32 cycles)
+{
+    PROFILE_SCOPE_T *entry = &Profile_scopes[scope];
+
+    entry->calls++;
+    entry->total += cycles;
+    if(cycles < entry->min)
+    {
+        entry->min = cycles;
+    }
+    if(cycles > entry->max)
+    {
+        entry->max = cycles;
+    }
+}
+
+#endif /* (PROFILE_ENABLE != 0u) */
+
+
+/* [] END OF FILE */
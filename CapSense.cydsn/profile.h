@@ -0,0 +1,74 @@
+/*******************************************************************************
+* File Name: profile.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the scope macros, function prototypes and constants of the
+*  SysTick based micro-profiler.
+*
+*******************************************************************************/
+
+#if !defined(PROFILE_H)
+#define PROFILE_H
+
+#include "project.h"
+
+
+/***************************************
+*  Conditional Compilation Parameters
+***************************************/
+#if !defined(PROFILE_ENABLE)
+#define PROFILE_ENABLE              (0u)    /* Set to 1 to time the profiled scopes into Profile_scopes[] */
+#endif /* !defined(PROFILE_ENABLE) */
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Profiled scopes */
+#define PROFILE_PROCESS_WIDGET      (0u)    /* CapSense_ProcessWidget(), all widgets without SCAN_PIPELINE_ENABLE */
+#define PROFILE_GESTURE             (1u)    /* Gesture_Process() */
+#define PROFILE_SCOPE_COUNT         (2u)
+
+
+/***************************************
+*        Data Types
+***************************************/
+typedef struct
+{
+    uint32 calls;
+    uint32 min;                 /* HFCLK cycles */
+    uint32 max;
+    uint64 total;
+} PROFILE_SCOPE_T;
+
+
+/***************************************
+*        Macros
+***************************************/
+#if (PROFILE_ENABLE != 0u)
+    #define PROFILE_BEGIN(scope)    uint32 profileStart##scope = Profile_Now()
+    #define PROFILE_END(scope)      Profile_Add((scope), Profile_Now() - profileStart##scope)
+#else
+    #define PROFILE_BEGIN(scope)
+    #define PROFILE_END(scope)
+#endif /* (PROFILE_ENABLE != 0u) */
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+#if (PROFILE_ENABLE != 0u)
+void Profile_Init(void);
+uint32 Profile_Now(void);
+void Profile_Add(uint8 scope, uint32 cycles);
+
+extern PROFILE_SCOPE_T Profile_scopes[PROFILE_SCOPE_COUNT];
+#endif /* (PROFILE_ENABLE != 0u) */
+
+#endif /* PROFILE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,386 @@
+/*******************************************************************************
+* File Name: tuning.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the CapSense tuning cache. The widget and sensor
+*  parameters set by SmartSense and the IDAC calibration are saved to flash
+*  once, and later starts restore them instead of tuning again. Runtime
+*  state such as baselines and debounce counters is not cached. A restored
+*  tuning is used only when its CRC, the design it was made for and a scan
+*  of all sensors agree with it; otherwise the component is calibrated and
+*  the cache rewritten. The time from Tuning_Start() to the first processed
+*  scan is kept in Tuning_startupTime.
+*
+* Hardware Dependency:
+*  CY8CKIT-149 PSoC 4100S Plus Prototyping Kit
+*
+*******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+#include "tuning.h"
+
+/* Copies the tuned parameters of one widget between the CapSense data
+*  structure and a TUNING_WIDGET_T. Button and slider widgets have
+*  different types but the same field names. */
+#define TUNING_GET_WIDGET(cached, wdgt) \
+    do { \
+        (cached).resolution = (wdgt).resolution; \
+        (cached).snsClk = (wdgt).snsClk; \
+        (cached).fingerTh = (wdgt).fingerTh; \
+        (cached).noiseTh = (wdgt).noiseTh; \
+        (cached).nNoiseTh = (wdgt).nNoiseTh; \
+        (cached).hysteresis = (wdgt).hysteresis; \
+        (cached).snsClkSource = (wdgt).snsClkSource; \
+        (cached).idacMod = (wdgt).idacMod[0u]; \
+        (cached).idacGainIndex = (wdgt).idacGainIndex; \
+    } while(0)
+
+#define TUNING_SET_WIDGET(wdgt, cached) \
+    do { \
+        (wdgt).resolution = (cached).resolution; \
+        (wdgt).snsClk = (cached).snsClk; \
+        (wdgt).fingerTh = (cached).fingerTh; \
+        (wdgt).noiseTh = (cached).noiseTh; \
+        (wdgt).nNoiseTh = (cached).nNoiseTh; \
+        (wdgt).hysteresis = (cached).hysteresis; \
+        (wdgt).snsClkSource = (cached).snsClkSource; \
+        (wdgt).idacMod[0u] = (cached).idacMod; \
+        (wdgt).idacGainIndex = (cached).idacGainIndex; \
+    } while(0)
+
+uint8 Tuning_source = TUNING_SOURCE_NO_CACHE;
+uint16 Tuning_startupTime = 0u;     /* Milliseconds, 0 until the first scan */
+
+static volatile uint32 tuningTime;  /* Milliseconds since Tuning_Start() */
+static uint8 tuningTimeRunning = 0u;
+
+#if (TUNING_CACHE_ENABLE != 0u)
+/* Flash rows holding the cache, zero in a freshly programmed device */
+static const volatile uint8 CY_ALIGN(CY_FLASH_SIZEOF_ROW) tuningFlash[TUNING_CACHE_ROWS * CY_FLASH_SIZEOF_ROW] = {0u};
+
+/* RAM image of the flash rows */
+static union
+{
+    TUNING_CACHE_T cache;
+    uint8 rows[TUNING_CACHE_ROWS][CY_FLASH_SIZEOF_ROW];
+    uint8 bytes[TUNING_CACHE_ROWS * CY_FLASH_SIZEOF_ROW];
+} tuningImage;
+
+static void Tuning_ScanAll(uint16 raw[]);
+static void Tuning_Save(const uint16 raw[]);
+static void Tuning_Restore(const TUNING_CACHE_T *cache);
+#endif /* (TUNING_CACHE_ENABLE != 0u) */
+static void Tuning_Tick(void);
+
+
+/*******************************************************************************
+* Function Name: Tuning_Start()
+********************************************************************************
+*
+* Summary:
+*   Starts the CapSense component, from the cached tuning when it is valid
+*   and with a full calibration otherwise. Called in place of
+*   CapSense_Start().
+*
+*******************************************************************************/
+void Tuning_Start(void)
+{
+#if (TUNING_CACHE_ENABLE != 0u)
+    uint16 raw[TUNING_SENSOR_COUNT];
+    uint32 index;
+#endif /* (TUNING_CACHE_ENABLE != 0u) */
+
+    tuningTime = 0u;
+    tuningTimeRunning = 1u;
+    CySysTickStart();
+    CySysTickSetCallback(TUNING_SYSTICK_CALLBACK, Tuning_Tick);
+
+#if (TUNING_CACHE_ENABLE != 0u)
+    for(index = 0u; index < sizeof(tuningImage); index++)
+    {
+        tuningImage.bytes[index] = tuningFlash[index];
+    }
+
+    (void)CapSense_Initialize();
+    if(Tuning_Validate(&tuningImage.cache, CapSense_dsRam.configId) == 0u)
+    {
+        Tuning_source = TUNING_SOURCE_NO_CACHE;
+    }
+    else
+    {
+        Tuning_Restore(&tuningImage.cache);
+        Tuning_ScanAll(raw);
+        Tuning_source = (Tuning_CheckRaw(tuningImage.cache.raw, raw) != 0u) ?
+                        TUNING_SOURCE_CACHE : TUNING_SOURCE_DRIFT;
+    }
+
+    if(Tuning_source != TUNING_SOURCE_CACHE)
+    {
+        if(CapSense_Start() == CYRET_SUCCESS)
+        {
+            Tuning_ScanAll(raw);
+            Tuning_Save(raw);
+        }
+    }
+    CapSense_InitializeAllBaselines();
+#else
+    (void)CapSense_Start();
+#endif /* (TUNING_CACHE_ENABLE != 0u) */
+}
+
+
+/*******************************************************************************
+* Function Name: Tuning_FirstScan()
+********************************************************************************
+*
+* Summary:
+*   Records the startup time on the first call. Called each time a scan of
+*   all widgets has been processed.
+*
+*******************************************************************************/
+void Tuning_FirstScan(void)
+{
+    if(tuningTimeRunning != 0u)
+    {
+        tuningTimeRunning = 0u;
+        CySysTickClearCallback(TUNING_SYSTICK_CALLBACK);
+        Tuning_startupTime = (tuningTime > 0xFFFFu) ? 0xFFFFu : (uint16)tuningTime;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Tuning_Validate()
+********************************************************************************
+*
+* Summary:
+*   Checks that a cache was written for this design and is intact.
+*
+* Parameters:
+*  cache - the cache to check
+*  configId - CapSense_dsRam.configId of the running design
+*
+* Return:
+*  Non-zero when the cache may be restored.
+*
+*******************************************************************************/
+uint8 Tuning_Validate(const TUNING_CACHE_T *cache, uint16 configId)
+{
+    return (uint8)((cache->configId == configId) &&
+                   (cache->size == sizeof(TUNING_CACHE_T)) &&
+                   (cache->crc == Tuning_Crc(cache)));
+}
+
+
+/*******************************************************************************
+* Function Name: Tuning_CheckRaw()
+********************************************************************************
+*
+* Summary:
+*   The environmental sanity check: every raw count must be within
+*   1/2^TUNING_RAW_TOLERANCE_SHIFT of the raw count seen after the
+*   calibration. A changed supply, temperature or overlay moves the raw
+*   counts away from the calibration target.
+*
+* Parameters:
+*  expected - raw counts stored with the cache
+*  measured - raw counts of a scan with the restored tuning
+*
+* Return:
+*  Non-zero when all sensors are within the tolerance.
+*
+*******************************************************************************/
+uint8 Tuning_CheckRaw(const uint16 expected[], const uint16 measured[])
+{
+    uint8 sensor;
+    uint16 delta;
+
+    for(sensor = 0u; sensor < TUNING_SENSOR_COUNT; sensor++)
+    {
+        delta = (measured[sensor] > expected[sensor]) ? (measured[sensor] - expected[sensor]) :
+                                                        (expected[sensor] - measured[sensor]);
+        if(delta > (expected[sensor] >> TUNING_RAW_TOLERANCE_SHIFT))
+        {
+            return 0u;
+        }
+    }
+    return 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: Tuning_Crc()
+********************************************************************************
+*
+* Summary:
+*   Computes the CRC-16-CCITT of a cache, over everything that follows the
+*   crc field: the header, the raw counts and the tuning parameters.
+*
+* Parameters:
+*  cache - the cache to compute the CRC of
+*
+* Return:
+*  The CRC.
+*
+*******************************************************************************/
+uint16 Tuning_Crc(const TUNING_CACHE_T *cache)
+{
+    const uint8 *data = (const uint8 *)&cache->configId;
+    uint32 size = sizeof(TUNING_CACHE_T) - offsetof(TUNING_CACHE_T, configId);
+    uint16 crc = TUNING_CRC_INIT;
+    uint8 bit;
+
+    while(size-- != 0u)
+    {
+        crc ^= (uint16)((uint16)*data++ << 8u);
+        for(bit = 0u; bit < 8u; bit++)
+        {
+            crc = ((crc & 0x8000u) != 0u) ? (uint16)((crc << 1u) ^ TUNING_CRC_POLY) : (uint16)(crc << 1u);
+        }
+    }
+    return crc;
+}
+
+
+#if (TUNING_CACHE_ENABLE != 0u)
+/*******************************************************************************
+* Function Name: Tuning_ScanAll()
+********************************************************************************
+*
+* Summary:
+*   Scans all widgets, waits for the scan to complete and returns the raw
+*   counts of the sensors in the sanity check.
+*
+* Parameters:
+*  raw - receives TUNING_SENSOR_COUNT raw counts
+*
+*******************************************************************************/
+static void Tuning_ScanAll(uint16 raw[])
+{
+    uint8 sensor;
+
+    (void)CapSense_ScanAllWidgets();
+    while(CapSense_IsBusy() != CapSense_NOT_BUSY)
+    {
+    }
+
+    raw[0u] = CapSense_dsRam.snsList.btn0[0u].raw[0u];
+    raw[1u] = CapSense_dsRam.snsList.btn1[0u].raw[0u];
+    raw[2u] = CapSense_dsRam.snsList.btn2[0u].raw[0u];
+    for(sensor = 0u; sensor < TUNING_SLIDER_SENSOR_COUNT; sensor++)
+    {
+        raw[TUNING_BUTTON_COUNT + sensor] = CapSense_dsRam.snsList.linearslider0[sensor].raw[0u];
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Tuning_Save()
+********************************************************************************
+*
+* Summary:
+*   Writes the current tuning to the cache. Rows that already hold the same
+*   data are not written again.
+*
+* Parameters:
+*  raw - raw counts of a scan right after the calibration
+*
+*******************************************************************************/
+static void Tuning_Save(const uint16 raw[])
+{
+    uint32 firstRow = ((uint32)tuningFlash - CY_FLASH_BASE) / CY_FLASH_SIZEOF_ROW;
+    uint32 row;
+    uint32 index;
+
+    TUNING_CACHE_T *cache = &tuningImage.cache;
+    uint8 sensor;
+
+    /* Cleared first, so the padding bytes under the CRC are defined */
+    (void)memset(&tuningImage, 0, sizeof(tuningImage));
+    cache->configId = CapSense_dsRam.configId;
+    cache->size = sizeof(TUNING_CACHE_T);
+    (void)memcpy(cache->raw, raw, sizeof(cache->raw));
+    TUNING_GET_WIDGET(cache->widget[CapSense_BTN0_WDGT_ID], CapSense_dsRam.wdgtList.btn0);
+    TUNING_GET_WIDGET(cache->widget[CapSense_BTN1_WDGT_ID], CapSense_dsRam.wdgtList.btn1);
+    TUNING_GET_WIDGET(cache->widget[CapSense_BTN2_WDGT_ID], CapSense_dsRam.wdgtList.btn2);
+    TUNING_GET_WIDGET(cache->widget[CapSense_LINEARSLIDER0_WDGT_ID], CapSense_dsRam.wdgtList.linearslider0);
+#if (0u != CapSense_CSD_IDAC_COMP_EN)
+    cache->idacComp[0u] = CapSense_dsRam.snsList.btn0[0u].idacComp[0u];
+    cache->idacComp[1u] = CapSense_dsRam.snsList.btn1[0u].idacComp[0u];
+    cache->idacComp[2u] = CapSense_dsRam.snsList.btn2[0u].idacComp[0u];
+    for(sensor = 0u; sensor < TUNING_SLIDER_SENSOR_COUNT; sensor++)
+    {
+        cache->idacComp[TUNING_BUTTON_COUNT + sensor] = CapSense_dsRam.snsList.linearslider0[sensor].idacComp[0u];
+    }
+#else
+    (void)sensor;
+#endif /* (0u != CapSense_CSD_IDAC_COMP_EN) */
+    cache->crc = Tuning_Crc(cache);
+
+    for(row = 0u; row < TUNING_CACHE_ROWS; row++)
+    {
+        for(index = 0u; index < CY_FLASH_SIZEOF_ROW; index++)
+        {
+            if(tuningImage.rows[row][index] != tuningFlash[(row * CY_FLASH_SIZEOF_ROW) + index])
+            {
+                (void)CySysFlashWriteRow(firstRow + row, tuningImage.rows[row]);
+                break;
+            }
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Tuning_Restore()
+********************************************************************************
+*
+* Summary:
+*   Writes the tuning parameters of a validated cache to the CapSense data
+*   structure. The runtime fields keep the values of CapSense_Initialize().
+*
+* Parameters:
+*  cache - the cache to restore
+*
+*******************************************************************************/
+static void Tuning_Restore(const TUNING_CACHE_T *cache)
+{
+    uint8 sensor;
+
+    TUNING_SET_WIDGET(CapSense_dsRam.wdgtList.btn0, cache->widget[CapSense_BTN0_WDGT_ID]);
+    TUNING_SET_WIDGET(CapSense_dsRam.wdgtList.btn1, cache->widget[CapSense_BTN1_WDGT_ID]);
+    TUNING_SET_WIDGET(CapSense_dsRam.wdgtList.btn2, cache->widget[CapSense_BTN2_WDGT_ID]);
+    TUNING_SET_WIDGET(CapSense_dsRam.wdgtList.linearslider0, cache->widget[CapSense_LINEARSLIDER0_WDGT_ID]);
+#if (0u != CapSense_CSD_IDAC_COMP_EN)
+    CapSense_dsRam.snsList.btn0[0u].idacComp[0u] = cache->idacComp[0u];
+    CapSense_dsRam.snsList.btn1[0u].idacComp[0u] = cache->idacComp[1u];
+    CapSense_dsRam.snsList.btn2[0u].idacComp[0u] = cache->idacComp[2u];
+    for(sensor = 0u; sensor < TUNING_SLIDER_SENSOR_COUNT; sensor++)
+    {
+        CapSense_dsRam.snsList.linearslider0[sensor].idacComp[0u] = cache->idacComp[TUNING_BUTTON_COUNT + sensor];
+    }
+#else
+    (void)sensor;
+#endif /* (0u != CapSense_CSD_IDAC_COMP_EN) */
+}
+#endif /* (TUNING_CACHE_ENABLE != 0u) */
+
+
+/*******************************************************************************
+* Function Name: Tuning_Tick()
+********************************************************************************
+*
+* Summary:
+*   SysTick callback counting the startup time.
+*
+*******************************************************************************/
+static void Tuning_Tick(void)
+{
+    tuningTime++;
+}
+
+
+/* [] END OF FILE */
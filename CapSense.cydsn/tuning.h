@@ -0,0 +1,95 @@
+/*******************************************************************************
+* File Name: tuning.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the CapSense tuning
+*  cache.
+*
+*******************************************************************************/
+
+#if !defined(TUNING_H)
+#define TUNING_H
+
+#include "project.h"
+
+
+/***************************************
+*  Conditional Compilation Parameters
+***************************************/
+#define TUNING_CACHE_ENABLE         (1u)    /* Set to 0 to calibrate on every start */
+
+
+/***************************************
+*          Constants
+***************************************/
+
+#define TUNING_CACHE_ROWS           ((sizeof(TUNING_CACHE_T) + CY_FLASH_SIZEOF_ROW - 1u) / CY_FLASH_SIZEOF_ROW)
+
+/* Cached widgets and sensors: three buttons and the slider segments */
+#define TUNING_BUTTON_COUNT         (3u)
+#define TUNING_SLIDER_SENSOR_COUNT  (6u)
+#define TUNING_WIDGET_COUNT         (TUNING_BUTTON_COUNT + 1u)
+#define TUNING_SENSOR_COUNT         (TUNING_BUTTON_COUNT + TUNING_SLIDER_SENSOR_COUNT)
+
+/* A restored tuning is rejected when a raw count moved by more than 1/2^n
+*  from the raw count seen right after the calibration */
+#define TUNING_RAW_TOLERANCE_SHIFT  (3u)
+
+#define TUNING_CRC_INIT             (0xFFFFu)
+#define TUNING_CRC_POLY             (0x1021u)   /* CRC-16-CCITT */
+
+/* SysTick callback slot of the startup time measurement */
+#define TUNING_SYSTICK_CALLBACK     (1u)
+
+/* Tuning_source values */
+#define TUNING_SOURCE_CACHE         (0u)    /* Restored from flash */
+#define TUNING_SOURCE_NO_CACHE      (1u)    /* Calibrated, no valid cache */
+#define TUNING_SOURCE_DRIFT         (2u)    /* Calibrated, the cached tuning failed the sanity check */
+
+
+/***************************************
+*        Data Types
+***************************************/
+/* Widget parameters set by SmartSense and the IDAC calibration */
+typedef struct
+{
+    uint16 resolution;
+    uint16 snsClk;
+    uint16 fingerTh;
+    uint8 noiseTh;
+    uint8 nNoiseTh;
+    uint8 hysteresis;
+    uint8 snsClkSource;
+    uint8 idacMod;
+    uint8 idacGainIndex;
+} TUNING_WIDGET_T;
+
+typedef struct
+{
+    uint16 crc;                                 /* CRC over all fields below */
+    uint16 configId;                            /* CapSense_dsRam.configId of the design that was tuned */
+    uint16 size;                                /* sizeof(TUNING_CACHE_T) */
+    uint16 raw[TUNING_SENSOR_COUNT];            /* Raw counts right after the calibration */
+    TUNING_WIDGET_T widget[TUNING_WIDGET_COUNT];    /* BTN0, BTN1, BTN2, LinearSlider0 */
+    uint8 idacComp[TUNING_SENSOR_COUNT];        /* Compensation IDAC of each sensor */
+} TUNING_CACHE_T;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+void Tuning_Start(void);
+void Tuning_FirstScan(void);
+uint8 Tuning_Validate(const TUNING_CACHE_T *cache, uint16 configId);
+uint8 Tuning_CheckRaw(const uint16 expected[], const uint16 measured[]);
+uint16 Tuning_Crc(const TUNING_CACHE_T *cache);
+
+extern uint8 Tuning_source;
+extern uint16 Tuning_startupTime;
+
+#endif /* TUNING_H */
+
+
+/* [] END OF FILE */
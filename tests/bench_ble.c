@@ -0,0 +1,830 @@
+/*******************************************************************************
+* File Name: bench_ble.c
+*
+* Version 1.0
+*
+* Description:
+*  Benchmark of the BLE firmware on the host simulation. Each session powers
+*  the BLE MCU on, lets a central connect and plays a script of CapSense
+*  mailbox publications, the way the CapSense MCU would publish touches.
+*  The central checks the keys it receives and the time from a publication
+*  to the first report of its key on air. The CPU residency and connection
+*  events give an estimate of the average current. A session may inject one
+*  fault and reports the time the firmware takes to recover from it.
+*
+*  A session runs in a child process, since the firmware keeps its state in
+*  statics and never returns from main(). The firmware debug output goes to
+*  build/bench_ble_<session>.log, the received reports to
+*  build/bench_ble_<session>.reports. The benchmark exits non-zero when a
+*  session sends wrong keys, exceeds its latency limit or ends the wrong way.
+*  The firmware is built with STATS_ENABLE, so a session can compare the
+*  statistics with what the central did.
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "sim/ble.h"
+#include "recovery.h"
+#include "stats.h"
+
+#define BENCH_LOG_DIR               "build"
+#define BENCH_MAX_KEYS              (32u)
+
+/* Typical supply currents of the current estimate, in microamps */
+#define BENCH_ACTIVE_CURRENT        (2500u)     /* CPU running or in Sleep, as in stats.h */
+#define BENCH_DEEP_SLEEP_CURRENT    (2u)
+#define BENCH_RADIO_CURRENT         (5600u)     /* Radio receiving or transmitting at 0 dBm */
+
+/* CapSense mailbox, see I2C buffer index in main.c of both projects */
+#define MAILBOX_SIZE                (9u)
+#define CONFIG_INDEX                (0u)
+#define MAILBOX_GEN_HEAD_INDEX      (1u)
+#define SLIDER_GESTURE_INDEX        (2u)
+#define BUTTON_COUNT_INDEX          (3u)
+#define BUTTON_STATUS_INDEX1        (4u)
+#define STATUS_FLAGS_INDEX          (5u)
+#define SLIDER_PARAM_INDEX          (6u)
+#define SLIDER_SEQUENCE_INDEX       (7u)
+#define MAILBOX_GEN_TAIL_INDEX      (MAILBOX_SIZE - 1u)
+#define STATUS_FLAG_APPROACH        (0x01u)
+
+/* Slider gesture codes and the keys they and the buttons send */
+#define GESTURE_NONE                (0x00u)
+#define GESTURE_LONG_PRESS          (0x12u)
+#define GESTURE_DOUBLE_TAP          (0x11u)
+#define GESTURE_FLICK_RIGHT         (0x54u)
+#define GESTURE_FLICK_LEFT          (0x5Cu)
+#define KEY_PAGE_UP                 (0x4Bu)
+#define KEY_PAGE_DOWN               (0x4Eu)
+#define KEY_F2                      (0x3Bu)
+#define KEY_F3                      (0x3Cu)
+#define KEY_F5                      (0x3Eu)
+#define KEY_F6                      (0x3Fu)
+
+#define BTN0                        (0x01u)
+#define BTN1                        (0x02u)
+#define BTN2                        (0x04u)
+
+/* Faults of a session */
+#define FAULT_NONE                  (0u)
+#define FAULT_CAPSENSE_RESTART      (1u)        /* The CapSense MCU resets and does not answer for faultTime */
+#define FAULT_SDA_HELD              (2u)        /* A slave holds SDA low until it sees 9 SCL pulses */
+#define FAULT_HARDWARE_ERROR        (3u)        /* One BLE hardware error */
+#define FAULT_HARDWARE_ERROR_PERSISTENT (4u)    /* A BLE hardware error on every stack start */
+#define FAULT_HANG                  (5u)        /* The main loop stops and no longer feeds the watchdog */
+#define FAULT_DISCONNECT            (6u)        /* The central drops the link and connects again after connectDelay */
+#define FAULT_SDA_CLOCKS            (9u)
+
+/* One publication of the CapSense MCU */
+typedef struct
+{
+    uint32_t at;                    /* ms after power on */
+    uint8_t buttons;
+    uint8_t gesture;                /* GESTURE_NONE keeps the last gesture */
+    uint8_t param;
+    uint8_t approach;
+    uint8_t keys;                   /* Keys the publication should send */
+} BENCH_STEP_T;
+
+typedef struct
+{
+    const char *name;
+    uint32_t duration;              /* ms */
+    SIM_CENTRAL_T central;
+    const BENCH_STEP_T *steps;
+    uint8_t stepCount;
+    const uint8_t *keys;            /* Expected keys in order */
+    uint8_t keyCount;
+    uint32_t latencyLimit;          /* ms from a publication to its first key on air */
+    uint8_t end;                    /* Expected SIM_END_xxx */
+    uint8_t fault;                  /* FAULT_xxx */
+    uint32_t faultAt;               /* ms the fault is injected at */
+    uint32_t faultTime;             /* ms the CapSense MCU does not answer on I2C after its restart */
+} BENCH_SESSION_T;
+
+/* Sent from the session process to the benchmark */
+typedef struct
+{
+    uint8_t end;
+    uint32_t reports;
+    uint32_t keyCount;
+    uint8_t keys[BENCH_MAX_KEYS];
+    uint32_t latencyCount;
+    uint64_t latencySum;            /* us */
+    uint64_t latencyMax;
+    SIM_CPU_T cpu;
+    uint32_t events;
+    uint32_t radioTime;
+    uint32_t paramUpdates;
+    uint16_t interval;
+    uint64_t time;                  /* us simulated */
+    uint64_t restoreTime;           /* us from the CapSense MCU answering again to its configuration restored */
+    uint64_t recoveryTime;          /* us from the fault to the recovery, 0 when it did not recover */
+    uint32_t stackStarts;
+    uint8_t sdaClocks;
+    uint64_t typingTime;            /* us from the first key press to the last */
+    uint16_t typingInterval;        /* Connection interval of the last key press, 1.25 ms units */
+    uint32_t attCounted[2u];        /* ATT requests stats counted before the disconnect and at the end */
+    uint32_t attSent[2u];           /* ATT requests the central sent on the connection, at the same times */
+} BENCH_RESULT_T;
+
+
+/*******************************************************************************
+* Sessions
+*******************************************************************************/
+#define CENTRAL_BONDED      {300000u, 24u, 0u, 6u, 1u, 1000000u, 4u, -60, 0u, NULL}
+#define CENTRAL_NEW         {300000u, 24u, 0u, 6u, 0u, 1500000u, 4u, -60, 0u, NULL}
+#define CENTRAL_NEW_LARGE_MTU {300000u, 24u, 0u, 6u, 0u, 1500000u, 4u, -60, 247u, NULL}
+#define CENTRAL_SLOW_ONLY   {300000u, 24u, 0u, 24u, 1u, 1000000u, 4u, -60, 0u, NULL}
+#define CENTRAL_NONE        {0u, 24u, 0u, 6u, 1u, 1000000u, 4u, -60, 0u, NULL}
+
+/* Each button reports once, BTN0 on release */
+static const BENCH_STEP_T buttonSteps[] =
+{
+    {2000u, BTN1, GESTURE_NONE, 0u, 0u, 1u},
+    {2200u, 0u, GESTURE_NONE, 0u, 0u, 0u},
+    {3000u, BTN2, GESTURE_NONE, 0u, 0u, 1u},
+    {3150u, 0u, GESTURE_NONE, 0u, 0u, 0u},
+    {4000u, BTN0, GESTURE_NONE, 0u, 0u, 0u},
+    {4300u, 0u, GESTURE_NONE, 0u, 0u, 1u},
+};
+static const uint8_t buttonKeys[] = {KEY_F5, KEY_F3, KEY_F6};
+
+/* The approach flag asks for the fast interval before the touch lands */
+static const BENCH_STEP_T approachSteps[] =
+{
+    {2000u, 0u, GESTURE_NONE, 0u, STATUS_FLAG_APPROACH, 0u},
+    {2600u, BTN1, GESTURE_NONE, 0u, STATUS_FLAG_APPROACH, 1u},
+    {2800u, 0u, GESTURE_NONE, 0u, STATUS_FLAG_APPROACH, 0u},
+    {3200u, BTN2, GESTURE_NONE, 0u, STATUS_FLAG_APPROACH, 1u},
+    {3400u, 0u, GESTURE_NONE, 0u, STATUS_FLAG_APPROACH, 0u},
+    {5400u, 0u, GESTURE_NONE, 0u, 0u, 0u},
+};
+static const uint8_t approachKeys[] = {KEY_F5, KEY_F3};
+
+static const BENCH_STEP_T gestureSteps[] =
+{
+    {2000u, 0u, GESTURE_FLICK_RIGHT, 40u, STATUS_FLAG_APPROACH, 1u},
+    {2600u, 0u, GESTURE_FLICK_LEFT, 40u, STATUS_FLAG_APPROACH, 1u},
+    {3200u, 0u, GESTURE_LONG_PRESS, 50u, STATUS_FLAG_APPROACH, 1u},
+    {5400u, 0u, GESTURE_NONE, 0u, 0u, 0u},
+};
+static const uint8_t gestureKeys[] = {KEY_PAGE_DOWN, KEY_PAGE_UP, KEY_F2};
+
+/* The station ID macro fills the HID queue and the TX buffers. The typing
+*  rate is reported at the fast interval the approach asks for, and at the
+*  slow one of a central that rejects it. */
+static const BENCH_STEP_T macroSteps[] =
+{
+    {1400u, 0u, GESTURE_NONE, 0u, STATUS_FLAG_APPROACH, 0u},
+    {2000u, 0u, GESTURE_DOUBLE_TAP, 50u, STATUS_FLAG_APPROACH, 1u},
+    {5000u, 0u, GESTURE_NONE, 0u, 0u, 0u},
+};
+static const uint8_t macroKeys[] = {0x06u, 0x1Cu, 0x25u, 0x06u, 0x0Eu, 0x0Cu, 0x17u, 0x2Du, 0x1Eu, 0x21u, 0x26u, 0x28u};
+
+/* A new central pairs and enables notifications before the first touch */
+static const BENCH_STEP_T pairingSteps[] =
+{
+    {3000u, BTN2, GESTURE_NONE, 0u, 0u, 1u},
+    {3200u, 0u, GESTURE_NONE, 0u, 0u, 0u},
+};
+static const uint8_t pairingKeys[] = {KEY_F3};
+
+/* One touch in a minute of idle connection */
+static const BENCH_STEP_T idleSteps[] =
+{
+    {30000u, BTN1, GESTURE_NONE, 0u, 0u, 1u},
+    {30200u, 0u, GESTURE_NONE, 0u, 0u, 0u},
+};
+static const uint8_t idleKeys[] = {KEY_F5};
+
+/* The CapSense MCU resets, e.g. for a firmware update, and comes back with
+*  its power-on mailbox: default configuration, generation and gesture
+*  sequence 0. The flick after the restart has the sequence number of the
+*  flick before it. */
+static const BENCH_STEP_T restartSteps[] =
+{
+    {2000u, 0u, GESTURE_FLICK_RIGHT, 40u, STATUS_FLAG_APPROACH, 1u},
+    {2200u, BTN1, GESTURE_NONE, 0u, STATUS_FLAG_APPROACH, 1u},
+    {2400u, 0u, GESTURE_NONE, 0u, 0u, 0u},
+    {4000u, 0u, GESTURE_FLICK_LEFT, 40u, STATUS_FLAG_APPROACH, 1u},
+    {4600u, BTN2, GESTURE_NONE, 0u, STATUS_FLAG_APPROACH, 1u},
+    {4800u, 0u, GESTURE_NONE, 0u, 0u, 0u},
+};
+static const uint8_t restartKeys[] = {KEY_PAGE_DOWN, KEY_F5, KEY_PAGE_UP, KEY_F3};
+
+/* A button before and after a fault at 3 s, the second one after the recovery */
+static const BENCH_STEP_T faultSteps[] =
+{
+    {2000u, BTN1, GESTURE_NONE, 0u, 0u, 1u},
+    {2200u, 0u, GESTURE_NONE, 0u, 0u, 0u},
+    {5000u, BTN2, GESTURE_NONE, 0u, 0u, 1u},
+    {5200u, 0u, GESTURE_NONE, 0u, 0u, 0u},
+};
+static const uint8_t faultKeys[] = {KEY_F5, KEY_F3};
+static const uint8_t faultResetKeys[] = {KEY_F5};
+
+#define STEPS(steps)        (steps), (uint8_t)(sizeof(steps) / sizeof((steps)[0u]))
+#define NO_FAULT            FAULT_NONE, 0u, 0u
+
+static const BENCH_SESSION_T sessions[] =
+{
+    {"buttons", 6000u, CENTRAL_BONDED, STEPS(buttonSteps), STEPS(buttonKeys), 300u, SIM_END_TIME, NO_FAULT},
+    {"approach", 6000u, CENTRAL_BONDED, STEPS(approachSteps), STEPS(approachKeys), 60u, SIM_END_TIME, NO_FAULT},
+    {"approach-rejected", 6000u, CENTRAL_SLOW_ONLY, STEPS(approachSteps), STEPS(approachKeys), 300u, SIM_END_TIME,
+     NO_FAULT},
+    {"gestures", 6000u, CENTRAL_BONDED, STEPS(gestureSteps), STEPS(gestureKeys), 60u, SIM_END_TIME, NO_FAULT},
+    {"macro", 6000u, CENTRAL_BONDED, STEPS(macroSteps), STEPS(macroKeys), 300u, SIM_END_TIME, NO_FAULT},
+    {"macro-slow", 6000u, CENTRAL_SLOW_ONLY, STEPS(macroSteps), STEPS(macroKeys), 300u, SIM_END_TIME, NO_FAULT},
+    {"pairing", 5000u, CENTRAL_NEW, STEPS(pairingSteps), STEPS(pairingKeys), 300u, SIM_END_TIME, NO_FAULT},
+    {"idle", 60000u, CENTRAL_BONDED, STEPS(idleSteps), STEPS(idleKeys), 300u, SIM_END_TIME, NO_FAULT},
+    {"capsense-restart", 6000u, CENTRAL_BONDED, STEPS(restartSteps), STEPS(restartKeys), 300u, SIM_END_TIME,
+     FAULT_CAPSENSE_RESTART, 3000u, 300u},
+    {"sda-held", 6000u, CENTRAL_BONDED, STEPS(faultSteps), STEPS(faultKeys), 300u, SIM_END_TIME,
+     FAULT_SDA_HELD, 3000u, 0u},
+    {"hardware-error", 6000u, CENTRAL_BONDED, STEPS(faultSteps), STEPS(faultKeys), 300u, SIM_END_TIME,
+     FAULT_HARDWARE_ERROR, 3000u, 0u},
+    {"error-every-start", 6000u, CENTRAL_BONDED, STEPS(faultSteps), STEPS(faultResetKeys), 300u, SIM_END_RESET,
+     FAULT_HARDWARE_ERROR_PERSISTENT, 3000u, 0u},
+    {"hang", 6000u, CENTRAL_BONDED, STEPS(faultSteps), STEPS(faultResetKeys), 300u, SIM_END_WATCHDOG,
+     FAULT_HANG, 3000u, 0u},
+    {"reconnect", 6000u, CENTRAL_NEW_LARGE_MTU, STEPS(faultSteps), STEPS(faultKeys), 300u, SIM_END_TIME,
+     FAULT_DISCONNECT, 3000u, 0u},
+    {"no-central", 200000u, CENTRAL_NONE, NULL, 0u, NULL, 0u, 0u, SIM_END_HIBERNATE, NO_FAULT},
+};
+
+static const char * const endNames[] = {"time", "hibernate", "reset", "watchdog", "idle"};
+
+/* State of the session process */
+static const BENCH_SESSION_T *session;
+static const uint8_t mailboxPowerOn[MAILBOX_SIZE] = {0u, 0u, 0u, 3u, 0u, 0u, 0u, 0u, 0u};
+static volatile uint8_t mailbox[MAILBOX_SIZE] = {0u, 0u, 0u, 3u, 0u, 0u, 0u, 0u, 0u};
+static uint8_t nextStep;
+static SIM_TIMER_T stepTimer;
+static SIM_TIMER_T endTimer;
+static SIM_TIMER_T faultTimer;
+static uint8_t restartConfig;       /* Configuration the BLE MCU had written before the restart */
+static uint64_t restartBack;        /* us the CapSense MCU answered again */
+static uint64_t restoreTime;
+static uint64_t faultAt;            /* us the fault was injected */
+static uint64_t recoveryTime;
+static uint32_t attCounted;         /* stats.attRequests of the firmware before the disconnect */
+static uint32_t attSent;            /* simBle.attRequests before the disconnect */
+
+
+/*******************************************************************************
+* Function Name: Publish()
+********************************************************************************
+*
+* Summary:
+*   Publishes the next script step like PublishMailbox() of the CapSense
+*   MCU, which the timers of the simulation never interrupt.
+*
+*******************************************************************************/
+static void Publish(void)
+{
+    const BENCH_STEP_T *step = &session->steps[nextStep++];
+    uint8_t generation = (uint8_t)(mailbox[MAILBOX_GEN_HEAD_INDEX] + 1u);
+
+    mailbox[MAILBOX_GEN_TAIL_INDEX] = generation;
+    mailbox[BUTTON_STATUS_INDEX1] = step->buttons;
+    mailbox[STATUS_FLAGS_INDEX] = step->approach;
+    if(step->gesture != GESTURE_NONE)
+    {
+        mailbox[SLIDER_GESTURE_INDEX] = step->gesture;
+        mailbox[SLIDER_PARAM_INDEX] = step->param;
+        mailbox[SLIDER_SEQUENCE_INDEX]++;
+    }
+    mailbox[MAILBOX_GEN_HEAD_INDEX] = generation;
+
+    if(nextStep < session->stepCount)
+    {
+        SimTimerStart(&stepTimer, (uint64_t)session->steps[nextStep].at * SIM_US_PER_MS, Publish);
+    }
+}
+
+static void SessionEnd(void)
+{
+    SimEnd(SIM_END_TIME);
+}
+
+
+/*******************************************************************************
+* Function Name: CheckConfig()
+********************************************************************************
+*
+* Summary:
+*   Polls every millisecond after a restart until the BLE MCU has written its
+*   configuration to the CapSense MCU again.
+*
+*******************************************************************************/
+static void CheckConfig(void)
+{
+    if(mailbox[CONFIG_INDEX] == restartConfig)
+    {
+        restoreTime = simNow - restartBack;
+    }
+    else
+    {
+        SimTimerStart(&faultTimer, simNow + SIM_US_PER_MS, CheckConfig);
+    }
+}
+
+/*******************************************************************************
+* Function Name: RestartDone()
+********************************************************************************
+*
+* Summary:
+*   The CapSense MCU answers again, with its power-on mailbox.
+*
+*******************************************************************************/
+static void RestartDone(void)
+{
+    uint8_t index;
+
+    for(index = 0u; index < MAILBOX_SIZE; index++)
+    {
+        mailbox[index] = mailboxPowerOn[index];
+    }
+    SimEzi2cSetBuffer(mailbox, MAILBOX_SIZE, 1u);
+    restartBack = simNow;
+    SimTimerStart(&faultTimer, simNow + SIM_US_PER_MS, CheckConfig);
+}
+
+/*******************************************************************************
+* Function Name: Restart()
+********************************************************************************
+*
+* Summary:
+*   Resets the CapSense MCU, e.g. for a firmware update. It does not
+*   acknowledge its address for faultTime.
+*
+*******************************************************************************/
+static void Restart(void)
+{
+    restartConfig = mailbox[CONFIG_INDEX];
+    SimEzi2cSetBuffer(NULL, 0u, 0u);
+    SimTimerStart(&faultTimer, simNow + ((uint64_t)session->faultTime * SIM_US_PER_MS), RestartDone);
+}
+
+
+/*******************************************************************************
+* Function Name: CheckRecovery()
+********************************************************************************
+*
+* Summary:
+*   Polls every millisecond after a fault until the firmware has recovered:
+*   after a held SDA, a transfer completed once the bus clear released it;
+*   after a hardware error or a disconnect, the central connected again.
+*
+*******************************************************************************/
+static void CheckRecovery(void)
+{
+    if((session->fault == FAULT_SDA_HELD) && (simBle.sdaReleasedAt != 0u) && (simBle.i2cDoneAt > simBle.sdaReleasedAt))
+    {
+        recoveryTime = simBle.i2cDoneAt - faultAt;
+    }
+    else if(((session->fault == FAULT_HARDWARE_ERROR) || (session->fault == FAULT_DISCONNECT)) &&
+            (simBle.connectedAt > faultAt))
+    {
+        recoveryTime = simBle.connectedAt - faultAt;
+    }
+    else
+    {
+        SimTimerStart(&faultTimer, simNow + SIM_US_PER_MS, CheckRecovery);
+    }
+}
+
+/*******************************************************************************
+* Function Name: Fault()
+********************************************************************************
+*
+* Summary:
+*   Injects the fault of the session. A fault that ends in a reset is
+*   recovered when the simulation ends.
+*
+*******************************************************************************/
+static void Fault(void)
+{
+    faultAt = simNow;
+    switch(session->fault)
+    {
+        case FAULT_CAPSENSE_RESTART:
+            Restart();
+            break;
+        case FAULT_SDA_HELD:
+            SimI2cHoldSda(FAULT_SDA_CLOCKS);
+            SimTimerStart(&faultTimer, simNow + SIM_US_PER_MS, CheckRecovery);
+            break;
+        case FAULT_HARDWARE_ERROR:
+            SimBleHardwareError(0u);
+            SimTimerStart(&faultTimer, simNow + SIM_US_PER_MS, CheckRecovery);
+            break;
+        case FAULT_HARDWARE_ERROR_PERSISTENT:
+            SimBleHardwareError(1u);
+            break;
+        case FAULT_HANG:
+            SimBleHang();
+            break;
+        case FAULT_DISCONNECT:
+            attCounted = stats.attRequests;
+            attSent = simBle.attRequests;
+            SimCentralDisconnect();
+            SimTimerStart(&faultTimer, simNow + SIM_US_PER_MS, CheckRecovery);
+            break;
+        default:
+            break;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Evaluate()
+********************************************************************************
+*
+* Summary:
+*   Turns the report log of the central into key presses. A report starts a
+*   key press when its first key differs from the one of the report before.
+*   The latency of a step that sends keys is the time to the first key
+*   press after it. The typing time spans the first to the last key press.
+*
+*******************************************************************************/
+static void Evaluate(BENCH_RESULT_T *result)
+{
+    uint64_t pressAt[BENCH_MAX_KEYS];
+    uint64_t stepAt;
+    uint8_t previous = 0u;
+    uint8_t key;
+    uint32_t index;
+    uint32_t press;
+
+    for(index = 0u; index < simBle.reports; index++)
+    {
+        key = simBle.log[index].report[2u];
+        if((key != 0u) && (key != previous))
+        {
+            if(result->keyCount < BENCH_MAX_KEYS)
+            {
+                result->keys[result->keyCount] = key;
+                pressAt[result->keyCount] = simBle.log[index].at;
+                result->typingInterval = simBle.log[index].interval;
+            }
+            result->keyCount++;
+        }
+        previous = key;
+    }
+    if((result->keyCount > 1u) && (result->keyCount <= BENCH_MAX_KEYS))
+    {
+        result->typingTime = pressAt[result->keyCount - 1u] - pressAt[0u];
+    }
+
+    for(index = 0u; index < session->stepCount; index++)
+    {
+        stepAt = (uint64_t)session->steps[index].at * SIM_US_PER_MS;
+        for(press = 0u; (session->steps[index].keys != 0u) && (press < result->keyCount) &&
+                        (press < BENCH_MAX_KEYS); press++)
+        {
+            if(pressAt[press] >= stepAt)
+            {
+                result->latencyCount++;
+                result->latencySum += pressAt[press] - stepAt;
+                if((pressAt[press] - stepAt) > result->latencyMax)
+                {
+                    result->latencyMax = pressAt[press] - stepAt;
+                }
+                break;
+            }
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: WriteReports()
+********************************************************************************
+*
+* Summary:
+*   Writes the script steps that send keys and the reports the central
+*   received to build/bench_ble_<session>.reports, in time order, for
+*   uhid_loopback to replay:
+*    step <us>
+*    report <us> <8 hex bytes>
+*
+*******************************************************************************/
+static void WriteReports(const BENCH_SESSION_T *run)
+{
+    FILE *file;
+    char path[64];
+    uint64_t stepAt;
+    uint32_t report = 0u;
+    uint8_t step = 0u;
+    uint8_t index;
+
+    (void)snprintf(path, sizeof(path), "%s/bench_ble_%s.reports", BENCH_LOG_DIR, run->name);
+    file = fopen(path, "w");
+    if(file == NULL)
+    {
+        return;
+    }
+    while((step < run->stepCount) || (report < simBle.reports))
+    {
+        stepAt = (step < run->stepCount) ? ((uint64_t)run->steps[step].at * SIM_US_PER_MS) : UINT64_MAX;
+        if((report < simBle.reports) && (simBle.log[report].at < stepAt))
+        {
+            fprintf(file, "report %llu", (unsigned long long)simBle.log[report].at);
+            for(index = 0u; index < SIM_BLE_REPORT_SIZE; index++)
+            {
+                fprintf(file, " %02x", simBle.log[report].report[index]);
+            }
+            fprintf(file, "\n");
+            report++;
+        }
+        else
+        {
+            if(run->steps[step].keys != 0u)
+            {
+                fprintf(file, "step %llu\n", (unsigned long long)stepAt);
+            }
+            step++;
+        }
+    }
+    (void)fclose(file);
+}
+
+
+/*******************************************************************************
+* Function Name: RunSession()
+********************************************************************************
+*
+* Summary:
+*   Runs a session in the current process and writes its result to fd.
+*
+*******************************************************************************/
+static void RunSession(const BENCH_SESSION_T *run, int fd)
+{
+    BENCH_RESULT_T result;
+    char path[64];
+
+    session = run;
+    (void)snprintf(path, sizeof(path), "%s/bench_ble_%s.log", BENCH_LOG_DIR, run->name);
+    if(freopen(path, "w", stdout) == NULL)
+    {
+        _exit(2);
+    }
+
+    simCentral = run->central;
+    SimEzi2cSetBuffer(mailbox, MAILBOX_SIZE, 1u);
+    if(run->stepCount != 0u)
+    {
+        SimTimerStart(&stepTimer, (uint64_t)run->steps[0u].at * SIM_US_PER_MS, Publish);
+    }
+    SimTimerStart(&endTimer, (uint64_t)run->duration * SIM_US_PER_MS, SessionEnd);
+    if(run->fault != FAULT_NONE)
+    {
+        SimTimerStart(&faultTimer, (uint64_t)run->faultAt * SIM_US_PER_MS, Fault);
+    }
+
+    (void)memset(&result, 0, sizeof(result));
+    result.end = SimRun(SimBleMain);
+    SimClose(&simBleCpu);
+    (void)fflush(stdout);
+
+    result.time = simNow;
+    result.reports = simBle.reports;
+    result.cpu = simBleCpu;
+    result.cpu.name = NULL;
+    result.events = simBle.events;
+    result.radioTime = simBle.radioTime;
+    result.paramUpdates = simBle.paramUpdates;
+    result.interval = simBle.interval;
+    result.restoreTime = restoreTime;
+    result.recoveryTime = recoveryTime;
+    if((run->fault == FAULT_HARDWARE_ERROR_PERSISTENT) || (run->fault == FAULT_HANG))
+    {
+        result.recoveryTime = (result.end == run->end) ? (simNow - faultAt) : 0u;
+    }
+    result.stackStarts = simBle.stackStarts;
+    result.sdaClocks = simBle.sdaClocks;
+    result.attCounted[0u] = attCounted;
+    result.attCounted[1u] = stats.attRequests;
+    result.attSent[0u] = attSent;
+    result.attSent[1u] = simBle.attRequests;
+    Evaluate(&result);
+    WriteReports(run);
+
+    if(write(fd, &result, sizeof(result)) != (ssize_t)sizeof(result))
+    {
+        _exit(2);
+    }
+    _exit(0);
+}
+
+
+/*******************************************************************************
+* Function Name: CheckFault()
+********************************************************************************
+*
+* Summary:
+*   Prints the recovery time of a fault and checks that the firmware
+*   recovered the way it should: a held SDA by the bus clear, a hardware
+*   error by one stack restart, a persistent one by a reset after
+*   RECOVERY_STACK_RESTART_LIMIT restarts, a hang by the watchdog reset.
+*   After a disconnect the ATT request count of the statistics has to
+*   start again with the connection: it counts what the central sent on
+*   each connection, not the sum of both.
+*
+* Return:
+*  Non-zero when the fault was recovered.
+*
+*******************************************************************************/
+static uint8_t CheckFault(const BENCH_SESSION_T *run, const BENCH_RESULT_T *result)
+{
+    static const char * const faultNames[] =
+    {
+        "", "", "held SDA", "hardware error", "hardware error on every start", "main loop hang", "disconnect"
+    };
+    uint8_t passed = 1u;
+
+    if(result->recoveryTime == 0u)
+    {
+        printf("  %s: %s not recovered\n", run->name, faultNames[run->fault]);
+        return (0u);
+    }
+    printf("  %s: %s recovered in %.1f ms", run->name, faultNames[run->fault],
+           (double)result->recoveryTime / 1000.0);
+    switch(run->fault)
+    {
+        case FAULT_SDA_HELD:
+            printf(", bus clear with %u SCL pulses\n", result->sdaClocks);
+            passed = (uint8_t)(result->sdaClocks == FAULT_SDA_CLOCKS);
+            break;
+        case FAULT_HARDWARE_ERROR:
+        case FAULT_HARDWARE_ERROR_PERSISTENT:
+            printf(", stack restarts: %lu\n", (unsigned long)(result->stackStarts - 1u));
+            passed = (uint8_t)((result->stackStarts - 1u) ==
+                               ((run->fault == FAULT_HARDWARE_ERROR) ? 1u : RECOVERY_STACK_RESTART_LIMIT));
+            break;
+        case FAULT_DISCONNECT:
+            printf(", ATT requests counted %lu then %lu, sent %lu then %lu\n",
+                   (unsigned long)result->attCounted[0u], (unsigned long)result->attCounted[1u],
+                   (unsigned long)result->attSent[0u], (unsigned long)result->attSent[1u]);
+            passed = (uint8_t)((result->attCounted[0u] == result->attSent[0u]) &&
+                               (result->attCounted[1u] == result->attSent[1u]) &&
+                               (result->attSent[1u] != 0u));
+            break;
+        default:
+            printf(" by the watchdog reset\n");
+            passed = (uint8_t)(result->recoveryTime <= ((uint64_t)SimLfclkTime(RECOVERY_WDT_TIMEOUT) +
+                                                         SIM_US_PER_MS * 100u));
+            break;
+    }
+    if(passed == 0u)
+    {
+        printf("  %s: recovered the wrong way\n", run->name);
+    }
+    return (passed);
+}
+
+
+/*******************************************************************************
+* Function Name: Check()
+********************************************************************************
+*
+* Summary:
+*   Compares a session result with what the session expects.
+*
+* Return:
+*  Non-zero when the session passed.
+*
+*******************************************************************************/
+static uint8_t Check(const BENCH_SESSION_T *run, const BENCH_RESULT_T *result)
+{
+    uint8_t passed = 1u;
+
+    if(result->end != run->end)
+    {
+        printf("  %s: ended by %s\n", run->name, endNames[result->end]);
+        passed = 0u;
+    }
+    if((result->keyCount != run->keyCount) ||
+       (memcmp(result->keys, run->keys, (run->keyCount < BENCH_MAX_KEYS) ? run->keyCount : BENCH_MAX_KEYS) != 0))
+    {
+        printf("  %s: %lu keys received, %u expected\n", run->name, (unsigned long)result->keyCount,
+               run->keyCount);
+        passed = 0u;
+    }
+    if(result->latencyMax > ((uint64_t)run->latencyLimit * SIM_US_PER_MS))
+    {
+        printf("  %s: latency %lu us over the limit of %lu ms\n", run->name, (unsigned long)result->latencyMax,
+               (unsigned long)run->latencyLimit);
+        passed = 0u;
+    }
+    if(run->fault == FAULT_CAPSENSE_RESTART)
+    {
+        if(result->restoreTime == 0u)
+        {
+            printf("  %s: CapSense configuration not restored after the restart\n", run->name);
+            passed = 0u;
+        }
+        else
+        {
+            printf("  %s: CapSense configuration restored %.1f ms after the restart\n", run->name,
+                   (double)result->restoreTime / 1000.0);
+        }
+    }
+    else if(run->fault != FAULT_NONE)
+    {
+        passed &= CheckFault(run, result);
+    }
+    else
+    {
+        /* No fault in the session */
+    }
+    if((run->steps == macroSteps) && (result->typingTime != 0u))
+    {
+        printf("  %s: %lu characters in %.1f ms, %.1f chars/s at the %.2f ms interval\n", run->name,
+               (unsigned long)result->keyCount, (double)result->typingTime / 1000.0,
+               ((double)(result->keyCount - 1u) * 1000000.0) / (double)result->typingTime,
+               result->typingInterval * 1.25);
+    }
+    return (passed);
+}
+
+/* Percent of the simulated time, with one decimal */
+static double Percent(uint64_t part, uint64_t time)
+{
+    return ((time != 0u) ? ((100.0 * (double)part) / (double)time) : 0.0);
+}
+
+
+int main(void)
+{
+    BENCH_RESULT_T result;
+    uint8_t index;
+    uint8_t failed = 0u;
+    uint8_t passed;
+    double current;
+    pid_t child;
+    int status;
+    int fds[2];
+
+    printf("%-18s %-9s %4s %4s %8s %8s %7s %6s %6s %6s %6s %5s %7s\n", "session", "end", "keys", "rep",
+           "lat avg", "lat max", "wakeups", "act%", "slp%", "deep%", "events", "intv", "uA");
+    for(index = 0u; index < (sizeof(sessions) / sizeof(sessions[0u])); index++)
+    {
+        (void)fflush(stdout);
+        if(pipe(fds) != 0)
+        {
+            return (2);
+        }
+        child = fork();
+        if(child == 0)
+        {
+            (void)close(fds[0u]);
+            RunSession(&sessions[index], fds[1u]);
+        }
+        (void)close(fds[1u]);
+        (void)memset(&result, 0, sizeof(result));
+        if((child < 0) || (read(fds[0u], &result, sizeof(result)) != (ssize_t)sizeof(result)))
+        {
+            printf("%-18s did not report a result\n", sessions[index].name);
+            failed++;
+            (void)close(fds[0u]);
+            (void)waitpid(child, &status, 0);
+            continue;
+        }
+        (void)close(fds[0u]);
+        (void)waitpid(child, &status, 0);
+
+        current = (((double)(result.cpu.activeTime + result.cpu.sleepTime) * BENCH_ACTIVE_CURRENT) +
+                   ((double)result.cpu.deepSleepTime * BENCH_DEEP_SLEEP_CURRENT) +
+                   ((double)result.radioTime * BENCH_RADIO_CURRENT)) / (double)result.time;
+        printf("%-18s %-9s %4lu %4lu %8.1f %8.1f %7lu %6.2f %6.2f %6.2f %6lu %5.1f %7.1f\n",
+               sessions[index].name, endNames[result.end], (unsigned long)result.keyCount,
+               (unsigned long)result.reports,
+               (result.latencyCount != 0u) ? ((double)result.latencySum / result.latencyCount / 1000.0) : 0.0,
+               (double)result.latencyMax / 1000.0, (unsigned long)result.cpu.wakeups,
+               Percent(result.cpu.activeTime, result.time), Percent(result.cpu.sleepTime, result.time),
+               Percent(result.cpu.deepSleepTime, result.time), (unsigned long)result.events,
+               result.interval * 1.25, current);
+
+        passed = Check(&sessions[index], &result);
+        if(passed == 0u)
+        {
+            failed++;
+        }
+    }
+
+    printf("%u of %u sessions failed\n", failed, (unsigned int)(sizeof(sessions) / sizeof(sessions[0u])));
+    return ((failed == 0u) ? 0 : 1);
+}
+
+
+/* [] END OF FILE */
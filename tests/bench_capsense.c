@@ -0,0 +1,702 @@
+/*******************************************************************************
+* File Name: bench_capsense.c
+*
+* Version 1.0
+*
+* Description:
+*  Benchmark of the CapSense firmware on the host simulation. Each session
+*  powers the CapSense MCU on and plays a script of fingers and hands on the
+*  synthetic panel. An I2C master polls the EZI2C mailbox the way the BLE
+*  MCU does: it writes the configuration byte once, then reads the mailbox
+*  byte by byte and retries reads that overlapped a publication.
+*
+*  The master checks the button changes and gestures it sees against the
+*  script, and the time from a script step to the first read that shows
+*  it. The scan loop throughput and the mailbox publication rate come from
+*  the simulated CapSense block and the mailbox generation.
+*
+*  A session runs in a child process, since the firmware keeps its state in
+*  statics and never returns from main(). The benchmark exits non-zero when
+*  a session sees wrong events, exceeds a latency limit or ends the wrong
+*  way.
+*
+*  The Makefile also builds the firmware with the serial scan order, all
+*  widgets scanned and then processed, as bench_capsense_serial. With
+*  --rates <file> a run writes the scans per second of each session to the
+*  file; with --serial <file> it adds the ratio of its own scans per second
+*  to the ones in the file. A --rates run is a reference: the latency
+*  limits are the ones of the pipelined order, so its failed sessions are
+*  printed but do not fail the benchmark.
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "sim/capsense.h"
+
+#define BENCH_MAX_EVENTS            (32u)
+#define BENCH_I2C_BYTE_TIME         (23u)       /* us per byte with ACK at 400 kHz */
+
+/* CapSense mailbox, see I2C buffer index in main.c of both projects */
+#define MAILBOX_SIZE                (9u)
+#define CONFIG_INDEX                (0u)
+#define MAILBOX_GEN_HEAD_INDEX      (1u)
+#define SLIDER_GESTURE_INDEX        (2u)
+#define BUTTON_STATUS_INDEX1        (4u)
+#define SLIDER_SEQUENCE_INDEX       (7u)
+#define MAILBOX_GEN_TAIL_INDEX      (MAILBOX_SIZE - 1u)
+
+/* Configuration byte */
+#define CONFIG_HIGH_NOISE           (0x01u)
+#define CONFIG_TIER_50MS            (0x04u)
+
+/* Slider gesture codes, see gesture.h */
+#define GESTURE_NONE                (0x00u)
+#define GESTURE_TAP                 (0x10u)
+#define GESTURE_DOUBLE_TAP          (0x11u)
+#define GESTURE_LONG_PRESS          (0x12u)
+#define GESTURE_SWIPE_RIGHT         (0x54u)
+#define GESTURE_SWIPE_LEFT          (0x5Cu)
+
+#define BTN0                        (0x01u)
+#define BTN1                        (0x02u)
+#define BTN2                        (0x04u)
+#define LIFT                        SIM_NO_FINGER
+
+/* What is on the panel from a script time on */
+typedef struct
+{
+    uint32_t at;                    /* ms after power on */
+    uint8_t buttons;
+    uint16_t position;              /* Finger on the slider, LIFT when none */
+    int16_t speed;                  /* Slider units per second */
+    uint8_t hand;
+    uint8_t gesture;                /* Gesture the step should bring, measured from the step */
+} BENCH_STEP_T;
+
+typedef struct
+{
+    const char *name;
+    uint32_t duration;              /* ms */
+    uint8_t config;                 /* Configuration byte the master writes */
+    uint32_t pollPeriod;            /* us between mailbox reads */
+    uint16_t noise;
+    int32_t drift;
+    const BENCH_STEP_T *steps;
+    uint8_t stepCount;
+    const uint8_t *gestures;        /* Expected gestures in order */
+    uint8_t gestureCount;
+    uint32_t buttonLimit;           /* ms from a step to the master seeing its buttons */
+    uint32_t gestureLimit;          /* ms from a step to the master seeing its gesture */
+} BENCH_SESSION_T;
+
+/* Change of the mailbox seen by the master */
+typedef struct
+{
+    uint64_t at;
+    uint8_t buttons;
+    uint8_t gesture;                /* GESTURE_NONE for a button change */
+} BENCH_EVENT_T;
+
+typedef struct
+{
+    uint64_t count;
+    uint64_t sum;                   /* us */
+    uint64_t max;
+} BENCH_LATENCY_T;
+
+/* Sent from the session process to the benchmark */
+typedef struct
+{
+    uint8_t end;
+    uint32_t eventCount;
+    BENCH_EVENT_T events[BENCH_MAX_EVENTS];
+    uint8_t missed;                 /* A script step was not seen in time */
+    BENCH_LATENCY_T buttonLatency;
+    BENCH_LATENCY_T gestureLatency;
+    SIM_CAPSENSE_RESULT_T capSense;
+    SIM_CPU_T cpu;
+    uint32_t publications;          /* Mailbox generations counted by the master */
+    uint32_t updates;               /* Reads that found a new generation */
+    uint32_t torn;                  /* Reads retried for overlapping a publication */
+    uint16_t startupTime;
+    uint64_t time;                  /* us simulated */
+} BENCH_RESULT_T;
+
+extern uint16_t Tuning_startupTime;
+
+
+/*******************************************************************************
+* Sessions
+*******************************************************************************/
+/* Each button alone, then two together released one after the other */
+static const BENCH_STEP_T buttonSteps[] =
+{
+    {500u, BTN0, LIFT, 0, 0u, GESTURE_NONE},
+    {650u, 0u, LIFT, 0, 0u, GESTURE_NONE},
+    {1000u, BTN1, LIFT, 0, 0u, GESTURE_NONE},
+    {1150u, 0u, LIFT, 0, 0u, GESTURE_NONE},
+    {1500u, BTN2, LIFT, 0, 0u, GESTURE_NONE},
+    {1650u, 0u, LIFT, 0, 0u, GESTURE_NONE},
+    {2000u, BTN0 | BTN2, LIFT, 0, 0u, GESTURE_NONE},
+    {2200u, BTN0, LIFT, 0, 0u, GESTURE_NONE},
+    {2300u, 0u, LIFT, 0, 0u, GESTURE_NONE},
+};
+
+/* The finger slides 300 units per second, a swipe takes 20 units */
+static const BENCH_STEP_T swipeSteps[] =
+{
+    {500u, 0u, 20u, 300, 0u, GESTURE_SWIPE_RIGHT},
+    {700u, 0u, LIFT, 0, 0u, GESTURE_NONE},
+    {1200u, 0u, 80u, -300, 0u, GESTURE_SWIPE_LEFT},
+    {1400u, 0u, LIFT, 0, 0u, GESTURE_NONE},
+};
+static const uint8_t swipeGestures[] = {GESTURE_SWIPE_RIGHT, GESTURE_SWIPE_LEFT};
+
+/* A tap is reported after the double tap gap, a long press after its hold time */
+static const BENCH_STEP_T tapSteps[] =
+{
+    {500u, 0u, 50u, 0, 0u, GESTURE_NONE},
+    {580u, 0u, LIFT, 0, 0u, GESTURE_TAP},
+    {1500u, 0u, 30u, 0, 0u, GESTURE_NONE},
+    {1560u, 0u, LIFT, 0, 0u, GESTURE_NONE},
+    {1700u, 0u, 32u, 0, 0u, GESTURE_DOUBLE_TAP},
+    {1760u, 0u, LIFT, 0, 0u, GESTURE_NONE},
+    {2500u, 0u, 70u, 0, 0u, GESTURE_LONG_PRESS},
+    {3300u, 0u, LIFT, 0, 0u, GESTURE_NONE},
+};
+static const uint8_t tapGestures[] = {GESTURE_TAP, GESTURE_DOUBLE_TAP, GESTURE_LONG_PRESS};
+
+/* Buttons and swipes on a noisy panel with the high noise filter profile */
+static const BENCH_STEP_T noiseSteps[] =
+{
+    {500u, BTN1, LIFT, 0, 0u, GESTURE_NONE},
+    {650u, 0u, LIFT, 0, 0u, GESTURE_NONE},
+    {1000u, 0u, 20u, 300, 0u, GESTURE_SWIPE_RIGHT},
+    {1200u, 0u, LIFT, 0, 0u, GESTURE_NONE},
+    {1700u, BTN2, LIFT, 0, 0u, GESTURE_NONE},
+    {1850u, 0u, LIFT, 0, 0u, GESTURE_NONE},
+};
+static const uint8_t noiseGestures[] = {GESTURE_SWIPE_RIGHT};
+
+/* The raw counts drift while the slowest tier is configured. The baseline
+*  lags the rising raw counts, and the summed lag of the nine sensors holds
+*  the approach flag of DetectApproach(), so the frame rate stays high. */
+static const BENCH_STEP_T driftSteps[] =
+{
+    {3000u, BTN0, LIFT, 0, 0u, GESTURE_NONE},
+    {3200u, 0u, LIFT, 0, 0u, GESTURE_NONE},
+    {6000u, BTN2, LIFT, 0, 0u, GESTURE_NONE},
+    {6200u, 0u, LIFT, 0, 0u, GESTURE_NONE},
+    {8000u, 0u, 80u, -300, 0u, GESTURE_SWIPE_LEFT},
+    {8200u, 0u, LIFT, 0, 0u, GESTURE_NONE},
+};
+static const uint8_t driftGestures[] = {GESTURE_SWIPE_LEFT};
+
+/* A hovering hand brings the full scan rate back before the touch lands */
+static const BENCH_STEP_T tierSteps[] =
+{
+    {1000u, 0u, LIFT, 0, 1u, GESTURE_NONE},
+    {1300u, BTN1, LIFT, 0, 1u, GESTURE_NONE},
+    {1450u, 0u, LIFT, 0, 1u, GESTURE_NONE},
+    {1600u, BTN2, LIFT, 0, 1u, GESTURE_NONE},
+    {1750u, 0u, LIFT, 0, 0u, GESTURE_NONE},
+    {5000u, BTN0, LIFT, 0, 0u, GESTURE_NONE},
+    {5150u, 0u, LIFT, 0, 0u, GESTURE_NONE},
+};
+
+#define STEPS(steps)        (steps), (uint8_t)(sizeof(steps) / sizeof((steps)[0u]))
+
+static const BENCH_SESSION_T sessions[] =
+{
+    {"buttons", 3000u, 0u, 7500u, 4u, 0, STEPS(buttonSteps), NULL, 0u, 20u, 0u},
+    {"swipes", 2000u, 0u, 7500u, 4u, 0, STEPS(swipeSteps), STEPS(swipeGestures), 20u, 150u},
+    {"taps", 4000u, 0u, 7500u, 4u, 0, STEPS(tapSteps), STEPS(tapGestures), 20u, 700u},
+    {"noise", 2500u, CONFIG_HIGH_NOISE, 7500u, 25u, 0, STEPS(noiseSteps), STEPS(noiseGestures), 40u, 200u},
+    {"drift", 10000u, CONFIG_TIER_50MS, 30000u, 4u, 5, STEPS(driftSteps), STEPS(driftGestures), 120u, 250u},
+    {"tier", 6000u, CONFIG_TIER_50MS, 7500u, 4u, 0, STEPS(tierSteps), NULL, 0u, 80u, 0u},
+    {"idle", 10000u, CONFIG_TIER_50MS, 30000u, 4u, 0, NULL, 0u, NULL, 0u, 0u, 0u},
+};
+
+#define SESSION_COUNT       (sizeof(sessions) / sizeof(sessions[0u]))
+
+static const char * const endNames[] = {"time", "hibernate", "reset", "watchdog", "idle"};
+
+/* State of the session process */
+static const BENCH_SESSION_T *session;
+static BENCH_RESULT_T result;
+static uint8_t nextStep;
+static SIM_TIMER_T stepTimer;
+static SIM_TIMER_T endTimer;
+static SIM_TIMER_T pollTimer;
+static SIM_TIMER_T byteTimer;
+static uint8_t configPending;
+static uint8_t readBuffer[MAILBOX_SIZE];
+static uint8_t readIndex;
+static uint8_t mailboxSeen;
+static uint8_t lastGeneration;
+static uint8_t lastButtons;
+static uint8_t lastSequence;
+
+static void Poll(void);
+static void ReadByte(void);
+
+
+/*******************************************************************************
+* Function Name: Step()
+********************************************************************************
+*
+* Summary:
+*   Puts the next script step on the panel.
+*
+*******************************************************************************/
+static void Step(void)
+{
+    const BENCH_STEP_T *step = &session->steps[nextStep++];
+
+    simPanel.buttons = step->buttons;
+    simPanel.position = step->position;
+    simPanel.speed = step->speed;
+    simPanel.moveStart = simNow;
+    simPanel.hand = step->hand;
+
+    if(nextStep < session->stepCount)
+    {
+        SimTimerStart(&stepTimer, (uint64_t)session->steps[nextStep].at * SIM_US_PER_MS, Step);
+    }
+}
+
+static void SessionEnd(void)
+{
+    SimEnd(SIM_END_TIME);
+}
+
+
+/*******************************************************************************
+* Function Name: Poll()
+********************************************************************************
+*
+* Summary:
+*   Starts a master transfer. The configuration byte is written until the
+*   slave acknowledges it, then every poll reads the mailbox from the
+*   sub-address 0 the write left behind, one byte per ReadByte().
+*
+*******************************************************************************/
+static void Poll(void)
+{
+    SimTimerStart(&pollTimer, simNow + session->pollPeriod, Poll);
+    if(byteTimer.armed != 0u)
+    {
+        /* The previous read is still on the bus */
+    }
+    else if(configPending != 0u)
+    {
+        if(SimEzi2cStart(0u) != 0u)
+        {
+            SimEzi2cWrite(CONFIG_INDEX);
+            SimEzi2cWrite(session->config);
+            configPending = 0u;
+        }
+    }
+    else if(SimEzi2cStart(1u) != 0u)
+    {
+        readIndex = 0u;
+        SimTimerStart(&byteTimer, simNow + BENCH_I2C_BYTE_TIME, ReadByte);
+    }
+    else
+    {
+        /* Slave not ready, no buffer yet */
+    }
+}
+
+/* Reads the next byte and checks the mailbox once the last one is in */
+static void ReadByte(void)
+{
+    uint8_t generation;
+
+    readBuffer[readIndex++] = SimEzi2cRead();
+    if(readIndex < MAILBOX_SIZE)
+    {
+        SimTimerStart(&byteTimer, simNow + BENCH_I2C_BYTE_TIME, ReadByte);
+        return;
+    }
+
+    generation = readBuffer[MAILBOX_GEN_HEAD_INDEX];
+    if(generation != readBuffer[MAILBOX_GEN_TAIL_INDEX])
+    {
+        /* Overlapped a publication, read again */
+        result.torn++;
+        (void)SimEzi2cStart(1u);
+        readIndex = 0u;
+        SimTimerStart(&byteTimer, simNow + BENCH_I2C_BYTE_TIME, ReadByte);
+        return;
+    }
+    if((mailboxSeen != 0u) && (generation == lastGeneration))
+    {
+        return;
+    }
+
+    if(mailboxSeen != 0u)
+    {
+        result.publications += (uint8_t)(generation - lastGeneration);
+        result.updates++;
+    }
+    if((readBuffer[BUTTON_STATUS_INDEX1] != lastButtons) && (result.eventCount < BENCH_MAX_EVENTS))
+    {
+        result.events[result.eventCount].at = simNow;
+        result.events[result.eventCount].buttons = readBuffer[BUTTON_STATUS_INDEX1];
+        result.events[result.eventCount].gesture = GESTURE_NONE;
+        result.eventCount++;
+    }
+    if((readBuffer[SLIDER_SEQUENCE_INDEX] != lastSequence) && (result.eventCount < BENCH_MAX_EVENTS))
+    {
+        result.events[result.eventCount].at = simNow;
+        result.events[result.eventCount].buttons = readBuffer[BUTTON_STATUS_INDEX1];
+        result.events[result.eventCount].gesture = readBuffer[SLIDER_GESTURE_INDEX];
+        result.eventCount++;
+    }
+    mailboxSeen = 1u;
+    lastGeneration = generation;
+    lastButtons = readBuffer[BUTTON_STATUS_INDEX1];
+    lastSequence = readBuffer[SLIDER_SEQUENCE_INDEX];
+}
+
+
+/*******************************************************************************
+* Function Name: Measure()
+********************************************************************************
+*
+* Summary:
+*   Finds the first event the master saw at or after a step time that
+*   matches the step and adds its latency. A step that is never seen marks
+*   the session as missed.
+*
+*******************************************************************************/
+static void Measure(BENCH_LATENCY_T *latency, uint64_t stepAt, uint8_t buttons, uint8_t gesture)
+{
+    uint32_t index;
+    const BENCH_EVENT_T *event;
+
+    for(index = 0u; index < result.eventCount; index++)
+    {
+        event = &result.events[index];
+        if((event->at >= stepAt) && (event->gesture == gesture) &&
+           ((gesture != GESTURE_NONE) || (event->buttons == buttons)))
+        {
+            latency->count++;
+            latency->sum += event->at - stepAt;
+            if((event->at - stepAt) > latency->max)
+            {
+                latency->max = event->at - stepAt;
+            }
+            return;
+        }
+    }
+    result.missed = 1u;
+}
+
+static void Evaluate(void)
+{
+    const BENCH_STEP_T *step;
+    uint8_t buttons = 0u;
+    uint8_t index;
+
+    for(index = 0u; index < session->stepCount; index++)
+    {
+        step = &session->steps[index];
+        if(step->buttons != buttons)
+        {
+            Measure(&result.buttonLatency, (uint64_t)step->at * SIM_US_PER_MS, step->buttons, GESTURE_NONE);
+            buttons = step->buttons;
+        }
+        if(step->gesture != GESTURE_NONE)
+        {
+            Measure(&result.gestureLatency, (uint64_t)step->at * SIM_US_PER_MS, 0u, step->gesture);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: RunSession()
+********************************************************************************
+*
+* Summary:
+*   Runs a session in the current process and writes its result to fd.
+*
+*******************************************************************************/
+static void RunSession(const BENCH_SESSION_T *run, int fd)
+{
+    session = run;
+    simPanel.noise = run->noise;
+    simPanel.drift = run->drift;
+    configPending = 1u;
+    if(run->stepCount != 0u)
+    {
+        SimTimerStart(&stepTimer, (uint64_t)run->steps[0u].at * SIM_US_PER_MS, Step);
+    }
+    SimTimerStart(&pollTimer, run->pollPeriod, Poll);
+    SimTimerStart(&endTimer, (uint64_t)run->duration * SIM_US_PER_MS, SessionEnd);
+
+    (void)memset(&result, 0, sizeof(result));
+    result.end = SimRun(SimCapSenseMain);
+    SimClose(&simCapSenseCpu);
+
+    result.time = simNow;
+    result.capSense = simCapSense;
+    result.cpu = simCapSenseCpu;
+    result.cpu.name = NULL;
+    result.startupTime = Tuning_startupTime;
+    Evaluate();
+
+    if(write(fd, &result, sizeof(result)) != (ssize_t)sizeof(result))
+    {
+        _exit(2);
+    }
+    _exit(0);
+}
+
+
+/*******************************************************************************
+* Function Name: Check()
+********************************************************************************
+*
+* Summary:
+*   Compares a session result with what the session expects: the button
+*   changes of the script and its gestures in order, nothing else, each
+*   within the latency limits.
+*
+* Return:
+*  Non-zero when the session passed.
+*
+*******************************************************************************/
+static uint8_t Check(const BENCH_SESSION_T *run, const BENCH_RESULT_T *outcome)
+{
+    uint8_t gestures[BENCH_MAX_EVENTS];
+    uint32_t gestureCount = 0u;
+    uint32_t buttonCount = 0u;
+    uint32_t expectedButtons = 0u;
+    uint8_t buttons = 0u;
+    uint32_t index;
+    uint8_t passed = 1u;
+
+    for(index = 0u; index < run->stepCount; index++)
+    {
+        if(run->steps[index].buttons != buttons)
+        {
+            expectedButtons++;
+            buttons = run->steps[index].buttons;
+        }
+    }
+    for(index = 0u; index < outcome->eventCount; index++)
+    {
+        if(outcome->events[index].gesture != GESTURE_NONE)
+        {
+            gestures[gestureCount++] = outcome->events[index].gesture;
+        }
+        else
+        {
+            buttonCount++;
+        }
+    }
+
+    if(outcome->end != SIM_END_TIME)
+    {
+        printf("  %s: ended by %s\n", run->name, endNames[outcome->end]);
+        passed = 0u;
+    }
+    if(buttonCount != expectedButtons)
+    {
+        printf("  %s: %lu button changes seen, %lu expected\n", run->name, (unsigned long)buttonCount,
+               (unsigned long)expectedButtons);
+        passed = 0u;
+    }
+    if((gestureCount != run->gestureCount) || (memcmp(gestures, run->gestures, gestureCount) != 0))
+    {
+        printf("  %s: %lu gestures seen, %u expected\n", run->name, (unsigned long)gestureCount, run->gestureCount);
+        passed = 0u;
+    }
+    if(outcome->missed != 0u)
+    {
+        printf("  %s: a script step was not seen by the master\n", run->name);
+        passed = 0u;
+    }
+    if(outcome->buttonLatency.max > ((uint64_t)run->buttonLimit * SIM_US_PER_MS))
+    {
+        printf("  %s: button latency %lu us over the limit of %lu ms\n", run->name,
+               (unsigned long)outcome->buttonLatency.max, (unsigned long)run->buttonLimit);
+        passed = 0u;
+    }
+    if(outcome->gestureLatency.max > ((uint64_t)run->gestureLimit * SIM_US_PER_MS))
+    {
+        printf("  %s: gesture latency %lu us over the limit of %lu ms\n", run->name,
+               (unsigned long)outcome->gestureLatency.max, (unsigned long)run->gestureLimit);
+        passed = 0u;
+    }
+    return (passed);
+}
+
+/* Per second of simulated time */
+static double Rate(uint32_t count, uint64_t time)
+{
+    return ((time != 0u) ? (((double)count * 1000000.0) / (double)time) : 0.0);
+}
+
+static double Percent(uint64_t part, uint64_t time)
+{
+    return ((time != 0u) ? ((100.0 * (double)part) / (double)time) : 0.0);
+}
+
+static double Average(const BENCH_LATENCY_T *latency)
+{
+    return ((latency->count != 0u) ? ((double)latency->sum / (double)latency->count / 1000.0) : 0.0);
+}
+
+
+/*******************************************************************************
+* Function Name: ReadRates()
+********************************************************************************
+*
+* Summary:
+*   Reads the scans per second of each session from a file written with
+*   --rates, one "<session> <scans/s>" line per session.
+*
+* Return:
+*  Non-zero when the file has a rate for every session.
+*
+*******************************************************************************/
+static uint8_t ReadRates(const char *path, double rates[])
+{
+    FILE *file = fopen(path, "r");
+    char name[16];
+    double rate;
+    uint8_t found = 0u;
+    uint8_t index;
+
+    if(file == NULL)
+    {
+        return (0u);
+    }
+    while(fscanf(file, "%15s %lf", name, &rate) == 2)
+    {
+        for(index = 0u; index < SESSION_COUNT; index++)
+        {
+            if((strcmp(name, sessions[index].name) == 0) && (rates[index] == 0.0))
+            {
+                rates[index] = rate;
+                found++;
+            }
+        }
+    }
+    (void)fclose(file);
+    return ((uint8_t)(found == SESSION_COUNT));
+}
+
+
+int main(int argc, char *argv[])
+{
+    BENCH_RESULT_T received;
+    double serialRates[SESSION_COUNT] = {0.0};
+    FILE *rates = NULL;
+    uint8_t compare = 0u;
+    uint8_t index;
+    uint8_t failed = 0u;
+    pid_t child;
+    int status;
+    int fds[2];
+
+    if((argc == 3) && (strcmp(argv[1u], "--rates") == 0))
+    {
+        rates = fopen(argv[2u], "w");
+        if(rates == NULL)
+        {
+            fprintf(stderr, "%s: can not write %s\n", argv[0u], argv[2u]);
+            return (2);
+        }
+    }
+    else if((argc == 3) && (strcmp(argv[1u], "--serial") == 0))
+    {
+        if(ReadRates(argv[2u], serialRates) == 0u)
+        {
+            fprintf(stderr, "%s: no scan rate for every session in %s\n", argv[0u], argv[2u]);
+            return (2);
+        }
+        compare = 1u;
+    }
+    else if(argc != 1)
+    {
+        fprintf(stderr, "usage: %s [--rates <file> | --serial <file>]\n", argv[0u]);
+        return (2);
+    }
+
+    printf("%-8s %-5s %3s %7s %7s %6s %6s %5s %7s %7s %7s %7s %6s %6s %5s%s\n", "session", "end", "evt", "frm/s",
+           "scan/s", "pub/s", "upd/s", "torn", "btn avg", "btn max", "gst avg", "gst max", "act%", "slp%",
+           "start", (compare != 0u) ? " x serial" : "");
+    for(index = 0u; index < SESSION_COUNT; index++)
+    {
+        (void)fflush(stdout);
+        if(pipe(fds) != 0)
+        {
+            return (2);
+        }
+        child = fork();
+        if(child == 0)
+        {
+            (void)close(fds[0u]);
+            RunSession(&sessions[index], fds[1u]);
+        }
+        (void)close(fds[1u]);
+        (void)memset(&received, 0, sizeof(received));
+        if((child < 0) || (read(fds[0u], &received, sizeof(received)) != (ssize_t)sizeof(received)))
+        {
+            printf("%-8s did not report a result\n", sessions[index].name);
+            failed++;
+            (void)close(fds[0u]);
+            (void)waitpid(child, &status, 0);
+            continue;
+        }
+        (void)close(fds[0u]);
+        (void)waitpid(child, &status, 0);
+
+        printf("%-8s %-5s %3lu %7.1f %7.1f %6.1f %6.1f %5lu %7.1f %7.1f %7.1f %7.1f %6.2f %6.2f %5u",
+               sessions[index].name, endNames[received.end], (unsigned long)received.eventCount,
+               Rate(received.capSense.frames, received.time), Rate(received.capSense.scans, received.time),
+               Rate(received.publications, received.time), Rate(received.updates, received.time),
+               (unsigned long)received.torn, Average(&received.buttonLatency),
+               (double)received.buttonLatency.max / 1000.0, Average(&received.gestureLatency),
+               (double)received.gestureLatency.max / 1000.0, Percent(received.cpu.activeTime, received.time),
+               Percent(received.cpu.sleepTime, received.time), received.startupTime);
+        if(compare != 0u)
+        {
+            printf(" %8.2f", (serialRates[index] != 0.0) ?
+                   (Rate(received.capSense.scans, received.time) / serialRates[index]) : 0.0);
+        }
+        printf("\n");
+        if(rates != NULL)
+        {
+            fprintf(rates, "%s %.1f\n", sessions[index].name, Rate(received.capSense.scans, received.time));
+        }
+
+        if(Check(&sessions[index], &received) == 0u)
+        {
+            failed++;
+        }
+    }
+
+    printf("%u of %u sessions failed\n", failed, (unsigned int)SESSION_COUNT);
+    if(rates != NULL)
+    {
+        /* Reference run */
+        (void)fclose(rates);
+        return (0);
+    }
+    return ((failed == 0u) ? 0 : 1);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,244 @@
+/*******************************************************************************
+* File Name: bench_hids.c
+*
+* Version 1.0
+*
+* Description:
+*  Benchmark of the HID transmit path on the host: the queue and send loop
+*  of hids.c against the loop it replaced, which read the protocol mode
+*  from the GATT database for every report, branched on it twice and
+*  printed the report in ten debug calls. Both send the same reports
+*  through the fake stack of fakes/ble. The current loop also counts the
+*  report for the host and marks the first report of the boot, which came
+*  later; the replaced one is run without them.
+*
+*  The Makefile builds the firmware and this file with printf renamed to
+*  BenchDebugPrintf(), which counts the debug output calls and formats them
+*  into /dev/null, the way the debug UART would take them. The benchmark
+*  prints the stack calls and debug calls per report, which are the same on
+*  the target, and the host time per report, which only compares the two
+*  paths with each other. It exits non-zero when the current path needs
+*  more than one stack call or one debug call per report.
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include "common.h"
+#include "hids.h"
+
+#define BENCH_REPORTS               (200000u)   /* Reports per run */
+#define BENCH_RUNS                  (15u)       /* Runs per path, in turns, the fastest counts */
+
+/* Operations and time of one run */
+typedef struct
+{
+    const char *name;
+    uint32_t reads;                 /* CyBle_HidssGetCharacteristicValue() calls */
+    uint32_t notifications;         /* CyBle_HidssSendNotification() calls */
+    uint32_t debugCalls;            /* printf() calls of the debug output */
+    uint64_t time;                  /* ns on the host, fastest run */
+} BENCH_RESULT_T;
+
+static FILE *debugUart;
+static uint32_t debugCalls;
+
+/* Queue of the replaced path, as hids.c had it */
+static uint8 legacyQueue[HID_QUEUE_SIZE][KEYBOARD_DATA_SIZE];
+static uint8 legacyHead = 0u;
+static uint8 legacyTail = 0u;
+
+
+/* The debug output of the firmware, see the Makefile */
+int BenchDebugPrintf(const char *format, ...)
+{
+    va_list args;
+    int written;
+
+    debugCalls++;
+    va_start(args, format);
+    written = vfprintf(debugUart, format, args);
+    va_end(args);
+    return (written);
+}
+
+
+/*******************************************************************************
+* Function Name: LegacyQueueReport(), LegacyProcessQueue()
+********************************************************************************
+*
+* Summary:
+*   HidsQueueReport() and HidsProcessQueue() before the protocol mode was
+*   cached, without the statistics.
+*
+*******************************************************************************/
+static void LegacyQueueReport(const uint8 report[])
+{
+    uint8 i;
+
+    if((uint8)(legacyHead - legacyTail) >= HID_QUEUE_SIZE)
+    {
+        return;
+    }
+    for(i = 0u; i < KEYBOARD_DATA_SIZE; i++)
+    {
+        legacyQueue[legacyHead & (HID_QUEUE_SIZE - 1u)][i] = report[i];
+    }
+    legacyHead++;
+    SetPendingWork(WORK_HID);
+}
+
+static void LegacyProcessQueue(void)
+{
+    CYBLE_API_RESULT_T apiResult;
+    uint8 *report;
+    uint8 i;
+
+    while((legacyHead != legacyTail) && (CyBle_GattGetBusyStatus() == CYBLE_STACK_STATE_FREE))
+    {
+        report = legacyQueue[legacyTail & (HID_QUEUE_SIZE - 1u)];
+
+        apiResult = CyBle_HidssGetCharacteristicValue(CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX,
+            CYBLE_HIDS_PROTOCOL_MODE, sizeof(protocol), &protocol);
+        if(apiResult == CYBLE_ERROR_OK)
+        {
+            DBG_PRINTF("HID notification @%lu: ", timerTicks);
+            for(i = 0; i < KEYBOARD_DATA_SIZE; i++)
+            {
+                DBG_PRINTF("%2.2x,", report[i]);
+            }
+            DBG_PRINTF("\r\n");
+
+            if(protocol == CYBLE_HIDS_PROTOCOL_MODE_BOOT)
+            {
+                apiResult = CyBle_HidssSendNotification(cyBle_connHandle, CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX,
+                    CYBLE_HIDS_BOOT_KYBRD_IN_REP, KEYBOARD_DATA_SIZE, report);
+            }
+            else
+            {
+                apiResult = CyBle_HidssSendNotification(cyBle_connHandle, CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX,
+                    CYBLE_HUMAN_INTERFACE_DEVICE_REPORT_IN, KEYBOARD_DATA_SIZE, report);
+            }
+        }
+        if(apiResult != CYBLE_ERROR_OK)
+        {
+            DBG_PRINTF("HID notification API Error: %x \r\n", apiResult);
+            keyboardSimulation = DISABLED;
+            legacyTail = legacyHead;
+        }
+        else
+        {
+            legacyTail++;
+        }
+    }
+}
+
+static void LegacySend(const uint8 report[])
+{
+    LegacyQueueReport(report);
+    LegacyProcessQueue();
+}
+
+static void CurrentSend(const uint8 report[])
+{
+    (void)HidsQueueReport(report);
+    HidsProcessQueue();
+}
+
+static uint64_t Now(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (((uint64_t)now.tv_sec * 1000000000u) + (uint64_t)now.tv_nsec);
+}
+
+
+/*******************************************************************************
+* Function Name: Run()
+********************************************************************************
+*
+* Summary:
+*   Sends BENCH_REPORTS key presses in boot protocol mode, which the fake
+*   GATT database holds, through one path.
+*
+* Parameters:
+*  send - queues and sends one report
+*  result - operations of the run, the time is kept when it is the fastest
+*
+*******************************************************************************/
+static void Run(void (*send)(const uint8 report[]), BENCH_RESULT_T *result)
+{
+    uint8 report[KEYBOARD_DATA_SIZE];
+    uint8 key = 0x04u;
+    uint32_t index;
+    uint64_t start;
+    uint64_t time;
+
+    FakeBleReset();
+    fakeState = CYBLE_STATE_CONNECTED;
+    keyboardSimulation = ENABLED;
+    HidsCallBack(CYBLE_EVT_HIDSS_BOOT_MODE_ENTER, NULL);
+    debugCalls = 0u;
+    start = Now();
+    for(index = 0u; index < BENCH_REPORTS; index++)
+    {
+        HidsEncodeKeyboard(report, 0u, &key, 1u);
+        send(report);
+    }
+    time = Now() - start;
+    result->time = (time < result->time) ? time : result->time;
+    result->reads = fakeCharValueReads;
+    result->notifications = fakeReportCount;
+    result->debugCalls = debugCalls;
+}
+
+/* Per report of a run */
+static double PerReport(uint64_t count)
+{
+    return ((double)count / BENCH_REPORTS);
+}
+
+
+int main(void)
+{
+    BENCH_RESULT_T results[2u] = {{"legacy", 0u, 0u, 0u, UINT64_MAX}, {"current", 0u, 0u, 0u, UINT64_MAX}};
+    uint8_t index;
+    uint32_t run;
+
+    debugUart = fopen("/dev/null", "w");
+    if(debugUart == NULL)
+    {
+        return (2);
+    }
+    /* In turns, so both paths see the same load of the host */
+    for(run = 0u; run < BENCH_RUNS; run++)
+    {
+        Run(LegacySend, &results[0u]);
+        Run(CurrentSend, &results[1u]);
+    }
+    (void)fclose(debugUart);
+
+    fprintf(stdout, "%-8s %7s %7s %7s %9s %9s\n", "path", "reads", "sends", "debug", "ns/report", "x legacy");
+    for(index = 0u; index < 2u; index++)
+    {
+        fprintf(stdout, "%-8s %7.2f %7.2f %7.2f %9.1f %9.2f\n", results[index].name,
+                PerReport(results[index].reads), PerReport(results[index].notifications),
+                PerReport(results[index].debugCalls), PerReport(results[index].time),
+                (double)results[0u].time / (double)results[index].time);
+    }
+    if((results[1u].reads != 0u) || (results[1u].notifications != BENCH_REPORTS) ||
+       (results[1u].debugCalls != BENCH_REPORTS))
+    {
+        fprintf(stdout, "current path: more than one stack or debug call per report\n");
+        return (1);
+    }
+    return (0);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,429 @@
+/*******************************************************************************
+* File Name: bench_ota.c
+*
+* Version 1.0
+*
+* Description:
+*  Benchmark of an over-the-air image transfer on the host simulation. The
+*  central of sim/ble.c sends a packed image (see ota/ota.h) in write
+*  commands at the MTU it agrees on connection, and a model of the device
+*  side of the update writes it to flash row by row and acknowledges it in
+*  notifications. Each run connects at one interval and MTU and reports the
+*  throughput, from the first write to the notification that the image
+*  passed its CRC check.
+*
+*  The firmware has no update service yet, it needs the bootloader and the
+*  BLE component customizer; the device model stands for its main loop.
+*  Each run is a child process, like the sessions of bench_ble, since the
+*  simulated stack keeps its state in statics. The benchmark exits non-zero
+*  when a transfer fails or does not finish in time.
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <project.h>
+#include "ota/ota.h"
+#include "sim/ble.h"
+
+#define BENCH_IMAGE_SIZE            (16000u)    /* About the size of the BLE application */
+#define BENCH_TIMEOUT               (120000u)   /* ms a transfer may take */
+#define BENCH_START_DELAY           (20000u)    /* us from the connection to the first write */
+#define BENCH_FEED_PERIOD           (1250u)     /* us the central tops its write queue up */
+#define BENCH_PACKETS_PER_EVENT     (6u)
+#define BENCH_OTA_HANDLE            (0x0040u)   /* Value handle of the update characteristic */
+
+/* Connection intervals in 1.25 ms units and MTUs of the runs */
+static const uint16_t intervals[] = {6u, 12u, 24u, 36u};
+static const uint16_t mtus[] = {23u, 64u, 158u, 247u};
+
+/* Sent from the run process to the benchmark */
+typedef struct
+{
+    uint8_t end;
+    uint8_t status;                 /* OTA_STATUS_xxx of the last acknowledgement */
+    uint16_t mtu;
+    uint64_t start;                 /* us of the first write */
+    uint64_t done;                  /* us of the final acknowledgement */
+    uint32_t writes;
+    uint32_t events;
+    SIM_CPU_T cpu;
+} BENCH_RESULT_T;
+
+/* Image, packed once before the runs */
+static uint8_t packed[OTA_HEADER_SIZE + BENCH_IMAGE_SIZE + OTA_ROW_SIZE];
+static uint32_t packedSize;
+
+/* Central */
+static SIM_TIMER_T feedTimer;
+static SIM_TIMER_T endTimer;
+static uint32_t sentOffset;
+static uint32_t ackOffset;
+static uint8_t ackStatus = OTA_STATUS_CONTINUE;
+static uint64_t startAt;
+static uint64_t doneAt;
+
+/* Device: bytes received and not yet written, the header and the row being filled */
+static uint8_t ring[OTA_WINDOW];
+static uint32_t ringHead;
+static uint32_t ringCount;
+static uint32_t received;           /* Packed image bytes received */
+static uint32_t written;            /* Packed image bytes consumed: the header and rows written */
+static uint32_t acknowledged;
+static uint8_t headerBytes[OTA_HEADER_SIZE];
+static OTA_HEADER_T header;
+static uint8_t status = OTA_STATUS_CONTINUE;
+static uint8_t ackPending;
+
+
+/*******************************************************************************
+* Device
+*******************************************************************************/
+/* Takes the oldest bytes out of the ring */
+static void RingTake(uint8_t *data, uint32_t size)
+{
+    while(size-- != 0u)
+    {
+        *data++ = ring[ringHead];
+        ringHead = (ringHead + 1u) % OTA_WINDOW;
+        ringCount--;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Receive()
+********************************************************************************
+*
+* Summary:
+*   Takes a chunk out of a write command into the ring. A chunk that does
+*   not continue the image, or would overflow the ring, abandons the update.
+*
+*******************************************************************************/
+static void Receive(const CYBLE_GATTS_WRITE_CMD_REQ_PARAM_T *write)
+{
+    const CYBLE_GATT_VALUE_T *value = &write->handleValPair.value;
+    uint32_t payload;
+    uint32_t index;
+
+    if((write->handleValPair.attrHandle != BENCH_OTA_HANDLE) || (status != OTA_STATUS_CONTINUE))
+    {
+        return;
+    }
+    payload = (uint32_t)value->len - OTA_CHUNK_HEADER;
+    if((value->len <= OTA_CHUNK_HEADER) || (OtaChunkOffset(value->val) != received) ||
+       ((ringCount + payload) > OTA_WINDOW))
+    {
+        status = OTA_STATUS_ERROR;
+        ackPending = 1u;
+        return;
+    }
+    for(index = 0u; index < payload; index++)
+    {
+        ring[(ringHead + ringCount) % OTA_WINDOW] = value->val[OTA_CHUNK_HEADER + index];
+        ringCount++;
+    }
+    received += payload;
+}
+
+static void AppCallback(uint32 event, void *eventParam)
+{
+    switch(event)
+    {
+        case CYBLE_EVT_STACK_ON:
+        case CYBLE_EVT_GAP_DEVICE_DISCONNECTED:
+            (void)CyBle_GappStartAdvertisement(CYBLE_ADVERTISING_FAST);
+            break;
+        case CYBLE_EVT_GATTS_WRITE_CMD_REQ:
+            Receive((CYBLE_GATTS_WRITE_CMD_REQ_PARAM_T *)eventParam);
+            break;
+        default:
+            break;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Program()
+********************************************************************************
+*
+* Summary:
+*   Consumes the header, then writes one row of the image when the ring
+*   holds it. After the last row it checks the CRC of the image in flash.
+*
+* Return:
+*  Non-zero when there was something to do.
+*
+*******************************************************************************/
+static uint8_t Program(void)
+{
+    uint8_t row[OTA_ROW_SIZE];
+
+    if(status != OTA_STATUS_CONTINUE)
+    {
+        return (0u);
+    }
+    if(written == 0u)
+    {
+        if(ringCount < OTA_HEADER_SIZE)
+        {
+            return (0u);
+        }
+        RingTake(headerBytes, OTA_HEADER_SIZE);
+        written = OTA_HEADER_SIZE;
+        if((OtaParseHeader(headerBytes, &header) == 0u) || (header.size > SIM_FLASH_SIZE))
+        {
+            status = OTA_STATUS_ERROR;
+            ackPending = 1u;
+        }
+        return (1u);
+    }
+    if(ringCount < OTA_ROW_SIZE)
+    {
+        return (0u);
+    }
+    RingTake(row, OTA_ROW_SIZE);
+    (void)CySysFlashWriteRow((written - OTA_HEADER_SIZE) / OTA_ROW_SIZE, row);
+    written += OTA_ROW_SIZE;
+    if(written >= OtaPackedSize(header.size))
+    {
+        status = (OtaVerify(simFlash, &header) != 0u) ? OTA_STATUS_DONE : OTA_STATUS_ERROR;
+        ackPending = 1u;
+    }
+    else if((written - acknowledged) >= (OTA_WINDOW / 2u))
+    {
+        ackPending = 1u;
+    }
+    else
+    {
+        /* Acknowledged with a later row */
+    }
+    return (1u);
+}
+
+/* Sends a pending acknowledgement, again in a later pass while the stack is busy */
+static void Acknowledge(void)
+{
+    CYBLE_GATTS_HANDLE_VALUE_NTF_T notification;
+    uint8_t ack[OTA_ACK_SIZE];
+
+    OtaAck(status, written, ack);
+    notification.attrHandle = BENCH_OTA_HANDLE;
+    notification.value.val = ack;
+    notification.value.len = OTA_ACK_SIZE;
+    if(CyBle_GattsNotification(cyBle_connHandle, &notification) == CYBLE_ERROR_OK)
+    {
+        acknowledged = written;
+        ackPending = 0u;
+    }
+}
+
+/* Main loop of the device model, in place of the firmware main() */
+int BleMain(void)
+{
+    uint8_t busy;
+
+    (void)CyBle_Start(AppCallback);
+    for(;;)
+    {
+        CyBle_ProcessEvents();
+        busy = Program();
+        if((ackPending != 0u) && (CyBle_GetState() == CYBLE_STATE_CONNECTED))
+        {
+            Acknowledge();
+        }
+        if((busy == 0u) && (ackPending == 0u))
+        {
+            CySysPmSleep();
+        }
+    }
+}
+
+/* The device model does not use the I2C master */
+void I2CHW_I2C_ISR_ExitCallback(void)
+{
+}
+
+
+/*******************************************************************************
+* Central
+*******************************************************************************/
+/*******************************************************************************
+* Function Name: Feed()
+********************************************************************************
+*
+* Summary:
+*   Tops the write queue of the central up with the next chunks, keeping
+*   at most OTA_WINDOW bytes beyond the last acknowledgement in flight.
+*
+*******************************************************************************/
+static void Feed(void)
+{
+    uint8_t chunk[SIM_BLE_MAX_MTU];
+    uint16_t size;
+
+    while(ackStatus == OTA_STATUS_CONTINUE)
+    {
+        size = OtaChunk(packed, packedSize, simBle.mtu, sentOffset, chunk);
+        if((size == 0u) || ((sentOffset + size - OTA_CHUNK_HEADER - ackOffset) > OTA_WINDOW) ||
+           (SimCentralWrite(BENCH_OTA_HANDLE, chunk, size) == 0u))
+        {
+            break;
+        }
+        if(sentOffset == 0u)
+        {
+            startAt = simNow;
+        }
+        sentOffset += (uint32_t)size - OTA_CHUNK_HEADER;
+    }
+    if(ackStatus == OTA_STATUS_CONTINUE)
+    {
+        SimTimerStart(&feedTimer, simNow + BENCH_FEED_PERIOD, Feed);
+    }
+}
+
+static void Notification(uint16_t attrHandle, const uint8_t *data, uint16_t size)
+{
+    if((attrHandle != BENCH_OTA_HANDLE) || (size != OTA_ACK_SIZE))
+    {
+        return;
+    }
+    ackStatus = data[0u];
+    ackOffset = OtaAckOffset(data);
+    if(ackStatus != OTA_STATUS_CONTINUE)
+    {
+        doneAt = simNow;
+        SimEnd(SIM_END_TIME);
+    }
+}
+
+static void RunEnd(void)
+{
+    SimEnd(SIM_END_TIME);
+}
+
+
+/*******************************************************************************
+* Function Name: RunTransfer()
+********************************************************************************
+*
+* Summary:
+*   Transfers the image at one interval and MTU in the current process and
+*   writes the result to fd.
+*
+*******************************************************************************/
+static void RunTransfer(uint16_t interval, uint16_t mtu, int fd)
+{
+    BENCH_RESULT_T result;
+    SIM_CENTRAL_T central = {300000u, 0u, 0u, 0u, 1u, 1000000u, BENCH_PACKETS_PER_EVENT, -60, 0u, NULL};
+
+    if(freopen("/dev/null", "w", stdout) == NULL)
+    {
+        _exit(2);
+    }
+    central.interval = interval;
+    central.minInterval = interval;
+    central.mtu = mtu;
+    central.notification = Notification;
+    simCentral = central;
+    SimTimerStart(&feedTimer, central.connectDelay + BENCH_START_DELAY, Feed);
+    SimTimerStart(&endTimer, (uint64_t)BENCH_TIMEOUT * SIM_US_PER_MS, RunEnd);
+
+    (void)memset(&result, 0, sizeof(result));
+    result.end = SimRun(SimBleMain);
+    SimClose(&simBleCpu);
+    result.status = ackStatus;
+    result.mtu = simBle.mtu;
+    result.start = startAt;
+    result.done = doneAt;
+    result.writes = simBle.writes;
+    result.events = simBle.events;
+    result.cpu = simBleCpu;
+    result.cpu.name = NULL;
+    if(write(fd, &result, sizeof(result)) != (ssize_t)sizeof(result))
+    {
+        _exit(2);
+    }
+    _exit(0);
+}
+
+/* Runs a transfer in a child process */
+static uint8_t Transfer(uint16_t interval, uint16_t mtu, BENCH_RESULT_T *result)
+{
+    pid_t child;
+    int status;
+    int fds[2];
+    uint8_t ok;
+
+    (void)fflush(stdout);
+    if(pipe(fds) != 0)
+    {
+        return (0u);
+    }
+    child = fork();
+    if(child == 0)
+    {
+        (void)close(fds[0u]);
+        RunTransfer(interval, mtu, fds[1u]);
+    }
+    (void)close(fds[1u]);
+    ok = (uint8_t)((child >= 0) && (read(fds[0u], result, sizeof(*result)) == (ssize_t)sizeof(*result)));
+    (void)close(fds[0u]);
+    (void)waitpid(child, &status, 0);
+    return (ok);
+}
+
+
+int main(void)
+{
+    static uint8_t image[BENCH_IMAGE_SIZE];
+    BENCH_RESULT_T result;
+    uint32_t index;
+    uint8_t interval;
+    uint8_t mtu;
+    uint8_t failed = 0u;
+    double time;
+
+    /* Any content does, as long as the CRC covers every byte */
+    for(index = 0u; index < BENCH_IMAGE_SIZE; index++)
+    {
+        image[index] = (uint8_t)((index * 7u) ^ (index >> 8u));
+    }
+    packedSize = OtaPack(image, BENCH_IMAGE_SIZE, 1u, packed, sizeof(packed));
+
+    printf("image %u bytes, %lu packed, %u bytes in flight, %u packets per event\n", BENCH_IMAGE_SIZE,
+           (unsigned long)packedSize, OTA_WINDOW, BENCH_PACKETS_PER_EVENT);
+    printf("%6s %4s %5s %6s %8s %8s %8s %6s\n", "intv", "mtu", "chunk", "writes", "time s", "B/s",
+           "B/event", "act%");
+    for(interval = 0u; interval < (sizeof(intervals) / sizeof(intervals[0u])); interval++)
+    {
+        for(mtu = 0u; mtu < (sizeof(mtus) / sizeof(mtus[0u])); mtu++)
+        {
+            if((Transfer(intervals[interval], mtus[mtu], &result) == 0u) || (result.status != OTA_STATUS_DONE) ||
+               (result.mtu != mtus[mtu]))
+            {
+                printf("%6.2f %4u transfer failed, status %u\n", intervals[interval] * 1.25, mtus[mtu],
+                       result.status);
+                failed++;
+                continue;
+            }
+            time = (double)(result.done - result.start) / 1e6;
+            printf("%6.2f %4u %5u %6lu %8.2f %8.0f %8.1f %6.2f\n", intervals[interval] * 1.25, result.mtu,
+                   OtaChunkPayload(result.mtu), (unsigned long)result.writes, time, (double)packedSize / time,
+                   (double)packedSize / (time * 1e6 / (intervals[interval] * 1250.0)),
+                   (100.0 * (double)result.cpu.activeTime) / (double)result.done);
+        }
+    }
+    printf("%u of %u transfers failed\n", failed,
+           (unsigned)((sizeof(intervals) / sizeof(intervals[0u])) * (sizeof(mtus) / sizeof(mtus[0u]))));
+    return ((failed == 0u) ? 0 : 1);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,681 @@
+/*******************************************************************************
+* File Name: bench_system.c
+*
+* Version 1.0
+*
+* Description:
+*  Benchmark of the complete keyboard on the host simulation: the BLE and
+*  the CapSense firmware run together with SimRunCpus(), and the BLE MCU
+*  polls the mailbox the CapSense firmware publishes over the simulated
+*  EZI2C bus. Each session plays a script of fingers and hands on the
+*  synthetic panel and a bonded central receives the keys. The latency of a
+*  step is the time from the touch to the first report of its key on air,
+*  so it covers the scan, the gesture detection, the mailbox poll and the
+*  connection interval.
+*
+*  Both firmwares keep their state in statics with clashing names, so the
+*  Makefile links each one as a relocatable object that only exports its
+*  simulation interface. A session runs in a child process, since the
+*  firmwares never return from main().
+*
+*  Without arguments the benchmark prints a table and exits non-zero when a
+*  session sends wrong keys, exceeds its latency limit or ends the wrong
+*  way. With --csv it prints one row of metrics over all sessions instead,
+*  for the parameter sweep of the Makefile. With --pareto <file> it prints
+*  the rows of a sweep result that no other valid row beats in both mean
+*  latency and current.
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "sim/ble.h"
+#include "sim/capsense.h"
+
+#define BENCH_LOG_DIR               "build"
+#define BENCH_MAX_KEYS              (32u)
+#define BENCH_MAX_ROWS              (1024u)
+#define BENCH_MAX_LINE              (256u)
+
+/* Typical supply currents of the current estimate, in microamps */
+#define BENCH_ACTIVE_CURRENT        (2500u)     /* BLE CPU running or in Sleep, as in stats.h */
+#define BENCH_DEEP_SLEEP_CURRENT    (2u)
+#define BENCH_RADIO_CURRENT         (5600u)     /* Radio receiving or transmitting at 0 dBm */
+#define BENCH_CAPSENSE_ACTIVE_CURRENT (2500u)   /* CapSense CPU running */
+#define BENCH_CAPSENSE_SLEEP_CURRENT (1300u)    /* CapSense CPU in Sleep, clocks running */
+#define BENCH_SCAN_CURRENT          (350u)      /* CSD block and IDACs while scanning, on top */
+
+/* Keys the BLE firmware sends for the panel */
+#define KEY_PAGE_UP                 (0x4Bu)     /* Swipe left */
+#define KEY_PAGE_DOWN               (0x4Eu)     /* Swipe right */
+#define KEY_F2                      (0x3Bu)     /* Long press */
+#define KEY_F3                      (0x3Cu)     /* BTN2 press */
+#define KEY_F5                      (0x3Eu)     /* BTN1 press */
+#define KEY_F6                      (0x3Fu)     /* BTN0 release */
+
+#define BTN0                        (0x01u)
+#define BTN1                        (0x02u)
+#define BTN2                        (0x04u)
+#define LIFT                        SIM_NO_FINGER
+
+/* What is on the panel from a script time on */
+typedef struct
+{
+    uint32_t at;                    /* ms after power on */
+    uint8_t buttons;
+    uint16_t position;              /* Finger on the slider, LIFT when none */
+    int16_t speed;                  /* Slider units per second */
+    uint8_t hand;
+    uint8_t keys;                   /* The step should send keys */
+} BENCH_STEP_T;
+
+typedef struct
+{
+    const char *name;
+    uint32_t duration;              /* ms */
+    const BENCH_STEP_T *steps;
+    uint8_t stepCount;
+    const uint8_t *keys;            /* Expected keys in order */
+    uint8_t keyCount;
+    uint32_t latencyLimit;          /* ms from a step to its first key on air */
+} BENCH_SESSION_T;
+
+/* Sent from the session process to the benchmark */
+typedef struct
+{
+    uint8_t end;
+    uint32_t reports;
+    uint32_t keyCount;
+    uint8_t keys[BENCH_MAX_KEYS];
+    uint32_t missed;                /* Expected keys not received */
+    uint32_t wrong;                 /* Received keys not expected */
+    uint32_t latencyCount;
+    uint64_t latencySum;            /* us */
+    uint64_t latencyMax;
+    SIM_CPU_T bleCpu;
+    SIM_CPU_T capSenseCpu;
+    uint32_t radioTime;
+    SIM_CAPSENSE_RESULT_T capSense;
+    uint64_t time;                  /* us simulated */
+    uint64_t advertisingAt;         /* us from power on to the first advertisement */
+    uint64_t connectedAt;           /* us from power on to the first connection */
+    uint64_t firstReportAt;         /* us from power on to the first report on air, 0 without reports */
+} BENCH_RESULT_T;
+
+
+/*******************************************************************************
+* Sessions
+*******************************************************************************/
+#define CENTRAL_BONDED      {300000u, 24u, 0u, 6u, 1u, 1000000u, 4u, -60, 0u, NULL}
+
+/* The hand hovers before the buttons, then one cold press without it */
+static const BENCH_STEP_T typingSteps[] =
+{
+    {1000u, 0u, LIFT, 0, 1u, 0u},
+    {1300u, BTN1, LIFT, 0, 1u, 1u},
+    {1450u, 0u, LIFT, 0, 1u, 0u},
+    {1800u, BTN2, LIFT, 0, 1u, 1u},
+    {1950u, 0u, LIFT, 0, 1u, 0u},
+    {2300u, BTN0, LIFT, 0, 1u, 0u},
+    {2450u, 0u, LIFT, 0, 1u, 1u},
+    {2600u, 0u, LIFT, 0, 0u, 0u},
+    {6000u, BTN1, LIFT, 0, 0u, 1u},
+    {6150u, 0u, LIFT, 0, 0u, 0u},
+};
+static const uint8_t typingKeys[] = {KEY_F5, KEY_F3, KEY_F6, KEY_F5};
+
+/* Page turns after a while of reading, the last one without a hover */
+static const BENCH_STEP_T browsingSteps[] =
+{
+    {2000u, 0u, LIFT, 0, 1u, 0u},
+    {2300u, 0u, 20u, 300, 1u, 1u},
+    {2500u, 0u, LIFT, 0, 1u, 0u},
+    {2600u, 0u, LIFT, 0, 0u, 0u},
+    {5000u, 0u, LIFT, 0, 1u, 0u},
+    {5300u, 0u, 80u, -300, 1u, 1u},
+    {5500u, 0u, LIFT, 0, 1u, 0u},
+    {5600u, 0u, LIFT, 0, 0u, 0u},
+    {8000u, 0u, 20u, 300, 0u, 1u},
+    {8200u, 0u, LIFT, 0, 0u, 0u},
+};
+static const uint8_t browsingKeys[] = {KEY_PAGE_DOWN, KEY_PAGE_UP, KEY_PAGE_DOWN};
+
+/* A long press, then a double tap with 200 ms between the taps that sends
+*  the station ID macro. The latency of the long press includes its hold. */
+static const BENCH_STEP_T mediaSteps[] =
+{
+    {2000u, 0u, 70u, 0, 0u, 1u},
+    {2800u, 0u, LIFT, 0, 0u, 0u},
+    {4000u, 0u, 30u, 0, 0u, 1u},
+    {4060u, 0u, LIFT, 0, 0u, 0u},
+    {4260u, 0u, 32u, 0, 0u, 0u},
+    {4320u, 0u, LIFT, 0, 0u, 0u},
+};
+static const uint8_t mediaKeys[] = {KEY_F2, 0x06u, 0x1Cu, 0x25u, 0x06u, 0x0Eu, 0x0Cu, 0x17u, 0x2Du, 0x1Eu, 0x21u,
+                                    0x26u, 0x28u};
+
+/* Half a minute of idle connection and one touch */
+static const BENCH_STEP_T idleSteps[] =
+{
+    {28000u, BTN2, LIFT, 0, 0u, 1u},
+    {28150u, 0u, LIFT, 0, 0u, 0u},
+};
+static const uint8_t idleKeys[] = {KEY_F3};
+
+/* A button held from soon after power on until after the connection, its
+*  key waits for the connection */
+static const BENCH_STEP_T wakeSteps[] =
+{
+    {100u, BTN1, LIFT, 0, 0u, 1u},
+    {600u, 0u, LIFT, 0, 0u, 0u},
+};
+static const uint8_t wakeKeys[] = {KEY_F5};
+
+#define STEPS(steps)        (steps), (uint8_t)(sizeof(steps) / sizeof((steps)[0u]))
+
+static const BENCH_SESSION_T sessions[] =
+{
+    {"typing", 8000u, STEPS(typingSteps), STEPS(typingKeys), 300u},
+    {"browsing", 10000u, STEPS(browsingSteps), STEPS(browsingKeys), 400u},
+    {"media", 7000u, STEPS(mediaSteps), STEPS(mediaKeys), 1000u},
+    {"idle", 30000u, STEPS(idleSteps), STEPS(idleKeys), 300u},
+    {"wake", 3000u, STEPS(wakeSteps), STEPS(wakeKeys), 1000u},
+};
+
+#define SESSION_COUNT       ((uint8_t)(sizeof(sessions) / sizeof(sessions[0u])))
+
+static const char * const endNames[] = {"time", "hibernate", "reset", "watchdog", "idle"};
+
+/* Columns of the sweep result the Pareto frontier needs */
+static const char * const paretoColumns[] = {"missed", "wrong", "lat_avg_ms", "total_uA"};
+
+/* State of the session process */
+static const BENCH_SESSION_T *session;
+static uint8_t nextStep;
+static SIM_TIMER_T stepTimer;
+static SIM_TIMER_T endTimer;
+
+
+/*******************************************************************************
+* Function Name: Step()
+********************************************************************************
+*
+* Summary:
+*   Puts the next script step on the panel.
+*
+*******************************************************************************/
+static void Step(void)
+{
+    const BENCH_STEP_T *step = &session->steps[nextStep++];
+
+    simPanel.buttons = step->buttons;
+    simPanel.position = step->position;
+    simPanel.speed = step->speed;
+    simPanel.moveStart = simNow;
+    simPanel.hand = step->hand;
+
+    if(nextStep < session->stepCount)
+    {
+        SimTimerStart(&stepTimer, (uint64_t)session->steps[nextStep].at * SIM_US_PER_MS, Step);
+    }
+}
+
+static void SessionEnd(void)
+{
+    SimEnd(SIM_END_TIME);
+}
+
+
+/*******************************************************************************
+* Function Name: Evaluate()
+********************************************************************************
+*
+* Summary:
+*   Turns the report log of the central into key presses, as bench_ble does,
+*   and matches them in order against the expected keys. The latency of a
+*   step that sends keys is the time to the first key press after it.
+*
+*******************************************************************************/
+static void Evaluate(BENCH_RESULT_T *result)
+{
+    uint64_t pressAt[BENCH_MAX_KEYS];
+    uint64_t stepAt;
+    uint8_t previous = 0u;
+    uint8_t key;
+    uint32_t index;
+    uint32_t press;
+    uint32_t matched = 0u;
+
+    for(index = 0u; index < simBle.reports; index++)
+    {
+        key = simBle.log[index].report[2u];
+        if((key != 0u) && (key != previous))
+        {
+            if(result->keyCount < BENCH_MAX_KEYS)
+            {
+                result->keys[result->keyCount] = key;
+                pressAt[result->keyCount] = simBle.log[index].at;
+            }
+            result->keyCount++;
+        }
+        previous = key;
+    }
+
+    for(press = 0u; (press < result->keyCount) && (press < BENCH_MAX_KEYS) && (matched < session->keyCount); press++)
+    {
+        if(result->keys[press] == session->keys[matched])
+        {
+            matched++;
+        }
+    }
+    result->missed = session->keyCount - matched;
+    result->wrong = result->keyCount - matched;
+
+    for(index = 0u; index < session->stepCount; index++)
+    {
+        stepAt = (uint64_t)session->steps[index].at * SIM_US_PER_MS;
+        for(press = 0u; (session->steps[index].keys != 0u) && (press < result->keyCount) &&
+                        (press < BENCH_MAX_KEYS); press++)
+        {
+            if(pressAt[press] >= stepAt)
+            {
+                result->latencyCount++;
+                result->latencySum += pressAt[press] - stepAt;
+                if((pressAt[press] - stepAt) > result->latencyMax)
+                {
+                    result->latencyMax = pressAt[press] - stepAt;
+                }
+                break;
+            }
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: RunSession()
+********************************************************************************
+*
+* Summary:
+*   Runs a session in the current process and writes its result to fd. The
+*   debug output of both firmwares goes to build/bench_system_<session>.log.
+*
+*******************************************************************************/
+static void RunSession(const BENCH_SESSION_T *run, int fd)
+{
+    static SIM_CPU_T *const cpus[] = {&simBleCpu, &simCapSenseCpu};
+    static void (*const entries[])(void) = {SimBleMain, SimCapSenseMain};
+    static const SIM_CENTRAL_T central = CENTRAL_BONDED;
+    BENCH_RESULT_T result;
+    char path[64];
+
+    session = run;
+    (void)snprintf(path, sizeof(path), "%s/bench_system_%s.log", BENCH_LOG_DIR, run->name);
+    if(freopen(path, "w", stdout) == NULL)
+    {
+        _exit(2);
+    }
+
+    simCentral = central;
+    simPanel.noise = 4u;
+    if(run->stepCount != 0u)
+    {
+        SimTimerStart(&stepTimer, (uint64_t)run->steps[0u].at * SIM_US_PER_MS, Step);
+    }
+    SimTimerStart(&endTimer, (uint64_t)run->duration * SIM_US_PER_MS, SessionEnd);
+
+    (void)memset(&result, 0, sizeof(result));
+    result.end = SimRunCpus(cpus, entries, 2u);
+    SimClose(&simBleCpu);
+    SimClose(&simCapSenseCpu);
+    (void)fflush(stdout);
+
+    result.time = simNow;
+    result.reports = simBle.reports;
+    result.bleCpu = simBleCpu;
+    result.bleCpu.name = NULL;
+    result.capSenseCpu = simCapSenseCpu;
+    result.capSenseCpu.name = NULL;
+    result.radioTime = simBle.radioTime;
+    result.capSense = simCapSense;
+    result.advertisingAt = simBle.advertisingAt;
+    result.connectedAt = simBle.connectedAt;
+    result.firstReportAt = (simBle.reports != 0u) ? simBle.log[0u].at : 0u;
+    Evaluate(&result);
+
+    if(write(fd, &result, sizeof(result)) != (ssize_t)sizeof(result))
+    {
+        _exit(2);
+    }
+    _exit(0);
+}
+
+/* Runs a session in a child process, non-zero when it reported a result */
+static uint8_t Run(const BENCH_SESSION_T *run, BENCH_RESULT_T *result)
+{
+    pid_t child;
+    int status;
+    int fds[2];
+    uint8_t received;
+
+    (void)fflush(stdout);
+    if(pipe(fds) != 0)
+    {
+        return (0u);
+    }
+    child = fork();
+    if(child == 0)
+    {
+        (void)close(fds[0u]);
+        RunSession(run, fds[1u]);
+    }
+    (void)close(fds[1u]);
+    (void)memset(result, 0, sizeof(*result));
+    received = ((child >= 0) && (read(fds[0u], result, sizeof(*result)) == (ssize_t)sizeof(*result))) ? 1u : 0u;
+    (void)close(fds[0u]);
+    if(child > 0)
+    {
+        (void)waitpid(child, &status, 0);
+    }
+    return (received);
+}
+
+
+/*******************************************************************************
+* Function Name: BleCurrent(), CapSenseCurrent()
+********************************************************************************
+*
+* Summary:
+*   Average supply current of each MCU over a session, in microamps.
+*
+*******************************************************************************/
+static double BleCurrent(const BENCH_RESULT_T *result)
+{
+    return ((((double)(result->bleCpu.activeTime + result->bleCpu.sleepTime) * BENCH_ACTIVE_CURRENT) +
+             ((double)result->bleCpu.deepSleepTime * BENCH_DEEP_SLEEP_CURRENT) +
+             ((double)result->radioTime * BENCH_RADIO_CURRENT)) / (double)result->time);
+}
+
+static double CapSenseCurrent(const BENCH_RESULT_T *result)
+{
+    return ((((double)result->capSenseCpu.activeTime * BENCH_CAPSENSE_ACTIVE_CURRENT) +
+             ((double)result->capSenseCpu.sleepTime * BENCH_CAPSENSE_SLEEP_CURRENT) +
+             ((double)result->capSenseCpu.deepSleepTime * BENCH_DEEP_SLEEP_CURRENT) +
+             ((double)result->capSense.scanTime * BENCH_SCAN_CURRENT)) / (double)result->time);
+}
+
+
+/*******************************************************************************
+* Function Name: Check()
+********************************************************************************
+*
+* Summary:
+*   Compares a session result with what the session expects.
+*
+* Return:
+*  Non-zero when the session passed.
+*
+*******************************************************************************/
+static uint8_t Check(const BENCH_SESSION_T *run, const BENCH_RESULT_T *result)
+{
+    uint8_t passed = 1u;
+
+    if(result->end != SIM_END_TIME)
+    {
+        printf("  %s: ended by %s\n", run->name, endNames[result->end]);
+        passed = 0u;
+    }
+    if((result->missed != 0u) || (result->wrong != 0u))
+    {
+        printf("  %s: %lu keys missed, %lu not expected\n", run->name, (unsigned long)result->missed,
+               (unsigned long)result->wrong);
+        passed = 0u;
+    }
+    if(result->latencyMax > ((uint64_t)run->latencyLimit * SIM_US_PER_MS))
+    {
+        printf("  %s: latency %lu us over the limit of %lu ms\n", run->name, (unsigned long)result->latencyMax,
+               (unsigned long)run->latencyLimit);
+        passed = 0u;
+    }
+    return (passed);
+}
+
+
+/*******************************************************************************
+* Function Name: Table()
+********************************************************************************
+*
+* Summary:
+*   Runs all sessions and prints a line per session. adv, conn and first
+*   are the ms from power on to the first advertisement, the connection and
+*   the first report on air; the wake session gives the time to the first
+*   key after a power on.
+*
+* Return:
+*  Number of failed sessions.
+*
+*******************************************************************************/
+static uint8_t Table(void)
+{
+    BENCH_RESULT_T result;
+    uint8_t index;
+    uint8_t failed = 0u;
+
+    printf("%-10s %-6s %4s %4s %8s %8s %6s %6s %7s %7s %7s %7s %7s %7s\n", "session", "end", "keys", "rep", "lat avg",
+           "lat max", "scans", "flash", "BLE uA", "CS uA", "uA", "adv", "conn", "first");
+    for(index = 0u; index < SESSION_COUNT; index++)
+    {
+        if(Run(&sessions[index], &result) == 0u)
+        {
+            printf("%-10s did not report a result\n", sessions[index].name);
+            failed++;
+            continue;
+        }
+        printf("%-10s %-6s %4lu %4lu %8.1f %8.1f %6lu %6lu %7.1f %7.1f %7.1f %7.2f %7.1f %7.1f\n", sessions[index].name,
+               endNames[result.end], (unsigned long)result.keyCount, (unsigned long)result.reports,
+               (result.latencyCount != 0u) ? ((double)result.latencySum / result.latencyCount / 1000.0) : 0.0,
+               (double)result.latencyMax / 1000.0, (unsigned long)result.capSense.scans,
+               (unsigned long)result.capSense.flashWrites, BleCurrent(&result), CapSenseCurrent(&result),
+               BleCurrent(&result) + CapSenseCurrent(&result), (double)result.advertisingAt / 1000.0,
+               (double)result.connectedAt / 1000.0,
+               (double)result.firstReportAt / 1000.0);
+        if(Check(&sessions[index], &result) == 0u)
+        {
+            failed++;
+        }
+    }
+    printf("%u of %u sessions failed\n", failed, SESSION_COUNT);
+    return (failed);
+}
+
+
+/*******************************************************************************
+* Function Name: Csv()
+********************************************************************************
+*
+* Summary:
+*   Runs all sessions and prints their metrics as one CSV row:
+*   missed,wrong,lat_avg_ms,lat_max_ms,ble_uA,capsense_uA,total_uA
+*   The latencies are over all steps, the currents over the whole time of
+*   all sessions. A session without a result counts all its keys missed.
+*
+*******************************************************************************/
+static void Csv(void)
+{
+    BENCH_RESULT_T result;
+    uint8_t index;
+    uint32_t missed = 0u;
+    uint32_t wrong = 0u;
+    uint32_t latencyCount = 0u;
+    uint64_t latencySum = 0u;
+    uint64_t latencyMax = 0u;
+    uint64_t time = 0u;
+    double bleCharge = 0.0;
+    double capSenseCharge = 0.0;
+
+    for(index = 0u; index < SESSION_COUNT; index++)
+    {
+        if((Run(&sessions[index], &result) == 0u) || (result.end != SIM_END_TIME))
+        {
+            missed += sessions[index].keyCount;
+            continue;
+        }
+        missed += result.missed;
+        wrong += result.wrong;
+        latencyCount += result.latencyCount;
+        latencySum += result.latencySum;
+        if(result.latencyMax > latencyMax)
+        {
+            latencyMax = result.latencyMax;
+        }
+        time += result.time;
+        bleCharge += BleCurrent(&result) * (double)result.time;
+        capSenseCharge += CapSenseCurrent(&result) * (double)result.time;
+    }
+    if(time == 0u)
+    {
+        time = 1u;
+    }
+    printf("%lu,%lu,%.1f,%.1f,%.1f,%.1f,%.1f\n", (unsigned long)missed, (unsigned long)wrong,
+           (latencyCount != 0u) ? ((double)latencySum / latencyCount / 1000.0) : 0.0, (double)latencyMax / 1000.0,
+           bleCharge / (double)time, capSenseCharge / (double)time, (bleCharge + capSenseCharge) / (double)time);
+}
+
+
+/*******************************************************************************
+* Function Name: Pareto()
+********************************************************************************
+*
+* Summary:
+*   Prints the header and the Pareto frontier of a sweep result: the rows
+*   without missed or wrong keys that no other such row beats in mean
+*   latency and current, one at least as good and the other better.
+*
+* Parameters:
+*  path - CSV file with a header line naming the paretoColumns
+*
+* Return:
+*  Non-zero when the file could not be read.
+*
+*******************************************************************************/
+static uint8_t Pareto(const char *path)
+{
+    static char lines[BENCH_MAX_ROWS][BENCH_MAX_LINE];
+    static double values[BENCH_MAX_ROWS][sizeof(paretoColumns) / sizeof(paretoColumns[0u])];
+    char header[BENCH_MAX_LINE];
+    char copy[BENCH_MAX_LINE];
+    int positions[sizeof(paretoColumns) / sizeof(paretoColumns[0u])];
+    FILE *file;
+    char *field;
+    uint32_t rows = 0u;
+    uint32_t row;
+    uint32_t other;
+    uint8_t column;
+    uint8_t dominated;
+    int position;
+
+    file = fopen(path, "r");
+    if((file == NULL) || (fgets(header, sizeof(header), file) == NULL))
+    {
+        return (1u);
+    }
+    (void)memcpy(copy, header, sizeof(copy));
+    for(column = 0u; column < (sizeof(paretoColumns) / sizeof(paretoColumns[0u])); column++)
+    {
+        positions[column] = -1;
+    }
+    position = 0;
+    for(field = strtok(copy, ",\n"); field != NULL; field = strtok(NULL, ",\n"))
+    {
+        for(column = 0u; column < (sizeof(paretoColumns) / sizeof(paretoColumns[0u])); column++)
+        {
+            if(strcmp(field, paretoColumns[column]) == 0)
+            {
+                positions[column] = position;
+            }
+        }
+        position++;
+    }
+    for(column = 0u; column < (sizeof(paretoColumns) / sizeof(paretoColumns[0u])); column++)
+    {
+        if(positions[column] < 0)
+        {
+            (void)fclose(file);
+            return (1u);
+        }
+    }
+
+    while((rows < BENCH_MAX_ROWS) && (fgets(lines[rows], BENCH_MAX_LINE, file) != NULL))
+    {
+        (void)memcpy(copy, lines[rows], sizeof(copy));
+        position = 0;
+        for(field = strtok(copy, ",\n"); field != NULL; field = strtok(NULL, ",\n"))
+        {
+            for(column = 0u; column < (sizeof(paretoColumns) / sizeof(paretoColumns[0u])); column++)
+            {
+                if(position == positions[column])
+                {
+                    values[rows][column] = strtod(field, NULL);
+                }
+            }
+            position++;
+        }
+        rows++;
+    }
+    (void)fclose(file);
+
+    printf("%s", header);
+    for(row = 0u; row < rows; row++)
+    {
+        /* values: missed, wrong, lat_avg_ms, total_uA */
+        if((values[row][0u] != 0.0) || (values[row][1u] != 0.0))
+        {
+            continue;
+        }
+        dominated = 0u;
+        for(other = 0u; (other < rows) && (dominated == 0u); other++)
+        {
+            if((values[other][0u] == 0.0) && (values[other][1u] == 0.0) &&
+               (values[other][2u] <= values[row][2u]) && (values[other][3u] <= values[row][3u]) &&
+               ((values[other][2u] < values[row][2u]) || (values[other][3u] < values[row][3u])))
+            {
+                dominated = 1u;
+            }
+        }
+        if(dominated == 0u)
+        {
+            printf("%s", lines[row]);
+        }
+    }
+    return (0u);
+}
+
+
+int main(int argc, char *argv[])
+{
+    if((argc == 2) && (strcmp(argv[1u], "--csv") == 0))
+    {
+        Csv();
+        return (0);
+    }
+    if((argc == 3) && (strcmp(argv[1u], "--pareto") == 0))
+    {
+        return ((Pareto(argv[2u]) == 0u) ? 0 : 2);
+    }
+    if(argc != 1)
+    {
+        fprintf(stderr, "usage: %s [--csv | --pareto <sweep.csv>]\n", argv[0u]);
+        return (2);
+    }
+    return ((Table() == 0u) ? 0 : 1);
+}
+
+
+/* [] END OF FILE */
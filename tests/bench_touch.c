@@ -0,0 +1,316 @@
+/*******************************************************************************
+* File Name: bench_touch.c
+*
+* Version 1.0
+*
+* Description:
+*  Benchmark of the per-sample cost of the slider gesture engine and of the
+*  touch filter on the host. Each gesture trace is one path through
+*  Gesture_Process(): no touch, a tap, a double tap, a long press and a
+*  swipe, sampled every scan period. The filter runs a quiet and a noisy
+*  sensor trace with touches through Filter_Process() in each profile. A
+*  trace is expanded into its samples once and replayed BENCH_REPEATS
+*  times; the benchmark prints the host time per sample of each trace. The
+*  time only compares the traces with each other, the target runs the same
+*  shifts and adds on a 48 MHz Cortex-M0+. It exits non-zero when a trace
+*  does not report the gesture it plays, or the filter does not report
+*  every touch of a trace once.
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include "project.h"
+#include "filter.h"
+#include "gesture.h"
+
+#define NO_TOUCH                    CapSense_SLIDER_NO_TOUCH
+#define TRACE_END                   (0xFFFFFFFFu)
+#define BENCH_PERIOD                (5u)        /* ms between samples, the fastest scan tier */
+#define BENCH_SAMPLES               (256u)      /* Largest trace in samples */
+#define BENCH_REPEATS               (20000u)
+#define BENCH_RUNS                  (5u)        /* The fastest run counts */
+
+/* Sensor traces of the filter: a touch every BENCH_TOUCH_PERIOD samples */
+#define BENCH_FINGER_TH             (100u)
+#define BENCH_TOUCH_LEVEL           (160u)      /* Difference count of a finger */
+#define BENCH_TOUCH_PERIOD          (50u)
+#define BENCH_TOUCH_SAMPLES         (20u)
+#define BENCH_FILTER_SAMPLES        (250u)      /* 5 touches */
+
+typedef struct
+{
+    uint32 time;            /* Milliseconds, TRACE_END ends the trace */
+    uint16 position;        /* Centroid or NO_TOUCH, held until the next entry */
+} TRACE_T;
+
+typedef struct
+{
+    const char *name;
+    const TRACE_T *trace;
+    uint8 event;            /* Gesture the trace plays, GESTURE_NONE for none */
+} BENCH_TRACE_T;
+
+typedef struct
+{
+    const char *name;
+    uint16 amplitude;       /* Noise in difference counts, around the baseline and the finger */
+} BENCH_NOISE_T;
+
+/* Samples of the trace under test */
+static uint16 positions[BENCH_SAMPLES];
+static uint32 times[BENCH_SAMPLES];
+static uint32 sampleCount;
+
+/* Keeps the compiler from dropping the calls */
+static volatile uint32 sink;
+
+
+/*******************************************************************************
+* Traces
+*******************************************************************************/
+static const TRACE_T idleTrace[] = {{0u, NO_TOUCH}, {1000u, NO_TOUCH}, {TRACE_END, 0u}};
+static const TRACE_T tapTrace[] =
+{
+    {0u, NO_TOUCH}, {100u, 40u}, {200u, NO_TOUCH}, {800u, NO_TOUCH}, {TRACE_END, 0u}
+};
+static const TRACE_T doubleTapTrace[] =
+{
+    {0u, NO_TOUCH}, {100u, 40u}, {200u, NO_TOUCH}, {300u, 42u}, {400u, NO_TOUCH}, {800u, NO_TOUCH}, {TRACE_END, 0u}
+};
+static const TRACE_T longPressTrace[] =
+{
+    {0u, NO_TOUCH}, {100u, 60u}, {900u, NO_TOUCH}, {1000u, NO_TOUCH}, {TRACE_END, 0u}
+};
+static const TRACE_T swipeTrace[] =
+{
+    {0u, NO_TOUCH}, {100u, 10u}, {120u, 20u}, {140u, 30u}, {160u, 40u}, {180u, 50u}, {200u, 60u},
+    {300u, NO_TOUCH}, {400u, NO_TOUCH}, {TRACE_END, 0u}
+};
+
+static const BENCH_TRACE_T traces[] =
+{
+    {"no touch", idleTrace, GESTURE_NONE},
+    {"tap", tapTrace, GESTURE_TAP},
+    {"double tap", doubleTapTrace, GESTURE_DOUBLE_TAP},
+    {"long press", longPressTrace, GESTURE_LONG_PRESS},
+    {"swipe", swipeTrace, GESTURE_SWIPE_RIGHT},
+};
+
+#define TRACE_COUNT         ((uint8_t)(sizeof(traces) / sizeof(traces[0u])))
+
+static const BENCH_NOISE_T noises[] =
+{
+    {"quiet", 4u},
+    {"noisy", 30u},
+};
+
+#define NOISE_COUNT         ((uint8_t)(sizeof(noises) / sizeof(noises[0u])))
+
+static const char * const profileNames[FILTER_PROFILE_COUNT] = {"low latency", "high noise"};
+
+static uint16 samples[BENCH_FILTER_SAMPLES];
+static uint32 noiseSeed;
+
+
+/* Expands a trace into one sample every BENCH_PERIOD */
+static void Expand(const TRACE_T trace[])
+{
+    uint32 time;
+    uint32 entry = 0u;
+
+    sampleCount = 0u;
+    for(time = trace[0u].time; (trace[entry + 1u].time != TRACE_END) && (sampleCount < BENCH_SAMPLES);
+        time += BENCH_PERIOD)
+    {
+        while((trace[entry + 1u].time != TRACE_END) && (time >= trace[entry + 1u].time))
+        {
+            entry++;
+        }
+        if(trace[entry + 1u].time == TRACE_END)
+        {
+            break;
+        }
+        positions[sampleCount] = trace[entry].position;
+        times[sampleCount] = time;
+        sampleCount++;
+    }
+}
+
+/* Uniform pseudo random noise in -amplitude..amplitude, as test_filter.c */
+static int32 Noise(uint16 amplitude)
+{
+    noiseSeed = (noiseSeed * 1103515245u) + 12345u;
+    return ((int32)((noiseSeed >> 16u) % ((2u * amplitude) + 1u)) - (int32)amplitude);
+}
+
+/* Fills the sensor trace: the baseline with a touch at the start of every
+*  BENCH_TOUCH_PERIOD, clipped at zero as the difference counts are */
+static void FillSensor(uint16 amplitude)
+{
+    uint32 sample;
+    int32 level;
+
+    noiseSeed = 1u;
+    for(sample = 0u; sample < BENCH_FILTER_SAMPLES; sample++)
+    {
+        level = ((sample % BENCH_TOUCH_PERIOD) < BENCH_TOUCH_SAMPLES) ? (int32)BENCH_TOUCH_LEVEL : 0;
+        level += Noise(amplitude);
+        samples[sample] = (level > 0) ? (uint16)level : 0u;
+    }
+}
+
+static uint64_t Now(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (((uint64_t)now.tv_sec * 1000000000u) + (uint64_t)now.tv_nsec);
+}
+
+
+/*******************************************************************************
+* Function Name: RunGesture()
+********************************************************************************
+*
+* Summary:
+*   Replays the expanded trace BENCH_REPEATS times through the gesture
+*   engine, each time from Gesture_Init().
+*
+* Parameters:
+*  event - receives the type of the first event of the trace
+*
+* Return:
+*  ns of the fastest of BENCH_RUNS runs.
+*
+*******************************************************************************/
+static uint64_t RunGesture(uint8 *event)
+{
+    GESTURE_EVENT_T detected;
+    uint64_t fastest = UINT64_MAX;
+    uint64_t start;
+    uint32 run;
+    uint32 repeat;
+    uint32 sample;
+
+    *event = GESTURE_NONE;
+    for(run = 0u; run < BENCH_RUNS; run++)
+    {
+        start = Now();
+        for(repeat = 0u; repeat < BENCH_REPEATS; repeat++)
+        {
+            Gesture_Init();
+            for(sample = 0u; sample < sampleCount; sample++)
+            {
+                if(Gesture_Process(positions[sample], times[sample], &detected) != 0u)
+                {
+                    sink += detected.type;
+                    *event = (*event == GESTURE_NONE) ? detected.type : *event;
+                }
+            }
+        }
+        start = Now() - start;
+        fastest = (start < fastest) ? start : fastest;
+    }
+    return (fastest);
+}
+
+
+/*******************************************************************************
+* Function Name: RunFilter()
+********************************************************************************
+*
+* Summary:
+*   Replays the sensor trace BENCH_REPEATS times through one filter channel
+*   in the active profile, each time from Filter_InitChannel().
+*
+* Parameters:
+*  touches - receives the touches the channel reported in one replay
+*
+* Return:
+*  ns of the fastest of BENCH_RUNS runs.
+*
+*******************************************************************************/
+static uint64_t RunFilter(uint32 *touches)
+{
+    FILTER_CHANNEL_T channel;
+    uint64_t fastest = UINT64_MAX;
+    uint64_t start;
+    uint32 run;
+    uint32 repeat;
+    uint32 sample;
+    uint8 touched;
+    uint8 state;
+
+    for(run = 0u; run < BENCH_RUNS; run++)
+    {
+        start = Now();
+        for(repeat = 0u; repeat < BENCH_REPEATS; repeat++)
+        {
+            Filter_InitChannel(&channel);
+            touched = 0u;
+            *touches = 0u;
+            for(sample = 0u; sample < BENCH_FILTER_SAMPLES; sample++)
+            {
+                state = Filter_Process(&channel, samples[sample], BENCH_FINGER_TH);
+                *touches += (uint32)((state != 0u) && (touched == 0u));
+                touched = state;
+            }
+            sink += touched;
+        }
+        start = Now() - start;
+        fastest = (start < fastest) ? start : fastest;
+    }
+    return (fastest);
+}
+
+
+int main(void)
+{
+    uint64_t time;
+    uint8_t index;
+    uint8_t profile;
+    uint8 event;
+    uint32 touches;
+    uint8_t failed = 0u;
+
+    printf("%-12s %7s %9s\n", "gesture", "samples", "ns/sample");
+    for(index = 0u; index < TRACE_COUNT; index++)
+    {
+        Expand(traces[index].trace);
+        time = RunGesture(&event);
+        printf("%-12s %7lu %9.2f\n", traces[index].name, (unsigned long)sampleCount,
+               (double)time / ((double)sampleCount * BENCH_REPEATS));
+        if(event != traces[index].event)
+        {
+            printf("  %s: event 0x%02x, 0x%02x expected\n", traces[index].name, event, traces[index].event);
+            failed++;
+        }
+    }
+
+    printf("%-12s %-6s %7s %9s\n", "filter", "trace", "touches", "ns/sample");
+    for(profile = 0u; profile < FILTER_PROFILE_COUNT; profile++)
+    {
+        Filter_SetProfile(profile);
+        for(index = 0u; index < NOISE_COUNT; index++)
+        {
+            FillSensor(noises[index].amplitude);
+            time = RunFilter(&touches);
+            printf("%-12s %-6s %7lu %9.2f\n", profileNames[profile], noises[index].name, (unsigned long)touches,
+                   (double)time / ((double)BENCH_FILTER_SAMPLES * BENCH_REPEATS));
+            if(touches != (BENCH_FILTER_SAMPLES / BENCH_TOUCH_PERIOD))
+            {
+                printf("  %s, %s: %lu touches, %u expected\n", profileNames[profile], noises[index].name,
+                       (unsigned long)touches, BENCH_FILTER_SAMPLES / BENCH_TOUCH_PERIOD);
+                failed++;
+            }
+        }
+    }
+    return ((failed == 0u) ? 0 : 1);
+}
+
+
+/* [] END OF FILE */
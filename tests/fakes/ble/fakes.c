@@ -0,0 +1,306 @@
+/*******************************************************************************
+* File Name: fakes.c
+*
+* Version 1.0
+*
+* Description:
+*  Host fakes of the BLE component API, of the main.c globals the tested
+*  modules share and of the firmware functions outside the tested modules.
+*  The calls are recorded for the tests to check.
+*
+*******************************************************************************/
+
+#include <string.h>
+#include "common.h"
+#include "boot.h"
+
+/* Globals of main.c */
+volatile uint32 timerTicks = 0u;
+uint8 capSenseConfig = CAPSENSE_FILTER_PROFILE | CAPSENSE_CONFIG_WRITTEN;
+uint8 capSenseConfigPending = DISABLED;
+
+CYBLE_CONN_HANDLE_T cyBle_connHandle = {1u, 0u};
+uint8 cyBle_pendingFlashWrite = 0u;
+
+uint32 fakeConnParamRequests;
+CYBLE_GAP_CONN_UPDATE_PARAM_T fakeConnParam;
+CYBLE_API_RESULT_T fakeConnParamResult;
+CYBLE_BLESS_PWR_LVL_T fakeTxPower;
+uint32 fakeTxPowerSets;
+int8 fakeRssi;
+uint32 fakeKeyGenerations;
+CYBLE_API_RESULT_T fakeKeyResult;
+uint32 fakeKeySets;
+CYBLE_GAP_SMP_LOCAL_P256_KEYS fakeKeys;
+uint32 fakeStoreBusy;                   /* Calls of CyBle_StoreAppData() that find the flash busy */
+uint32 fakeStores;
+const uint8 *fakeStoreDest;             /* Flash written by the last CyBle_StoreAppData() */
+uint32 fakeStoreSize;
+CYBLE_STATE_T fakeState;
+CYBLE_GAP_BONDED_DEV_ADDR_LIST_T fakeBondedList;
+CYBLE_GAP_BD_ADDR_T fakePeerAddr;        /* Address of the connected host */
+uint32 fakeDisconnects;
+uint32 fakeAdvStarts;
+uint32 fakePendingWork;                 /* WORK_xxx bits of SetPendingWork() */
+CYBLE_STACK_STATE_T fakeBusy;
+uint32 fakeReportCount;                 /* HID notifications sent, the first FAKE_REPORT_LOG in fakeReports */
+uint8 fakeReports[FAKE_REPORT_LOG][FAKE_REPORT_SIZE];
+uint32 fakeCharValueReads;              /* HIDS characteristic values read from the GATT database */
+uint8 fakeCapsLockLed = LED_OFF;
+uint32 fakeSysTickCount;                /* Current value of the SysTick down counter */
+uint32 fakeSysTickReload;
+
+static CYBLE_GAPP_DISC_PARAM_T fakeAdvParam;
+CYBLE_GAPP_DISC_MODE_INFO_T cyBle_discoveryModeInfo = {&fakeAdvParam};
+
+
+/* Restores the fakes and the main.c globals to their state after a reset,
+*  with the TX power at the 0 dBm set in the BLE component */
+void FakeBleReset(void)
+{
+    timerTicks = 0u;
+    capSenseConfig = CAPSENSE_FILTER_PROFILE | CAPSENSE_CONFIG_WRITTEN;
+    capSenseConfigPending = DISABLED;
+    fakeConnParamRequests = 0u;
+    fakeConnParamResult = CYBLE_ERROR_OK;
+    fakeTxPower = CYBLE_LL_PWR_LVL_0_DBM;
+    fakeTxPowerSets = 0u;
+    fakeRssi = -60;
+    cyBle_pendingFlashWrite = 0u;
+    fakeKeyGenerations = 0u;
+    fakeKeyResult = CYBLE_ERROR_OK;
+    fakeKeySets = 0u;
+    (void)memset(&fakeKeys, 0, sizeof(fakeKeys));
+    fakeStoreBusy = 0u;
+    fakeStores = 0u;
+    fakeState = CYBLE_STATE_DISCONNECTED;
+    (void)memset(&fakeBondedList, 0, sizeof(fakeBondedList));
+    (void)memset(&fakePeerAddr, 0, sizeof(fakePeerAddr));
+    fakeDisconnects = 0u;
+    fakeAdvStarts = 0u;
+    (void)memset(&fakeAdvParam, 0, sizeof(fakeAdvParam));
+    fakePendingWork = 0u;
+    fakeBusy = CYBLE_STACK_STATE_FREE;
+    fakeReportCount = 0u;
+    (void)memset(fakeReports, 0, sizeof(fakeReports));
+    fakeCharValueReads = 0u;
+    fakeCapsLockLed = LED_OFF;
+    fakeSysTickCount = 0u;
+    fakeSysTickReload = 0u;
+}
+
+CYBLE_STATE_T CyBle_GetState(void)
+{
+    return (fakeState);
+}
+
+CYBLE_API_RESULT_T CyBle_GappStartAdvertisement(uint8 advertisingIntervalType)
+{
+    (void)advertisingIntervalType;
+    fakeAdvStarts++;
+    fakeState = CYBLE_STATE_ADVERTISING;
+    return (CYBLE_ERROR_OK);
+}
+
+void CyBle_GappStopAdvertisement(void)
+{
+    fakeState = CYBLE_STATE_DISCONNECTED;
+}
+
+CYBLE_API_RESULT_T CyBle_GapDisconnect(uint8 bdHandle)
+{
+    (void)bdHandle;
+    fakeDisconnects++;
+    return (CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_GapGetBondedDevicesList(CYBLE_GAP_BONDED_DEV_ADDR_LIST_T *bondedDevList)
+{
+    *bondedDevList = fakeBondedList;
+    return (CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_GapGetPeerBdAddr(uint8 bdHandle, CYBLE_GAP_BD_ADDR_T *peerBdAddr)
+{
+    (void)bdHandle;
+    *peerBdAddr = fakePeerAddr;
+    return (CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_L2capLeConnectionParamUpdateRequest(uint8 bdHandle,
+                                                             CYBLE_GAP_CONN_UPDATE_PARAM_T *connParam)
+{
+    (void)bdHandle;
+    fakeConnParamRequests++;
+    fakeConnParam = *connParam;
+    return (fakeConnParamResult);
+}
+
+CYBLE_API_RESULT_T CyBle_GetTxPowerLevel(CYBLE_BLESS_PWR_IN_DB_T *bleSsPwrLvl)
+{
+    bleSsPwrLvl->blePwrLevelInDbm = fakeTxPower;
+    return (CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_SetTxPowerLevel(const CYBLE_BLESS_PWR_IN_DB_T *bleSsPwrLvl)
+{
+    fakeTxPower = bleSsPwrLvl->blePwrLevelInDbm;
+    fakeTxPowerSets++;
+    return (CYBLE_ERROR_OK);
+}
+
+int8 CyBle_GetRssi(void)
+{
+    return (fakeRssi);
+}
+
+/* The flash of the host build is RAM, the whole buffer is written at once */
+CYBLE_API_RESULT_T CyBle_StoreAppData(uint8 *srcBuff, const uint8 destAddr[], uint32 buffLen, uint8 isForceWrite)
+{
+    (void)isForceWrite;
+    if(fakeStoreBusy != 0u)
+    {
+        fakeStoreBusy--;
+        return (CYBLE_ERROR_FLASH_WRITE_NOT_PERMITTED);
+    }
+    (void)memcpy((uint8 *)destAddr, srcBuff, buffLen);
+    fakeStores++;
+    fakeStoreDest = destAddr;
+    fakeStoreSize = buffLen;
+    return (CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_GapGenerateLocalP256Keys(void)
+{
+    fakeKeyGenerations++;
+    return (fakeKeyResult);
+}
+
+CYBLE_API_RESULT_T CyBle_GapSetLocalP256Keys(CYBLE_GAP_SMP_LOCAL_P256_KEYS *localP256Keys)
+{
+    fakeKeySets++;
+    fakeKeys = *localP256Keys;
+    return (CYBLE_ERROR_OK);
+}
+
+CYBLE_STACK_STATE_T CyBle_GattGetBusyStatus(void)
+{
+    return (fakeBusy);
+}
+
+void CyBle_HidsRegisterAttrCallback(CYBLE_CALLBACK_T callbackFunc)
+{
+    (void)callbackFunc;
+}
+
+CYBLE_API_RESULT_T CyBle_HidssSendNotification(CYBLE_CONN_HANDLE_T connHandle, uint8 serviceIndex,
+                                               CYBLE_HIDS_CHAR_INDEX_T charIndex, uint8 attrSize, uint8 *attrValue)
+{
+    (void)connHandle;
+    (void)serviceIndex;
+    (void)charIndex;
+    if(fakeReportCount < FAKE_REPORT_LOG)
+    {
+        (void)memcpy(fakeReports[fakeReportCount], attrValue,
+                     (attrSize < FAKE_REPORT_SIZE) ? attrSize : FAKE_REPORT_SIZE);
+    }
+    fakeReportCount++;
+    return (CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_HidssGetCharacteristicValue(uint8 serviceIndex, CYBLE_HIDS_CHAR_INDEX_T charIndex,
+                                                     uint8 attrSize, uint8 *attrValue)
+{
+    (void)serviceIndex;
+    (void)charIndex;
+    fakeCharValueReads++;
+    (void)memset(attrValue, 0, attrSize);
+    return (CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_HidssGetCharacteristicDescriptor(uint8 serviceIndex, CYBLE_HIDS_CHAR_INDEX_T charIndex,
+                                                          CYBLE_HIDS_DESCR_T descrIndex, uint8 attrSize,
+                                                          uint8 *attrValue)
+{
+    (void)serviceIndex;
+    (void)charIndex;
+    (void)descrIndex;
+    (void)memset(attrValue, 0, attrSize);
+    return (CYBLE_ERROR_OK);
+}
+
+void UART_DEB_Start(void)
+{
+}
+
+void UART_DEB_Stop(void)
+{
+}
+
+
+/* No interrupts run in the unit tests */
+uint8 CyEnterCriticalSection(void)
+{
+    return (0u);
+}
+
+void CyExitCriticalSection(uint8 savedIntrStatus)
+{
+    (void)savedIntrStatus;
+}
+
+
+/* LED pins, LED_ON is low */
+void CapsLock_LED_Write(uint8 value)
+{
+    fakeCapsLockLed = value;
+}
+
+void LowPower_LED_Write(uint8 value)
+{
+    (void)value;
+}
+
+
+/* SysTick, the counter only moves when a test sets fakeSysTickCount */
+void CySysTickInit(void)
+{
+}
+
+void CySysTickSetReload(uint32 value)
+{
+    fakeSysTickReload = value;
+}
+
+void CySysTickClear(void)
+{
+    fakeSysTickCount = 0u;
+}
+
+void CySysTickEnable(void)
+{
+}
+
+void CySysTickDisableInterrupt(void)
+{
+}
+
+
+/* Firmware functions of main.c and boot.c */
+void SetPendingWork(uint32 work)
+{
+    fakePendingWork |= work;
+}
+
+void ShowValue(CYBLE_GATT_VALUE_T *value)
+{
+    (void)value;
+}
+
+void BootMark(uint8 phase)
+{
+    (void)phase;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,555 @@
+/*******************************************************************************
+* File Name: project.h
+*
+* Version 1.0
+*
+* Description:
+*  Host stand-in for the PSoC Creator generated header of the BLE project.
+*  Declares the part of the BLE component, I2C master, WDT, pin and system
+*  APIs the firmware sources use. fakes.c implements the calls the unit
+*  tests need and records them; sim/ble.c implements all of them on the
+*  virtual clock of the simulation.
+*
+*******************************************************************************/
+
+#if !defined(FAKE_PROJECT_H)
+#define FAKE_PROJECT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "cyapicallbacks.h"
+
+
+/***************************************
+*        Data Types
+***************************************/
+typedef uint8_t uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef uint64_t uint64;
+typedef int8_t int8;
+typedef int16_t int16;
+typedef int32_t int32;
+typedef char char8;
+
+typedef void (*cyisraddress)(void);
+typedef void (*CYBLE_CALLBACK_T)(uint32 eventCode, void *eventParam);
+
+typedef enum
+{
+    CYBLE_ERROR_OK = 0x0000u,
+    CYBLE_ERROR_INVALID_PARAMETER = 0x0001u,
+    CYBLE_ERROR_INVALID_OPERATION = 0x0002u,
+    CYBLE_ERROR_MEMORY_ALLOCATION_FAILED = 0x0003u,
+    CYBLE_ERROR_INVALID_STATE = 0x0005u,
+    CYBLE_ERROR_FLASH_WRITE_NOT_PERMITTED = 0x0012u,
+    CYBLE_ERROR_FLASH_WRITE = 0x0013u,
+    CYBLE_ERROR_NTF_DISABLED = 0x0157u
+} CYBLE_API_RESULT_T;
+
+typedef enum
+{
+    /* Generic events */
+    CYBLE_EVT_HOST_INVALID = 0x0000u,
+    CYBLE_EVT_STACK_ON,
+    CYBLE_EVT_TIMEOUT,
+    CYBLE_EVT_HARDWARE_ERROR,
+    CYBLE_EVT_HCI_STATUS,
+    CYBLE_EVT_STACK_BUSY_STATUS,
+    CYBLE_EVT_PENDING_FLASH_WRITE,
+
+    /* GAP events */
+    CYBLE_EVT_GAP_AUTH_REQ = 0x0030u,
+    CYBLE_EVT_GAP_PASSKEY_ENTRY_REQUEST,
+    CYBLE_EVT_GAP_PASSKEY_DISPLAY_REQUEST,
+    CYBLE_EVT_GAP_AUTH_COMPLETE,
+    CYBLE_EVT_GAP_AUTH_FAILED,
+    CYBLE_EVT_GAPP_ADVERTISEMENT_START_STOP,
+    CYBLE_EVT_GAP_DEVICE_CONNECTED,
+    CYBLE_EVT_GAP_DEVICE_DISCONNECTED,
+    CYBLE_EVT_GAP_ENCRYPT_CHANGE,
+    CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE,
+    CYBLE_EVT_GAP_KEYINFO_EXCHNGE_CMPLT,
+    CYBLE_EVT_GAP_GEN_SET_LOCAL_P256_KEYS_COMPLETE,
+
+    /* GATT events */
+    CYBLE_EVT_GATT_CONNECT_IND = 0x0050u,
+    CYBLE_EVT_GATT_DISCONNECT_IND,
+    CYBLE_EVT_GATTS_XCNHG_MTU_REQ,
+    CYBLE_EVT_GATTS_WRITE_REQ,
+    CYBLE_EVT_GATTS_WRITE_CMD_REQ,
+    CYBLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ,
+
+    /* L2CAP events */
+    CYBLE_EVT_L2CAP_CONN_PARAM_UPDATE_RSP = 0x0070u,
+
+    /* Service events, delivered to the service callbacks */
+    CYBLE_EVT_BASS_NOTIFICATION_ENABLED = 0x1000u,
+    CYBLE_EVT_BASS_NOTIFICATION_DISABLED,
+    CYBLE_EVT_BASC_NOTIFICATION,
+    CYBLE_EVT_BASC_READ_CHAR_RESPONSE,
+    CYBLE_EVT_BASC_READ_DESCR_RESPONSE,
+    CYBLE_EVT_BASC_WRITE_DESCR_RESPONSE,
+
+    CYBLE_EVT_HIDSS_NOTIFICATION_ENABLED = 0x1100u,
+    CYBLE_EVT_HIDSS_NOTIFICATION_DISABLED,
+    CYBLE_EVT_HIDSS_BOOT_MODE_ENTER,
+    CYBLE_EVT_HIDSS_REPORT_MODE_ENTER,
+    CYBLE_EVT_HIDSS_SUSPEND,
+    CYBLE_EVT_HIDSS_EXIT_SUSPEND,
+    CYBLE_EVT_HIDSS_REPORT_CHAR_WRITE,
+    CYBLE_EVT_HIDSC_NOTIFICATION,
+    CYBLE_EVT_HIDSC_READ_CHAR_RESPONSE,
+    CYBLE_EVT_HIDSC_WRITE_CHAR_RESPONSE,
+    CYBLE_EVT_HIDSC_READ_DESCR_RESPONSE,
+    CYBLE_EVT_HIDSC_WRITE_DESCR_RESPONSE,
+
+    CYBLE_EVT_SCPSS_NOTIFICATION_ENABLED = 0x1200u,
+    CYBLE_EVT_SCPSS_NOTIFICATION_DISABLED,
+    CYBLE_EVT_SCPSS_SCAN_INT_WIN_CHAR_WRITE,
+    CYBLE_EVT_SCPSC_NOTIFICATION,
+    CYBLE_EVT_SCPSC_READ_DESCR_RESPONSE,
+    CYBLE_EVT_SCPSC_WRITE_DESCR_RESPONSE
+} CYBLE_EVENT_T;
+
+typedef enum
+{
+    CYBLE_STATE_STOPPED = 0x00u,
+    CYBLE_STATE_INITIALIZING,
+    CYBLE_STATE_CONNECTED,
+    CYBLE_STATE_ADVERTISING,
+    CYBLE_STATE_SCANNING,
+    CYBLE_STATE_CONNECTING,
+    CYBLE_STATE_DISCONNECTED
+} CYBLE_STATE_T;
+
+typedef enum
+{
+    CYBLE_BLESS_ACTIVE = 0x01u,
+    CYBLE_BLESS_SLEEP,
+    CYBLE_BLESS_DEEPSLEEP,
+    CYBLE_BLESS_HIBERNATE,
+    CYBLE_BLESS_INVALID = 0xFFu
+} CYBLE_LP_MODE_T;
+
+typedef enum
+{
+    CYBLE_BLESS_STATE_ACTIVE = 0x01u,
+    CYBLE_BLESS_STATE_EVENT_CLOSE,
+    CYBLE_BLESS_STATE_SLEEP,
+    CYBLE_BLESS_STATE_ECO_ON,
+    CYBLE_BLESS_STATE_ECO_STABLE,
+    CYBLE_BLESS_STATE_DEEPSLEEP,
+    CYBLE_BLESS_STATE_HIBERNATE,
+    CYBLE_BLESS_STATE_INVALID = 0xFFu
+} CYBLE_BLESS_STATE_T;
+
+typedef enum
+{
+    CYBLE_STACK_STATE_BUSY = 0x01u,
+    CYBLE_STACK_STATE_FREE
+} CYBLE_STACK_STATE_T;
+
+/* Values of the BLE component, ordered from the lowest power up */
+typedef enum
+{
+    CYBLE_LL_PWR_LVL_NEG_18_DBM = 0x01u,
+    CYBLE_LL_PWR_LVL_NEG_12_DBM,
+    CYBLE_LL_PWR_LVL_NEG_6_DBM,
+    CYBLE_LL_PWR_LVL_NEG_3_DBM,
+    CYBLE_LL_PWR_LVL_NEG_2_DBM,
+    CYBLE_LL_PWR_LVL_NEG_1_DBM,
+    CYBLE_LL_PWR_LVL_0_DBM,
+    CYBLE_LL_PWR_LVL_3_DBM,
+    CYBLE_LL_PWR_LVL_MAX
+} CYBLE_BLESS_PWR_LVL_T;
+
+typedef enum
+{
+    CYBLE_LL_ADV_CH_TYPE = 0x00u,
+    CYBLE_LL_CONN_CH_TYPE,
+    CYBLE_LL_MAX_CH_TYPE
+} CYBLE_BLESS_PHY_CH_GRP_ID_T;
+
+typedef struct
+{
+    CYBLE_BLESS_PWR_LVL_T blePwrLevelInDbm;
+    CYBLE_BLESS_PHY_CH_GRP_ID_T bleSsChId;
+} CYBLE_BLESS_PWR_IN_DB_T;
+
+typedef struct
+{
+    uint16 connIntvMin;
+    uint16 connIntvMax;
+    uint16 connLatency;
+    uint16 supervisionTO;
+} CYBLE_GAP_CONN_UPDATE_PARAM_T;
+
+typedef struct
+{
+    uint8 status;
+    uint16 connIntv;
+    uint16 connLatency;
+    uint16 supervisionTO;
+} CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T;
+
+typedef struct
+{
+    uint8 bdHandle;
+    uint8 attId;
+} CYBLE_CONN_HANDLE_T;
+
+typedef struct
+{
+    uint8 *val;
+    uint16 len;
+    uint16 actualLen;
+} CYBLE_GATT_VALUE_T;
+
+typedef struct
+{
+    uint16 attrHandle;
+    CYBLE_GATT_VALUE_T value;
+} CYBLE_GATT_HANDLE_VALUE_PAIR_T;
+
+typedef struct
+{
+    CYBLE_CONN_HANDLE_T connHandle;
+    CYBLE_GATT_HANDLE_VALUE_PAIR_T handleValPair;
+} CYBLE_GATTS_WRITE_REQ_PARAM_T;
+
+typedef CYBLE_GATTS_WRITE_REQ_PARAM_T CYBLE_GATTS_WRITE_CMD_REQ_PARAM_T;
+typedef CYBLE_GATT_HANDLE_VALUE_PAIR_T CYBLE_GATTS_HANDLE_VALUE_NTF_T;
+
+typedef struct
+{
+    CYBLE_CONN_HANDLE_T connHandle;
+    uint16 attrHandle;
+    uint8 gattErrorCode;
+} CYBLE_GATTS_CHAR_VAL_READ_REQ_T;
+
+#define CYBLE_GAP_BD_ADDR_SIZE      (6u)
+
+typedef struct
+{
+    uint8 bdAddr[CYBLE_GAP_BD_ADDR_SIZE];
+    uint8 type;
+} CYBLE_GAP_BD_ADDR_T;
+
+#define CYBLE_GAP_MAX_BONDED_DEVICE (4u)
+
+typedef struct
+{
+    uint8 count;
+    CYBLE_GAP_BD_ADDR_T bdAddrList[CYBLE_GAP_MAX_BONDED_DEVICE];
+} CYBLE_GAP_BONDED_DEV_ADDR_LIST_T;
+
+typedef struct
+{
+    uint8 security;
+    uint8 bonding;
+    uint8 ekeySize;
+    uint8 authErr;
+} CYBLE_GAP_AUTH_INFO_T;
+
+#define CYBLE_GAP_SMP_P256_PUBLIC_KEY_SIZE  (64u)
+#define CYBLE_GAP_SMP_P256_PRIVATE_KEY_SIZE (32u)
+
+typedef struct
+{
+    uint8 publicKey[CYBLE_GAP_SMP_P256_PUBLIC_KEY_SIZE];
+    uint8 privateKey[CYBLE_GAP_SMP_P256_PRIVATE_KEY_SIZE];
+} CYBLE_GAP_SMP_LOCAL_P256_KEYS;
+
+typedef struct
+{
+    uint8 advType;
+    uint8 directAddrType;
+    uint8 directAddr[CYBLE_GAP_BD_ADDR_SIZE];
+} CYBLE_GAPP_DISC_PARAM_T;
+
+typedef struct
+{
+    CYBLE_GAPP_DISC_PARAM_T *advParam;
+} CYBLE_GAPP_DISC_MODE_INFO_T;
+
+/* Service characteristic indexes of the GATT database */
+typedef enum
+{
+    CYBLE_HIDS_PROTOCOL_MODE = 0x00u,
+    CYBLE_HIDS_INFORMATION,
+    CYBLE_HIDS_CONTROL_POINT,
+    CYBLE_HIDS_REPORT_MAP,
+    CYBLE_HIDS_BOOT_KYBRD_IN_REP,
+    CYBLE_HIDS_BOOT_KYBRD_OUT_REP,
+    CYBLE_HIDS_BOOT_MOUSE_IN_REP,
+    CYBLE_HIDS_REPORT,
+    CYBLE_HIDS_CHAR_COUNT
+} CYBLE_HIDS_CHAR_INDEX_T;
+
+typedef enum
+{
+    CYBLE_HIDS_REPORT_CCCD = 0x00u,
+    CYBLE_HIDS_REPORT_RRD,
+    CYBLE_HIDS_DESCR_COUNT
+} CYBLE_HIDS_DESCR_T;
+
+typedef enum
+{
+    CYBLE_BAS_BATTERY_LEVEL = 0x00u,
+    CYBLE_BAS_CHAR_COUNT
+} CYBLE_BAS_CHAR_INDEX_T;
+
+typedef enum
+{
+    CYBLE_BAS_BATTERY_LEVEL_CCCD = 0x00u,
+    CYBLE_BAS_DESCR_COUNT
+} CYBLE_BAS_DESCR_INDEX_T;
+
+typedef enum
+{
+    CYBLE_SCPS_SCAN_INT_WIN = 0x00u,
+    CYBLE_SCPS_SCAN_REFRESH,
+    CYBLE_SCPS_CHAR_COUNT
+} CYBLE_SCPS_CHAR_INDEX_T;
+
+typedef enum
+{
+    CYBLE_SCPS_SCAN_REFRESH_CCCD = 0x00u,
+    CYBLE_SCPS_DESCR_COUNT
+} CYBLE_SCPS_DESCR_INDEX_T;
+
+typedef struct
+{
+    CYBLE_CONN_HANDLE_T connHandle;
+    uint8 serviceIndex;
+    CYBLE_HIDS_CHAR_INDEX_T charIndex;
+    CYBLE_GATT_VALUE_T *value;
+} CYBLE_HIDS_CHAR_VALUE_T;
+
+typedef struct
+{
+    CYBLE_CONN_HANDLE_T connHandle;
+    uint8 serviceIndex;
+    CYBLE_BAS_CHAR_INDEX_T charIndex;
+    CYBLE_GATT_VALUE_T *value;
+} CYBLE_BAS_CHAR_VALUE_T;
+
+typedef struct
+{
+    CYBLE_CONN_HANDLE_T connHandle;
+    CYBLE_SCPS_CHAR_INDEX_T charIndex;
+    CYBLE_GATT_VALUE_T *value;
+} CYBLE_SCPS_CHAR_VALUE_T;
+
+
+/***************************************
+*          Constants
+***************************************/
+#define CYBLE_BONDING_NO            (0u)
+#define CYBLE_BONDING_YES           (1u)
+#define CYBLE_BONDING_REQUIREMENT   (CYBLE_BONDING_YES)
+
+#define CYBLE_ADVERTISING_FAST      (0x00u)
+#define CYBLE_GAPP_CONNECTABLE_UNDIRECTED_ADV       (0x00u)
+#define CYBLE_GAPP_CONNECTABLE_HIGH_DC_DIRECTED_ADV (0x01u)
+
+#define CYBLE_CCCD_LEN              (2u)
+#define CYBLE_GATT_DB_ATTR_CHAR_VAL_RD_EVENT        (0x01u)
+#define CYBLE_BAS_MAX_BATTERY_LEVEL_VALUE           (100u)
+
+/* Services and report characteristics of the BLE component configuration */
+#define CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX  (0x00u)
+#define CYBLE_HUMAN_INTERFACE_DEVICE_REPORT_IN      (CYBLE_HIDS_REPORT)
+#define CYBLE_HUMAN_INTERFACE_DEVICE_REPORT_OUT     (CYBLE_HIDS_REPORT + 1u)
+#define CYBLE_BATTERY_SERVICE_SERVICE_INDEX         (0x00u)
+
+#define CYBLE_HIDS_PROTOCOL_MODE_BOOT               (0x00u)
+#define CYBLE_HIDS_PROTOCOL_MODE_REPORT             (0x01u)
+#define CYBLE_HIDS_CP_SUSPEND                       (0x00u)
+#define CYBLE_HIDS_CP_EXIT_SUSPEND                  (0x01u)
+
+/* I2C master */
+#define I2CHW_I2C_MODE_COMPLETE_XFER                (0x00u)
+#define I2CHW_I2C_MSTAT_RD_CMPLT                    (0x01u)
+#define I2CHW_I2C_MSTAT_WR_CMPLT                    (0x02u)
+#define I2CHW_I2C_MSTAT_XFER_INP                    (0x04u)
+#define I2CHW_I2C_MSTAT_ERR_XFER                    (0x80u)
+
+/* Watchdog timer */
+#define CY_SYS_WDT_COUNTER0         (0x00u)
+#define CY_SYS_WDT_COUNTER1         (0x01u)
+#define CY_SYS_WDT_COUNTER2         (0x02u)
+#define CY_SYS_WDT_COUNTER0_MASK    (0x01u)
+#define CY_SYS_WDT_COUNTER1_MASK    (0x0100u)
+#define CY_SYS_WDT_COUNTER2_MASK    (0x010000u)
+#define CY_SYS_WDT_COUNTER0_RESET   (0x01u)
+#define CY_SYS_WDT_COUNTER1_RESET   (0x0100u)
+#define CY_SYS_WDT_COUNTER2_RESET   (0x010000u)
+#define CY_SYS_WDT_COUNTER1_INT     (0x08u)
+#define CY_SYS_WDT_MODE_NONE        (0u)
+#define CY_SYS_WDT_MODE_INT         (1u)
+#define CY_SYS_WDT_MODE_RESET       (2u)
+
+#define CY_FLASH_SIZEOF_ROW         (128u)
+#define CY_SYS_FLASH_SUCCESS        (0x00u)
+#define CY_ALIGN(align)             __attribute__((aligned(align)))
+
+#define CY_SYS_RESET_WDT            (0x01u)
+#define CY_SYS_SYST_CVR_REG         (fakeSysTickCount)
+#define CY_NOINIT
+
+#define UART_DEB_GET_TX_FIFO_SR_VALID   (0u)
+
+#define CyGlobalIntEnable
+#define CYASSERT(x)                 ((void)(x))
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+/* BLE component */
+CYBLE_API_RESULT_T CyBle_Start(CYBLE_CALLBACK_T callbackFunc);
+void CyBle_Stop(void);
+void CyBle_ProcessEvents(void);
+CYBLE_STATE_T CyBle_GetState(void);
+CYBLE_LP_MODE_T CyBle_EnterLPM(CYBLE_LP_MODE_T pwrMode);
+CYBLE_BLESS_STATE_T CyBle_GetBleSsState(void);
+CYBLE_STACK_STATE_T CyBle_GattGetBusyStatus(void);
+CYBLE_API_RESULT_T CyBle_GappStartAdvertisement(uint8 advertisingIntervalType);
+void CyBle_GappStopAdvertisement(void);
+CYBLE_API_RESULT_T CyBle_GetDeviceAddress(CYBLE_GAP_BD_ADDR_T *bdAddr);
+CYBLE_API_RESULT_T CyBle_GapDisconnect(uint8 bdHandle);
+CYBLE_API_RESULT_T CyBle_GapGetBondedDevicesList(CYBLE_GAP_BONDED_DEV_ADDR_LIST_T *bondedDevList);
+CYBLE_API_RESULT_T CyBle_GapGetPeerBdAddr(uint8 bdHandle, CYBLE_GAP_BD_ADDR_T *peerBdAddr);
+CYBLE_API_RESULT_T CyBle_GattGetMtuSize(uint16 *mtu);
+CYBLE_API_RESULT_T CyBle_GattsWriteRsp(CYBLE_CONN_HANDLE_T connHandle);
+CYBLE_API_RESULT_T CyBle_GattsNotification(CYBLE_CONN_HANDLE_T connHandle, CYBLE_GATTS_HANDLE_VALUE_NTF_T *ntfParam);
+CYBLE_API_RESULT_T CyBle_StoreBondingData(uint8 isForceWrite);
+CYBLE_API_RESULT_T CyBle_StoreAppData(uint8 *srcBuff, const uint8 destAddr[], uint32 buffLen, uint8 isForceWrite);
+CYBLE_API_RESULT_T CyBle_GapGenerateLocalP256Keys(void);
+CYBLE_API_RESULT_T CyBle_GapSetLocalP256Keys(CYBLE_GAP_SMP_LOCAL_P256_KEYS *localP256Keys);
+CYBLE_API_RESULT_T CyBle_L2capLeConnectionParamUpdateRequest(uint8 bdHandle,
+                                                             CYBLE_GAP_CONN_UPDATE_PARAM_T *connParam);
+CYBLE_API_RESULT_T CyBle_GetTxPowerLevel(CYBLE_BLESS_PWR_IN_DB_T *bleSsPwrLvl);
+CYBLE_API_RESULT_T CyBle_SetTxPowerLevel(const CYBLE_BLESS_PWR_IN_DB_T *bleSsPwrLvl);
+int8 CyBle_GetRssi(void);
+uint16 CyBle_Get16ByPtr(const uint8 ptr[]);
+
+void CyBle_HidsRegisterAttrCallback(CYBLE_CALLBACK_T callbackFunc);
+CYBLE_API_RESULT_T CyBle_HidssSendNotification(CYBLE_CONN_HANDLE_T connHandle, uint8 serviceIndex,
+                                               CYBLE_HIDS_CHAR_INDEX_T charIndex, uint8 attrSize, uint8 *attrValue);
+CYBLE_API_RESULT_T CyBle_HidssGetCharacteristicValue(uint8 serviceIndex, CYBLE_HIDS_CHAR_INDEX_T charIndex,
+                                                     uint8 attrSize, uint8 *attrValue);
+CYBLE_API_RESULT_T CyBle_HidssGetCharacteristicDescriptor(uint8 serviceIndex, CYBLE_HIDS_CHAR_INDEX_T charIndex,
+                                                          CYBLE_HIDS_DESCR_T descrIndex, uint8 attrSize,
+                                                          uint8 *attrValue);
+void CyBle_BasRegisterAttrCallback(CYBLE_CALLBACK_T callbackFunc);
+CYBLE_API_RESULT_T CyBle_BassSendNotification(CYBLE_CONN_HANDLE_T connHandle, uint8 serviceIndex,
+                                              CYBLE_BAS_CHAR_INDEX_T charIndex, uint8 attrSize, uint8 *attrValue);
+CYBLE_API_RESULT_T CyBle_BassSetCharacteristicValue(uint8 serviceIndex, CYBLE_BAS_CHAR_INDEX_T charIndex,
+                                                    uint8 attrSize, uint8 *attrValue);
+CYBLE_API_RESULT_T CyBle_BassGetCharacteristicDescriptor(uint8 serviceIndex, CYBLE_BAS_CHAR_INDEX_T charIndex,
+                                                         CYBLE_BAS_DESCR_INDEX_T descrIndex, uint8 attrSize,
+                                                         uint8 *attrValue);
+void CyBle_ScpsRegisterAttrCallback(CYBLE_CALLBACK_T callbackFunc);
+CYBLE_API_RESULT_T CyBle_ScpssGetCharacteristicDescriptor(CYBLE_SCPS_CHAR_INDEX_T charIndex,
+                                                          CYBLE_SCPS_DESCR_INDEX_T descrIndex, uint8 attrSize,
+                                                          uint8 *attrValue);
+
+/* I2C master */
+void I2CHW_Start(void);
+void I2CHW_Stop(void);
+uint32 I2CHW_I2CMasterStatus(void);
+uint32 I2CHW_I2CMasterClearStatus(void);
+uint32 I2CHW_I2CMasterReadBuf(uint32 slaveAddress, uint8 *rdData, uint32 cnt, uint32 mode);
+uint32 I2CHW_I2CMasterWriteBuf(uint32 slaveAddress, uint8 *wrData, uint32 cnt, uint32 mode);
+uint8 I2CHW_sda_Read(void);
+void I2CHW_sda_Write(uint8 value);
+void I2CHW_scl_Write(uint8 value);
+
+/* Debug UART and pins */
+void UART_DEB_Start(void);
+void UART_DEB_Stop(void);
+void UART_DEB_UartPutChar(uint32 txDataByte);
+uint32 UART_DEB_SpiUartGetTxBufferSize(void);
+void Advertising_LED_Write(uint8 value);
+void Disconnect_LED_Write(uint8 value);
+void CapsLock_LED_Write(uint8 value);
+void LowPower_LED_Write(uint8 value);
+
+/* System */
+uint8 CyEnterCriticalSection(void);
+void CyExitCriticalSection(uint8 savedIntrStatus);
+void CyDelay(uint32 milliseconds);
+void CyDelayUs(uint16 microseconds);
+void CySoftwareReset(void);
+uint32 CySysGetResetReason(uint32 reason);
+void CySysPmSleep(void);
+void CySysPmDeepSleep(void);
+void CySysPmHibernate(void);
+void CySysWdtUnlock(void);
+void CySysWdtLock(void);
+void CySysWdtWriteMode(uint32 counterNum, uint32 mode);
+void CySysWdtWriteClearOnMatch(uint32 counterNum, uint32 enable);
+void CySysWdtWriteMatch(uint32 counterNum, uint32 match);
+void CySysWdtEnable(uint32 counterMask);
+void CySysWdtDisable(uint32 counterMask);
+void CySysWdtResetCounters(uint32 countersMask);
+uint32 CySysWdtGetCount(uint32 counterNum);
+uint32 CySysWdtGetInterruptSource(void);
+void CySysWdtEnableCounterIsr(uint32 counterNum);
+cyisraddress CySysWdtSetInterruptCallback(uint32 counterNum, cyisraddress function);
+uint32 CySysFlashWriteRow(uint32 rowNum, const uint8 rowData[]);
+void CySysTickInit(void);
+void CySysTickSetReload(uint32 value);
+void CySysTickClear(void);
+void CySysTickEnable(void);
+void CySysTickDisableInterrupt(void);
+
+
+/***************************************
+* External data references
+***************************************/
+extern CYBLE_CONN_HANDLE_T cyBle_connHandle;
+extern CYBLE_GAPP_DISC_MODE_INFO_T cyBle_discoveryModeInfo;
+extern uint8 cyBle_pendingFlashWrite;
+
+/* Fake state of the unit tests, see fakes.c */
+#define FAKE_REPORT_LOG             (32u)       /* HID notifications recorded */
+#define FAKE_REPORT_SIZE            (8u)
+
+extern uint32 fakeConnParamRequests;
+extern CYBLE_GAP_CONN_UPDATE_PARAM_T fakeConnParam;
+extern CYBLE_API_RESULT_T fakeConnParamResult;
+extern CYBLE_BLESS_PWR_LVL_T fakeTxPower;
+extern uint32 fakeTxPowerSets;
+extern int8 fakeRssi;
+extern uint32 fakeKeyGenerations;
+extern CYBLE_API_RESULT_T fakeKeyResult;
+extern uint32 fakeKeySets;
+extern CYBLE_GAP_SMP_LOCAL_P256_KEYS fakeKeys;
+extern uint32 fakeStoreBusy;
+extern uint32 fakeStores;
+extern const uint8 *fakeStoreDest;
+extern uint32 fakeStoreSize;
+extern CYBLE_STATE_T fakeState;
+extern CYBLE_GAP_BONDED_DEV_ADDR_LIST_T fakeBondedList;
+extern CYBLE_GAP_BD_ADDR_T fakePeerAddr;
+extern uint32 fakeDisconnects;
+extern uint32 fakeAdvStarts;
+extern uint32 fakePendingWork;
+extern CYBLE_STACK_STATE_T fakeBusy;
+extern uint32 fakeReportCount;
+extern uint8 fakeReports[FAKE_REPORT_LOG][FAKE_REPORT_SIZE];
+extern uint32 fakeCharValueReads;
+extern uint8 fakeCapsLockLed;
+extern uint32 fakeSysTickCount;
+extern uint32 fakeSysTickReload;
+
+void FakeBleReset(void);
+
+#endif /* FAKE_PROJECT_H */
+
+
+/* [] END OF FILE */
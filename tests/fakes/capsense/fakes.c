@@ -0,0 +1,176 @@
+/*******************************************************************************
+* File Name: fakes.c
+*
+* Version 1.0
+*
+* Description:
+*  Host fakes of the CapSense, EZI2C, pin and system APIs. Scans complete at
+*  once; flash rows written by the firmware are captured in fakeFlash[].
+*
+*******************************************************************************/
+
+#include <string.h>
+#include "project.h"
+
+#define FAKE_FLASH_ROWS             (4u)
+
+CapSense_RAM_STRUCT CapSense_dsRam = {.configId = CapSense_CONFIG_ID, .timestampInterval = 1u};
+
+uint32 fakeCapSenseStarts = 0u;
+uint8 fakeFlash[FAKE_FLASH_ROWS * CY_FLASH_SIZEOF_ROW];
+uint32 fakeFlashWrites = 0u;
+uint32 fakeSysTickCount = 0u;           /* Current value of the SysTick down counter */
+static uint32 fakeFlashFirstRow;
+
+
+uint32 CapSense_Start(void)
+{
+    fakeCapSenseStarts++;
+    return (CYRET_SUCCESS);
+}
+
+uint32 CapSense_Initialize(void)
+{
+    return (CYRET_SUCCESS);
+}
+
+void CapSense_InitializeAllBaselines(void)
+{
+}
+
+uint32 CapSense_ScanAllWidgets(void)
+{
+    return (CYRET_SUCCESS);
+}
+
+uint32 CapSense_SetupWidget(uint32 widgetId)
+{
+    (void)widgetId;
+    return (CYRET_SUCCESS);
+}
+
+uint32 CapSense_Scan(void)
+{
+    return (CYRET_SUCCESS);
+}
+
+uint32 CapSense_IsBusy(void)
+{
+    return (CapSense_NOT_BUSY);
+}
+
+uint32 CapSense_ProcessWidget(uint32 widgetId)
+{
+    (void)widgetId;
+    return (CYRET_SUCCESS);
+}
+
+uint32 CapSense_GetCentroidPos(uint32 widgetId)
+{
+    (void)widgetId;
+    return (CapSense_dsRam.wdgtList.linearslider0.position[0u]);
+}
+
+void CapSense_IncrementGestureTimestamp(void)
+{
+    CapSense_dsRam.timestamp += CapSense_dsRam.timestampInterval;
+}
+
+void CapSense_SetGestureTimestamp(uint32 value)
+{
+    CapSense_dsRam.timestamp = value;
+}
+
+void EZI2C_Start(void)
+{
+}
+
+void EZI2C_EzI2CSetBuffer1(uint32 bufSize, uint32 rwBoundary, volatile uint8 *buffer)
+{
+    (void)bufSize;
+    (void)rwBoundary;
+    (void)buffer;
+}
+
+void LED_11_Write(uint8 value)
+{
+    (void)value;
+}
+
+void LED_12_Write(uint8 value)
+{
+    (void)value;
+}
+
+void LED_13_Write(uint8 value)
+{
+    (void)value;
+}
+
+void Left_LED_Write(uint8 value)
+{
+    (void)value;
+}
+
+void Right_LED_Write(uint8 value)
+{
+    (void)value;
+}
+
+void CySysTickStart(void)
+{
+}
+
+uint32 CySysTickGetReload(void)
+{
+    return (47999u);
+}
+
+cySysTickCallback CySysTickSetCallback(uint32 number, cySysTickCallback function)
+{
+    (void)number;
+    (void)function;
+    return ((cySysTickCallback)0);
+}
+
+void CySysTickClearCallback(uint32 number)
+{
+    (void)number;
+}
+
+/* Rows are stored relative to the first row written since fakeFlashWrites
+*  was cleared; the firmware address of the row does not fit 32 bits here */
+uint32 CySysFlashWriteRow(uint32 rowNum, const uint8 rowData[])
+{
+    if(fakeFlashWrites == 0u)
+    {
+        fakeFlashFirstRow = rowNum;
+    }
+    if((rowNum - fakeFlashFirstRow) < FAKE_FLASH_ROWS)
+    {
+        (void)memcpy(&fakeFlash[(rowNum - fakeFlashFirstRow) * CY_FLASH_SIZEOF_ROW], rowData, CY_FLASH_SIZEOF_ROW);
+    }
+    fakeFlashWrites++;
+    return (CYRET_SUCCESS);
+}
+
+void CySysWdtSetIgnoreBits(uint32 bitsNum)
+{
+    (void)bitsNum;
+}
+
+void CySysWdtEnable(void)
+{
+}
+
+void CySysWdtClearInterrupt(void)
+{
+}
+
+void CySysPmSleep(void)
+{
+    CapSense_dsRam.timestamp++;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,167 @@
+/*******************************************************************************
+* File Name: project.h
+*
+* Version 1.0
+*
+* Description:
+*  Host stand-in for the PSoC Creator generated header of the CapSense
+*  project. Declares the part of the CapSense, EZI2C, pin and system APIs
+*  the firmware sources use; fakes.c implements them.
+*
+*******************************************************************************/
+
+#if !defined(FAKE_PROJECT_H)
+#define FAKE_PROJECT_H
+
+#include <stdint.h>
+
+
+/***************************************
+*        Data Types
+***************************************/
+typedef uint8_t uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef uint64_t uint64;
+typedef int8_t int8;
+typedef int16_t int16;
+typedef int32_t int32;
+
+typedef void (*cySysTickCallback)(void);
+
+/* Widget and sensor RAM structures, reduced to the fields the firmware uses */
+typedef struct
+{
+    uint16 resolution;
+    uint16 fingerTh;
+    uint8 noiseTh;
+    uint8 nNoiseTh;
+    uint8 hysteresis;
+    uint8 onDebounce;
+    uint8 lowBslnRst;
+    uint8 idacMod[1u];
+    uint8 idacGainIndex;
+    uint16 snsClk;
+    uint8 snsClkSource;
+} CapSense_RAM_WD_BUTTON_STRUCT;
+
+typedef struct
+{
+    uint16 resolution;
+    uint16 fingerTh;
+    uint8 noiseTh;
+    uint8 nNoiseTh;
+    uint8 hysteresis;
+    uint8 onDebounce;
+    uint8 lowBslnRst;
+    uint8 idacMod[1u];
+    uint8 idacGainIndex;
+    uint16 snsClk;
+    uint8 snsClkSource;
+    uint16 position[1u];
+} CapSense_RAM_WD_SLIDER_STRUCT;
+
+typedef struct
+{
+    uint16 raw[1u];
+    uint16 bsln[1u];
+    uint16 diff;
+    uint8 idacComp[1u];
+} CapSense_RAM_SNS_STRUCT;
+
+typedef struct
+{
+    uint16 configId;
+    uint32 timestamp;
+    uint8 timestampInterval;
+    struct
+    {
+        CapSense_RAM_WD_BUTTON_STRUCT btn0;
+        CapSense_RAM_WD_BUTTON_STRUCT btn1;
+        CapSense_RAM_WD_BUTTON_STRUCT btn2;
+        CapSense_RAM_WD_SLIDER_STRUCT linearslider0;
+    } wdgtList;
+    struct
+    {
+        CapSense_RAM_SNS_STRUCT btn0[1u];
+        CapSense_RAM_SNS_STRUCT btn1[1u];
+        CapSense_RAM_SNS_STRUCT btn2[1u];
+        CapSense_RAM_SNS_STRUCT linearslider0[6u];
+    } snsList;
+} CapSense_RAM_STRUCT;
+
+
+/***************************************
+*          Constants
+***************************************/
+#define CYRET_SUCCESS               (0x00u)
+#define CY_FLASH_BASE               (0x00000000u)
+#define CY_FLASH_SIZEOF_ROW         (128u)
+#define CY_SYS_SYST_CVR_REG         (fakeSysTickCount)
+#define CY_ALIGN(align)             __attribute__((aligned(align)))
+
+#define CapSense_NOT_BUSY           (0u)
+#define CapSense_SW_STS_BUSY        (0x80000000u)
+#define CapSense_CSD_IDAC_COMP_EN   (1u)
+#define CapSense_TOTAL_WIDGETS      (4u)
+#define CapSense_BTN0_WDGT_ID       (0u)
+#define CapSense_BTN1_WDGT_ID       (1u)
+#define CapSense_BTN2_WDGT_ID       (2u)
+#define CapSense_LINEARSLIDER0_WDGT_ID (3u)
+#define CapSense_SLIDER_NO_TOUCH    (0xFFFFu)
+#define CapSense_CONFIG_ID          (0x5A3Cu)
+
+#define CyGlobalIntEnable
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+uint32 CapSense_Start(void);
+uint32 CapSense_Initialize(void);
+void CapSense_InitializeAllBaselines(void);
+uint32 CapSense_ScanAllWidgets(void);
+uint32 CapSense_ProcessAllWidgets(void);
+uint32 CapSense_SetupWidget(uint32 widgetId);
+uint32 CapSense_Scan(void);
+uint32 CapSense_IsBusy(void);
+uint32 CapSense_ProcessWidget(uint32 widgetId);
+uint32 CapSense_GetCentroidPos(uint32 widgetId);
+void CapSense_IncrementGestureTimestamp(void);
+void CapSense_SetGestureTimestamp(uint32 value);
+
+void EZI2C_Start(void);
+void EZI2C_EzI2CSetBuffer1(uint32 bufSize, uint32 rwBoundary, volatile uint8 *buffer);
+
+void LED_11_Write(uint8 value);
+void LED_12_Write(uint8 value);
+void LED_13_Write(uint8 value);
+void Left_LED_Write(uint8 value);
+void Right_LED_Write(uint8 value);
+
+void CySysTickStart(void);
+uint32 CySysTickGetReload(void);
+cySysTickCallback CySysTickSetCallback(uint32 number, cySysTickCallback function);
+void CySysTickClearCallback(uint32 number);
+uint32 CySysFlashWriteRow(uint32 rowNum, const uint8 rowData[]);
+void CySysWdtSetIgnoreBits(uint32 bitsNum);
+void CySysWdtEnable(void);
+void CySysWdtClearInterrupt(void);
+void CySysPmSleep(void);
+
+
+/***************************************
+* External data references
+***************************************/
+extern CapSense_RAM_STRUCT CapSense_dsRam;
+
+/* Fake state, see fakes.c */
+extern uint32 fakeCapSenseStarts;
+extern uint8 fakeFlash[];
+extern uint32 fakeFlashWrites;
+extern uint32 fakeSysTickCount;
+
+#endif /* FAKE_PROJECT_H */
+
+
+/* [] END OF FILE */
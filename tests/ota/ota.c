@@ -0,0 +1,259 @@
+/*******************************************************************************
+* File Name: ota.c
+*
+* Version 1.0
+*
+* Description:
+*  This file contains the over-the-air update image packer: the header and
+*  CRC of a packed image, and its chunks for ATT write commands at a given
+*  MTU. The update client and the device model of the transfer benchmark
+*  share it, so both ends agree on the format.
+*
+*******************************************************************************/
+
+#include <string.h>
+#include "ota.h"
+
+#define OTA_CRC_INIT                (0xFFFFFFFFu)
+#define OTA_CRC_POLY                (0xEDB88320u)   /* CRC-32, reflected */
+
+static void OtaPut32(uint8_t *data, uint32_t value);
+static uint32_t OtaGet32(const uint8_t *data);
+
+
+/*******************************************************************************
+* Function Name: OtaCrc32()
+********************************************************************************
+*
+* Summary:
+*   Computes the CRC-32 of IEEE 802.3 over a buffer, bit by bit as the
+*   device would without a table.
+*
+* Parameters:
+*  data - the buffer
+*  size - its size
+*  crc - 0 to start, the result of the previous part to continue
+*
+* Return:
+*  The CRC.
+*
+*******************************************************************************/
+uint32_t OtaCrc32(const uint8_t *data, uint32_t size, uint32_t crc)
+{
+    uint8_t bit;
+
+    crc = ~crc;
+    while(size-- != 0u)
+    {
+        crc ^= *data++;
+        for(bit = 0u; bit < 8u; bit++)
+        {
+            crc = ((crc & 1u) != 0u) ? ((crc >> 1u) ^ OTA_CRC_POLY) : (crc >> 1u);
+        }
+    }
+    return (~crc);
+}
+
+
+/*******************************************************************************
+* Function Name: OtaPackedSize()
+********************************************************************************
+*
+* Summary:
+*   Size of the packed image of an image: the header and the image padded to
+*   whole flash rows.
+*
+*******************************************************************************/
+uint32_t OtaPackedSize(uint32_t size)
+{
+    return (OTA_HEADER_SIZE + (((size + OTA_ROW_SIZE - 1u) / OTA_ROW_SIZE) * OTA_ROW_SIZE));
+}
+
+
+/*******************************************************************************
+* Function Name: OtaPack()
+********************************************************************************
+*
+* Summary:
+*   Packs an image: writes the header with the CRC of the image, the image
+*   and the padding of its last row, which is erased flash.
+*
+* Parameters:
+*  image - the firmware image
+*  size - its size
+*  version - application version
+*  packed - the packed image
+*  packedSize - room in packed
+*
+* Return:
+*  Size of the packed image, 0 when it does not fit.
+*
+*******************************************************************************/
+uint32_t OtaPack(const uint8_t *image, uint32_t size, uint16_t version, uint8_t *packed, uint32_t packedSize)
+{
+    uint32_t length = OtaPackedSize(size);
+
+    if((size == 0u) || (length > packedSize))
+    {
+        return (0u);
+    }
+    OtaPut32(&packed[0u], OTA_MAGIC);
+    packed[4u] = (uint8_t)version;
+    packed[5u] = (uint8_t)(version >> 8u);
+    packed[6u] = (uint8_t)OTA_ROW_SIZE;
+    packed[7u] = (uint8_t)(OTA_ROW_SIZE >> 8u);
+    OtaPut32(&packed[8u], size);
+    OtaPut32(&packed[12u], OtaCrc32(image, size, 0u));
+    (void)memcpy(&packed[OTA_HEADER_SIZE], image, size);
+    (void)memset(&packed[OTA_HEADER_SIZE + size], 0, length - OTA_HEADER_SIZE - size);
+    return (length);
+}
+
+
+/*******************************************************************************
+* Function Name: OtaParseHeader()
+********************************************************************************
+*
+* Summary:
+*   Reads the header at the start of a packed image.
+*
+* Parameters:
+*  data - OTA_HEADER_SIZE bytes
+*  header - the header read
+*
+* Return:
+*  Non-zero when the header is one of this format.
+*
+*******************************************************************************/
+uint8_t OtaParseHeader(const uint8_t *data, OTA_HEADER_T *header)
+{
+    header->magic = OtaGet32(&data[0u]);
+    header->version = (uint16_t)(data[4u] | ((uint16_t)data[5u] << 8u));
+    header->rowSize = (uint16_t)(data[6u] | ((uint16_t)data[7u] << 8u));
+    header->size = OtaGet32(&data[8u]);
+    header->crc = OtaGet32(&data[12u]);
+    return ((uint8_t)((header->magic == OTA_MAGIC) && (header->rowSize == OTA_ROW_SIZE) && (header->size != 0u)));
+}
+
+
+/*******************************************************************************
+* Function Name: OtaChunkPayload()
+********************************************************************************
+*
+* Summary:
+*   Image bytes in one chunk: the ATT MTU less the write command header and
+*   the chunk offset.
+*
+*******************************************************************************/
+uint16_t OtaChunkPayload(uint16_t mtu)
+{
+    return ((uint16_t)(mtu - OTA_ATT_WRITE_HEADER - OTA_CHUNK_HEADER));
+}
+
+uint32_t OtaChunkCount(uint32_t packedSize, uint16_t mtu)
+{
+    return ((packedSize + OtaChunkPayload(mtu) - 1u) / OtaChunkPayload(mtu));
+}
+
+
+/*******************************************************************************
+* Function Name: OtaChunk()
+********************************************************************************
+*
+* Summary:
+*   Cuts the chunk at an offset out of a packed image. The chunks of a
+*   transfer follow each other without a gap, the last one is shorter.
+*
+* Parameters:
+*  packed - the packed image
+*  packedSize - its size
+*  mtu - ATT MTU agreed with the device
+*  offset - offset of the chunk payload in the packed image
+*  chunk - at least mtu - OTA_ATT_WRITE_HEADER bytes
+*
+* Return:
+*  Size of the chunk, the value of the write command; 0 past the end.
+*
+*******************************************************************************/
+uint16_t OtaChunk(const uint8_t *packed, uint32_t packedSize, uint16_t mtu, uint32_t offset, uint8_t *chunk)
+{
+    uint32_t payload = OtaChunkPayload(mtu);
+
+    if(offset >= packedSize)
+    {
+        return (0u);
+    }
+    if(payload > (packedSize - offset))
+    {
+        payload = packedSize - offset;
+    }
+    OtaPut32(chunk, offset);
+    (void)memcpy(&chunk[OTA_CHUNK_HEADER], &packed[offset], payload);
+    return ((uint16_t)(OTA_CHUNK_HEADER + payload));
+}
+
+uint32_t OtaChunkOffset(const uint8_t *chunk)
+{
+    return (OtaGet32(chunk));
+}
+
+
+/*******************************************************************************
+* Function Name: OtaVerify()
+********************************************************************************
+*
+* Summary:
+*   Checks a written image against the CRC of its header.
+*
+* Parameters:
+*  image - the image as written, without the header
+*  header - its header
+*
+* Return:
+*  Non-zero when the image is intact.
+*
+*******************************************************************************/
+uint8_t OtaVerify(const uint8_t *image, const OTA_HEADER_T *header)
+{
+    return ((uint8_t)(OtaCrc32(image, header->size, 0u) == header->crc));
+}
+
+
+/*******************************************************************************
+* Function Name: OtaAck()
+********************************************************************************
+*
+* Summary:
+*   Writes the acknowledgement notification of the device: OTA_STATUS_xxx
+*   and the offset in the packed image up to which it has written flash.
+*
+*******************************************************************************/
+void OtaAck(uint8_t status, uint32_t offset, uint8_t *ack)
+{
+    ack[0u] = status;
+    OtaPut32(&ack[1u], offset);
+}
+
+uint32_t OtaAckOffset(const uint8_t *ack)
+{
+    return (OtaGet32(&ack[1u]));
+}
+
+
+/* Little endian fields */
+static void OtaPut32(uint8_t *data, uint32_t value)
+{
+    data[0u] = (uint8_t)value;
+    data[1u] = (uint8_t)(value >> 8u);
+    data[2u] = (uint8_t)(value >> 16u);
+    data[3u] = (uint8_t)(value >> 24u);
+}
+
+static uint32_t OtaGet32(const uint8_t *data)
+{
+    return ((uint32_t)data[0u] | ((uint32_t)data[1u] << 8u) | ((uint32_t)data[2u] << 16u) |
+            ((uint32_t)data[3u] << 24u));
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,78 @@
+/*******************************************************************************
+* File Name: ota.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the interface of the over-the-air update image packer and the
+*  format of the transfer it prepares.
+*
+*  A packed image is a header followed by the firmware image, padded to
+*  whole flash rows. The header carries the image size and its CRC-32. The
+*  update client cuts the packed image into chunks that fit one ATT write
+*  command at the MTU agreed with the device; each chunk starts with the
+*  offset of its payload in the packed image. The device acknowledges the
+*  bytes it has written to flash in notifications, and the client keeps at
+*  most OTA_WINDOW bytes beyond the last acknowledgement in flight.
+*
+*******************************************************************************/
+
+#if !defined(OTA_H)
+#define OTA_H
+
+#include <stdint.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+#define OTA_MAGIC                   (0x3141544Fu)   /* "OTA1" */
+#define OTA_ROW_SIZE                (128u)          /* Flash row of the BLE MCU */
+#define OTA_HEADER_SIZE             (16u)
+
+#define OTA_ATT_DEFAULT_MTU         (23u)
+#define OTA_ATT_WRITE_HEADER        (3u)            /* Opcode and handle of a write command */
+#define OTA_CHUNK_HEADER            (4u)            /* Offset of the chunk payload */
+
+#define OTA_WINDOW                  (1024u)         /* Bytes the device buffers, sent ahead of the acknowledgement */
+#define OTA_ACK_SIZE                (5u)            /* Status and the offset written */
+
+/* Status of an acknowledgement */
+#define OTA_STATUS_CONTINUE         (0u)            /* Offset written, send on */
+#define OTA_STATUS_DONE             (1u)            /* Image written and its CRC verified */
+#define OTA_STATUS_ERROR            (2u)            /* Bad header, offset or CRC; the update is abandoned */
+
+
+/***************************************
+*        Data Types
+***************************************/
+/* Header, little endian at the start of a packed image */
+typedef struct
+{
+    uint32_t magic;                 /* OTA_MAGIC */
+    uint16_t version;               /* Application version of the image */
+    uint16_t rowSize;               /* OTA_ROW_SIZE */
+    uint32_t size;                  /* Image bytes, without the padding */
+    uint32_t crc;                   /* CRC-32 of the image, without the padding */
+} OTA_HEADER_T;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+uint32_t OtaCrc32(const uint8_t *data, uint32_t size, uint32_t crc);
+uint32_t OtaPackedSize(uint32_t size);
+uint32_t OtaPack(const uint8_t *image, uint32_t size, uint16_t version, uint8_t *packed, uint32_t packedSize);
+uint8_t OtaParseHeader(const uint8_t *data, OTA_HEADER_T *header);
+uint16_t OtaChunkPayload(uint16_t mtu);
+uint32_t OtaChunkCount(uint32_t packedSize, uint16_t mtu);
+uint16_t OtaChunk(const uint8_t *packed, uint32_t packedSize, uint16_t mtu, uint32_t offset, uint8_t *chunk);
+uint32_t OtaChunkOffset(const uint8_t *chunk);
+uint8_t OtaVerify(const uint8_t *image, const OTA_HEADER_T *header);
+void OtaAck(uint8_t status, uint32_t offset, uint8_t *ack);
+uint32_t OtaAckOffset(const uint8_t *ack);
+
+#endif /* OTA_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,108 @@
+/*******************************************************************************
+* File Name: ota_pack.c
+*
+* Version 1.0
+*
+* Description:
+*  Packs a BLE MCU firmware image for an over-the-air update, see ota/ota.h:
+*
+*   ota_pack [-v version] [-m mtu] image.bin image.ota
+*
+*  image.bin is the application as a raw binary, e.g. from
+*  "arm-none-eabi-objcopy -O binary" of the linked ELF. The tool writes the
+*  packed image and prints its header and the chunks of a transfer at the
+*  given ATT MTU, 23 by default.
+*
+*******************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ota/ota.h"
+
+#define PACK_MAX_IMAGE              (256u * 1024u)  /* Flash of the BLE MCU */
+#define PACK_MAX_MTU                (512u)
+
+static uint8_t image[PACK_MAX_IMAGE];
+static uint8_t packed[OTA_HEADER_SIZE + PACK_MAX_IMAGE];
+
+
+static int Usage(const char *name)
+{
+    printf("usage: %s [-v version] [-m mtu] image.bin image.ota\n", name);
+    return (2);
+}
+
+
+int main(int argc, char *argv[])
+{
+    OTA_HEADER_T header;
+    unsigned long value;
+    uint16_t version = 0u;
+    uint16_t mtu = OTA_ATT_DEFAULT_MTU;
+    uint32_t size;
+    uint32_t length;
+    FILE *file;
+    int arg = 1;
+
+    while(((arg + 1) < argc) && (argv[arg][0u] == '-'))
+    {
+        value = strtoul(argv[arg + 1], NULL, 0);
+        if((strcmp(argv[arg], "-v") == 0) && (value <= UINT16_MAX))
+        {
+            version = (uint16_t)value;
+        }
+        else if((strcmp(argv[arg], "-m") == 0) && (value > (OTA_ATT_WRITE_HEADER + OTA_CHUNK_HEADER)) &&
+                (value <= PACK_MAX_MTU))
+        {
+            mtu = (uint16_t)value;
+        }
+        else
+        {
+            return (Usage(argv[0u]));
+        }
+        arg += 2;
+    }
+    if((argc - arg) != 2)
+    {
+        return (Usage(argv[0u]));
+    }
+
+    file = fopen(argv[arg], "rb");
+    if(file == NULL)
+    {
+        printf("%s: cannot open\n", argv[arg]);
+        return (1);
+    }
+    size = (uint32_t)fread(image, 1u, sizeof(image), file);
+    if((size == sizeof(image)) && (fgetc(file) != EOF))
+    {
+        size = 0u;
+    }
+    (void)fclose(file);
+    length = OtaPack(image, size, version, packed, sizeof(packed));
+    if(length == 0u)
+    {
+        printf("%s: empty or larger than the flash\n", argv[arg]);
+        return (1);
+    }
+
+    file = fopen(argv[arg + 1], "wb");
+    if((file == NULL) || (fwrite(packed, 1u, length, file) != length) || (fclose(file) != 0))
+    {
+        printf("%s: cannot write\n", argv[arg + 1]);
+        return (1);
+    }
+
+    (void)OtaParseHeader(packed, &header);
+    printf("version %u, image %lu bytes, CRC-32 %08lx, %lu rows of %u bytes\n", header.version,
+           (unsigned long)header.size, (unsigned long)header.crc,
+           (unsigned long)((length - OTA_HEADER_SIZE) / OTA_ROW_SIZE), header.rowSize);
+    printf("MTU %u: %lu chunks of up to %u bytes\n", mtu, (unsigned long)OtaChunkCount(length, mtu),
+           OtaChunkPayload(mtu));
+    return (0);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,1465 @@
+/*******************************************************************************
+* File Name: ble.c
+*
+* Version 1.0
+*
+* Description:
+*  This file contains the simulated BLE MCU: the component APIs of the fake
+*  project.h implemented on the virtual clock, and the central at the other
+*  end of the link.
+*
+*  The model covers what the firmware timing depends on:
+*   - the stack event queue, delivered by CyBle_ProcessEvents()
+*   - fast and slow advertising, the connection, pairing and the CCCD write
+*   - connection events with slave latency, a few TX buffers per link and
+*     the busy status, and the connection parameter update procedure
+*   - the ATT MTU exchange, and write commands of the central cut into LL
+*     packets of 27 bytes, which take one of a few RX buffers of the stack
+*   - the BLESS state the low power code checks: ECO_STABLE inside an
+*     attended connection event, Deep-Sleep otherwise
+*   - the WDT counters, the I2C master byte by byte, Sleep and Deep-Sleep,
+*     and flash row writes, which stall the CPU
+*   - the faults a bench injects: a slave holding SDA low until it sees
+*     enough SCL pulses, a BLE hardware error that may come back on every
+*     stack start, and a main loop that hangs
+*  Advertising events are not modeled, the CPU sleeps through them, and the
+*  debug UART is taken to be idle.
+*
+*******************************************************************************/
+
+#include <string.h>
+#include "project.h"
+#include "ble.h"
+
+/* Model parameters */
+#define SIM_LOOP_TIME               (50u)       /* us of one main loop pass with its event processing */
+#define SIM_EVENT_TIME              (400u)      /* us the radio is on in an empty connection event */
+#define SIM_PACKET_TIME             (600u)      /* us per LL packet, with the response of the other side */
+#define SIM_TX_BUFFERS              (4u)        /* Notifications the stack holds per link */
+#define SIM_RX_BUFFERS              (4u)        /* Write commands the stack holds for the application */
+#define SIM_CENTRAL_WRITES          (16u)       /* Write commands the central queues */
+#define SIM_LL_PAYLOAD              (27u)       /* LL data payload, without data length extension */
+#define SIM_L2CAP_HEADER            (4u)
+#define SIM_ATT_WRITE_HEADER        (3u)        /* Opcode and handle */
+#define SIM_ATT_DEFAULT_MTU         (23u)
+#define SIM_NTF_SIZE                (SIM_ATT_DEFAULT_MTU - SIM_ATT_WRITE_HEADER)
+#define SIM_CONN_UPDATE_INSTANT     (6u)        /* Events from the response to the new parameters */
+#define SIM_FAST_ADV_TIME           (30000000u) /* us of fast advertising */
+#define SIM_SLOW_ADV_TIME           (150000000u)/* us of slow advertising */
+#define SIM_DIRECTED_ADV_TIME       (1280000u)  /* us of high duty cycle directed advertising */
+#define SIM_FLASH_ROW_TIME          (20000u)    /* us the CPU stalls per flash row write */
+#define SIM_I2C_BYTE_TIME           (23u)       /* us per byte with ACK at 400 kHz */
+#define SIM_EZI2C_ADDRESS           (0x08u)     /* Slave address of the EZI2C component on the CapSense MCU */
+#define SIM_EVENT_QUEUE_SIZE        (16u)
+#define SIM_WDT_COUNTERS            (3u)
+#define SIM_WDT_MASK(counter)       (1u << (8u * (counter)))
+#define SIM_DISCONNECT_REASON       (0x16u)     /* Connection terminated by the local host */
+
+/* Connection parameter update procedure */
+#define SIM_PARAM_IDLE              (0u)
+#define SIM_PARAM_REQUESTED         (1u)        /* Request sent in the next event */
+#define SIM_PARAM_UPDATING          (2u)        /* Accepted, waiting for the instant */
+
+typedef struct
+{
+    uint32 event;
+    union
+    {
+        uint8 status;
+        uint16 result;
+        CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T updated;
+        CYBLE_GAP_AUTH_INFO_T auth;
+        CYBLE_HIDS_CHAR_VALUE_T hids;
+        CYBLE_GATTS_WRITE_CMD_REQ_PARAM_T write;
+    } param;
+} SIM_EVENT_T;
+
+/* Notification in a TX buffer, of one LL packet */
+typedef struct
+{
+    uint16 attrHandle;              /* 0 for a HID report, which goes to the report log */
+    uint8 size;
+    uint8 data[SIM_NTF_SIZE];
+} SIM_TX_T;
+
+/* Write command of the central */
+typedef struct
+{
+    uint16 attrHandle;
+    uint16 size;
+    uint8 data[SIM_BLE_MAX_MTU];
+} SIM_WRITE_T;
+
+SIM_CPU_T simBleCpu;
+SIM_CENTRAL_T simCentral;
+SIM_BLE_RESULT_T simBle;
+void (*simBleInterrupt)(void);
+
+CYBLE_CONN_HANDLE_T cyBle_connHandle = {0u, 0u};
+static CYBLE_GAPP_DISC_PARAM_T simAdvParam;
+CYBLE_GAPP_DISC_MODE_INFO_T cyBle_discoveryModeInfo = {&simAdvParam};
+uint8 cyBle_pendingFlashWrite = 0u;
+uint8 simFlash[SIM_FLASH_SIZE];
+
+int BleMain();
+
+/* Stack */
+static CYBLE_CALLBACK_T appCallback;
+static CYBLE_CALLBACK_T hidsCallback;
+static CYBLE_CALLBACK_T basCallback;
+static CYBLE_CALLBACK_T scpsCallback;
+static CYBLE_STATE_T bleState = CYBLE_STATE_STOPPED;
+static SIM_EVENT_T eventQueue[SIM_EVENT_QUEUE_SIZE];
+static uint8 eventHead;
+static uint8 eventTail;
+static CYBLE_BLESS_PWR_LVL_T txPower = CYBLE_LL_PWR_LVL_0_DBM;
+
+/* Advertising and connection */
+static SIM_TIMER_T advTimer;
+static SIM_TIMER_T connectTimer;
+static SIM_TIMER_T pairTimer;
+static SIM_TIMER_T anchorTimer;
+static SIM_TIMER_T eventEndTimer;
+static uint8 slowAdvertising;
+static uint8 bonded;
+static uint8 disconnectPending;
+static uint16 connInterval;
+static uint16 connLatency;
+static uint32 anchorCount;
+static uint16 anchorsSkipped;
+static uint64 eventStart;
+static uint64 eventEnd;
+static uint8 paramState = SIM_PARAM_IDLE;
+static CYBLE_GAP_CONN_UPDATE_PARAM_T paramRequest;
+static uint32 paramInstant;
+
+/* GATT database values written by the central */
+static uint16 hidsReportCccd;
+static uint16 hidsBootCccd;
+static uint8 hidsProtocolMode = CYBLE_HIDS_PROTOCOL_MODE_REPORT;
+
+/* TX buffers */
+static SIM_TX_T txQueue[SIM_TX_BUFFERS];
+static uint8 txHead;
+static uint8 txCount;
+static CYBLE_STACK_STATE_T busyStatus = CYBLE_STACK_STATE_FREE;
+
+/* Write commands: queued by the central, then in the RX buffers until delivered */
+static uint16 attMtu = SIM_ATT_DEFAULT_MTU;
+static SIM_WRITE_T writeQueue[SIM_CENTRAL_WRITES];
+static uint8 writeHead;
+static uint8 writeCount;
+static uint8 writePackets;                  /* LL packets of the first queued write already sent */
+static SIM_WRITE_T rxQueue[SIM_RX_BUFFERS];
+static uint8 rxHead;
+static uint8 rxCount;
+
+/* WDT */
+static uint32 wdtEnabled;
+static uint32 wdtMode[SIM_WDT_COUNTERS];
+static uint32 wdtMatch[SIM_WDT_COUNTERS];
+static uint32 wdtClearOnMatch[SIM_WDT_COUNTERS];
+static uint64 wdtResetAt[SIM_WDT_COUNTERS];     /* Time the count was 0 */
+static uint32 wdtHeld[SIM_WDT_COUNTERS];        /* Count of a disabled counter */
+static uint32 wdtMatches;                   /* Counter 1 matches since its reset */
+static cyisraddress wdtCallback[SIM_WDT_COUNTERS];
+static SIM_TIMER_T wdtResetTimer;
+static SIM_TIMER_T wdtIntTimer;
+
+/* I2C master */
+static SIM_TIMER_T i2cTimer;
+static uint8 i2cStarted;
+static uint32 i2cStatus;
+static uint8 *i2cData;
+static uint32 i2cCount;
+static uint32 i2cIndex;
+static uint8 i2cRead;
+static uint8 sdaHeld;                       /* SCL pulses until the slave releases SDA, 0 when free */
+static uint8 sclLevel = 1u;
+
+/* Faults */
+static uint8 hardwareErrorPersistent;
+static uint8 hang;
+
+static void QueueEvent(uint32 event, const void *param, size_t size);
+static void AdvertisingTimeout(void);
+static void Connect(void);
+static void PairingComplete(void);
+static void Anchor(void);
+static void EventEnd(void);
+static void Disconnect(void);
+static uint8 SendWrites(void);
+static uint8 WritePackets(uint16 size);
+static void WdtArm(void);
+static void WdtReset(void);
+static void WdtInterrupt(void);
+static void I2cAddress(void);
+static void I2cByte(void);
+static void I2cFinish(uint32 status);
+
+
+/*******************************************************************************
+* Function Name: SimBleMain()
+********************************************************************************
+*
+* Summary:
+*   Entry of the BLE MCU for SimRun(): powers the device on with the
+*   central set up in simCentral and runs the firmware main().
+*
+*******************************************************************************/
+void SimBleMain(void)
+{
+    simBleCpu.name = "BLE";
+    bonded = simCentral.bonded;
+    (void)BleMain();
+}
+
+
+/*******************************************************************************
+* Stack
+*******************************************************************************/
+CYBLE_API_RESULT_T CyBle_Start(CYBLE_CALLBACK_T callbackFunc)
+{
+    appCallback = callbackFunc;
+    bleState = CYBLE_STATE_DISCONNECTED;
+    simBle.stackStarts++;
+    QueueEvent(CYBLE_EVT_STACK_ON, NULL, 0u);
+    if(hardwareErrorPersistent != 0u)
+    {
+        QueueEvent(CYBLE_EVT_HARDWARE_ERROR, NULL, 0u);
+    }
+    return (CYBLE_ERROR_OK);
+}
+
+void CyBle_Stop(void)
+{
+    bleState = CYBLE_STATE_STOPPED;
+    eventHead = eventTail;
+    txCount = 0u;
+    rxCount = 0u;
+    writeCount = 0u;
+    writePackets = 0u;
+    busyStatus = CYBLE_STACK_STATE_FREE;
+    paramState = SIM_PARAM_IDLE;
+    SimTimerStop(&advTimer);
+    SimTimerStop(&connectTimer);
+    SimTimerStop(&pairTimer);
+    SimTimerStop(&anchorTimer);
+    SimTimerStop(&eventEndTimer);
+}
+
+
+/*******************************************************************************
+* Function Name: CyBle_ProcessEvents()
+********************************************************************************
+*
+* Summary:
+*   Takes the time of one main loop pass, then delivers the queued stack
+*   events to the application and service callbacks. After SimBleHang() the
+*   main loop never gets past it, only the interrupts run.
+*
+*******************************************************************************/
+void CyBle_ProcessEvents(void)
+{
+    SIM_EVENT_T event;
+
+    SimBusy(&simBleCpu, SIM_LOOP_TIME);
+    while(hang != 0u)
+    {
+        SimBusy(&simBleCpu, SIM_LOOP_TIME);
+    }
+    while(eventTail != eventHead)
+    {
+        event = eventQueue[eventTail];
+        eventTail = (uint8)((eventTail + 1u) % SIM_EVENT_QUEUE_SIZE);
+        if((event.event >= CYBLE_EVT_SCPSS_NOTIFICATION_ENABLED) && (scpsCallback != NULL))
+        {
+            scpsCallback(event.event, &event.param);
+        }
+        else if((event.event >= CYBLE_EVT_HIDSS_NOTIFICATION_ENABLED) &&
+                (event.event < CYBLE_EVT_SCPSS_NOTIFICATION_ENABLED) && (hidsCallback != NULL))
+        {
+            hidsCallback(event.event, &event.param);
+        }
+        else if((event.event >= CYBLE_EVT_BASS_NOTIFICATION_ENABLED) &&
+                (event.event < CYBLE_EVT_HIDSS_NOTIFICATION_ENABLED) && (basCallback != NULL))
+        {
+            basCallback(event.event, &event.param);
+        }
+        else if((event.event < CYBLE_EVT_BASS_NOTIFICATION_ENABLED) && (appCallback != NULL))
+        {
+            appCallback(event.event, &event.param);
+        }
+        else
+        {
+            /* No callback registered */
+        }
+        if(event.event == CYBLE_EVT_GATTS_WRITE_CMD_REQ)
+        {
+            /* The callback has taken the value, the RX buffer is free again */
+            rxHead = (uint8)((rxHead + 1u) % SIM_RX_BUFFERS);
+            rxCount--;
+        }
+    }
+}
+
+CYBLE_STATE_T CyBle_GetState(void)
+{
+    return (bleState);
+}
+
+/* The link layer stays active for the rest of an attended connection event */
+CYBLE_LP_MODE_T CyBle_EnterLPM(CYBLE_LP_MODE_T pwrMode)
+{
+    CYBLE_LP_MODE_T mode = pwrMode;
+
+    if((bleState == CYBLE_STATE_STOPPED) || (bleState == CYBLE_STATE_INITIALIZING) ||
+       ((bleState == CYBLE_STATE_CONNECTED) && (simNow >= eventStart) && (simNow < eventEnd)))
+    {
+        mode = CYBLE_BLESS_ACTIVE;
+    }
+    return (mode);
+}
+
+CYBLE_BLESS_STATE_T CyBle_GetBleSsState(void)
+{
+    return (((bleState == CYBLE_STATE_CONNECTED) && (simNow >= eventStart) && (simNow < eventEnd)) ?
+            CYBLE_BLESS_STATE_ECO_STABLE : CYBLE_BLESS_STATE_DEEPSLEEP);
+}
+
+CYBLE_STACK_STATE_T CyBle_GattGetBusyStatus(void)
+{
+    return (busyStatus);
+}
+
+
+/*******************************************************************************
+* GAP
+*******************************************************************************/
+CYBLE_API_RESULT_T CyBle_GappStartAdvertisement(uint8 advertisingIntervalType)
+{
+    uint32 timeout = SIM_FAST_ADV_TIME;
+
+    (void)advertisingIntervalType;
+    if(bleState != CYBLE_STATE_DISCONNECTED)
+    {
+        return (CYBLE_ERROR_INVALID_STATE);
+    }
+    bleState = CYBLE_STATE_ADVERTISING;
+    slowAdvertising = 0u;
+    simBle.advertisingAt = simNow;
+    if(simAdvParam.advType == CYBLE_GAPP_CONNECTABLE_HIGH_DC_DIRECTED_ADV)
+    {
+        timeout = SIM_DIRECTED_ADV_TIME;
+    }
+    SimTimerStart(&advTimer, simNow + timeout, AdvertisingTimeout);
+    if(simCentral.connectDelay != 0u)
+    {
+        SimTimerStart(&connectTimer, simNow + simCentral.connectDelay, Connect);
+    }
+    QueueEvent(CYBLE_EVT_GAPP_ADVERTISEMENT_START_STOP, NULL, 0u);
+    return (CYBLE_ERROR_OK);
+}
+
+void CyBle_GappStopAdvertisement(void)
+{
+    if(bleState == CYBLE_STATE_ADVERTISING)
+    {
+        bleState = CYBLE_STATE_DISCONNECTED;
+        SimTimerStop(&advTimer);
+        SimTimerStop(&connectTimer);
+        QueueEvent(CYBLE_EVT_GAPP_ADVERTISEMENT_START_STOP, NULL, 0u);
+    }
+}
+
+CYBLE_API_RESULT_T CyBle_GetDeviceAddress(CYBLE_GAP_BD_ADDR_T *bdAddr)
+{
+    static const uint8 address[CYBLE_GAP_BD_ADDR_SIZE] = {0x01u, 0x00u, 0x00u, 0x50u, 0xA0u, 0x00u};
+
+    (void)memcpy(bdAddr->bdAddr, address, sizeof(address));
+    return (CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_GapDisconnect(uint8 bdHandle)
+{
+    (void)bdHandle;
+    if(bleState != CYBLE_STATE_CONNECTED)
+    {
+        return (CYBLE_ERROR_INVALID_STATE);
+    }
+    disconnectPending = 1u;
+    return (CYBLE_ERROR_OK);
+}
+
+/* The central is the only bonded device once it has paired */
+CYBLE_API_RESULT_T CyBle_GapGetBondedDevicesList(CYBLE_GAP_BONDED_DEV_ADDR_LIST_T *bondedDevList)
+{
+    (void)memset(bondedDevList, 0, sizeof(*bondedDevList));
+    if(bonded != 0u)
+    {
+        bondedDevList->count = 1u;
+        (void)CyBle_GapGetPeerBdAddr(cyBle_connHandle.bdHandle, &bondedDevList->bdAddrList[0u]);
+    }
+    return (CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_GapGetPeerBdAddr(uint8 bdHandle, CYBLE_GAP_BD_ADDR_T *peerBdAddr)
+{
+    static const uint8 address[CYBLE_GAP_BD_ADDR_SIZE] = {0x02u, 0x00u, 0x00u, 0x50u, 0xA0u, 0x00u};
+
+    (void)bdHandle;
+    (void)memcpy(peerBdAddr->bdAddr, address, sizeof(address));
+    peerBdAddr->type = 0u;
+    return (CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_StoreBondingData(uint8 isForceWrite)
+{
+    (void)isForceWrite;
+    SimBusy(&simBleCpu, SIM_FLASH_ROW_TIME);
+    cyBle_pendingFlashWrite = 0u;
+    return (CYBLE_ERROR_OK);
+}
+
+/* The request goes out in the next connection event */
+CYBLE_API_RESULT_T CyBle_L2capLeConnectionParamUpdateRequest(uint8 bdHandle,
+                                                             CYBLE_GAP_CONN_UPDATE_PARAM_T *connParam)
+{
+    (void)bdHandle;
+    if(bleState != CYBLE_STATE_CONNECTED)
+    {
+        return (CYBLE_ERROR_INVALID_STATE);
+    }
+    if(paramState != SIM_PARAM_IDLE)
+    {
+        return (CYBLE_ERROR_INVALID_OPERATION);
+    }
+    paramRequest = *connParam;
+    paramState = SIM_PARAM_REQUESTED;
+    simBle.paramRequests++;
+    return (CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_GetTxPowerLevel(CYBLE_BLESS_PWR_IN_DB_T *bleSsPwrLvl)
+{
+    bleSsPwrLvl->blePwrLevelInDbm = txPower;
+    return (CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_SetTxPowerLevel(const CYBLE_BLESS_PWR_IN_DB_T *bleSsPwrLvl)
+{
+    txPower = bleSsPwrLvl->blePwrLevelInDbm;
+    return (CYBLE_ERROR_OK);
+}
+
+int8 CyBle_GetRssi(void)
+{
+    return (simCentral.rssi);
+}
+
+uint16 CyBle_Get16ByPtr(const uint8 ptr[])
+{
+    return ((uint16)(ptr[0u] | ((uint16)ptr[1u] << 8u)));
+}
+
+
+/*******************************************************************************
+* GATT and services
+*******************************************************************************/
+CYBLE_API_RESULT_T CyBle_GattGetMtuSize(uint16 *mtu)
+{
+    *mtu = attMtu;
+    return (CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_GattsWriteRsp(CYBLE_CONN_HANDLE_T connHandle)
+{
+    (void)connHandle;
+    return (CYBLE_ERROR_OK);
+}
+
+void CyBle_HidsRegisterAttrCallback(CYBLE_CALLBACK_T callbackFunc)
+{
+    hidsCallback = callbackFunc;
+}
+
+void CyBle_BasRegisterAttrCallback(CYBLE_CALLBACK_T callbackFunc)
+{
+    basCallback = callbackFunc;
+}
+
+void CyBle_ScpsRegisterAttrCallback(CYBLE_CALLBACK_T callbackFunc)
+{
+    scpsCallback = callbackFunc;
+}
+
+
+/*******************************************************************************
+* Function Name: CyBle_HidssSendNotification()
+********************************************************************************
+*
+* Summary:
+*   Takes a TX buffer for the report. The stack turns busy when the last
+*   buffer is taken and free again once a connection event sent some.
+*
+*******************************************************************************/
+CYBLE_API_RESULT_T CyBle_HidssSendNotification(CYBLE_CONN_HANDLE_T connHandle, uint8 serviceIndex,
+                                               CYBLE_HIDS_CHAR_INDEX_T charIndex, uint8 attrSize, uint8 *attrValue)
+{
+    SIM_TX_T *tx;
+    uint16 cccd = (charIndex == CYBLE_HIDS_BOOT_KYBRD_IN_REP) ? hidsBootCccd : hidsReportCccd;
+
+    (void)connHandle;
+    (void)serviceIndex;
+    if(bleState != CYBLE_STATE_CONNECTED)
+    {
+        return (CYBLE_ERROR_INVALID_STATE);
+    }
+    if(cccd == 0u)
+    {
+        return (CYBLE_ERROR_NTF_DISABLED);
+    }
+    if((txCount >= SIM_TX_BUFFERS) || (attrSize > SIM_BLE_REPORT_SIZE))
+    {
+        return (CYBLE_ERROR_MEMORY_ALLOCATION_FAILED);
+    }
+
+    tx = &txQueue[(txHead + txCount) % SIM_TX_BUFFERS];
+    tx->attrHandle = 0u;
+    tx->size = SIM_BLE_REPORT_SIZE;
+    (void)memset(tx->data, 0, sizeof(tx->data));
+    (void)memcpy(tx->data, attrValue, attrSize);
+    txCount++;
+    if(txCount == SIM_TX_BUFFERS)
+    {
+        busyStatus = CYBLE_STACK_STATE_BUSY;
+        QueueEvent(CYBLE_EVT_STACK_BUSY_STATUS, &busyStatus, sizeof(uint8));
+    }
+    return (CYBLE_ERROR_OK);
+}
+
+/* Notification of a characteristic outside the services, e.g. a vendor service */
+CYBLE_API_RESULT_T CyBle_GattsNotification(CYBLE_CONN_HANDLE_T connHandle, CYBLE_GATTS_HANDLE_VALUE_NTF_T *ntfParam)
+{
+    SIM_TX_T *tx;
+
+    (void)connHandle;
+    if(bleState != CYBLE_STATE_CONNECTED)
+    {
+        return (CYBLE_ERROR_INVALID_STATE);
+    }
+    if((ntfParam->attrHandle == 0u) || (ntfParam->value.len > SIM_NTF_SIZE))
+    {
+        return (CYBLE_ERROR_INVALID_PARAMETER);
+    }
+    if(txCount >= SIM_TX_BUFFERS)
+    {
+        return (CYBLE_ERROR_MEMORY_ALLOCATION_FAILED);
+    }
+
+    tx = &txQueue[(txHead + txCount) % SIM_TX_BUFFERS];
+    tx->attrHandle = ntfParam->attrHandle;
+    tx->size = (uint8)ntfParam->value.len;
+    (void)memcpy(tx->data, ntfParam->value.val, ntfParam->value.len);
+    txCount++;
+    if(txCount == SIM_TX_BUFFERS)
+    {
+        busyStatus = CYBLE_STACK_STATE_BUSY;
+        QueueEvent(CYBLE_EVT_STACK_BUSY_STATUS, &busyStatus, sizeof(uint8));
+    }
+    return (CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_HidssGetCharacteristicValue(uint8 serviceIndex, CYBLE_HIDS_CHAR_INDEX_T charIndex,
+                                                     uint8 attrSize, uint8 *attrValue)
+{
+    (void)serviceIndex;
+    if((charIndex != CYBLE_HIDS_PROTOCOL_MODE) || (attrSize < 1u))
+    {
+        return (CYBLE_ERROR_INVALID_PARAMETER);
+    }
+    attrValue[0u] = hidsProtocolMode;
+    return (CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_HidssGetCharacteristicDescriptor(uint8 serviceIndex, CYBLE_HIDS_CHAR_INDEX_T charIndex,
+                                                          CYBLE_HIDS_DESCR_T descrIndex, uint8 attrSize,
+                                                          uint8 *attrValue)
+{
+    uint16 cccd = (charIndex == CYBLE_HIDS_BOOT_KYBRD_IN_REP) ? hidsBootCccd : hidsReportCccd;
+
+    (void)serviceIndex;
+    if((descrIndex != CYBLE_HIDS_REPORT_CCCD) || (attrSize < CYBLE_CCCD_LEN))
+    {
+        return (CYBLE_ERROR_INVALID_PARAMETER);
+    }
+    attrValue[0u] = (uint8)cccd;
+    attrValue[1u] = (uint8)(cccd >> 8u);
+    return (CYBLE_ERROR_OK);
+}
+
+/* Battery notifications are never enabled by the central */
+CYBLE_API_RESULT_T CyBle_BassSendNotification(CYBLE_CONN_HANDLE_T connHandle, uint8 serviceIndex,
+                                              CYBLE_BAS_CHAR_INDEX_T charIndex, uint8 attrSize, uint8 *attrValue)
+{
+    (void)connHandle;
+    (void)serviceIndex;
+    (void)charIndex;
+    (void)attrSize;
+    (void)attrValue;
+    return (CYBLE_ERROR_NTF_DISABLED);
+}
+
+CYBLE_API_RESULT_T CyBle_BassSetCharacteristicValue(uint8 serviceIndex, CYBLE_BAS_CHAR_INDEX_T charIndex,
+                                                    uint8 attrSize, uint8 *attrValue)
+{
+    (void)serviceIndex;
+    (void)charIndex;
+    (void)attrSize;
+    (void)attrValue;
+    return (CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_BassGetCharacteristicDescriptor(uint8 serviceIndex, CYBLE_BAS_CHAR_INDEX_T charIndex,
+                                                         CYBLE_BAS_DESCR_INDEX_T descrIndex, uint8 attrSize,
+                                                         uint8 *attrValue)
+{
+    (void)serviceIndex;
+    (void)charIndex;
+    (void)descrIndex;
+    (void)memset(attrValue, 0, attrSize);
+    return (CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_ScpssGetCharacteristicDescriptor(CYBLE_SCPS_CHAR_INDEX_T charIndex,
+                                                          CYBLE_SCPS_DESCR_INDEX_T descrIndex, uint8 attrSize,
+                                                          uint8 *attrValue)
+{
+    (void)charIndex;
+    (void)descrIndex;
+    (void)memset(attrValue, 0, attrSize);
+    return (CYBLE_ERROR_OK);
+}
+
+
+/*******************************************************************************
+* Function Name: QueueEvent()
+********************************************************************************
+*
+* Summary:
+*   Queues a stack event for CyBle_ProcessEvents() and wakes the CPU, like
+*   the BLESS interrupt does.
+*
+* Parameters:
+*  event - CYBLE_EVT_xxx
+*  param - event parameter, copied; NULL for none
+*  size - parameter size
+*
+*******************************************************************************/
+static void QueueEvent(uint32 event, const void *param, size_t size)
+{
+    uint8 next = (uint8)((eventHead + 1u) % SIM_EVENT_QUEUE_SIZE);
+
+    if(next != eventTail)
+    {
+        eventQueue[eventHead].event = event;
+        (void)memset(&eventQueue[eventHead].param, 0, sizeof(eventQueue[eventHead].param));
+        if(param != NULL)
+        {
+            (void)memcpy(&eventQueue[eventHead].param, param, size);
+        }
+        eventHead = next;
+    }
+    SimWake(&simBleCpu);
+}
+
+
+/*******************************************************************************
+* Function Name: AdvertisingTimeout()
+********************************************************************************
+*
+* Summary:
+*   Fast advertising goes over to slow advertising, which ends in the
+*   disconnected state. Directed advertising ends at once.
+*
+*******************************************************************************/
+static void AdvertisingTimeout(void)
+{
+    if((slowAdvertising == 0u) && (simAdvParam.advType != CYBLE_GAPP_CONNECTABLE_HIGH_DC_DIRECTED_ADV))
+    {
+        slowAdvertising = 1u;
+        SimTimerStart(&advTimer, simNow + SIM_SLOW_ADV_TIME, AdvertisingTimeout);
+    }
+    else
+    {
+        bleState = CYBLE_STATE_DISCONNECTED;
+        SimTimerStop(&connectTimer);
+    }
+    QueueEvent(CYBLE_EVT_GAPP_ADVERTISEMENT_START_STOP, NULL, 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: Connect()
+********************************************************************************
+*
+* Summary:
+*   The central connects. A bonded central has its CCCDs restored by the
+*   stack; a new one pairs and writes the CCCD after cccdDelay.
+*
+*******************************************************************************/
+static void Connect(void)
+{
+    CYBLE_GAP_AUTH_INFO_T auth = {0x01u, CYBLE_BONDING_YES, 0x10u, 0u};
+
+    SimTimerStop(&advTimer);
+    bleState = CYBLE_STATE_CONNECTED;
+    connInterval = simCentral.interval;
+    connLatency = simCentral.latency;
+    anchorCount = 0u;
+    anchorsSkipped = 0u;
+    disconnectPending = 0u;
+    paramState = SIM_PARAM_IDLE;
+    hidsReportCccd = (bonded != 0u) ? 1u : 0u;
+    hidsBootCccd = 0u;
+    attMtu = SIM_ATT_DEFAULT_MTU;
+    simBle.attRequests = 0u;
+    SimTimerStart(&anchorTimer, simNow + ((uint64)connInterval * 1250u), Anchor);
+
+    QueueEvent(CYBLE_EVT_GATT_CONNECT_IND, NULL, 0u);
+    QueueEvent(CYBLE_EVT_GAP_DEVICE_CONNECTED, NULL, 0u);
+    if(simCentral.mtu > SIM_ATT_DEFAULT_MTU)
+    {
+        /* The server answers with its own MTU, the smaller one applies */
+        attMtu = (simCentral.mtu < SIM_BLE_MAX_MTU) ? simCentral.mtu : SIM_BLE_MAX_MTU;
+        QueueEvent(CYBLE_EVT_GATTS_XCNHG_MTU_REQ, &simCentral.mtu, sizeof(simCentral.mtu));
+        simBle.attRequests++;
+    }
+    simBle.mtu = attMtu;
+    simBle.connectedAt = simNow;
+    if(bonded == 0u)
+    {
+        QueueEvent(CYBLE_EVT_GAP_AUTH_REQ, &auth, sizeof(auth));
+        SimTimerStart(&pairTimer, simNow + simCentral.cccdDelay, PairingComplete);
+    }
+}
+
+static void PairingComplete(void)
+{
+    CYBLE_GAP_AUTH_INFO_T auth = {0x01u, CYBLE_BONDING_YES, 0x10u, 0u};
+    CYBLE_HIDS_CHAR_VALUE_T hids;
+
+    if(bleState != CYBLE_STATE_CONNECTED)
+    {
+        return;
+    }
+    bonded = 1u;
+    QueueEvent(CYBLE_EVT_GAP_AUTH_COMPLETE, &auth, sizeof(auth));
+    cyBle_pendingFlashWrite = 1u;
+    QueueEvent(CYBLE_EVT_PENDING_FLASH_WRITE, NULL, 0u);
+
+    hidsReportCccd = 1u;
+    (void)memset(&hids, 0, sizeof(hids));
+    hids.serviceIndex = CYBLE_HUMAN_INTERFACE_DEVICE_SERVICE_INDEX;
+    hids.charIndex = CYBLE_HUMAN_INTERFACE_DEVICE_REPORT_IN;
+    QueueEvent(CYBLE_EVT_HIDSS_NOTIFICATION_ENABLED, &hids, sizeof(hids));
+    simBle.attRequests++;
+}
+
+
+/*******************************************************************************
+* Function Name: Anchor()
+********************************************************************************
+*
+* Summary:
+*   Connection event anchor point. The peripheral skips up to connLatency
+*   events while it has nothing to send. An attended event carries up to
+*   packetsPerEvent LL packets each way: write commands of the central and
+*   notifications. It also carries the connection parameter update
+*   procedure and a pending disconnect, and wakes the CPU.
+*
+*******************************************************************************/
+static void Anchor(void)
+{
+    CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T updated;
+    uint16 result;
+    uint8 sent = 0u;
+    uint8 received;
+    uint8 instant;
+
+    anchorCount++;
+    instant = ((paramState == SIM_PARAM_UPDATING) && (anchorCount == paramInstant)) ? 1u : 0u;
+    if((txCount == 0u) && (anchorsSkipped < connLatency) && (paramState != SIM_PARAM_REQUESTED) &&
+       (instant == 0u) && (disconnectPending == 0u))
+    {
+        anchorsSkipped++;
+        SimTimerStart(&anchorTimer, simNow + ((uint64)connInterval * 1250u), Anchor);
+        return;
+    }
+    anchorsSkipped = 0u;
+    simBle.events++;
+
+    if(disconnectPending != 0u)
+    {
+        Disconnect();
+        return;
+    }
+
+    /* Writes first, the central answers a notification in a later event */
+    received = SendWrites();
+    while((txCount != 0u) && (sent < simCentral.packetsPerEvent))
+    {
+        sent++;
+        if(txQueue[txHead].attrHandle != 0u)
+        {
+            if(simCentral.notification != NULL)
+            {
+                simCentral.notification(txQueue[txHead].attrHandle, txQueue[txHead].data, txQueue[txHead].size);
+            }
+        }
+        else if(simBle.reports < SIM_BLE_REPORT_LOG)
+        {
+            simBle.log[simBle.reports].at = simNow + ((uint64)sent * SIM_PACKET_TIME);
+            (void)memcpy(simBle.log[simBle.reports].report, txQueue[txHead].data, SIM_BLE_REPORT_SIZE);
+            simBle.log[simBle.reports].interval = connInterval;
+            simBle.reports++;
+        }
+        else
+        {
+            /* Log full */
+        }
+        txHead = (uint8)((txHead + 1u) % SIM_TX_BUFFERS);
+        txCount--;
+    }
+    if(received > sent)
+    {
+        sent = received;
+    }
+    if((busyStatus == CYBLE_STACK_STATE_BUSY) && (txCount < SIM_TX_BUFFERS))
+    {
+        busyStatus = CYBLE_STACK_STATE_FREE;
+        QueueEvent(CYBLE_EVT_STACK_BUSY_STATUS, &busyStatus, sizeof(uint8));
+    }
+
+    if(paramState == SIM_PARAM_REQUESTED)
+    {
+        /* The central answers the request in the same event */
+        result = (paramRequest.connIntvMax >= simCentral.minInterval) ? 0u : 1u;
+        paramState = (result == 0u) ? SIM_PARAM_UPDATING : SIM_PARAM_IDLE;
+        paramInstant = anchorCount + SIM_CONN_UPDATE_INSTANT;
+        QueueEvent(CYBLE_EVT_L2CAP_CONN_PARAM_UPDATE_RSP, &result, sizeof(result));
+    }
+    else if(instant != 0u)
+    {
+        connInterval = paramRequest.connIntvMax;
+        connLatency = paramRequest.connLatency;
+        paramState = SIM_PARAM_IDLE;
+        simBle.paramUpdates++;
+        updated.status = 0u;
+        updated.connIntv = connInterval;
+        updated.connLatency = connLatency;
+        updated.supervisionTO = paramRequest.supervisionTO;
+        QueueEvent(CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE, &updated, sizeof(updated));
+    }
+    else
+    {
+        /* No link layer control procedure in this event */
+    }
+
+    eventStart = simNow;
+    eventEnd = simNow + SIM_EVENT_TIME + ((uint64)sent * SIM_PACKET_TIME);
+    simBle.radioTime += (uint32)(eventEnd - eventStart);
+    simBle.interval = connInterval;
+    SimTimerStart(&eventEndTimer, eventEnd, EventEnd);
+    SimTimerStart(&anchorTimer, simNow + ((uint64)connInterval * 1250u), Anchor);
+    SimWake(&simBleCpu);
+}
+
+/* Event close interrupt */
+static void EventEnd(void)
+{
+    SimWake(&simBleCpu);
+}
+
+static void Disconnect(void)
+{
+    uint8 reason = SIM_DISCONNECT_REASON;
+
+    bleState = CYBLE_STATE_DISCONNECTED;
+    disconnectPending = 0u;
+    txCount = 0u;
+    writeCount = 0u;
+    writePackets = 0u;
+    busyStatus = CYBLE_STACK_STATE_FREE;
+    paramState = SIM_PARAM_IDLE;
+    SimTimerStop(&anchorTimer);
+    SimTimerStop(&pairTimer);
+    QueueEvent(CYBLE_EVT_GAP_DEVICE_DISCONNECTED, &reason, sizeof(reason));
+    QueueEvent(CYBLE_EVT_GATT_DISCONNECT_IND, NULL, 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: SendWrites()
+********************************************************************************
+*
+* Summary:
+*   Sends the queued write commands of the central in LL packets, up to
+*   packetsPerEvent in this event. A write may span events. The central only
+*   starts a write while the stack has an RX buffer for it, and the stack
+*   raises CYBLE_EVT_GATTS_WRITE_CMD_REQ with its last packet.
+*
+* Return:
+*  LL packets sent.
+*
+*******************************************************************************/
+static uint8 SendWrites(void)
+{
+    CYBLE_GATTS_WRITE_CMD_REQ_PARAM_T param;
+    SIM_WRITE_T *write;
+    SIM_WRITE_T *rx;
+    uint8 packets = 0u;
+
+    while((writeCount != 0u) && (packets < simCentral.packetsPerEvent))
+    {
+        write = &writeQueue[writeHead];
+        if((writePackets == 0u) && (rxCount >= SIM_RX_BUFFERS))
+        {
+            break;
+        }
+        packets++;
+        if(++writePackets < WritePackets(write->size))
+        {
+            continue;
+        }
+
+        rx = &rxQueue[(rxHead + rxCount) % SIM_RX_BUFFERS];
+        *rx = *write;
+        rxCount++;
+        param.connHandle = cyBle_connHandle;
+        param.handleValPair.attrHandle = rx->attrHandle;
+        param.handleValPair.value.val = rx->data;
+        param.handleValPair.value.len = rx->size;
+        param.handleValPair.value.actualLen = rx->size;
+        QueueEvent(CYBLE_EVT_GATTS_WRITE_CMD_REQ, &param, sizeof(param));
+        simBle.writes++;
+        writePackets = 0u;
+        writeHead = (uint8)((writeHead + 1u) % SIM_CENTRAL_WRITES);
+        writeCount--;
+    }
+    return (packets);
+}
+
+/* LL packets of a write command with its ATT and L2CAP headers */
+static uint8 WritePackets(uint16 size)
+{
+    return ((uint8)((size + SIM_ATT_WRITE_HEADER + SIM_L2CAP_HEADER + SIM_LL_PAYLOAD - 1u) / SIM_LL_PAYLOAD));
+}
+
+
+/*******************************************************************************
+* Function Name: SimCentralWrite()
+********************************************************************************
+*
+* Summary:
+*   Queues a write command of the central, sent from the next connection
+*   event on.
+*
+* Parameters:
+*  attrHandle - handle of the characteristic value
+*  data - the value
+*  size - its size, up to the agreed MTU less 3
+*
+* Return:
+*  Non-zero when queued; 0 without a connection, with a full queue or a
+*  value too long.
+*
+*******************************************************************************/
+uint8_t SimCentralWrite(uint16_t attrHandle, const uint8_t *data, uint16_t size)
+{
+    SIM_WRITE_T *write;
+
+    if((bleState != CYBLE_STATE_CONNECTED) || (writeCount >= SIM_CENTRAL_WRITES) ||
+       (size > (attMtu - SIM_ATT_WRITE_HEADER)))
+    {
+        return (0u);
+    }
+    write = &writeQueue[(writeHead + writeCount) % SIM_CENTRAL_WRITES];
+    write->attrHandle = attrHandle;
+    write->size = size;
+    (void)memcpy(write->data, data, size);
+    writeCount++;
+    return (1u);
+}
+
+
+/*******************************************************************************
+* I2C master
+*******************************************************************************/
+void I2CHW_Start(void)
+{
+    i2cStarted = 1u;
+}
+
+void I2CHW_Stop(void)
+{
+    i2cStarted = 0u;
+    i2cStatus = 0u;
+    SimTimerStop(&i2cTimer);
+}
+
+uint32 I2CHW_I2CMasterStatus(void)
+{
+    return (i2cStatus);
+}
+
+uint32 I2CHW_I2CMasterClearStatus(void)
+{
+    uint32 status = i2cStatus;
+
+    i2cStatus &= I2CHW_I2C_MSTAT_XFER_INP;
+    return (status);
+}
+
+uint32 I2CHW_I2CMasterReadBuf(uint32 slaveAddress, uint8 *rdData, uint32 cnt, uint32 mode)
+{
+    (void)mode;
+    if((i2cStarted == 0u) || ((i2cStatus & I2CHW_I2C_MSTAT_XFER_INP) != 0u))
+    {
+        return (I2CHW_I2C_MSTAT_ERR_XFER);
+    }
+    i2cStatus = I2CHW_I2C_MSTAT_XFER_INP;
+    i2cData = rdData;
+    i2cCount = cnt;
+    i2cIndex = 0u;
+    i2cRead = (slaveAddress == SIM_EZI2C_ADDRESS) ? 1u : 2u;
+    SimTimerStart(&i2cTimer, simNow + SIM_I2C_BYTE_TIME, I2cAddress);
+    return (0u);
+}
+
+uint32 I2CHW_I2CMasterWriteBuf(uint32 slaveAddress, uint8 *wrData, uint32 cnt, uint32 mode)
+{
+    (void)mode;
+    if((i2cStarted == 0u) || ((i2cStatus & I2CHW_I2C_MSTAT_XFER_INP) != 0u))
+    {
+        return (I2CHW_I2C_MSTAT_ERR_XFER);
+    }
+    i2cStatus = I2CHW_I2C_MSTAT_XFER_INP;
+    i2cData = wrData;
+    i2cCount = cnt;
+    i2cIndex = 0u;
+    i2cRead = (slaveAddress == SIM_EZI2C_ADDRESS) ? 0u : 2u;
+    SimTimerStart(&i2cTimer, simNow + SIM_I2C_BYTE_TIME, I2cAddress);
+    return (0u);
+}
+
+/* The pins as GPIOs while the SCB is stopped */
+uint8 I2CHW_sda_Read(void)
+{
+    return ((sdaHeld == 0u) ? 1u : 0u);
+}
+
+void I2CHW_sda_Write(uint8 value)
+{
+    (void)value;
+}
+
+/* A slave holding SDA counts the rising edges of SCL */
+void I2CHW_scl_Write(uint8 value)
+{
+    if((value != 0u) && (sclLevel == 0u) && (sdaHeld != 0u))
+    {
+        simBle.sdaClocks++;
+        if(--sdaHeld == 0u)
+        {
+            simBle.sdaReleasedAt = simNow;
+        }
+    }
+    sclLevel = value;
+}
+
+/* Address byte; i2cRead is 2 for any other slave address, which is not acknowledged.
+*  With SDA held low the master never gets the bus, the transfer does not complete. */
+static void I2cAddress(void)
+{
+    if(sdaHeld != 0u)
+    {
+        return;
+    }
+    if((i2cRead > 1u) || (SimEzi2cStart(i2cRead) == 0u))
+    {
+        I2cFinish(I2CHW_I2C_MSTAT_ERR_XFER);
+    }
+    else
+    {
+        SimTimerStart(&i2cTimer, simNow + SIM_I2C_BYTE_TIME, I2cByte);
+    }
+}
+
+static void I2cByte(void)
+{
+    if(i2cRead != 0u)
+    {
+        i2cData[i2cIndex] = SimEzi2cRead();
+    }
+    else
+    {
+        SimEzi2cWrite(i2cData[i2cIndex]);
+    }
+    if(++i2cIndex < i2cCount)
+    {
+        SimTimerStart(&i2cTimer, simNow + SIM_I2C_BYTE_TIME, I2cByte);
+    }
+    else
+    {
+        I2cFinish((i2cRead != 0u) ? I2CHW_I2C_MSTAT_RD_CMPLT : I2CHW_I2C_MSTAT_WR_CMPLT);
+    }
+}
+
+/* Completion interrupt of the SCB */
+static void I2cFinish(uint32 status)
+{
+    i2cStatus = status | ((i2cRead != 0u) ? I2CHW_I2C_MSTAT_RD_CMPLT : I2CHW_I2C_MSTAT_WR_CMPLT);
+    if((status & I2CHW_I2C_MSTAT_ERR_XFER) == 0u)
+    {
+        simBle.i2cDoneAt = simNow;
+    }
+    I2CHW_I2C_ISR_ExitCallback();
+    SimWake(&simBleCpu);
+}
+
+
+/*******************************************************************************
+* Faults
+*******************************************************************************/
+/*******************************************************************************
+* Function Name: SimI2cHoldSda()
+********************************************************************************
+*
+* Summary:
+*   A slave that lost track of a transfer holds SDA low until it has seen
+*   clocks SCL pulses. Transfers started meanwhile never complete.
+*
+*******************************************************************************/
+void SimI2cHoldSda(uint8_t clocks)
+{
+    sdaHeld = clocks;
+    simBle.sdaClocks = 0u;
+    simBle.sdaReleasedAt = 0u;
+}
+
+/*******************************************************************************
+* Function Name: SimBleHardwareError()
+********************************************************************************
+*
+* Summary:
+*   Raises CYBLE_EVT_HARDWARE_ERROR. A persistent error is raised again on
+*   every following stack start.
+*
+*******************************************************************************/
+void SimBleHardwareError(uint8_t persistent)
+{
+    hardwareErrorPersistent = persistent;
+    QueueEvent(CYBLE_EVT_HARDWARE_ERROR, NULL, 0u);
+}
+
+/* The main loop stops in its next CyBle_ProcessEvents() call */
+void SimBleHang(void)
+{
+    hang = 1u;
+    SimWake(&simBleCpu);
+}
+
+/* The central drops the link at its next connection event */
+void SimCentralDisconnect(void)
+{
+    if(bleState == CYBLE_STATE_CONNECTED)
+    {
+        disconnectPending = 1u;
+    }
+}
+
+
+/*******************************************************************************
+* Debug UART and pins
+*******************************************************************************/
+void UART_DEB_Start(void)
+{
+}
+
+void UART_DEB_Stop(void)
+{
+}
+
+void UART_DEB_UartPutChar(uint32 txDataByte)
+{
+    (void)txDataByte;
+}
+
+uint32 UART_DEB_SpiUartGetTxBufferSize(void)
+{
+    return (0u);
+}
+
+void Advertising_LED_Write(uint8 value)
+{
+    (void)value;
+}
+
+void Disconnect_LED_Write(uint8 value)
+{
+    (void)value;
+}
+
+void CapsLock_LED_Write(uint8 value)
+{
+    (void)value;
+}
+
+void LowPower_LED_Write(uint8 value)
+{
+    (void)value;
+}
+
+
+/*******************************************************************************
+* System
+*******************************************************************************/
+uint8 CyEnterCriticalSection(void)
+{
+    return (0u);
+}
+
+/* An interrupt raised while they were disabled runs once they are enabled */
+void CyExitCriticalSection(uint8 savedIntrStatus)
+{
+    void (*interrupt)(void) = simBleInterrupt;
+
+    (void)savedIntrStatus;
+    if(interrupt != NULL)
+    {
+        simBleInterrupt = NULL;
+        interrupt();
+    }
+}
+
+void CyDelay(uint32 milliseconds)
+{
+    SimBusy(&simBleCpu, milliseconds * SIM_US_PER_MS);
+}
+
+void CyDelayUs(uint16 microseconds)
+{
+    SimBusy(&simBleCpu, microseconds);
+}
+
+void CySoftwareReset(void)
+{
+    SimEnd(SIM_END_RESET);
+}
+
+uint32 CySysGetResetReason(uint32 reason)
+{
+    (void)reason;
+    return (0u);
+}
+
+/* A queued stack event is a pending interrupt, the CPU does not sleep */
+void CySysPmSleep(void)
+{
+    if(eventHead == eventTail)
+    {
+        SimWait(&simBleCpu, 0u);
+    }
+}
+
+void CySysPmDeepSleep(void)
+{
+    if(eventHead == eventTail)
+    {
+        SimWait(&simBleCpu, 1u);
+    }
+}
+
+void CySysPmHibernate(void)
+{
+    SimEnd(SIM_END_HIBERNATE);
+}
+
+uint32 CySysFlashWriteRow(uint32 rowNum, const uint8 rowData[])
+{
+    SimBusy(&simBleCpu, SIM_FLASH_ROW_TIME);
+    (void)memcpy(&simFlash[rowNum * CY_FLASH_SIZEOF_ROW], rowData, CY_FLASH_SIZEOF_ROW);
+    return (CY_SYS_FLASH_SUCCESS);
+}
+
+
+/*******************************************************************************
+* WDT
+*******************************************************************************/
+void CySysWdtUnlock(void)
+{
+}
+
+void CySysWdtLock(void)
+{
+}
+
+void CySysWdtWriteMode(uint32 counterNum, uint32 mode)
+{
+    wdtMode[counterNum] = mode;
+    WdtArm();
+}
+
+void CySysWdtWriteClearOnMatch(uint32 counterNum, uint32 enable)
+{
+    wdtClearOnMatch[counterNum] = enable;
+}
+
+void CySysWdtWriteMatch(uint32 counterNum, uint32 match)
+{
+    wdtMatch[counterNum] = match;
+    WdtArm();
+}
+
+/* A disabled counter holds its count and goes on from there when enabled */
+void CySysWdtEnable(uint32 counterMask)
+{
+    uint32 counter;
+    uint64 held;
+
+    for(counter = 0u; counter < SIM_WDT_COUNTERS; counter++)
+    {
+        if(((counterMask & ~wdtEnabled) & SIM_WDT_MASK(counter)) != 0u)
+        {
+            held = SimLfclkTime(wdtHeld[counter]);
+            wdtResetAt[counter] = (simNow > held) ? (simNow - held) : 0u;
+            if(counter == CY_SYS_WDT_COUNTER1)
+            {
+                wdtMatches = 0u;
+            }
+        }
+    }
+    wdtEnabled |= counterMask;
+    WdtArm();
+}
+
+void CySysWdtDisable(uint32 counterMask)
+{
+    uint32 counter;
+
+    for(counter = 0u; counter < SIM_WDT_COUNTERS; counter++)
+    {
+        if(((counterMask & wdtEnabled) & SIM_WDT_MASK(counter)) != 0u)
+        {
+            wdtHeld[counter] = CySysWdtGetCount(counter);
+        }
+    }
+    wdtEnabled &= ~counterMask;
+    WdtArm();
+}
+
+/* The reset masks have the bit positions of the counter masks */
+void CySysWdtResetCounters(uint32 countersMask)
+{
+    uint32 counter;
+
+    for(counter = 0u; counter < SIM_WDT_COUNTERS; counter++)
+    {
+        if((countersMask & SIM_WDT_MASK(counter)) != 0u)
+        {
+            wdtResetAt[counter] = simNow;
+            wdtHeld[counter] = 0u;
+            if(counter == CY_SYS_WDT_COUNTER1)
+            {
+                wdtMatches = 0u;
+            }
+        }
+    }
+    WdtArm();
+}
+
+uint32 CySysWdtGetCount(uint32 counterNum)
+{
+    uint32 count = SimLfclkCounts(simNow - wdtResetAt[counterNum]);
+
+    if(counterNum == CY_SYS_WDT_COUNTER2)
+    {
+        return (count);
+    }
+    if(wdtClearOnMatch[counterNum] != 0u)
+    {
+        count %= (wdtMatch[counterNum] + 1u);
+    }
+    return (count & 0xFFFFu);
+}
+
+uint32 CySysWdtGetInterruptSource(void)
+{
+    return (0u);
+}
+
+void CySysWdtEnableCounterIsr(uint32 counterNum)
+{
+    (void)counterNum;
+}
+
+cyisraddress CySysWdtSetInterruptCallback(uint32 counterNum, cyisraddress function)
+{
+    cyisraddress previous = wdtCallback[counterNum];
+
+    wdtCallback[counterNum] = function;
+    return (previous);
+}
+
+
+/*******************************************************************************
+* Function Name: WdtArm()
+********************************************************************************
+*
+* Summary:
+*   Arms the timers of the counters that act: counter 0 resets the device on
+*   a match, counter 1 raises its interrupt on every match and clears.
+*   Counter 2 only counts.
+*
+*******************************************************************************/
+static void WdtArm(void)
+{
+    if(((wdtEnabled & CY_SYS_WDT_COUNTER0_MASK) != 0u) && (wdtMode[CY_SYS_WDT_COUNTER0] == CY_SYS_WDT_MODE_RESET))
+    {
+        SimTimerStart(&wdtResetTimer, wdtResetAt[CY_SYS_WDT_COUNTER0] +
+                      SimLfclkTime(wdtMatch[CY_SYS_WDT_COUNTER0]), WdtReset);
+    }
+    else
+    {
+        SimTimerStop(&wdtResetTimer);
+    }
+    if(((wdtEnabled & CY_SYS_WDT_COUNTER1_MASK) != 0u) && (wdtMode[CY_SYS_WDT_COUNTER1] == CY_SYS_WDT_MODE_INT))
+    {
+        SimTimerStart(&wdtIntTimer, wdtResetAt[CY_SYS_WDT_COUNTER1] +
+                      SimLfclkTime((uint64)(wdtMatches + 1u) * (wdtMatch[CY_SYS_WDT_COUNTER1] + 1u)), WdtInterrupt);
+    }
+    else
+    {
+        SimTimerStop(&wdtIntTimer);
+    }
+}
+
+static void WdtReset(void)
+{
+    SimEnd(SIM_END_WATCHDOG);
+}
+
+static void WdtInterrupt(void)
+{
+    wdtMatches++;
+    if(wdtCallback[CY_SYS_WDT_COUNTER1] != NULL)
+    {
+        wdtCallback[CY_SYS_WDT_COUNTER1]();
+    }
+    WdtArm();
+    SimWake(&simBleCpu);
+}
+
+
+/* [] END OF FILE */
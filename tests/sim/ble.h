@@ -0,0 +1,98 @@
+/*******************************************************************************
+* File Name: ble.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the interface of the simulated BLE MCU: the central the firmware
+*  connects to, and what the central and the radio saw during a run. The
+*  firmware itself only sees the component APIs of the fake project.h.
+*
+*******************************************************************************/
+
+#if !defined(SIM_BLE_H)
+#define SIM_BLE_H
+
+#include "sim.h"
+
+
+/***************************************
+*          Constants
+***************************************/
+#define SIM_BLE_REPORT_SIZE         (8u)        /* Keyboard input report */
+#define SIM_BLE_REPORT_LOG          (256u)      /* Reports kept in the log of the central */
+#define SIM_BLE_MAX_MTU             (512u)      /* ATT MTU of the GATT server */
+#define SIM_FLASH_SIZE              (256u * 1024u)
+
+
+/***************************************
+*        Data Types
+***************************************/
+/* Behaviour of the central */
+typedef struct
+{
+    uint32_t connectDelay;          /* us from the advertising start to the connection, 0 never connects */
+    uint16_t interval;              /* Connection interval set up on connection, 1.25 ms units */
+    uint16_t latency;               /* Slave latency set up on connection */
+    uint16_t minInterval;           /* Shortest interval it accepts in an update request */
+    uint8_t bonded;                 /* The stack restores the CCCDs on connection */
+    uint32_t cccdDelay;             /* us from the connection to the CCCD write when not bonded */
+    uint8_t packetsPerEvent;        /* Notifications it takes per connection event */
+    int8_t rssi;
+    uint16_t mtu;                   /* ATT MTU it asks for on connection, 0 keeps the default of 23 */
+    /* Called with the notifications that are not HID reports */
+    void (*notification)(uint16_t attrHandle, const uint8_t *data, uint16_t size);
+} SIM_CENTRAL_T;
+
+typedef struct
+{
+    uint64_t at;                    /* us the packet was received */
+    uint16_t interval;              /* Connection interval of the event, 1.25 ms units */
+    uint8_t report[SIM_BLE_REPORT_SIZE];
+} SIM_REPORT_T;
+
+typedef struct
+{
+    uint32_t events;                /* Connection events the peripheral took part in */
+    uint32_t radioTime;             /* us the radio was on in connection events */
+    uint32_t paramRequests;         /* Connection parameter update requests */
+    uint32_t paramUpdates;          /* Connection parameter updates carried out */
+    uint16_t interval;              /* Connection interval at the end of the run */
+    uint16_t mtu;                   /* ATT MTU agreed on the last connection */
+    uint32_t writes;                /* Write commands of the central received by the stack */
+    uint32_t stackStarts;           /* CyBle_Start() calls */
+    uint64_t advertisingAt;         /* us advertising last started */
+    uint64_t connectedAt;           /* us of the last connection */
+    uint64_t i2cDoneAt;             /* us the last I2C transfer completed without error */
+    uint8_t sdaClocks;              /* SCL pulses seen by a slave holding SDA */
+    uint64_t sdaReleasedAt;         /* us a held SDA was released, 0 while held */
+    uint32_t reports;               /* HID input reports received */
+    uint32_t attRequests;           /* ATT requests of the central on the current connection */
+    SIM_REPORT_T log[SIM_BLE_REPORT_LOG];
+} SIM_BLE_RESULT_T;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+void SimBleMain(void);
+uint8_t SimCentralWrite(uint16_t attrHandle, const uint8_t *data, uint16_t size);
+void SimI2cHoldSda(uint8_t clocks);
+void SimBleHardwareError(uint8_t persistent);
+void SimBleHang(void);
+void SimCentralDisconnect(void);
+
+
+/***************************************
+* External data references
+***************************************/
+extern SIM_CPU_T simBleCpu;
+extern SIM_CENTRAL_T simCentral;
+extern SIM_BLE_RESULT_T simBle;
+extern uint8_t simFlash[SIM_FLASH_SIZE];
+extern void (*simBleInterrupt)(void);   /* Raised once at the next CyExitCriticalSection() */
+
+#endif /* SIM_BLE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,722 @@
+/*******************************************************************************
+* File Name: capsense.c
+*
+* Version 1.0
+*
+* Description:
+*  This file contains the simulated CapSense MCU: the component APIs of the
+*  fake project.h implemented on the virtual clock, and a synthetic model of
+*  the touch panel they scan.
+*
+*  The model covers what the firmware timing and touch decisions depend on:
+*   - widget scans that take the time of their sensors, the busy status
+*     and the scan complete interrupt
+*   - raw counts of every sensor: a level with drift and noise, a finger on
+*     a button or at a position of the slider, a hand hovering above all
+*     sensors
+*   - the baseline and difference counts of CapSense_ProcessWidget() and
+*     the centroid of the slider
+*   - the 1 ms SysTick callbacks, the WDT with ignore bits, Sleep and flash
+*  The EZI2C slave is the one of the simulation core; the interrupt time
+*  of a master transfer is not charged to the CPU.
+*
+*******************************************************************************/
+
+#include <string.h>
+#include "project.h"
+#include "capsense.h"
+
+/* Model parameters */
+#define SIM_POLL_TIME               (2u)        /* us of one main loop pass waiting for a scan */
+#define SIM_SETUP_TIME              (10u)       /* us of CapSense_SetupWidget() */
+#define SIM_SENSOR_PROCESS_TIME     (12u)       /* us of CapSense_ProcessWidget() per sensor */
+#define SIM_FRAME_TIME              (60u)       /* us of the frame work after the last widget: filters, gestures, publication */
+#define SIM_CALIBRATION_TIME        (15000u)    /* us of the IDAC calibration of CapSense_Start() */
+#define SIM_FLASH_ROW_TIME          (20000u)    /* us the CPU stalls writing a flash row */
+#define SIM_MOD_CLK_MHZ             (48u)       /* Modulator clock, the sense clock divides it */
+#define SIM_ILO_HZ                  (40000u)    /* WDT clock */
+#define SIM_WDT_MISSED_MATCHES      (3u)        /* Unserviced matches that reset the device */
+#define SIM_SYSTICK_PERIOD          (1000u)     /* us */
+#define SIM_SYSTICK_RELOAD          (47999u)    /* 1 ms at 48 MHz */
+#define SIM_SYSTICK_CALLBACKS       (5u)
+
+/* Configuration of the customizer, as CapSense_Initialize() sets it */
+#define SIM_RESOLUTION              (12u)       /* Scan resolution, bits */
+#define SIM_SNS_CLK                 (4u)        /* Sense clock divider */
+#define SIM_FINGER_TH               (100u)
+#define SIM_NOISE_TH                (40u)
+#define SIM_NEGATIVE_NOISE_TH       (40u)
+#define SIM_HYSTERESIS              (10u)
+#define SIM_ON_DEBOUNCE             (3u)
+#define SIM_LOW_BASELINE_RESET      (30u)
+#define SIM_IDAC_MOD                (32u)       /* Set by the calibration */
+#define SIM_IDAC_COMP               (24u)
+
+/* Sensors and raw counts */
+#define SIM_BUTTONS                 (3u)
+#define SIM_SLIDER_SENSORS          (6u)
+#define SIM_SENSORS                 (SIM_BUTTONS + SIM_SLIDER_SENSORS)
+#define SIM_SLIDER_PITCH            (SIM_SLIDER_RESOLUTION / (SIM_SLIDER_SENSORS - 1u))
+#define SIM_RAW_MAX                 ((1u << SIM_RESOLUTION) - 1u)
+#define SIM_RAW_LEVEL               (3480u)     /* 85 % of the full scale, the calibration target */
+#define SIM_RAW_SPREAD              (20u)       /* Raw count difference between neighbouring sensors */
+#define SIM_BASELINE_SHIFT          (5u)        /* Baseline IIR coefficient 1/2^n */
+#define SIM_BASELINE_FRAC           (8u)        /* Fractional bits of the baseline */
+#define SIM_ALL_WIDGETS             (0xFFu)     /* Scan of CapSense_ScanAllWidgets() */
+
+SIM_CPU_T simCapSenseCpu;
+SIM_PANEL_T simPanel = {0u, 0, 200u, 8u, 0u, 0u, SIM_NO_FINGER, 0, 0u};
+SIM_CAPSENSE_RESULT_T simCapSense;
+
+CapSense_RAM_STRUCT CapSense_dsRam;
+
+int CapSenseMain();
+
+/* Scanning */
+static SIM_TIMER_T scanTimer;
+static uint8 scanWidget;
+static uint8 scanning;
+static uint32 baseline[SIM_SENSORS];
+static uint8 lowCount[SIM_SENSORS];
+static uint8 sliderActive;
+static uint32 noiseState = 1u;
+
+/* SysTick */
+static SIM_TIMER_T sysTickTimer;
+static cySysTickCallback sysTickCallbacks[SIM_SYSTICK_CALLBACKS];
+
+/* WDT */
+static SIM_TIMER_T wdtTimer;
+static uint32 wdtPeriod = 1u << 16u;    /* ILO counts between matches */
+static uint32 wdtMissed;
+
+static CapSense_RAM_SNS_STRUCT *Sensor(uint32 sensor);
+static const CapSense_RAM_WD_BUTTON_STRUCT *Button(uint32 widgetId);
+static uint64 ScanTime(uint32 widgetId);
+static uint32 WidgetFirstSensor(uint32 widgetId);
+static uint32 WidgetSensors(uint32 widgetId);
+static uint16 SensorRaw(uint32 sensor);
+static int32 FingerPosition(void);
+static int32 Noise(void);
+static void ProcessSensor(uint32 sensor, uint8 noiseTh, uint8 nNoiseTh, uint8 lowBslnRst);
+static uint16 Centroid(void);
+static void ScanComplete(void);
+static void SysTick(void);
+static void WdtMatch(void);
+
+
+/*******************************************************************************
+* Function Name: SimCapSenseMain()
+********************************************************************************
+*
+* Summary:
+*   Entry of the CapSense MCU for SimRun(): powers the device on with the
+*   panel set up in simPanel and runs the firmware main().
+*
+*******************************************************************************/
+void SimCapSenseMain(void)
+{
+    simCapSenseCpu.name = "CapSense";
+    (void)CapSenseMain();
+}
+
+
+/*******************************************************************************
+* CapSense
+*******************************************************************************/
+uint32 CapSense_Initialize(void)
+{
+    CapSense_RAM_WD_BUTTON_STRUCT button;
+
+    (void)memset(&CapSense_dsRam, 0, sizeof(CapSense_dsRam));
+    CapSense_dsRam.configId = CapSense_CONFIG_ID;
+    CapSense_dsRam.timestampInterval = 1u;
+
+    (void)memset(&button, 0, sizeof(button));
+    button.resolution = SIM_RESOLUTION;
+    button.fingerTh = SIM_FINGER_TH;
+    button.noiseTh = SIM_NOISE_TH;
+    button.nNoiseTh = SIM_NEGATIVE_NOISE_TH;
+    button.hysteresis = SIM_HYSTERESIS;
+    button.onDebounce = SIM_ON_DEBOUNCE;
+    button.lowBslnRst = SIM_LOW_BASELINE_RESET;
+    button.snsClk = SIM_SNS_CLK;
+    CapSense_dsRam.wdgtList.btn0 = button;
+    CapSense_dsRam.wdgtList.btn1 = button;
+    CapSense_dsRam.wdgtList.btn2 = button;
+    CapSense_dsRam.wdgtList.linearslider0.resolution = SIM_RESOLUTION;
+    CapSense_dsRam.wdgtList.linearslider0.fingerTh = SIM_FINGER_TH;
+    CapSense_dsRam.wdgtList.linearslider0.noiseTh = SIM_NOISE_TH;
+    CapSense_dsRam.wdgtList.linearslider0.nNoiseTh = SIM_NEGATIVE_NOISE_TH;
+    CapSense_dsRam.wdgtList.linearslider0.hysteresis = SIM_HYSTERESIS;
+    CapSense_dsRam.wdgtList.linearslider0.onDebounce = SIM_ON_DEBOUNCE;
+    CapSense_dsRam.wdgtList.linearslider0.lowBslnRst = SIM_LOW_BASELINE_RESET;
+    CapSense_dsRam.wdgtList.linearslider0.snsClk = SIM_SNS_CLK;
+    CapSense_dsRam.wdgtList.linearslider0.position[0u] = CapSense_SLIDER_NO_TOUCH;
+    return (CYRET_SUCCESS);
+}
+
+/* Initializes, calibrates the IDACs and takes the first baselines */
+uint32 CapSense_Start(void)
+{
+    uint32 sensor;
+
+    (void)CapSense_Initialize();
+    SimBusy(&simCapSenseCpu, SIM_CALIBRATION_TIME);
+    CapSense_dsRam.wdgtList.btn0.idacMod[0u] = SIM_IDAC_MOD;
+    CapSense_dsRam.wdgtList.btn1.idacMod[0u] = SIM_IDAC_MOD;
+    CapSense_dsRam.wdgtList.btn2.idacMod[0u] = SIM_IDAC_MOD;
+    CapSense_dsRam.wdgtList.linearslider0.idacMod[0u] = SIM_IDAC_MOD;
+    for(sensor = 0u; sensor < SIM_SENSORS; sensor++)
+    {
+        Sensor(sensor)->idacComp[0u] = SIM_IDAC_COMP;
+    }
+
+    (void)CapSense_ScanAllWidgets();
+    while(CapSense_IsBusy() != CapSense_NOT_BUSY)
+    {
+    }
+    CapSense_InitializeAllBaselines();
+    return (CYRET_SUCCESS);
+}
+
+void CapSense_InitializeAllBaselines(void)
+{
+    uint32 sensor;
+
+    for(sensor = 0u; sensor < SIM_SENSORS; sensor++)
+    {
+        baseline[sensor] = (uint32)Sensor(sensor)->raw[0u] << SIM_BASELINE_FRAC;
+        lowCount[sensor] = 0u;
+        Sensor(sensor)->bsln[0u] = Sensor(sensor)->raw[0u];
+        Sensor(sensor)->diff = 0u;
+    }
+}
+
+uint32 CapSense_ScanAllWidgets(void)
+{
+    uint64 time = 0u;
+    uint32 widgetId;
+
+    for(widgetId = 0u; widgetId < CapSense_TOTAL_WIDGETS; widgetId++)
+    {
+        SimBusy(&simCapSenseCpu, SIM_SETUP_TIME);
+        time += ScanTime(widgetId);
+    }
+    scanWidget = SIM_ALL_WIDGETS;
+    scanning = 1u;
+    simCapSense.scanTime += (uint32)time;
+    SimTimerStart(&scanTimer, simNow + time, ScanComplete);
+    return (CYRET_SUCCESS);
+}
+
+uint32 CapSense_SetupWidget(uint32 widgetId)
+{
+    SimBusy(&simCapSenseCpu, SIM_SETUP_TIME);
+    scanWidget = (uint8)widgetId;
+    return (CYRET_SUCCESS);
+}
+
+uint32 CapSense_Scan(void)
+{
+    uint64 time = ScanTime(scanWidget);
+
+    scanning = 1u;
+    simCapSense.scanTime += (uint32)time;
+    SimTimerStart(&scanTimer, simNow + time, ScanComplete);
+    return (CYRET_SUCCESS);
+}
+
+/* Every call is one pass of a loop waiting for the scan */
+uint32 CapSense_IsBusy(void)
+{
+    SimBusy(&simCapSenseCpu, SIM_POLL_TIME);
+    return ((scanning != 0u) ? CapSense_SW_STS_BUSY : CapSense_NOT_BUSY);
+}
+
+uint32 CapSense_ProcessWidget(uint32 widgetId)
+{
+    uint32 sensor;
+    uint32 time = WidgetSensors(widgetId) * SIM_SENSOR_PROCESS_TIME;
+    uint8 noiseTh;
+    uint8 nNoiseTh;
+    uint8 lowBslnRst;
+
+    if(widgetId == (CapSense_TOTAL_WIDGETS - 1u))
+    {
+        time += SIM_FRAME_TIME;
+        simCapSense.frames++;
+    }
+    SimBusy(&simCapSenseCpu, time);
+
+    if(widgetId == CapSense_LINEARSLIDER0_WDGT_ID)
+    {
+        noiseTh = CapSense_dsRam.wdgtList.linearslider0.noiseTh;
+        nNoiseTh = CapSense_dsRam.wdgtList.linearslider0.nNoiseTh;
+        lowBslnRst = CapSense_dsRam.wdgtList.linearslider0.lowBslnRst;
+    }
+    else
+    {
+        noiseTh = Button(widgetId)->noiseTh;
+        nNoiseTh = Button(widgetId)->nNoiseTh;
+        lowBslnRst = Button(widgetId)->lowBslnRst;
+    }
+    for(sensor = WidgetFirstSensor(widgetId); sensor < (WidgetFirstSensor(widgetId) + WidgetSensors(widgetId)); sensor++)
+    {
+        ProcessSensor(sensor, noiseTh, nNoiseTh, lowBslnRst);
+    }
+    if(widgetId == CapSense_LINEARSLIDER0_WDGT_ID)
+    {
+        CapSense_dsRam.wdgtList.linearslider0.position[0u] = Centroid();
+    }
+    return (CYRET_SUCCESS);
+}
+
+uint32 CapSense_ProcessAllWidgets(void)
+{
+    uint32 widgetId;
+
+    for(widgetId = 0u; widgetId < CapSense_TOTAL_WIDGETS; widgetId++)
+    {
+        (void)CapSense_ProcessWidget(widgetId);
+    }
+    return (CYRET_SUCCESS);
+}
+
+/* Position of the last processed slider scan */
+uint32 CapSense_GetCentroidPos(uint32 widgetId)
+{
+    (void)widgetId;
+    return (CapSense_dsRam.wdgtList.linearslider0.position[0u]);
+}
+
+void CapSense_IncrementGestureTimestamp(void)
+{
+    CapSense_dsRam.timestamp += CapSense_dsRam.timestampInterval;
+}
+
+void CapSense_SetGestureTimestamp(uint32 value)
+{
+    CapSense_dsRam.timestamp = value;
+}
+
+
+/*******************************************************************************
+* Function Name: Sensor()
+********************************************************************************
+*
+* Summary:
+*   Sensor RAM of a sensor number: the buttons first, then the slider
+*   sensors from left to right.
+*
+*******************************************************************************/
+static CapSense_RAM_SNS_STRUCT *Sensor(uint32 sensor)
+{
+    CapSense_RAM_SNS_STRUCT *sns;
+
+    switch(sensor)
+    {
+        case CapSense_BTN0_WDGT_ID:
+            sns = &CapSense_dsRam.snsList.btn0[0u];
+            break;
+        case CapSense_BTN1_WDGT_ID:
+            sns = &CapSense_dsRam.snsList.btn1[0u];
+            break;
+        case CapSense_BTN2_WDGT_ID:
+            sns = &CapSense_dsRam.snsList.btn2[0u];
+            break;
+        default:
+            sns = &CapSense_dsRam.snsList.linearslider0[sensor - SIM_BUTTONS];
+            break;
+    }
+    return (sns);
+}
+
+static uint32 WidgetFirstSensor(uint32 widgetId)
+{
+    return ((widgetId == SIM_ALL_WIDGETS) ? 0u : widgetId);
+}
+
+static uint32 WidgetSensors(uint32 widgetId)
+{
+    uint32 count = 1u;
+
+    if(widgetId == CapSense_LINEARSLIDER0_WDGT_ID)
+    {
+        count = SIM_SLIDER_SENSORS;
+    }
+    else if(widgetId == SIM_ALL_WIDGETS)
+    {
+        count = SIM_SENSORS;
+    }
+    else
+    {
+        /* A button */
+    }
+    return (count);
+}
+
+
+static const CapSense_RAM_WD_BUTTON_STRUCT *Button(uint32 widgetId)
+{
+    const CapSense_RAM_WD_BUTTON_STRUCT *button = &CapSense_dsRam.wdgtList.btn0;
+
+    if(widgetId == CapSense_BTN1_WDGT_ID)
+    {
+        button = &CapSense_dsRam.wdgtList.btn1;
+    }
+    else if(widgetId == CapSense_BTN2_WDGT_ID)
+    {
+        button = &CapSense_dsRam.wdgtList.btn2;
+    }
+    else
+    {
+        /* Button 0 */
+    }
+    return (button);
+}
+
+/* A sensor scan takes 2^resolution sense clock periods, us */
+static uint64 ScanTime(uint32 widgetId)
+{
+    uint16 resolution;
+    uint16 snsClk;
+
+    if(widgetId == CapSense_LINEARSLIDER0_WDGT_ID)
+    {
+        resolution = CapSense_dsRam.wdgtList.linearslider0.resolution;
+        snsClk = CapSense_dsRam.wdgtList.linearslider0.snsClk;
+    }
+    else
+    {
+        resolution = Button(widgetId)->resolution;
+        snsClk = Button(widgetId)->snsClk;
+    }
+    return (((uint64)WidgetSensors(widgetId) * (1u << resolution) * snsClk) / SIM_MOD_CLK_MHZ);
+}
+
+
+/*******************************************************************************
+* Function Name: Centroid()
+********************************************************************************
+*
+* Summary:
+*   Linear slider centroid of the strongest sensor and its neighbours,
+*   scaled to SIM_SLIDER_RESOLUTION. The slider turns active when the
+*   strongest sensor reaches the finger threshold and stays active down to
+*   the threshold less the hysteresis; an inactive slider has no position.
+*
+*******************************************************************************/
+static uint16 Centroid(void)
+{
+    const CapSense_RAM_WD_SLIDER_STRUCT *slider = &CapSense_dsRam.wdgtList.linearslider0;
+    int32 diff[SIM_SLIDER_SENSORS + 2u];
+    int32 position;
+    uint32 peak = 1u;
+    uint32 sensor;
+
+    diff[0u] = 0;
+    diff[SIM_SLIDER_SENSORS + 1u] = 0;
+    for(sensor = 0u; sensor < SIM_SLIDER_SENSORS; sensor++)
+    {
+        diff[sensor + 1u] = (int32)Sensor(SIM_BUTTONS + sensor)->diff;
+        if(diff[sensor + 1u] > diff[peak])
+        {
+            peak = sensor + 1u;
+        }
+    }
+
+    if(diff[peak] >= ((int32)slider->fingerTh - ((sliderActive != 0u) ? (int32)slider->hysteresis : 0)))
+    {
+        sliderActive = 1u;
+    }
+    else
+    {
+        sliderActive = 0u;
+        return (CapSense_SLIDER_NO_TOUCH);
+    }
+
+    position = ((int32)(peak - 1u) * (int32)SIM_SLIDER_PITCH) +
+               (((diff[peak + 1u] - diff[peak - 1u]) * (int32)SIM_SLIDER_PITCH) /
+                (diff[peak - 1u] + diff[peak] + diff[peak + 1u]));
+    if(position < 0)
+    {
+        position = 0;
+    }
+    if(position > (int32)SIM_SLIDER_RESOLUTION)
+    {
+        position = SIM_SLIDER_RESOLUTION;
+    }
+    return ((uint16)position);
+}
+
+
+/*******************************************************************************
+* Function Name: SensorRaw()
+********************************************************************************
+*
+* Summary:
+*   Raw count of a sensor scanned now. A finger on the slider covers one and
+*   a half sensor pitches on either side: the signal of a sensor falls off
+*   linearly with its distance from the finger.
+*
+*******************************************************************************/
+static uint16 SensorRaw(uint32 sensor)
+{
+    int32 raw = (int32)(SIM_RAW_LEVEL + (sensor * SIM_RAW_SPREAD));
+    int32 distance;
+    int32 reach = 3 * (int32)SIM_SLIDER_PITCH;
+
+    raw += (int32)(((int64_t)simPanel.drift * (int64_t)simNow) / 1000000);
+    raw += Noise();
+    if(simPanel.hand != 0u)
+    {
+        raw += simPanel.handSignal;
+    }
+    if(sensor < SIM_BUTTONS)
+    {
+        if((simPanel.buttons & (1u << sensor)) != 0u)
+        {
+            raw += simPanel.fingerSignal;
+        }
+    }
+    else if(simPanel.position != SIM_NO_FINGER)
+    {
+        distance = 2 * (FingerPosition() - ((int32)(sensor - SIM_BUTTONS) * (int32)SIM_SLIDER_PITCH));
+        distance = (distance < 0) ? -distance : distance;
+        if(distance < reach)
+        {
+            raw += ((int32)simPanel.fingerSignal * (reach - distance)) / reach;
+        }
+    }
+    else
+    {
+        /* No finger on the slider */
+    }
+
+    if(raw < 0)
+    {
+        raw = 0;
+    }
+    if(raw > (int32)SIM_RAW_MAX)
+    {
+        raw = SIM_RAW_MAX;
+    }
+    return ((uint16)raw);
+}
+
+/* Slider position of the moving finger now */
+static int32 FingerPosition(void)
+{
+    int32 position = (int32)simPanel.position +
+                     (int32)(((int64_t)simPanel.speed * (int64_t)(simNow - simPanel.moveStart)) / 1000000);
+
+    if(position < 0)
+    {
+        position = 0;
+    }
+    if(position > (int32)SIM_SLIDER_RESOLUTION)
+    {
+        position = SIM_SLIDER_RESOLUTION;
+    }
+    return (position);
+}
+
+/* Uniform within +-simPanel.noise, the same sequence in every run */
+static int32 Noise(void)
+{
+    noiseState = (noiseState * 1103515245u) + 12345u;
+    return ((simPanel.noise == 0u) ? 0 :
+            ((int32)((noiseState >> 16u) % ((2u * simPanel.noise) + 1u)) - (int32)simPanel.noise));
+}
+
+
+/*******************************************************************************
+* Function Name: ProcessSensor()
+********************************************************************************
+*
+* Summary:
+*   Updates the baseline and difference count of a sensor. The baseline
+*   follows the raw count while the difference stays below the noise
+*   threshold, and is reset to the raw count after lowBslnRst scans below
+*   the negative noise threshold. A touched sensor keeps its baseline.
+*
+*******************************************************************************/
+static void ProcessSensor(uint32 sensor, uint8 noiseTh, uint8 nNoiseTh, uint8 lowBslnRst)
+{
+    CapSense_RAM_SNS_STRUCT *sns = Sensor(sensor);
+    int32 raw = (int32)sns->raw[0u];
+    int32 delta = raw - (int32)(baseline[sensor] >> SIM_BASELINE_FRAC);
+
+    if(delta >= (int32)noiseTh)
+    {
+        lowCount[sensor] = 0u;
+    }
+    else if(delta < -(int32)nNoiseTh)
+    {
+        lowCount[sensor]++;
+        if(lowCount[sensor] >= lowBslnRst)
+        {
+            baseline[sensor] = (uint32)raw << SIM_BASELINE_FRAC;
+            lowCount[sensor] = 0u;
+        }
+    }
+    else
+    {
+        lowCount[sensor] = 0u;
+        baseline[sensor] = (uint32)((int32)baseline[sensor] +
+                                    ((((int32)raw << SIM_BASELINE_FRAC) - (int32)baseline[sensor]) >> SIM_BASELINE_SHIFT));
+    }
+
+    delta = raw - (int32)(baseline[sensor] >> SIM_BASELINE_FRAC);
+    sns->bsln[0u] = (uint16)(baseline[sensor] >> SIM_BASELINE_FRAC);
+    sns->diff = (delta > 0) ? (uint16)delta : 0u;
+}
+
+/* Scan complete interrupt, the raw counts are sampled now */
+static void ScanComplete(void)
+{
+    uint32 sensor;
+
+    for(sensor = WidgetFirstSensor(scanWidget); sensor < (WidgetFirstSensor(scanWidget) + WidgetSensors(scanWidget)); sensor++)
+    {
+        Sensor(sensor)->raw[0u] = SensorRaw(sensor);
+    }
+    simCapSense.scans += (scanWidget == SIM_ALL_WIDGETS) ? CapSense_TOTAL_WIDGETS : 1u;
+    scanning = 0u;
+    SimWake(&simCapSenseCpu);
+}
+
+
+/*******************************************************************************
+* EZI2C and pins
+*******************************************************************************/
+void EZI2C_Start(void)
+{
+}
+
+void EZI2C_EzI2CSetBuffer1(uint32 bufSize, uint32 rwBoundary, volatile uint8 *buffer)
+{
+    SimEzi2cSetBuffer(buffer, bufSize, rwBoundary);
+}
+
+void LED_11_Write(uint8 value)
+{
+    (void)value;
+}
+
+void LED_12_Write(uint8 value)
+{
+    (void)value;
+}
+
+void LED_13_Write(uint8 value)
+{
+    (void)value;
+}
+
+void Left_LED_Write(uint8 value)
+{
+    (void)value;
+}
+
+void Right_LED_Write(uint8 value)
+{
+    (void)value;
+}
+
+
+/*******************************************************************************
+* System
+*******************************************************************************/
+void CySysTickStart(void)
+{
+    if(sysTickTimer.armed == 0u)
+    {
+        SimTimerStart(&sysTickTimer, simNow + SIM_SYSTICK_PERIOD, SysTick);
+    }
+}
+
+uint32 CySysTickGetReload(void)
+{
+    return (SIM_SYSTICK_RELOAD);
+}
+
+cySysTickCallback CySysTickSetCallback(uint32 number, cySysTickCallback function)
+{
+    cySysTickCallback previous = sysTickCallbacks[number];
+
+    sysTickCallbacks[number] = function;
+    return (previous);
+}
+
+void CySysTickClearCallback(uint32 number)
+{
+    sysTickCallbacks[number] = (cySysTickCallback)0;
+}
+
+/* SysTick interrupt, runs the callbacks and wakes the CPU */
+static void SysTick(void)
+{
+    uint32 number;
+
+    SimTimerStart(&sysTickTimer, simNow + SIM_SYSTICK_PERIOD, SysTick);
+    for(number = 0u; number < SIM_SYSTICK_CALLBACKS; number++)
+    {
+        if(sysTickCallbacks[number] != (cySysTickCallback)0)
+        {
+            sysTickCallbacks[number]();
+        }
+    }
+    SimWake(&simCapSenseCpu);
+}
+
+uint32 CySysFlashWriteRow(uint32 rowNum, const uint8 rowData[])
+{
+    (void)rowNum;
+    (void)rowData;
+    SimBusy(&simCapSenseCpu, SIM_FLASH_ROW_TIME);
+    simCapSense.flashWrites++;
+    return (CYRET_SUCCESS);
+}
+
+void CySysPmSleep(void)
+{
+    SimWait(&simCapSenseCpu, 0u);
+}
+
+
+/*******************************************************************************
+* WDT
+*******************************************************************************/
+/* Only the low 16 - bitsNum bits of the count are matched */
+void CySysWdtSetIgnoreBits(uint32 bitsNum)
+{
+    wdtPeriod = 1u << (16u - bitsNum);
+}
+
+void CySysWdtEnable(void)
+{
+    wdtMissed = 0u;
+    SimTimerStart(&wdtTimer, simNow + (((uint64)wdtPeriod * 1000000u) / SIM_ILO_HZ), WdtMatch);
+}
+
+void CySysWdtClearInterrupt(void)
+{
+    wdtMissed = 0u;
+}
+
+/* Resets the device after SIM_WDT_MISSED_MATCHES matches without a clear */
+static void WdtMatch(void)
+{
+    wdtMissed++;
+    if(wdtMissed >= SIM_WDT_MISSED_MATCHES)
+    {
+        SimEnd(SIM_END_WATCHDOG);
+    }
+    SimTimerStart(&wdtTimer, simNow + (((uint64)wdtPeriod * 1000000u) / SIM_ILO_HZ), WdtMatch);
+    SimWake(&simCapSenseCpu);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,68 @@
+/*******************************************************************************
+* File Name: capsense.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the interface of the simulated CapSense MCU: the touch panel
+*  the sensor model scans, and what the CapSense block did during a run.
+*  The firmware itself only sees the component APIs of the fake project.h.
+*
+*******************************************************************************/
+
+#if !defined(SIM_CAPSENSE_H)
+#define SIM_CAPSENSE_H
+
+#include "sim.h"
+
+
+/***************************************
+*          Constants
+***************************************/
+#define SIM_NO_FINGER               (0xFFFFu)   /* simPanel.position with no finger on the slider */
+#define SIM_SLIDER_RESOLUTION       (100u)      /* Centroid of the slider, 0 to this value */
+
+
+/***************************************
+*        Data Types
+***************************************/
+/* What is on the panel, set by the session while the simulation runs */
+typedef struct
+{
+    uint16_t noise;                 /* Raw count noise, uniform within +-noise */
+    int32_t drift;                  /* Raw count change of all sensors per second */
+    uint16_t fingerSignal;          /* Raw count rise of a sensor under a finger */
+    uint16_t handSignal;            /* Raw count rise of every sensor under a hovering hand */
+    uint8_t buttons;                /* Touched buttons, bit n = button n */
+    uint8_t hand;                   /* A hand hovers over the panel */
+    uint16_t position;              /* Finger on the slider at moveStart, or SIM_NO_FINGER */
+    int16_t speed;                  /* Slider units per second the finger moves */
+    uint64_t moveStart;             /* us */
+} SIM_PANEL_T;
+
+typedef struct
+{
+    uint32_t scans;                 /* Widget scans completed */
+    uint32_t frames;                /* Scans of the last widget processed */
+    uint32_t flashWrites;           /* Flash rows written */
+    uint32_t scanTime;              /* us the CapSense block scanned */
+} SIM_CAPSENSE_RESULT_T;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+void SimCapSenseMain(void);
+
+
+/***************************************
+* External data references
+***************************************/
+extern SIM_CPU_T simCapSenseCpu;
+extern SIM_PANEL_T simPanel;
+extern SIM_CAPSENSE_RESULT_T simCapSense;
+
+#endif /* SIM_CAPSENSE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,526 @@
+/*******************************************************************************
+* File Name: sim.c
+*
+* Version 1.0
+*
+* Description:
+*  This file contains the host simulation core: a discrete event scheduler
+*  over the virtual clock, the CPU time accounting, and the EZI2C slave
+*  model. Time only advances from one timer expiry to the next, so a
+*  simulated minute of mostly sleeping firmware runs in milliseconds.
+*
+*  SimRunCpus() runs each firmware as a coroutine with its own stack. Only
+*  one CPU runs at a time and it hands over at its next SimBusy() or
+*  SimWait(), so the runs are as deterministic as those of SimRun().
+*
+*******************************************************************************/
+
+#include <setjmp.h>
+#include <stddef.h>
+#include <ucontext.h>
+#include "sim.h"
+
+#define SIM_CPU_STACK_SIZE          (256u * 1024u)
+
+uint64_t simNow = 0u;
+SIM_EZI2C_T simEzi2c;
+
+static SIM_TIMER_T *simTimers = NULL;
+static jmp_buf simExit;
+
+/* SimRunCpus() */
+static uint8_t simCpuCount = 0u;
+static SIM_CPU_T *simCpus[SIM_MAX_CPUS];
+static void (*simEntries[SIM_MAX_CPUS])(void);
+static uint8_t simCpuDone[SIM_MAX_CPUS];
+static ucontext_t simContexts[SIM_MAX_CPUS];
+static ucontext_t simScheduler;
+static uint8_t simStacks[SIM_MAX_CPUS][SIM_CPU_STACK_SIZE];
+static SIM_CPU_T *simCurrent = NULL;        /* CPU whose code runs, NULL in the scheduler */
+static uint8_t simEndReason;                /* SIM_END_xxx + 1 once the run ends */
+
+static void SimStep(void);
+static void SimAccount(SIM_CPU_T *cpu);
+static void SimSwitch(SIM_CPU_T *cpu);
+static uint8_t SimKeepsTurn(const SIM_CPU_T *cpu);
+static SIM_TIMER_T *SimNextTimer(void);
+
+
+/*******************************************************************************
+* Function Name: SimTimerStart()
+********************************************************************************
+*
+* Summary:
+*   Arms a timer, replacing an earlier expiry. A timer is registered with
+*   the scheduler on its first start and stays registered.
+*
+* Parameters:
+*  timer - the timer
+*  at - expiry time, us; a time in the past expires on the next step
+*  expire - called at the expiry time
+*
+*******************************************************************************/
+void SimTimerStart(SIM_TIMER_T *timer, uint64_t at, void (*expire)(void))
+{
+    SIM_TIMER_T *entry;
+
+    for(entry = simTimers; (entry != NULL) && (entry != timer); entry = entry->next)
+    {
+    }
+    if(entry == NULL)
+    {
+        timer->next = simTimers;
+        simTimers = timer;
+    }
+    timer->at = (at < simNow) ? simNow : at;
+    timer->expire = expire;
+    timer->armed = 1u;
+}
+
+void SimTimerStop(SIM_TIMER_T *timer)
+{
+    timer->armed = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: SimBusy()
+********************************************************************************
+*
+* Summary:
+*   Advances the clock while the CPU runs code. Timers that expire in the
+*   meantime raise their interrupts as they would on the target.
+*
+* Parameters:
+*  cpu - the running CPU
+*  time - run time, us
+*
+*******************************************************************************/
+void SimBusy(SIM_CPU_T *cpu, uint32_t time)
+{
+    uint64_t end = simNow + time;
+    SIM_TIMER_T *next;
+    SIM_TIMER_T *entry;
+
+    cpu->activeTime += time;
+    if(simCpuCount != 0u)
+    {
+        /* An interrupt handler takes no time of the scheduler */
+        if(cpu == simCurrent)
+        {
+            cpu->readyAt = end;
+            if(SimKeepsTurn(cpu) != 0u)
+            {
+                simNow = end;
+            }
+            else
+            {
+                SimSwitch(cpu);
+            }
+        }
+        return;
+    }
+    for(;;)
+    {
+        next = NULL;
+        for(entry = simTimers; entry != NULL; entry = entry->next)
+        {
+            if((entry->armed != 0u) && (entry->at <= end) && ((next == NULL) || (entry->at < next->at)))
+            {
+                next = entry;
+            }
+        }
+        if(next == NULL)
+        {
+            break;
+        }
+        simNow = next->at;
+        next->armed = 0u;
+        next->expire();
+    }
+    simNow = end;
+}
+
+
+/*******************************************************************************
+* Function Name: SimWait()
+********************************************************************************
+*
+* Summary:
+*   Sleeps until a timer wakes the CPU with SimWake(). Called by the fake
+*   CPU sleep functions; the interrupt handlers run before it returns.
+*
+* Parameters:
+*  cpu - the sleeping CPU
+*  deep - non-zero for Deep-Sleep
+*
+*******************************************************************************/
+void SimWait(SIM_CPU_T *cpu, uint8_t deep)
+{
+    cpu->asleep = 1u;
+    cpu->deep = deep;
+    cpu->sleepStart = simNow;
+    while(cpu->asleep != 0u)
+    {
+        if(simCpuCount != 0u)
+        {
+            SimSwitch(cpu);
+        }
+        else
+        {
+            SimStep();
+        }
+    }
+    cpu->wakeups++;
+    SimAccount(cpu);
+}
+
+void SimWake(SIM_CPU_T *cpu)
+{
+    if(cpu->asleep != 0u)
+    {
+        cpu->asleep = 0u;
+        cpu->readyAt = simNow;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: SimClose()
+********************************************************************************
+*
+* Summary:
+*   Ends the sleep a CPU was in when the simulation ended. Called for every
+*   CPU once SimRun() returned.
+*
+* Parameters:
+*  cpu - the CPU
+*
+*******************************************************************************/
+void SimClose(SIM_CPU_T *cpu)
+{
+    if(cpu->asleep != 0u)
+    {
+        cpu->asleep = 0u;
+        SimAccount(cpu);
+    }
+}
+
+/* Adds the time since the CPU went to sleep to its sleep time */
+static void SimAccount(SIM_CPU_T *cpu)
+{
+    if(cpu->deep != 0u)
+    {
+        cpu->deepSleepTime += simNow - cpu->sleepStart;
+    }
+    else
+    {
+        cpu->sleepTime += simNow - cpu->sleepStart;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: SimRun()
+********************************************************************************
+*
+* Summary:
+*   Runs a firmware main() until SimEnd() is called. The firmware state is
+*   not reset afterwards, so each simulation runs in its own process.
+*
+* Parameters:
+*  entry - calls the firmware main()
+*
+* Return:
+*  SIM_END_xxx reason.
+*
+*******************************************************************************/
+uint8_t SimRun(void (*entry)(void))
+{
+    int reason = setjmp(simExit);
+
+    if(reason == 0)
+    {
+        entry();
+        reason = SIM_END_IDLE + 1;
+    }
+    return ((uint8_t)(reason - 1));
+}
+
+/*******************************************************************************
+* Function Name: SimRunCpus()
+********************************************************************************
+*
+* Summary:
+*   Runs the firmware of several CPUs together until SimEnd() is called.
+*   Between two steps one CPU runs until it is busy or sleeps, or one timer
+*   expires; at equal times timers go first, then the CPUs in their order.
+*   Timer handlers run on the scheduler, as interrupts between the steps of
+*   the CPUs.
+*
+* Parameters:
+*  cpus - the CPUs, SimBusy() and SimWait() of each hand over to the others
+*  entries - calls the firmware main() of each CPU
+*  count - number of CPUs, up to SIM_MAX_CPUS
+*
+* Return:
+*  SIM_END_xxx reason.
+*
+*******************************************************************************/
+static void SimCpuEntry(void)
+{
+    uint8_t index;
+
+    for(index = 0u; simCpus[index] != simCurrent; index++)
+    {
+    }
+    simEntries[index]();
+    simCpuDone[index] = 1u;
+}
+
+uint8_t SimRunCpus(SIM_CPU_T *const cpus[], void (*const entries[])(void), uint8_t count)
+{
+    SIM_TIMER_T *timer;
+    SIM_CPU_T *cpu;
+    uint8_t index;
+    uint8_t next;
+
+    simCpuCount = count;
+    for(index = 0u; index < count; index++)
+    {
+        simCpus[index] = cpus[index];
+        simEntries[index] = entries[index];
+        simCpuDone[index] = 0u;
+        cpus[index]->asleep = 0u;
+        cpus[index]->readyAt = simNow;
+        (void)getcontext(&simContexts[index]);
+        simContexts[index].uc_stack.ss_sp = simStacks[index];
+        simContexts[index].uc_stack.ss_size = SIM_CPU_STACK_SIZE;
+        simContexts[index].uc_link = &simScheduler;
+        makecontext(&simContexts[index], SimCpuEntry, 0);
+    }
+
+    simEndReason = 0u;
+    while(simEndReason == 0u)
+    {
+        next = count;
+        for(index = 0u; index < count; index++)
+        {
+            cpu = cpus[index];
+            if((simCpuDone[index] == 0u) && (cpu->asleep == 0u) &&
+               ((next == count) || (cpu->readyAt < cpus[next]->readyAt)))
+            {
+                next = index;
+            }
+        }
+        timer = SimNextTimer();
+        if((timer != NULL) && ((next == count) || (timer->at <= cpus[next]->readyAt)))
+        {
+            simNow = timer->at;
+            timer->armed = 0u;
+            timer->expire();
+        }
+        else if(next != count)
+        {
+            simNow = cpus[next]->readyAt;
+            simCurrent = cpus[next];
+            (void)swapcontext(&simScheduler, &simContexts[next]);
+            simCurrent = NULL;
+        }
+        else
+        {
+            simEndReason = SIM_END_IDLE + 1u;
+        }
+    }
+    simCpuCount = 0u;
+    return ((uint8_t)(simEndReason - 1u));
+}
+
+/* Continues the scheduler until it gives the CPU its turn again */
+static void SimSwitch(SIM_CPU_T *cpu)
+{
+    uint8_t index;
+
+    for(index = 0u; simCpus[index] != cpu; index++)
+    {
+    }
+    (void)swapcontext(&simContexts[index], &simScheduler);
+}
+
+/* The scheduler would pick the CPU at its readyAt anyway, so it can go on
+*  without a context switch */
+static uint8_t SimKeepsTurn(const SIM_CPU_T *cpu)
+{
+    SIM_TIMER_T *timer = SimNextTimer();
+    uint8_t keeps = ((timer == NULL) || (timer->at > cpu->readyAt)) ? 1u : 0u;
+    uint8_t before = 1u;
+    uint8_t index;
+
+    for(index = 0u; (index < simCpuCount) && (keeps != 0u); index++)
+    {
+        if(simCpus[index] == cpu)
+        {
+            before = 0u;
+        }
+        else if((simCpuDone[index] == 0u) && (simCpus[index]->asleep == 0u) &&
+                ((simCpus[index]->readyAt < cpu->readyAt) ||
+                 ((before != 0u) && (simCpus[index]->readyAt == cpu->readyAt))))
+        {
+            keeps = 0u;
+        }
+        else
+        {
+            /* The other CPU sleeps or continues later */
+        }
+    }
+    return (keeps);
+}
+
+
+/*******************************************************************************
+* Function Name: SimEnd()
+********************************************************************************
+*
+* Summary:
+*   Ends the run. Under SimRunCpus() a CPU that ends the run is never
+*   continued, while a timer handler that ends it returns first.
+*
+*******************************************************************************/
+void SimEnd(uint8_t reason)
+{
+    if(simCpuCount == 0u)
+    {
+        longjmp(simExit, reason + 1);
+    }
+    if(simEndReason == 0u)
+    {
+        simEndReason = reason + 1u;
+    }
+    if(simCurrent != NULL)
+    {
+        SimSwitch(simCurrent);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: SimLfclkCounts()
+********************************************************************************
+*
+* Summary:
+*   Converts between virtual time and LFCLK counts. SimLfclkTime() rounds
+*   up, so a timer armed for a count expires once the count is reached.
+*
+*******************************************************************************/
+uint32_t SimLfclkCounts(uint64_t time)
+{
+    return ((uint32_t)((time * SIM_LFCLK_HZ) / 1000000u));
+}
+
+uint64_t SimLfclkTime(uint64_t counts)
+{
+    return (((counts * 1000000u) + SIM_LFCLK_HZ - 1u) / SIM_LFCLK_HZ);
+}
+
+
+/*******************************************************************************
+* Function Name: SimEzi2cSetBuffer()
+********************************************************************************
+*
+* Summary:
+*   Sets up the EZI2C slave like EZI2C_EzI2CSetBuffer1(). The first written
+*   byte of a transfer is the sub-address, the following ones are stored
+*   from there up to the read/write boundary. A read starts at the
+*   sub-address and returns 0xFF past the buffer end.
+*
+*******************************************************************************/
+void SimEzi2cSetBuffer(volatile uint8_t *buffer, uint32_t size, uint32_t rwBoundary)
+{
+    simEzi2c.buffer = buffer;
+    simEzi2c.size = size;
+    simEzi2c.rwBoundary = rwBoundary;
+    simEzi2c.base = 0u;
+}
+
+/* Address phase, returns non-zero on ACK */
+uint8_t SimEzi2cStart(uint8_t read)
+{
+    simEzi2c.pointer = simEzi2c.base;
+    simEzi2c.subAddress = (read == 0u) ? 1u : 0u;
+    return ((simEzi2c.buffer != NULL) ? 1u : 0u);
+}
+
+uint8_t SimEzi2cRead(void)
+{
+    uint8_t data = 0xFFu;
+
+    if(simEzi2c.pointer < simEzi2c.size)
+    {
+        data = simEzi2c.buffer[simEzi2c.pointer++];
+    }
+    return (data);
+}
+
+void SimEzi2cWrite(uint8_t data)
+{
+    if(simEzi2c.subAddress != 0u)
+    {
+        simEzi2c.subAddress = 0u;
+        if(data < simEzi2c.size)
+        {
+            simEzi2c.base = data;
+            simEzi2c.pointer = data;
+        }
+    }
+    else if(simEzi2c.pointer < simEzi2c.rwBoundary)
+    {
+        simEzi2c.buffer[simEzi2c.pointer++] = data;
+        simEzi2c.writes++;
+    }
+    else
+    {
+        /* Read only area, the byte is not acknowledged */
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: SimStep()
+********************************************************************************
+*
+* Summary:
+*   Advances the clock to the earliest armed timer and expires it. Ends the
+*   simulation when no timer is armed, nothing could wake a CPU any more.
+*
+*******************************************************************************/
+static void SimStep(void)
+{
+    SIM_TIMER_T *next = SimNextTimer();
+
+    if(next == NULL)
+    {
+        SimEnd(SIM_END_IDLE);
+    }
+    simNow = next->at;
+    next->armed = 0u;
+    next->expire();
+}
+
+/* Earliest armed timer, NULL when none is armed */
+static SIM_TIMER_T *SimNextTimer(void)
+{
+    SIM_TIMER_T *next = NULL;
+    SIM_TIMER_T *entry;
+
+    for(entry = simTimers; entry != NULL; entry = entry->next)
+    {
+        if((entry->armed != 0u) && ((next == NULL) || (entry->at < next->at)))
+        {
+            next = entry;
+        }
+    }
+    return (next);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,114 @@
+/*******************************************************************************
+* File Name: sim.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the interface of the host simulation core: the virtual clock and
+*  its timers, the time accounting of a simulated CPU, and the EZI2C slave
+*  the I2C master of the BLE MCU talks to.
+*
+*  Firmware code takes no virtual time by itself. A CPU spends time only in
+*  SimBusy() and SimWait(), which the fake component APIs call: a main loop
+*  pass costs a fixed time, a sleep call waits until a timer raises an
+*  interrupt of that CPU. Timers stand for the hardware: WDT counters,
+*  connection events, I2C byte transfers, CapSense scans.
+*
+*  SimRun() runs one firmware. SimRunCpus() runs several, each on its own
+*  stack: a CPU hands over to the scheduler in SimBusy() and SimWait(), and
+*  the scheduler continues whichever CPU or timer is due first.
+*
+*******************************************************************************/
+
+#if !defined(SIM_H)
+#define SIM_H
+
+#include <stdint.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+#define SIM_US_PER_MS               (1000u)
+#define SIM_LFCLK_HZ                (32768u)
+#define SIM_MAX_CPUS                (2u)        /* CPUs of SimRunCpus() */
+
+/* Why a simulation ended */
+#define SIM_END_TIME                (0u)        /* The session time elapsed */
+#define SIM_END_HIBERNATE           (1u)        /* The firmware entered Hibernate */
+#define SIM_END_RESET               (2u)        /* Software reset */
+#define SIM_END_WATCHDOG            (3u)        /* The liveness watchdog reset the device */
+#define SIM_END_IDLE                (4u)        /* No timer left to wake any CPU */
+
+
+/***************************************
+*        Data Types
+***************************************/
+typedef struct SIM_TIMER
+{
+    uint64_t at;                    /* Expiry time, us */
+    void (*expire)(void);
+    uint8_t armed;
+    struct SIM_TIMER *next;         /* Registered timers */
+} SIM_TIMER_T;
+
+typedef struct
+{
+    const char *name;
+    uint64_t activeTime;            /* us running code */
+    uint64_t sleepTime;             /* us in CPU Sleep */
+    uint64_t deepSleepTime;         /* us in Deep-Sleep */
+    uint32_t wakeups;               /* Sleep calls ended by an interrupt */
+    uint8_t asleep;
+    uint8_t deep;                   /* The current sleep is Deep-Sleep */
+    uint64_t sleepStart;
+    uint64_t readyAt;               /* SimRunCpus(): time the CPU continues when not asleep */
+} SIM_CPU_T;
+
+/* EZI2C slave buffer as set up by the slave firmware */
+typedef struct
+{
+    volatile uint8_t *buffer;
+    uint32_t size;
+    uint32_t rwBoundary;            /* Bytes the master may write, from the start */
+    uint32_t base;                  /* Sub-address set by the last write */
+    uint32_t pointer;               /* Next byte of the current transfer */
+    uint8_t subAddress;             /* The next written byte is the sub-address */
+    uint32_t writes;                /* Data bytes written by the master */
+} SIM_EZI2C_T;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+void SimTimerStart(SIM_TIMER_T *timer, uint64_t at, void (*expire)(void));
+void SimTimerStop(SIM_TIMER_T *timer);
+
+void SimBusy(SIM_CPU_T *cpu, uint32_t time);
+void SimWait(SIM_CPU_T *cpu, uint8_t deep);
+void SimWake(SIM_CPU_T *cpu);
+void SimClose(SIM_CPU_T *cpu);
+
+uint8_t SimRun(void (*entry)(void));
+uint8_t SimRunCpus(SIM_CPU_T *const cpus[], void (*const entries[])(void), uint8_t count);
+void SimEnd(uint8_t reason);
+
+uint32_t SimLfclkCounts(uint64_t time);
+uint64_t SimLfclkTime(uint64_t counts);
+
+void SimEzi2cSetBuffer(volatile uint8_t *buffer, uint32_t size, uint32_t rwBoundary);
+uint8_t SimEzi2cStart(uint8_t read);
+uint8_t SimEzi2cRead(void);
+void SimEzi2cWrite(uint8_t data);
+
+
+/***************************************
+* External data references
+***************************************/
+extern uint64_t simNow;             /* Virtual time, us */
+extern SIM_EZI2C_T simEzi2c;
+
+#endif /* SIM_H */
+
+
+/* [] END OF FILE */
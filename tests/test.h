@@ -0,0 +1,65 @@
+/*******************************************************************************
+* File Name: test.h
+*
+* Version 1.0
+*
+* Description:
+*  Minimal assertion helpers of the host tests. Every test program counts
+*  its failed checks and returns non-zero from main() when any failed.
+*
+*******************************************************************************/
+
+#if !defined(TEST_H)
+#define TEST_H
+
+#include <stdio.h>
+
+
+/***************************************
+*        External data references
+***************************************/
+extern unsigned int testChecks;
+extern unsigned int testFailures;
+
+
+/***************************************
+*        Macros
+***************************************/
+/* Defines the counters, once per test program */
+#define TEST_COUNTERS               unsigned int testChecks = 0u; unsigned int testFailures = 0u
+
+#define TEST_CHECK(condition) \
+    do { \
+        testChecks++; \
+        if(!(condition)) \
+        { \
+            testFailures++; \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+        } \
+    } while(0)
+
+#define TEST_CHECK_EQUAL(expected, actual) \
+    do { \
+        long testExpected = (long)(expected); \
+        long testActual = (long)(actual); \
+        testChecks++; \
+        if(testExpected != testActual) \
+        { \
+            testFailures++; \
+            printf("%s:%d: %s is %ld, expected %ld\n", __FILE__, __LINE__, #actual, testActual, testExpected); \
+        } \
+    } while(0)
+
+#define TEST_RUN(test) \
+    do { \
+        unsigned int testFailed = testFailures; \
+        test(); \
+        printf("%-48s %s\n", #test, (testFailed == testFailures) ? "ok" : "FAILED"); \
+    } while(0)
+
+#define TEST_RESULT()               ((testFailures == 0u) ? 0 : 1)
+
+#endif /* TEST_H */
+
+
+/* [] END OF FILE */
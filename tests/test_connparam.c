@@ -0,0 +1,225 @@
+/*******************************************************************************
+* File Name: test_connparam.c
+*
+* Version 1.0
+*
+* Description:
+*  Host tests of the connection parameter policy. The tests drive
+*  ConnParamUpdate() once per timer tick, as the mailbox reads do, and play
+*  the central with the L2CAP response and the update complete event.
+*
+*******************************************************************************/
+
+#include "common.h"
+#include "connparam.h"
+#include "power.h"
+#include "test.h"
+
+TEST_COUNTERS;
+
+
+static void Connect(void)
+{
+    FakeBleReset();
+    ConnParamInit();
+}
+
+static void Tick(uint8 approach)
+{
+    timerTicks++;
+    ConnParamUpdate(approach);
+}
+
+static void Respond(void)
+{
+    ConnParamEventHandler(CYBLE_EVT_L2CAP_CONN_PARAM_UPDATE_RSP, NULL);
+}
+
+static void Complete(uint8 status, uint16 interval)
+{
+    CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T updated;
+
+    updated.status = status;
+    updated.connIntv = interval;
+    updated.connLatency = 0u;
+    updated.supervisionTO = CONN_FAST_TIMEOUT;
+    ConnParamEventHandler(CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE, &updated);
+}
+
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+static void TestApproachRequestsFastInterval(void)
+{
+    Connect();
+    Tick(0u);
+    TEST_CHECK_EQUAL(1u, fakeConnParamRequests);
+    TEST_CHECK_EQUAL(CONN_SLOW_INTERVAL_MAX, fakeConnParam.connIntvMax);
+    Respond();
+    Tick(0u);
+    TEST_CHECK_EQUAL(1u, fakeConnParamRequests);
+
+    Tick(1u);
+    TEST_CHECK_EQUAL(2u, fakeConnParamRequests);
+    TEST_CHECK_EQUAL(CONN_FAST_INTERVAL_MIN, fakeConnParam.connIntvMin);
+    TEST_CHECK_EQUAL(CONN_FAST_INTERVAL_MAX, fakeConnParam.connIntvMax);
+    TEST_CHECK_EQUAL(CONN_FAST_LATENCY, fakeConnParam.connLatency);
+}
+
+/* One request at a time; a change during a request is sent after the response */
+static void TestOneRequestOutstanding(void)
+{
+    Connect();
+    Tick(1u);
+    TEST_CHECK_EQUAL(1u, fakeConnParamRequests);
+    Tick(0u);
+    Tick(0u);
+    TEST_CHECK_EQUAL(1u, fakeConnParamRequests);
+    Respond();
+    Tick(0u);
+    TEST_CHECK_EQUAL(2u, fakeConnParamRequests);
+    TEST_CHECK_EQUAL(CONN_SLOW_INTERVAL_MAX, fakeConnParam.connIntvMax);
+}
+
+/* A central that never answers must not block the policy for the connection */
+static void TestStuckPendingTimesOut(void)
+{
+    uint32 tick;
+
+    Connect();
+    Tick(1u);
+    TEST_CHECK_EQUAL(1u, fakeConnParamRequests);
+    for(tick = 1u; tick < CONN_PARAM_RESPONSE_TIMEOUT; tick++)
+    {
+        Tick(0u);
+    }
+    TEST_CHECK_EQUAL(1u, fakeConnParamRequests);
+    Tick(0u);
+    TEST_CHECK_EQUAL(2u, fakeConnParamRequests);
+    TEST_CHECK_EQUAL(CONN_SLOW_INTERVAL_MAX, fakeConnParam.connIntvMax);
+}
+
+/* The timeout also works across the wrap of the tick counter */
+static void TestTimeoutAcrossTickWrap(void)
+{
+    uint32 tick;
+
+    Connect();
+    timerTicks = 0xFFFFFFFFu - 10u;
+    Tick(1u);
+    for(tick = 0u; tick < CONN_PARAM_RESPONSE_TIMEOUT; tick++)
+    {
+        Tick(0u);
+    }
+    TEST_CHECK_EQUAL(2u, fakeConnParamRequests);
+}
+
+/* A rejected request is not repeated until the state changes */
+static void TestRejectedRequestNotRepeated(void)
+{
+    uint32 tick;
+
+    Connect();
+    Tick(1u);
+    Respond();
+    for(tick = 0u; tick < (2u * CONN_PARAM_RESPONSE_TIMEOUT); tick++)
+    {
+        Tick(1u);
+    }
+    TEST_CHECK_EQUAL(1u, fakeConnParamRequests);
+    TEST_CHECK_EQUAL(CONN_PARAM_NONE, connParamActive);
+}
+
+/* A request the stack could not send is tried again on the next update */
+static void TestFailedRequestRetried(void)
+{
+    Connect();
+    fakeConnParamResult = CYBLE_ERROR_INVALID_OPERATION;
+    Tick(1u);
+    TEST_CHECK_EQUAL(1u, fakeConnParamRequests);
+    fakeConnParamResult = CYBLE_ERROR_OK;
+    Tick(1u);
+    TEST_CHECK_EQUAL(2u, fakeConnParamRequests);
+    Tick(1u);
+    TEST_CHECK_EQUAL(2u, fakeConnParamRequests);
+}
+
+/* Only the update complete event sets the parameters in use */
+static void TestUpdateCompleteRecordsActive(void)
+{
+    Connect();
+    Tick(1u);
+    Respond();
+    TEST_CHECK_EQUAL(CONN_PARAM_NONE, connParamActive);
+    Complete(0u, CONN_FAST_INTERVAL_MAX);
+    TEST_CHECK_EQUAL(CONN_PARAM_FAST, connParamActive);
+    Complete(1u, CONN_SLOW_INTERVAL_MAX);
+    TEST_CHECK_EQUAL(CONN_PARAM_FAST, connParamActive);
+    Complete(0u, CONN_SLOW_INTERVAL_MIN);
+    TEST_CHECK_EQUAL(CONN_PARAM_SLOW, connParamActive);
+
+    ConnParamEventHandler(CYBLE_EVT_GAP_DEVICE_DISCONNECTED, NULL);
+    TEST_CHECK_EQUAL(CONN_PARAM_NONE, connParamActive);
+}
+
+/* Approach and touch timeline at 100 ms ticks: the hand is reported 300 ms
+*  before the touch, the central answers on the next tick and switches the
+*  interval two ticks later. The fast interval must be in use at the touch. */
+static void TestApproachTimeline(void)
+{
+    uint32 tick;
+    uint32 requestTick = 0u;
+    uint32 fastTick = 0u;
+    uint32 requests;
+
+    Connect();
+    Tick(0u);
+    Respond();
+    Complete(0u, CONN_SLOW_INTERVAL_MAX);
+    for(tick = 1u; tick <= 25u; tick++)
+    {
+        requests = fakeConnParamRequests;
+        Tick((uint8)((tick >= 10u) && (tick < 18u)));
+        if(fakeConnParamRequests != requests)
+        {
+            requestTick = tick;
+        }
+        if((requestTick != 0u) && (tick == (requestTick + 1u)))
+        {
+            Respond();
+        }
+        if((requestTick != 0u) && (tick == (requestTick + 3u)))
+        {
+            Complete(0u, fakeConnParam.connIntvMax);
+        }
+        if((fastTick == 0u) && (connParamActive == CONN_PARAM_FAST))
+        {
+            fastTick = tick;
+        }
+        if(tick == 13u)
+        {
+            /* Touch down */
+            TEST_CHECK_EQUAL(CONN_PARAM_FAST, connParamActive);
+        }
+    }
+    TEST_CHECK_EQUAL(10u, fastTick - 3u);
+    TEST_CHECK_EQUAL(CONN_PARAM_SLOW, connParamActive);
+}
+
+
+int main(void)
+{
+    TEST_RUN(TestApproachRequestsFastInterval);
+    TEST_RUN(TestOneRequestOutstanding);
+    TEST_RUN(TestStuckPendingTimesOut);
+    TEST_RUN(TestTimeoutAcrossTickWrap);
+    TEST_RUN(TestRejectedRequestNotRepeated);
+    TEST_RUN(TestFailedRequestRetried);
+    TEST_RUN(TestUpdateCompleteRecordsActive);
+    TEST_RUN(TestApproachTimeline);
+    return (TEST_RESULT());
+}
+
+
+/* [] END OF FILE */
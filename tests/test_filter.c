@@ -0,0 +1,212 @@
+/*******************************************************************************
+* File Name: test_filter.c
+*
+* Version 1.0
+*
+* Description:
+*  Host tests of the adaptive touch filter: first-touch latency and release
+*  of both profiles, the noise estimate that must not follow an approaching
+*  finger, and false touches and latency on synthetic noisy traces.
+*
+*******************************************************************************/
+
+#include "project.h"
+#include "filter.h"
+#include "test.h"
+
+#define FINGER_TH                   (100u)
+#define TOUCH_LEVEL                 (160u)      /* Difference count of a finger */
+#define NOISE_SAMPLES               (20000u)
+#define LATENCY_MAX                 (16u)
+
+TEST_COUNTERS;
+
+static uint32 noiseSeed;
+
+
+/* Uniform pseudo random noise in -amplitude..amplitude around the baseline,
+*  clipped at zero as the difference counts are */
+static uint16 Noise(uint16 amplitude)
+{
+    int32 noise;
+
+    noiseSeed = (noiseSeed * 1103515245u) + 12345u;
+    noise = (int32)((noiseSeed >> 16u) % ((2u * amplitude) + 1u)) - (int32)amplitude;
+    return ((noise > 0) ? (uint16)noise : 0u);
+}
+
+/* Samples from the first touch sample until the channel reports the touch */
+static uint32 TouchLatency(FILTER_CHANNEL_T *channel, uint16 amplitude)
+{
+    uint32 samples = 0u;
+
+    while(samples < LATENCY_MAX)
+    {
+        samples++;
+        if(Filter_Process(channel, TOUCH_LEVEL + Noise(amplitude), FINGER_TH) != 0u)
+        {
+            break;
+        }
+    }
+    return (samples);
+}
+
+/* Released samples with noise of the given amplitude, returns the touches seen */
+static uint32 RunNoise(FILTER_CHANNEL_T *channel, uint16 amplitude, uint32 count)
+{
+    uint32 touches = 0u;
+    uint8 touched = 0u;
+    uint8 state;
+
+    while(count-- != 0u)
+    {
+        state = Filter_Process(channel, Noise(amplitude), FINGER_TH);
+        if((state != 0u) && (touched == 0u))
+        {
+            touches++;
+        }
+        touched = state;
+    }
+    return (touches);
+}
+
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+static void TestFirstTouchLatency(void)
+{
+    FILTER_CHANNEL_T channel;
+
+    Filter_SetProfile(FILTER_PROFILE_LOW_LATENCY);
+    Filter_InitChannel(&channel);
+    TEST_CHECK_EQUAL(0u, RunNoise(&channel, 0u, 10u));
+    TEST_CHECK_EQUAL(1u, TouchLatency(&channel, 0u));
+
+    /* One sample for the median and one for the slower attack */
+    Filter_SetProfile(FILTER_PROFILE_HIGH_NOISE);
+    Filter_InitChannel(&channel);
+    TEST_CHECK_EQUAL(0u, RunNoise(&channel, 0u, 10u));
+    TEST_CHECK_EQUAL(3u, TouchLatency(&channel, 0u));
+}
+
+/* A single spike passes the low latency profile but not the median */
+static void TestSpike(void)
+{
+    FILTER_CHANNEL_T channel;
+
+    Filter_SetProfile(FILTER_PROFILE_HIGH_NOISE);
+    Filter_InitChannel(&channel);
+    TEST_CHECK_EQUAL(0u, Filter_Process(&channel, 0u, FINGER_TH));
+    TEST_CHECK_EQUAL(0u, Filter_Process(&channel, 0u, FINGER_TH));
+    TEST_CHECK_EQUAL(0u, Filter_Process(&channel, 400u, FINGER_TH));
+    TEST_CHECK_EQUAL(0u, Filter_Process(&channel, 0u, FINGER_TH));
+
+    Filter_SetProfile(FILTER_PROFILE_LOW_LATENCY);
+    Filter_InitChannel(&channel);
+    TEST_CHECK_EQUAL(0u, Filter_Process(&channel, 0u, FINGER_TH));
+    TEST_CHECK_EQUAL(1u, Filter_Process(&channel, 400u, FINGER_TH));
+}
+
+/* Release at 3/4 of the touch threshold, after the release filter settles */
+static void TestReleaseHysteresis(void)
+{
+    FILTER_CHANNEL_T channel;
+    uint32 samples;
+
+    Filter_SetProfile(FILTER_PROFILE_LOW_LATENCY);
+    Filter_InitChannel(&channel);
+    TEST_CHECK_EQUAL(1u, TouchLatency(&channel, 0u));
+    for(samples = 0u; samples < 20u; samples++)
+    {
+        TEST_CHECK_EQUAL(1u, Filter_Process(&channel, (FINGER_TH * 3u) / 4u, FINGER_TH));
+    }
+    for(samples = 0u; samples < 20u; samples++)
+    {
+        if(Filter_Process(&channel, 0u, FINGER_TH) == 0u)
+        {
+            break;
+        }
+    }
+    TEST_CHECK(samples < 4u);
+}
+
+/* A finger hovering below the threshold must not raise the noise estimate,
+*  or the touch that follows is missed in the high noise profile */
+static void TestNoiseFrozenDuringApproach(void)
+{
+    FILTER_CHANNEL_T channel;
+    int32 quietNoise;
+    uint32 sample;
+
+    Filter_SetProfile(FILTER_PROFILE_HIGH_NOISE);
+    Filter_InitChannel(&channel);
+    noiseSeed = 1u;
+    TEST_CHECK_EQUAL(0u, RunNoise(&channel, 6u, 200u));
+    quietNoise = channel.noise;
+
+    /* Slow approach to 90 % of the threshold, then a jittery hover */
+    for(sample = 0u; sample < 90u; sample++)
+    {
+        TEST_CHECK_EQUAL(0u, Filter_Process(&channel, (uint16)sample, FINGER_TH));
+    }
+    for(sample = 0u; sample < 200u; sample++)
+    {
+        TEST_CHECK_EQUAL(0u, Filter_Process(&channel, (uint16)(70u + Noise(20u)), FINGER_TH));
+    }
+    TEST_CHECK(channel.noise <= quietNoise);
+
+    /* A touch just above the threshold plus the quiet noise margin */
+    TEST_CHECK(TouchLatency(&channel, 0u) <= 3u);
+}
+
+/* False touches and first-touch latency against noise amplitude, printed as
+*  a table. Both profiles are clean up to 90 % of the finger threshold; the
+*  high noise profile stays clean at 150 %, where the low latency one fails. */
+static void TestNoisyTraces(void)
+{
+    static const uint16 amplitudes[] = {0u, 60u, 90u, 120u, 150u, 200u};
+    FILTER_CHANNEL_T channel;
+    uint32 falseTouches[FILTER_PROFILE_COUNT][sizeof(amplitudes) / sizeof(amplitudes[0u])];
+    uint32 latency;
+    uint8 profile;
+    uint8 amplitude;
+
+    printf("  amplitude  profile  false touches  latency\n");
+    for(amplitude = 0u; amplitude < (sizeof(amplitudes) / sizeof(amplitudes[0u])); amplitude++)
+    {
+        for(profile = 0u; profile < FILTER_PROFILE_COUNT; profile++)
+        {
+            Filter_SetProfile(profile);
+            Filter_InitChannel(&channel);
+            noiseSeed = 12345u;
+            falseTouches[profile][amplitude] = RunNoise(&channel, amplitudes[amplitude], NOISE_SAMPLES);
+            (void)RunNoise(&channel, 0u, 20u);
+            latency = TouchLatency(&channel, amplitudes[amplitude] / 2u);
+            printf("  %9u  %7u  %13lu  %7lu\n", amplitudes[amplitude], profile,
+                   (unsigned long)falseTouches[profile][amplitude], (unsigned long)latency);
+            TEST_CHECK(latency < LATENCY_MAX);
+        }
+    }
+    for(amplitude = 0u; amplitude <= 2u; amplitude++)
+    {
+        TEST_CHECK_EQUAL(0u, falseTouches[FILTER_PROFILE_LOW_LATENCY][amplitude]);
+        TEST_CHECK_EQUAL(0u, falseTouches[FILTER_PROFILE_HIGH_NOISE][amplitude]);
+    }
+    TEST_CHECK_EQUAL(0u, falseTouches[FILTER_PROFILE_HIGH_NOISE][4u]);
+    TEST_CHECK(falseTouches[FILTER_PROFILE_LOW_LATENCY][4u] != 0u);
+}
+
+
+int main(void)
+{
+    TEST_RUN(TestFirstTouchLatency);
+    TEST_RUN(TestSpike);
+    TEST_RUN(TestReleaseHysteresis);
+    TEST_RUN(TestNoiseFrozenDuringApproach);
+    TEST_RUN(TestNoisyTraces);
+    return (TEST_RESULT());
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,237 @@
+/*******************************************************************************
+* File Name: test_gesture.c
+*
+* Version 1.0
+*
+* Description:
+*  Host tests of the slider gesture engine. Each test replays a slider
+*  trace, one centroid sample per scan, and compares the reported events
+*  and the time they were reported with the expected ones.
+*
+*******************************************************************************/
+
+#include "project.h"
+#include "gesture.h"
+#include "test.h"
+
+#define NO_TOUCH                    CapSense_SLIDER_NO_TOUCH
+#define TRACE_END                   (0xFFFFFFFFu)
+#define EVENTS_MAX                  (8u)
+
+typedef struct
+{
+    uint32 time;            /* Milliseconds, TRACE_END ends the trace */
+    uint16 position;        /* Centroid or NO_TOUCH, held until the next entry */
+} TRACE_T;
+
+typedef struct
+{
+    uint32 time;
+    uint8 type;
+    uint8 param;
+} EVENT_T;
+
+TEST_COUNTERS;
+
+static EVENT_T events[EVENTS_MAX];
+static unsigned int eventCount;
+
+
+/* Replays a trace sampled every period milliseconds from base on and
+*  records the events. Trace times are relative to base. */
+static void Replay(const TRACE_T trace[], uint32 period, uint32 base)
+{
+    GESTURE_EVENT_T event;
+    uint32 time;
+    unsigned int entry = 0u;
+
+    Gesture_Init();
+    eventCount = 0u;
+    for(time = trace[0u].time; trace[entry + 1u].time != TRACE_END; time += period)
+    {
+        while((trace[entry + 1u].time != TRACE_END) && (time >= trace[entry + 1u].time))
+        {
+            entry++;
+        }
+        if(trace[entry + 1u].time == TRACE_END)
+        {
+            break;
+        }
+        if((Gesture_Process(trace[entry].position, base + time, &event) != 0u) && (eventCount < EVENTS_MAX))
+        {
+            events[eventCount].time = time;
+            events[eventCount].type = event.type;
+            events[eventCount].param = event.param;
+            eventCount++;
+        }
+    }
+}
+
+static void CheckEvent(unsigned int index, uint32 time, uint8 type, uint8 param)
+{
+    TEST_CHECK(index < eventCount);
+    if(index < eventCount)
+    {
+        TEST_CHECK_EQUAL(time, events[index].time);
+        TEST_CHECK_EQUAL(type, events[index].type);
+        TEST_CHECK_EQUAL(param, events[index].param);
+    }
+}
+
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+/* A tap is reported once the double tap gap has passed without a second touch */
+static void TestTapAfterGap(void)
+{
+    static const TRACE_T trace[] =
+    {
+        {0u, NO_TOUCH}, {100u, 60u}, {200u, NO_TOUCH}, {1000u, NO_TOUCH}, {TRACE_END, 0u}
+    };
+
+    Replay(trace, 10u, 0u);
+    TEST_CHECK_EQUAL(1u, eventCount);
+    CheckEvent(0u, 200u + GESTURE_DOUBLE_TAP_GAP + 10u, GESTURE_TAP, 60u);
+}
+
+/* A touch held longer than a tap but released before the long press is no gesture */
+static void TestSlowTouchIsIgnored(void)
+{
+    static const TRACE_T trace[] =
+    {
+        {0u, NO_TOUCH}, {100u, 60u}, {500u, NO_TOUCH}, {1200u, NO_TOUCH}, {TRACE_END, 0u}
+    };
+
+    Replay(trace, 10u, 0u);
+    TEST_CHECK_EQUAL(0u, eventCount);
+}
+
+/* The double tap is reported on the second touch down, not on its release */
+static void TestDoubleTap(void)
+{
+    static const TRACE_T trace[] =
+    {
+        {0u, NO_TOUCH}, {100u, 60u}, {200u, NO_TOUCH}, {300u, 70u}, {400u, NO_TOUCH},
+        {1200u, NO_TOUCH}, {TRACE_END, 0u}
+    };
+
+    Replay(trace, 10u, 0u);
+    TEST_CHECK_EQUAL(1u, eventCount);
+    CheckEvent(0u, 300u, GESTURE_DOUBLE_TAP, 60u);
+}
+
+/* A second touch far from the first tap is a new touch, not a double tap */
+static void TestDoubleTapTooFar(void)
+{
+    static const TRACE_T trace[] =
+    {
+        {0u, NO_TOUCH}, {100u, 20u}, {200u, NO_TOUCH}, {300u, 20u + GESTURE_DOUBLE_TAP_MAX_MOVE + 1u},
+        {400u, NO_TOUCH}, {1200u, NO_TOUCH}, {TRACE_END, 0u}
+    };
+
+    Replay(trace, 10u, 0u);
+    TEST_CHECK_EQUAL(2u, eventCount);
+    CheckEvent(0u, 300u, GESTURE_TAP, 20u);
+    CheckEvent(1u, 400u + GESTURE_DOUBLE_TAP_GAP + 10u, GESTURE_TAP, 20u + GESTURE_DOUBLE_TAP_MAX_MOVE + 1u);
+}
+
+/* A slow scan tier delivers the second touch after the gap without a release
+*  frame in between: the first tap is reported and the touch starts anew */
+static void TestSecondTouchAfterGap(void)
+{
+    static const TRACE_T trace[] =
+    {
+        {0u, NO_TOUCH}, {100u, 60u}, {200u, NO_TOUCH}, {500u, 60u}, {1300u, NO_TOUCH},
+        {1400u, NO_TOUCH}, {TRACE_END, 0u}
+    };
+
+    /* 50 ms samples: the release at 200 ms is seen once, the next frame is
+    *  a touch 300 ms later */
+    Replay(trace, 50u, 0u);
+    TEST_CHECK_EQUAL(2u, eventCount);
+    CheckEvent(0u, 500u, GESTURE_TAP, 60u);
+    CheckEvent(1u, 500u + GESTURE_LONG_PRESS_TIME, GESTURE_LONG_PRESS, 60u);
+}
+
+/* A long press is reported as soon as the hold time is reached */
+static void TestLongPress(void)
+{
+    static const TRACE_T trace[] =
+    {
+        {0u, NO_TOUCH}, {100u, 80u}, {400u, 83u}, {1000u, NO_TOUCH}, {1500u, NO_TOUCH},
+        {TRACE_END, 0u}
+    };
+
+    Replay(trace, 10u, 0u);
+    TEST_CHECK_EQUAL(1u, eventCount);
+    CheckEvent(0u, 100u + GESTURE_LONG_PRESS_TIME, GESTURE_LONG_PRESS, 80u);
+}
+
+/* A swipe is reported once the filtered travel is reached, with its speed */
+static void TestSwipes(void)
+{
+    static const TRACE_T right[] =
+    {
+        {0u, NO_TOUCH}, {100u, 10u}, {110u, 15u}, {120u, 20u}, {130u, 25u}, {140u, 30u},
+        {150u, 35u}, {160u, 40u}, {170u, 45u}, {180u, NO_TOUCH}, {800u, NO_TOUCH}, {TRACE_END, 0u}
+    };
+    static const TRACE_T left[] =
+    {
+        {0u, NO_TOUCH}, {100u, 90u}, {110u, 80u}, {120u, 70u}, {130u, 60u}, {140u, NO_TOUCH},
+        {800u, NO_TOUCH}, {TRACE_END, 0u}
+    };
+
+    Replay(right, 10u, 0u);
+    TEST_CHECK_EQUAL(1u, eventCount);
+    TEST_CHECK_EQUAL(GESTURE_SWIPE_RIGHT, events[0u].type);
+    TEST_CHECK(events[0u].time <= 160u);
+    /* 5 units per 10 ms, 50 per 100 ms, less the lag of the position filter */
+    TEST_CHECK((events[0u].param >= 30u) && (events[0u].param <= 50u));
+
+    Replay(left, 10u, 0u);
+    TEST_CHECK_EQUAL(1u, eventCount);
+    TEST_CHECK_EQUAL(GESTURE_SWIPE_LEFT, events[0u].type);
+    TEST_CHECK(events[0u].time <= 130u);
+    /* 10 units per 10 ms, less the lag of the position filter */
+    TEST_CHECK((events[0u].param >= 60u) && (events[0u].param <= 100u));
+}
+
+/* The timestamp wraps during a double tap and a long press */
+static void TestTimestampWrap(void)
+{
+    static const TRACE_T doubleTap[] =
+    {
+        {0u, NO_TOUCH}, {100u, 60u}, {200u, NO_TOUCH}, {300u, 60u}, {400u, NO_TOUCH},
+        {1000u, NO_TOUCH}, {TRACE_END, 0u}
+    };
+    static const TRACE_T longPress[] =
+    {
+        {0u, NO_TOUCH}, {100u, 40u}, {1000u, NO_TOUCH}, {1500u, NO_TOUCH}, {TRACE_END, 0u}
+    };
+
+    Replay(doubleTap, 10u, 0xFFFFFFFFu - 250u);
+    TEST_CHECK_EQUAL(1u, eventCount);
+    CheckEvent(0u, 300u, GESTURE_DOUBLE_TAP, 60u);
+
+    Replay(longPress, 10u, 0xFFFFFFFFu - 300u);
+    TEST_CHECK_EQUAL(1u, eventCount);
+    CheckEvent(0u, 100u + GESTURE_LONG_PRESS_TIME, GESTURE_LONG_PRESS, 40u);
+}
+
+
+int main(void)
+{
+    TEST_RUN(TestTapAfterGap);
+    TEST_RUN(TestSlowTouchIsIgnored);
+    TEST_RUN(TestDoubleTap);
+    TEST_RUN(TestDoubleTapTooFar);
+    TEST_RUN(TestSecondTouchAfterGap);
+    TEST_RUN(TestLongPress);
+    TEST_RUN(TestSwipes);
+    TEST_RUN(TestTimestampWrap);
+    return (TEST_RESULT());
+}
+
+
+/* [] END OF FILE */
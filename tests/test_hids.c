@@ -0,0 +1,210 @@
+/*******************************************************************************
+* File Name: test_hids.c
+*
+* Version 1.0
+*
+* Description:
+*  Host tests of the keyboard input report: HidsEncodeKeyboard() with 0 to
+*  7 keys and without a key list, and the report map items generated from
+*  HID_KEYBOARD_REPORT, which must read back what the encoder wrote.
+*
+*******************************************************************************/
+
+#include <string.h>
+#include "common.h"
+#include "hids.h"
+#include "test.h"
+
+#define REPORT_MAP_FIELDS           (3u)
+
+TEST_COUNTERS;
+
+/* Input items of the report, as a host builds them */
+static const uint8 reportMap[] =
+{
+    0x05u, 0x07u,           /* Usage Page (Keyboard) */
+    HID_KEYBOARD_REPORT(HID_REPORT_FIELD_ITEMS)
+};
+
+static const uint8 keyList[HID_KEYBOARD_KEYCODES_SIZE + 1u] = {0x04u, 0x05u, 0x06u, 0x07u, 0x08u, 0x09u, 0x0Au};
+
+/* A field of the report as the report map describes it */
+typedef struct
+{
+    uint8 bits;
+    uint8 count;
+    uint8 input;
+    uint8 values[HID_KEYBOARD_KEYCODES_SIZE];
+} FIELD_T;
+
+
+/* Reads count bits at bit position from a report, least significant first */
+static uint8 Bits(const uint8 report[], uint32 position, uint8 count)
+{
+    uint8 value = 0u;
+    uint8 bit;
+
+    for(bit = 0u; bit < count; bit++)
+    {
+        value |= (uint8)(((report[(position + bit) / 8u] >> ((position + bit) % 8u)) & 1u) << bit);
+    }
+    return (value);
+}
+
+/* Splits a report into the fields of the Input items of reportMap, the way
+*  a HID parser does. Returns the number of report bits described. */
+static uint32 Parse(const uint8 report[], FIELD_T fields[])
+{
+    uint32 position = 0u;
+    uint32 index;
+    uint8 field = 0u;
+    uint8 bits = 0u;
+    uint8 count = 0u;
+    uint8 element;
+
+    (void)memset(fields, 0, REPORT_MAP_FIELDS * sizeof(FIELD_T));
+    for(index = 0u; (index + 1u) < sizeof(reportMap); index += 2u)
+    {
+        switch(reportMap[index])
+        {
+            case 0x75u:
+                bits = reportMap[index + 1u];
+                break;
+
+            case 0x95u:
+                count = reportMap[index + 1u];
+                break;
+
+            case 0x81u:
+                fields[field].bits = bits;
+                fields[field].count = count;
+                fields[field].input = reportMap[index + 1u];
+                for(element = 0u; element < count; element++)
+                {
+                    /* Single bit elements are packed into one value */
+                    if(bits == 1u)
+                    {
+                        fields[field].values[0u] |= (uint8)(Bits(report, position, 1u) << element);
+                    }
+                    else
+                    {
+                        fields[field].values[element] = Bits(report, position, bits);
+                    }
+                    position += bits;
+                }
+                field++;
+                break;
+
+            default:
+                break;
+        }
+    }
+    return (position);
+}
+
+/* A report with every byte set, to see what the encoder clears */
+static void Fill(uint8 report[])
+{
+    (void)memset(report, 0xFF, KEYBOARD_DATA_SIZE);
+}
+
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+/* The modifier bits go to their byte unchanged, the reserved byte is cleared */
+static void TestModifiers(void)
+{
+    uint8 report[KEYBOARD_DATA_SIZE];
+
+    Fill(report);
+    HidsEncodeKeyboard(report, 0xA5u, NULL, 0u);
+    TEST_CHECK_EQUAL(0xA5u, report[HID_KEYBOARD_MODIFIERS_OFFSET]);
+    TEST_CHECK_EQUAL(0u, report[HID_KEYBOARD_RESERVED_OFFSET]);
+    HidsEncodeKeyboard(report, 0u, keyList, 1u);
+    TEST_CHECK_EQUAL(0u, report[HID_KEYBOARD_MODIFIERS_OFFSET]);
+}
+
+/* 0 to 6 keys fill the slots in order, the rest are empty */
+static void TestKeyCounts(void)
+{
+    uint8 report[KEYBOARD_DATA_SIZE];
+    uint8 count;
+    uint8 slot;
+
+    for(count = 0u; count <= HID_KEYBOARD_KEYCODES_SIZE; count++)
+    {
+        Fill(report);
+        HidsEncodeKeyboard(report, 0u, keyList, count);
+        for(slot = 0u; slot < HID_KEYBOARD_KEYCODES_SIZE; slot++)
+        {
+            TEST_CHECK_EQUAL((slot < count) ? keyList[slot] : 0u, report[HID_KEYBOARD_KEYCODES_OFFSET + slot]);
+        }
+    }
+}
+
+/* More keys than slots: every slot reports ErrorRollOver, the modifiers stay */
+static void TestRollover(void)
+{
+    uint8 report[KEYBOARD_DATA_SIZE];
+    uint8 slot;
+
+    Fill(report);
+    HidsEncodeKeyboard(report, 0x02u, keyList, HID_KEYBOARD_KEYCODES_SIZE + 1u);
+    TEST_CHECK_EQUAL(0x02u, report[HID_KEYBOARD_MODIFIERS_OFFSET]);
+    for(slot = 0u; slot < HID_KEYBOARD_KEYCODES_SIZE; slot++)
+    {
+        TEST_CHECK_EQUAL(KEY_ERROR_ROLL_OVER, report[HID_KEYBOARD_KEYCODES_OFFSET + slot]);
+    }
+}
+
+/* No key list is a release of all keys, whatever the count */
+static void TestNullKeys(void)
+{
+    static const uint8 released[KEYBOARD_DATA_SIZE] = {0u};
+    uint8 report[KEYBOARD_DATA_SIZE];
+
+    Fill(report);
+    HidsEncodeKeyboard(report, 0u, NULL, 0u);
+    TEST_CHECK(memcmp(report, released, KEYBOARD_DATA_SIZE) == 0);
+    Fill(report);
+    HidsEncodeKeyboard(report, 0u, NULL, 3u);
+    TEST_CHECK(memcmp(report, released, KEYBOARD_DATA_SIZE) == 0);
+}
+
+/* The report map covers the report and reads the encoded fields back */
+static void TestReportMap(void)
+{
+    FIELD_T fields[REPORT_MAP_FIELDS];
+    uint8 report[KEYBOARD_DATA_SIZE];
+    uint8 slot;
+
+    HidsEncodeKeyboard(report, 0x81u, keyList, 4u);
+    TEST_CHECK_EQUAL(KEYBOARD_DATA_SIZE * 8u, Parse(report, fields));
+
+    TEST_CHECK_EQUAL(HID_INPUT_DATA_VARIABLE, fields[0u].input);
+    TEST_CHECK_EQUAL(8u, fields[0u].count);
+    TEST_CHECK_EQUAL(0x81u, fields[0u].values[0u]);
+    TEST_CHECK_EQUAL(HID_INPUT_CONSTANT, fields[1u].input);
+    TEST_CHECK_EQUAL(HID_INPUT_DATA_ARRAY, fields[2u].input);
+    TEST_CHECK_EQUAL(HID_KEYBOARD_KEYCODES_SIZE, fields[2u].count);
+    for(slot = 0u; slot < HID_KEYBOARD_KEYCODES_SIZE; slot++)
+    {
+        TEST_CHECK_EQUAL((slot < 4u) ? keyList[slot] : 0u, fields[2u].values[slot]);
+    }
+}
+
+
+int main(void)
+{
+    TEST_RUN(TestModifiers);
+    TEST_RUN(TestKeyCounts);
+    TEST_RUN(TestRollover);
+    TEST_RUN(TestNullKeys);
+    TEST_RUN(TestReportMap);
+    printf("%u checks, %u failed\n", testChecks, testFailures);
+    return (TEST_RESULT());
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,164 @@
+/*******************************************************************************
+* File Name: test_host.c
+*
+* Version 1.0
+*
+* Description:
+*  Host tests of the host selection: the slider zones of the host slots,
+*  the switch to a bonded host by directed advertising, and the time to the
+*  first report, which is only measured when the selected host answered.
+*
+*******************************************************************************/
+
+#include <string.h>
+#include "common.h"
+#include "host.h"
+#include "test.h"
+
+TEST_COUNTERS;
+
+
+/* Bonds count hosts, host n has every address byte set to n + 1 */
+static void Bond(uint8 count)
+{
+    uint8 slot;
+
+    fakeBondedList.count = count;
+    for(slot = 0u; slot < count; slot++)
+    {
+        (void)memset(fakeBondedList.bdAddrList[slot].bdAddr, slot + 1u, CYBLE_GAP_BD_ADDR_SIZE);
+        fakeBondedList.bdAddrList[slot].type = 0u;
+    }
+}
+
+/* Connected to the host of a slot */
+static void Connect(uint8 slot)
+{
+    fakeState = CYBLE_STATE_CONNECTED;
+    fakePeerAddr = fakeBondedList.bdAddrList[slot];
+    HostConnected();
+}
+
+/* Clears a pending switch and measurement left by an earlier test */
+static void Reset(void)
+{
+    FakeBleReset();
+    (void)HostStartAdvertisement();
+    HostConnected();
+    FakeBleReset();
+}
+
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+/* Positions 0 to 100 split into three zones, anything above is off the slider */
+static void TestSlotEdges(void)
+{
+    TEST_CHECK_EQUAL(0u, HostSlot(0u, HOST_SLOT_COUNT));
+    TEST_CHECK_EQUAL(0u, HostSlot(33u, HOST_SLOT_COUNT));
+    TEST_CHECK_EQUAL(1u, HostSlot(34u, HOST_SLOT_COUNT));
+    TEST_CHECK_EQUAL(1u, HostSlot(67u, HOST_SLOT_COUNT));
+    TEST_CHECK_EQUAL(2u, HostSlot(68u, HOST_SLOT_COUNT));
+    TEST_CHECK_EQUAL(2u, HostSlot(HOST_SLIDER_RESOLUTION, HOST_SLOT_COUNT));
+    TEST_CHECK_EQUAL(HOST_SLOT_NONE, HostSlot(HOST_SLIDER_RESOLUTION + 1u, HOST_SLOT_COUNT));
+    TEST_CHECK_EQUAL(HOST_SLOT_NONE, HostSlot(0xFFu, HOST_SLOT_COUNT));
+}
+
+/* More bonds than slots do not add slots */
+static void TestMoreBondsThanSlots(void)
+{
+    TEST_CHECK_EQUAL(2u, HostSlot(HOST_SLIDER_RESOLUTION, CYBLE_GAP_MAX_BONDED_DEVICE));
+}
+
+/* The zones keep their place with fewer bonds, the ones past the list are empty */
+static void TestShortBondList(void)
+{
+    TEST_CHECK_EQUAL(HOST_SLOT_NONE, HostSlot(0u, 0u));
+    TEST_CHECK_EQUAL(0u, HostSlot(33u, 1u));
+    TEST_CHECK_EQUAL(HOST_SLOT_NONE, HostSlot(34u, 1u));
+    TEST_CHECK_EQUAL(1u, HostSlot(67u, 2u));
+    TEST_CHECK_EQUAL(HOST_SLOT_NONE, HostSlot(68u, 2u));
+}
+
+/* Selecting another host drops the link and advertises directed to it */
+static void TestSelectSwitches(void)
+{
+    Reset();
+    Bond(3u);
+    Connect(0u);
+    HostSelect(50u);
+    TEST_CHECK_EQUAL(1u, fakeDisconnects);
+
+    fakeState = CYBLE_STATE_DISCONNECTED;
+    TEST_CHECK_EQUAL(CYBLE_ERROR_OK, HostStartAdvertisement());
+    TEST_CHECK_EQUAL(CYBLE_GAPP_CONNECTABLE_HIGH_DC_DIRECTED_ADV, cyBle_discoveryModeInfo.advParam->advType);
+    TEST_CHECK(memcmp(cyBle_discoveryModeInfo.advParam->directAddr, fakeBondedList.bdAddrList[1u].bdAddr,
+                      CYBLE_GAP_BD_ADDR_SIZE) == 0);
+}
+
+/* The connected host and an empty slot are not switched to */
+static void TestSelectIgnored(void)
+{
+    Reset();
+    Bond(2u);
+    Connect(0u);
+    HostSelect(10u);
+    HostSelect(90u);
+    TEST_CHECK_EQUAL(0u, fakeDisconnects);
+
+    fakeState = CYBLE_STATE_DISCONNECTED;
+    (void)HostStartAdvertisement();
+    TEST_CHECK_EQUAL(CYBLE_GAPP_CONNECTABLE_UNDIRECTED_ADV, cyBle_discoveryModeInfo.advParam->advType);
+}
+
+/* The selected host answers: the first report is measured once */
+static void TestFirstReportAfterSwitch(void)
+{
+    Reset();
+    Bond(3u);
+    HostSelect(80u);
+    (void)HostStartAdvertisement();
+    Connect(2u);
+    TEST_CHECK_EQUAL(ENABLED, hostFirstReport);
+    HostReportSent();
+    TEST_CHECK_EQUAL(DISABLED, hostFirstReport);
+}
+
+/* The selected host does not answer: after the fallback to undirected
+*  advertising any host may connect, which is not a switch to measure */
+static void TestNoFirstReportAfterFallback(void)
+{
+    Reset();
+    Bond(3u);
+    HostSelect(80u);
+    (void)HostStartAdvertisement();
+    fakeState = CYBLE_STATE_DISCONNECTED;
+    TEST_CHECK_EQUAL(ENABLED, HostAdvertisementStopped());
+    TEST_CHECK_EQUAL(CYBLE_GAPP_CONNECTABLE_UNDIRECTED_ADV, cyBle_discoveryModeInfo.advParam->advType);
+    TEST_CHECK_EQUAL(2u, fakeAdvStarts);
+
+    /* Undirected advertising ends without a restart */
+    fakeState = CYBLE_STATE_DISCONNECTED;
+    TEST_CHECK_EQUAL(DISABLED, HostAdvertisementStopped());
+    (void)HostStartAdvertisement();
+    Connect(0u);
+    TEST_CHECK_EQUAL(DISABLED, hostFirstReport);
+}
+
+
+int main(void)
+{
+    TEST_RUN(TestSlotEdges);
+    TEST_RUN(TestMoreBondsThanSlots);
+    TEST_RUN(TestShortBondList);
+    TEST_RUN(TestSelectSwitches);
+    TEST_RUN(TestSelectIgnored);
+    TEST_RUN(TestFirstReportAfterSwitch);
+    TEST_RUN(TestNoFirstReportAfterFallback);
+    printf("%u checks, %u failed\n", testChecks, testFailures);
+    return (TEST_RESULT());
+}
+
+
+/* [] END OF FILE */
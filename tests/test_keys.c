@@ -0,0 +1,255 @@
+/*******************************************************************************
+* File Name: test_keys.c
+*
+* Version 1.0
+*
+* Description:
+*  Host tests of the lifecycle of the LE Secure Connections key pair: the
+*  generation while idle, the record in flash, its use by pairings and its
+*  replacement. KeysStart() stands for a reset, the flash keeps its
+*  content across it.
+*
+*******************************************************************************/
+
+#include <string.h>
+#include "common.h"
+#include "keys.h"
+#include "test.h"
+
+TEST_COUNTERS;
+
+
+/* Clears the flash rows of the record, as in a freshly programmed device */
+static void Erase(void)
+{
+    if(fakeStoreDest != NULL)
+    {
+        (void)memset((uint8 *)fakeStoreDest, 0, fakeStoreSize);
+    }
+}
+
+/* A key pair with every byte set to value */
+static CYBLE_GAP_SMP_LOCAL_P256_KEYS Pair(uint8 value)
+{
+    CYBLE_GAP_SMP_LOCAL_P256_KEYS pair;
+
+    (void)memset(&pair, value, sizeof(pair));
+    return (pair);
+}
+
+/* The record in flash */
+static KEYS_RECORD_T Stored(void)
+{
+    KEYS_RECORD_T record;
+
+    (void)memcpy(&record, fakeStoreDest, sizeof(record));
+    return (record);
+}
+
+/* Starts from erased flash and lets the stack generate and store a pair */
+static void Provision(uint8 value)
+{
+    CYBLE_GAP_SMP_LOCAL_P256_KEYS pair = Pair(value);
+
+    FakeBleReset();
+    Erase();
+    KeysStart();
+    KeysProcess(1u);
+    KeysGenerated(&pair);
+    KeysProcess(1u);
+}
+
+static void Pairing(void)
+{
+    KeysPairingStart();
+    KeysPairingEnd();
+}
+
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+/* Nothing is generated while a hand is near or a report waits */
+static void TestGeneratesOnlyWhenIdle(void)
+{
+    FakeBleReset();
+    Erase();
+    KeysStart();
+    TEST_CHECK_EQUAL(KEYS_STATE_NONE, keysState);
+    TEST_CHECK_EQUAL(0u, fakeKeySets);
+
+    KeysProcess(0u);
+    TEST_CHECK_EQUAL(0u, fakeKeyGenerations);
+    KeysProcess(1u);
+    TEST_CHECK_EQUAL(1u, fakeKeyGenerations);
+    TEST_CHECK_EQUAL(KEYS_STATE_GENERATING, keysState);
+    KeysProcess(1u);
+    TEST_CHECK_EQUAL(1u, fakeKeyGenerations);
+}
+
+/* The generated pair is stored once, the stack already has it */
+static void TestStoresGeneratedPair(void)
+{
+    KEYS_RECORD_T record;
+
+    Provision(0x11u);
+    TEST_CHECK_EQUAL(KEYS_STATE_READY, keysState);
+    TEST_CHECK_EQUAL(1u, fakeStores);
+    TEST_CHECK_EQUAL(0u, fakeKeySets);
+    record = Stored();
+    TEST_CHECK(KeysValidate(&record) != 0u);
+    TEST_CHECK_EQUAL(1u, record.generation);
+    TEST_CHECK_EQUAL(0u, record.uses);
+    TEST_CHECK_EQUAL(0x11u, record.pair.privateKey[0u]);
+
+    KeysProcess(1u);
+    TEST_CHECK_EQUAL(1u, fakeStores);
+    TEST_CHECK_EQUAL(1u, fakeKeyGenerations);
+}
+
+/* After a reset the stored pair is set in the stack, not generated again */
+static void TestRestoresAfterReset(void)
+{
+    Provision(0x22u);
+    FakeBleReset();
+    KeysStart();
+    TEST_CHECK_EQUAL(KEYS_STATE_READY, keysState);
+    TEST_CHECK_EQUAL(1u, fakeKeySets);
+    TEST_CHECK_EQUAL(0x22u, fakeKeys.publicKey[CYBLE_GAP_SMP_P256_PUBLIC_KEY_SIZE - 1u]);
+    KeysProcess(1u);
+    TEST_CHECK_EQUAL(0u, fakeKeyGenerations);
+}
+
+/* A record that fails its CRC is not used */
+static void TestRejectsCorruptRecord(void)
+{
+    Provision(0x33u);
+    ((uint8 *)fakeStoreDest)[sizeof(KEYS_RECORD_T) - 1u] ^= 0x01u;
+    FakeBleReset();
+    KeysStart();
+    TEST_CHECK_EQUAL(KEYS_STATE_NONE, keysState);
+    TEST_CHECK_EQUAL(0u, fakeKeySets);
+    KeysProcess(1u);
+    TEST_CHECK_EQUAL(1u, fakeKeyGenerations);
+}
+
+/* A pairing uses the pair up, the next idle tick replaces it */
+static void TestReplacesPairAfterPairing(void)
+{
+    CYBLE_GAP_SMP_LOCAL_P256_KEYS pair = Pair(0x55u);
+    KEYS_RECORD_T record;
+
+    Provision(0x44u);
+    KeysPairingStart();
+    TEST_CHECK_EQUAL(ENABLED, keysPairingReady);
+    KeysProcess(1u);
+    TEST_CHECK_EQUAL(1u, fakeKeyGenerations);
+    KeysPairingEnd();
+    TEST_CHECK_EQUAL(KEYS_STATE_STORING, keysState);
+
+    /* The use is stored first, so a reset does not bring the pair back */
+    KeysProcess(1u);
+    record = Stored();
+    TEST_CHECK(KeysValidate(&record) != 0u);
+    TEST_CHECK_EQUAL(KEYS_MAX_USES, record.uses);
+    TEST_CHECK_EQUAL(1u, fakeKeyGenerations);
+
+    KeysProcess(1u);
+    TEST_CHECK_EQUAL(2u, fakeKeyGenerations);
+    KeysGenerated(&pair);
+    KeysProcess(0u);
+    record = Stored();
+    TEST_CHECK_EQUAL(KEYS_STATE_READY, keysState);
+    TEST_CHECK_EQUAL(2u, record.generation);
+    TEST_CHECK_EQUAL(0u, record.uses);
+    TEST_CHECK_EQUAL(0x55u, record.pair.privateKey[0u]);
+}
+
+/* A used up pair is still set after a reset, and replaced when idle */
+static void TestReplacesUsedPairAfterReset(void)
+{
+    Provision(0x66u);
+    Pairing();
+    KeysProcess(0u);
+    FakeBleReset();
+    KeysStart();
+    TEST_CHECK_EQUAL(KEYS_STATE_READY, keysState);
+    TEST_CHECK_EQUAL(1u, fakeKeySets);
+    KeysProcess(0u);
+    TEST_CHECK_EQUAL(0u, fakeKeyGenerations);
+    KeysProcess(1u);
+    TEST_CHECK_EQUAL(1u, fakeKeyGenerations);
+}
+
+/* Without a pair the stack generates its own during the pairing */
+static void TestPairingWithoutPair(void)
+{
+    FakeBleReset();
+    Erase();
+    KeysStart();
+    KeysPairingStart();
+    TEST_CHECK_EQUAL(DISABLED, keysPairingReady);
+    KeysPairingEnd();
+    TEST_CHECK_EQUAL(KEYS_STATE_NONE, keysState);
+    TEST_CHECK_EQUAL(0u, fakeStores);
+}
+
+/* The record waits for the bonding data and retries a busy flash */
+static void TestStoreWaitsForFlash(void)
+{
+    CYBLE_GAP_SMP_LOCAL_P256_KEYS pair = Pair(0x77u);
+
+    FakeBleReset();
+    Erase();
+    KeysStart();
+    KeysProcess(1u);
+    KeysGenerated(&pair);
+
+    cyBle_pendingFlashWrite = 1u;
+    KeysProcess(1u);
+    TEST_CHECK_EQUAL(KEYS_STATE_STORING, keysState);
+    cyBle_pendingFlashWrite = 0u;
+
+    fakeStoreBusy = 2u;
+    KeysProcess(1u);
+    KeysProcess(1u);
+    TEST_CHECK_EQUAL(KEYS_STATE_STORING, keysState);
+    TEST_CHECK_EQUAL(0u, fakeStores);
+    KeysProcess(1u);
+    TEST_CHECK_EQUAL(KEYS_STATE_READY, keysState);
+    TEST_CHECK_EQUAL(1u, fakeStores);
+}
+
+/* A stack restart during the generation falls back to the stored pair */
+static void TestStackRestartWhileGenerating(void)
+{
+    Provision(0x88u);
+    Pairing();
+    KeysProcess(1u);
+    KeysProcess(1u);
+    TEST_CHECK_EQUAL(KEYS_STATE_GENERATING, keysState);
+    KeysStart();
+    TEST_CHECK_EQUAL(KEYS_STATE_READY, keysState);
+    TEST_CHECK_EQUAL(0x88u, fakeKeys.privateKey[0u]);
+    KeysProcess(1u);
+    TEST_CHECK_EQUAL(3u, fakeKeyGenerations);
+}
+
+
+int main(void)
+{
+    TEST_RUN(TestGeneratesOnlyWhenIdle);
+    TEST_RUN(TestStoresGeneratedPair);
+    TEST_RUN(TestRestoresAfterReset);
+    TEST_RUN(TestRejectsCorruptRecord);
+    TEST_RUN(TestReplacesPairAfterPairing);
+    TEST_RUN(TestReplacesUsedPairAfterReset);
+    TEST_RUN(TestPairingWithoutPair);
+    TEST_RUN(TestStoreWaitsForFlash);
+    TEST_RUN(TestStackRestartWhileGenerating);
+    printf("%u checks, %u failed\n", testChecks, testFailures);
+    return (TEST_RESULT());
+}
+
+
+/* [] END OF FILE */
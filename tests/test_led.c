@@ -0,0 +1,178 @@
+/*******************************************************************************
+* File Name: test_led.c
+*
+* Version 1.0
+*
+* Description:
+*  Host tests of the LED manager: LedTick() steps of 100 ms with the energy
+*  budget, which keeps an LED that stays on lit steadily for 3 s and then
+*  flashes it for one step in every ten, the timeouts, and the feedback LEDs
+*  that stay dark in the power bands without ledFeedback. The Caps Lock pin
+*  is read back from fakeCapsLockLed; the low power LED has no pin in this
+*  build and is seen through ledCharge.
+*
+*******************************************************************************/
+
+#include "common.h"
+#include "led.h"
+#include "power.h"
+#include "test.h"
+
+/* Steps of one lit LED from a full budget, and the steps between flashes
+*  once it is empty */
+#define STEADY_STEPS                (((LED_BUDGET_MAX - LED_CURRENT) / (LED_CURRENT - LED_BUDGET_RATE)) + 1u)
+#define FLASH_PERIOD                (LED_CURRENT / LED_BUDGET_RATE)
+
+TEST_COUNTERS;
+
+
+/* All LEDs off and the budget full again */
+static void Reset(void)
+{
+    uint32 step;
+
+    powerBand = POWER_BAND_NORMAL;
+    LedAllOff();
+    for(step = 0u; step < (LED_BUDGET_MAX / LED_BUDGET_RATE); step++)
+    {
+        LedTick();
+    }
+}
+
+/* One step, returns whether the Caps Lock LED was lit in it */
+static uint8 Step(void)
+{
+    LedTick();
+    return ((uint8)(fakeCapsLockLed == LED_ON));
+}
+
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+/* Caps Lock on: lit for 3 s, then one step in every ten */
+static void TestBudget(void)
+{
+    uint32 step;
+    uint32 lit = 0u;
+    uint32 last = 0u;
+    uint8 evenlySpaced = 1u;
+
+    Reset();
+    LedSet(LED_CAPS_LOCK, LED_PATTERN_ON, 0u);
+    for(step = 0u; step < STEADY_STEPS; step++)
+    {
+        lit += Step();
+    }
+    TEST_CHECK_EQUAL(STEADY_STEPS, lit);
+    TEST_CHECK((STEADY_STEPS >= 30u) && (STEADY_STEPS < 40u));
+    TEST_CHECK_EQUAL(0u, Step());
+
+    /* Skip to the first flash of the empty budget */
+    while(Step() == 0u)
+    {
+    }
+    lit = 0u;
+    for(step = 1u; step <= (10u * FLASH_PERIOD); step++)
+    {
+        if(Step() != 0u)
+        {
+            lit++;
+            evenlySpaced &= (uint8)((step - last) == FLASH_PERIOD);
+            last = step;
+        }
+    }
+    TEST_CHECK_EQUAL(10u, FLASH_PERIOD);
+    TEST_CHECK_EQUAL(10u, lit);
+    TEST_CHECK(evenlySpaced);
+    TEST_CHECK_EQUAL(ENABLED, LedActive());
+}
+
+/* Every lit step draws LED_CURRENT from the budget into ledCharge */
+static void TestCharge(void)
+{
+    uint32 charge;
+
+    Reset();
+    charge = ledCharge;
+    LedSet(LED_CAPS_LOCK, LED_PATTERN_ON, 0u);
+    (void)Step();
+    (void)Step();
+    TEST_CHECK_EQUAL(2u * LED_CURRENT, ledCharge - charge);
+    LedSet(LED_CAPS_LOCK, LED_PATTERN_OFF, 0u);
+    (void)Step();
+    TEST_CHECK_EQUAL(2u * LED_CURRENT, ledCharge - charge);
+}
+
+/* A timeout of n steps lights the LED n times, the next step turns it off
+*  and ends the need for the timer */
+static void TestTimeout(void)
+{
+    uint32 step;
+    uint32 lit = 0u;
+
+    Reset();
+    LedSet(LED_CAPS_LOCK, LED_PATTERN_ON, 5u);
+    for(step = 0u; step < 5u; step++)
+    {
+        lit += Step();
+    }
+    TEST_CHECK_EQUAL(5u, lit);
+    TEST_CHECK_EQUAL(ENABLED, LedActive());
+    TEST_CHECK_EQUAL(0u, Step());
+    TEST_CHECK_EQUAL(DISABLED, LedActive());
+    for(step = 0u; step < 20u; step++)
+    {
+        lit += Step();
+    }
+    TEST_CHECK_EQUAL(5u, lit);
+}
+
+/* In the saver and critical bands Caps Lock stays dark and does not keep
+*  the timer running, the low power status LED still lights */
+static void TestFeedbackSuppressed(void)
+{
+    uint8 band;
+    uint32 step;
+    uint32 lit;
+    uint32 charge;
+
+    for(band = POWER_BAND_SAVER; band < POWER_BAND_COUNT; band++)
+    {
+        Reset();
+        powerBand = band;
+        TEST_CHECK_EQUAL(0u, PowerGetProfile()->ledFeedback);
+        LedSet(LED_CAPS_LOCK, LED_PATTERN_ON, 0u);
+        lit = 0u;
+        for(step = 0u; step < LED_PATTERN_STEPS; step++)
+        {
+            lit += Step();
+        }
+        TEST_CHECK_EQUAL(0u, lit);
+        TEST_CHECK_EQUAL(DISABLED, LedActive());
+
+        charge = ledCharge;
+        LedSet(LED_LOW_POWER, LED_PATTERN_ON, 0u);
+        (void)Step();
+        TEST_CHECK_EQUAL(LED_CURRENT, ledCharge - charge);
+        TEST_CHECK_EQUAL(ENABLED, LedActive());
+    }
+
+    Reset();
+    LedSet(LED_CAPS_LOCK, LED_PATTERN_ON, 0u);
+    TEST_CHECK_EQUAL(1u, Step());
+}
+
+
+int main(void)
+{
+    TEST_RUN(TestBudget);
+    TEST_RUN(TestCharge);
+    TEST_RUN(TestTimeout);
+    TEST_RUN(TestFeedbackSuppressed);
+    printf("%u checks, %u failed\n", testChecks, testFailures);
+    return (TEST_RESULT());
+}
+
+
+/* [] END OF FILE */
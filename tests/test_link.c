@@ -0,0 +1,154 @@
+/*******************************************************************************
+* File Name: test_link.c
+*
+* Version 1.0
+*
+* Description:
+*  Host tests of the RSSI driven TX power control with synthetic RSSI
+*  traces. The BLE component is configured for 0 dBm, the ceiling.
+*
+*******************************************************************************/
+
+#include "common.h"
+#include "link.h"
+#include "test.h"
+
+#define STEP_0_DBM                  (4u)        /* Index of 0 dBm in the power steps */
+#define STEP_LOWEST                 (0u)
+
+TEST_COUNTERS;
+
+
+/* Feeds samples of a constant RSSI, returns the samples until the power
+*  step changed or count when it did not */
+static uint32 Sample(int8 rssi, uint32 count)
+{
+    uint8 step = linkPowerStep;
+    uint32 sample;
+
+    fakeRssi = rssi;
+    for(sample = 1u; sample <= count; sample++)
+    {
+        LinkProcess();
+        if(linkPowerStep != step)
+        {
+            return (sample);
+        }
+    }
+    return (count);
+}
+
+/* Feeds count samples of a constant RSSI */
+static void Run(int8 rssi, uint32 count)
+{
+    fakeRssi = rssi;
+    while(count-- != 0u)
+    {
+        LinkProcess();
+    }
+}
+
+static void Connect(void)
+{
+    LinkStart();
+    LinkInit();
+}
+
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+static void TestStartsAtConfiguredPower(void)
+{
+    FakeBleReset();
+    Connect();
+    TEST_CHECK_EQUAL(STEP_0_DBM, linkPowerStep);
+    TEST_CHECK_EQUAL(CYBLE_LL_PWR_LVL_0_DBM, fakeTxPower);
+}
+
+/* A close host steps the power down one step per hold time, to the lowest */
+static void TestStepsDownWhenClose(void)
+{
+    uint8 step;
+
+    FakeBleReset();
+    Connect();
+    for(step = STEP_0_DBM; step > STEP_LOWEST; step--)
+    {
+        TEST_CHECK_EQUAL(LINK_HOLD_SAMPLES + 1u, Sample(-40, 20u));
+        TEST_CHECK_EQUAL(step - 1u, linkPowerStep);
+    }
+    TEST_CHECK_EQUAL(CYBLE_LL_PWR_LVL_NEG_18_DBM, fakeTxPower);
+    Run(-40, 20u);
+    TEST_CHECK_EQUAL(STEP_LOWEST, linkPowerStep);
+}
+
+/* Inside the RSSI window the power does not move */
+static void TestHysteresisWindow(void)
+{
+    FakeBleReset();
+    Connect();
+    Run(-40, LINK_HOLD_SAMPLES + 1u);
+    TEST_CHECK_EQUAL(STEP_0_DBM - 1u, linkPowerStep);
+    Run((LINK_RSSI_HIGH + LINK_RSSI_LOW) / 2, 100u);
+    TEST_CHECK_EQUAL(STEP_0_DBM - 1u, linkPowerStep);
+}
+
+/* A weak link steps the power back up, never above the configured power */
+static void TestStepsUpToCeiling(void)
+{
+    FakeBleReset();
+    Connect();
+    Run(-40, 100u);
+    TEST_CHECK_EQUAL(STEP_LOWEST, linkPowerStep);
+    Run(-80, 200u);
+    TEST_CHECK_EQUAL(STEP_0_DBM, linkPowerStep);
+    TEST_CHECK_EQUAL(CYBLE_LL_PWR_LVL_0_DBM, fakeTxPower);
+}
+
+/* Below the critical level the power jumps to the ceiling without a hold */
+static void TestCriticalJumpsToCeiling(void)
+{
+    FakeBleReset();
+    Connect();
+    Run(-40, 100u);
+    TEST_CHECK_EQUAL(STEP_LOWEST, linkPowerStep);
+    /* The filtered RSSI crosses the critical level on the fifth sample */
+    Run(-100, 5u);
+    TEST_CHECK_EQUAL(STEP_0_DBM, linkPowerStep);
+    TEST_CHECK_EQUAL(CYBLE_LL_PWR_LVL_0_DBM, fakeTxPower);
+}
+
+/* The power a connection ended with is not the ceiling of the next one,
+*  also when the stack restarts in between */
+static void TestNoRatchetAcrossConnections(void)
+{
+    FakeBleReset();
+    Connect();
+    Run(-40, 100u);
+    TEST_CHECK_EQUAL(CYBLE_LL_PWR_LVL_NEG_18_DBM, fakeTxPower);
+
+    /* Disconnect and stack restart, CYBLE_EVT_STACK_ON reads the power again */
+    Connect();
+    TEST_CHECK_EQUAL(STEP_0_DBM, linkPowerStep);
+    TEST_CHECK_EQUAL(CYBLE_LL_PWR_LVL_0_DBM, fakeTxPower);
+
+    Run(-40, 100u);
+    Run(-80, 200u);
+    TEST_CHECK_EQUAL(STEP_0_DBM, linkPowerStep);
+}
+
+
+int main(void)
+{
+    TEST_RUN(TestStartsAtConfiguredPower);
+    TEST_RUN(TestStepsDownWhenClose);
+    TEST_RUN(TestHysteresisWindow);
+    TEST_RUN(TestStepsUpToCeiling);
+    TEST_RUN(TestCriticalJumpsToCeiling);
+    TEST_RUN(TestNoRatchetAcrossConnections);
+    return (TEST_RESULT());
+}
+
+
+/* [] END OF FILE */
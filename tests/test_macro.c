@@ -0,0 +1,202 @@
+/*******************************************************************************
+* File Name: test_macro.c
+*
+* Version 1.0
+*
+* Description:
+*  Host tests of the macro playback. The Makefile sets the macro text to
+*  "Noo?on_\n": a shifted letter, a repeated key, an untypeable character
+*  between two presses of the same key, and a shifted symbol. The reports go
+*  through the HID queue of hids.c to the fake notification log.
+*
+*******************************************************************************/
+
+#include <string.h>
+#include "common.h"
+#include "hids.h"
+#include "macro.h"
+#include "test.h"
+
+/* Modifiers and the one key of each report the text types */
+typedef struct
+{
+    uint8 modifiers;
+    uint8 key;
+} TYPED_T;
+
+TEST_COUNTERS;
+
+static const TYPED_T typed[] =
+{
+    {KEY_MODIFIER_LEFT_SHIFT, 0x11u},               /* N */
+    {0u, 0x12u},                                    /* o */
+    {0u, 0u},                                       /* Release before the same key */
+    {0u, 0x12u},                                    /* o */
+    {0u, 0u},                                       /* ? skipped, release before the same key */
+    {0u, 0x12u},                                    /* o */
+    {0u, 0x11u},                                    /* n */
+    {KEY_MODIFIER_LEFT_SHIFT, KEY_USAGE_MINUS},     /* _ */
+    {0u, KEY_USAGE_ENTER},                          /* \n */
+    {0u, 0u},                                       /* Final release */
+};
+
+#define TYPED_COUNT                 (sizeof(typed) / sizeof(typed[0u]))
+
+
+/* Connected with notifications on, nothing queued or playing */
+static void Reset(void)
+{
+    MacroStop();
+    HidsProcessQueue();
+    FakeBleReset();
+    fakeState = CYBLE_STATE_CONNECTED;
+    keyboardSimulation = ENABLED;
+}
+
+/* Plays the macro to its end the way the main loop does. Returns the
+*  smallest number of free queue slots MacroProcess() left. */
+static uint8 Type(void)
+{
+    uint8 leastFree = HID_QUEUE_SIZE;
+    uint32 sent;
+
+    MacroStart(MACRO_STATION_ID);
+    do
+    {
+        sent = fakeReportCount;
+        MacroProcess();
+        leastFree = (HidsQueueFree() < leastFree) ? HidsQueueFree() : leastFree;
+        HidsProcessQueue();
+    }
+    while(fakeReportCount != sent);
+    return (leastFree);
+}
+
+static uint8 IsRelease(uint32 report)
+{
+    static const uint8 released[FAKE_REPORT_SIZE] = {0u};
+
+    return ((uint8)(memcmp(fakeReports[report], released, FAKE_REPORT_SIZE) == 0));
+}
+
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+/* Each character gives its key and modifiers, in order */
+static void TestTyped(void)
+{
+    uint32 report;
+
+    Reset();
+    (void)Type();
+    TEST_CHECK_EQUAL(TYPED_COUNT, fakeReportCount);
+    for(report = 0u; (report < TYPED_COUNT) && (report < fakeReportCount); report++)
+    {
+        TEST_CHECK_EQUAL(typed[report].modifiers, fakeReports[report][HID_KEYBOARD_MODIFIERS_OFFSET]);
+        TEST_CHECK_EQUAL(typed[report].key, fakeReports[report][HID_KEYBOARD_KEYCODES_OFFSET]);
+        TEST_CHECK_EQUAL(0u, fakeReports[report][HID_KEYBOARD_KEYCODES_OFFSET + 1u]);
+    }
+}
+
+/* The same key twice in a row has a release between the presses, also
+*  when a skipped character is between them */
+static void TestRepeatedKey(void)
+{
+    Reset();
+    (void)Type();
+    TEST_CHECK_EQUAL(0x12u, fakeReports[1u][HID_KEYBOARD_KEYCODES_OFFSET]);
+    TEST_CHECK(IsRelease(2u));
+    TEST_CHECK_EQUAL(0x12u, fakeReports[3u][HID_KEYBOARD_KEYCODES_OFFSET]);
+    TEST_CHECK(IsRelease(4u));
+    TEST_CHECK_EQUAL(0x12u, fakeReports[5u][HID_KEYBOARD_KEYCODES_OFFSET]);
+}
+
+/* Untypeable characters send nothing, every other one a press */
+static void TestSkipped(void)
+{
+    uint32 report;
+    uint8 presses = 0u;
+
+    Reset();
+    (void)Type();
+    for(report = 0u; report < fakeReportCount; report++)
+    {
+        presses += (uint8)(IsRelease(report) == 0u);
+    }
+    TEST_CHECK_EQUAL(strlen(MACRO_TEXT_STATION_ID) - 1u, presses);
+}
+
+/* The first pass fills all slots but one, every pass keeps one free, and
+*  the macro ends with a release so no key stays down */
+static void TestFinalRelease(void)
+{
+    Reset();
+    MacroStart(MACRO_STATION_ID);
+    TEST_CHECK((fakePendingWork & WORK_HID) != 0u);
+    MacroProcess();
+    TEST_CHECK_EQUAL(1u, HidsQueueFree());
+    HidsProcessQueue();
+
+    Reset();
+    TEST_CHECK_EQUAL(1u, Type());
+    TEST_CHECK(IsRelease(fakeReportCount - 1u));
+    TEST_CHECK_EQUAL(HID_QUEUE_SIZE, HidsQueueFree());
+}
+
+/* A macro started with the queue nearly full waits for room */
+static void TestQueueFull(void)
+{
+    uint8 report[KEYBOARD_DATA_SIZE];
+    uint8 slot;
+
+    Reset();
+    HidsEncodeKeyboard(report, 0u, NULL, 0u);
+    for(slot = 0u; slot < (HID_QUEUE_SIZE - 1u); slot++)
+    {
+        (void)HidsQueueReport(report);
+    }
+    MacroStart(MACRO_STATION_ID);
+    MacroProcess();
+    TEST_CHECK_EQUAL(1u, HidsQueueFree());
+    HidsProcessQueue();
+    MacroProcess();
+    TEST_CHECK_EQUAL(1u, HidsQueueFree());
+    HidsProcessQueue();
+    TEST_CHECK_EQUAL(HID_QUEUE_SIZE - 1u + HID_QUEUE_SIZE - 1u, fakeReportCount);
+    TEST_CHECK_EQUAL(KEY_MODIFIER_LEFT_SHIFT, fakeReports[HID_QUEUE_SIZE - 1u][HID_KEYBOARD_MODIFIERS_OFFSET]);
+}
+
+/* The macro stops with the link or the notifications */
+static void TestStopped(void)
+{
+    Reset();
+    MacroStart(MACRO_STATION_ID);
+    fakeState = CYBLE_STATE_DISCONNECTED;
+    MacroProcess();
+    TEST_CHECK_EQUAL(HID_QUEUE_SIZE, HidsQueueFree());
+    fakeState = CYBLE_STATE_CONNECTED;
+    MacroProcess();
+    TEST_CHECK_EQUAL(HID_QUEUE_SIZE, HidsQueueFree());
+
+    MacroStart(MACRO_STATION_ID);
+    keyboardSimulation = DISABLED;
+    MacroProcess();
+    TEST_CHECK_EQUAL(HID_QUEUE_SIZE, HidsQueueFree());
+}
+
+
+int main(void)
+{
+    TEST_RUN(TestTyped);
+    TEST_RUN(TestRepeatedKey);
+    TEST_RUN(TestSkipped);
+    TEST_RUN(TestFinalRelease);
+    TEST_RUN(TestQueueFull);
+    TEST_RUN(TestStopped);
+    printf("%u checks, %u failed\n", testChecks, testFailures);
+    return (TEST_RESULT());
+}
+
+
+/* [] END OF FILE */
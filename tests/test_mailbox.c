@@ -0,0 +1,254 @@
+/*******************************************************************************
+* File Name: test_mailbox.c
+*
+* Version 1.0
+*
+* Description:
+*  Host tests of the CapSense mailbox publication. PublishMailbox() runs with
+*  its stores recorded; the simulator then replays the stores against a
+*  master that reads the buffer byte by byte, head to tail, and checks every
+*  possible interleaving. A read the master accepts, one with equal head and
+*  tail generations, must hold exactly one published snapshot.
+*
+*******************************************************************************/
+
+#include <string.h>
+#include "project.h"
+#include "test.h"
+
+#define STORE_TRACE_SIZE            (64u)
+
+typedef struct
+{
+    uint8 index;
+    uint8 value;
+} STORE_T;
+
+static STORE_T storeTrace[STORE_TRACE_SIZE];
+static unsigned int storeCount;
+
+#define MAILBOX_STORE(index, value) (RecordStore((index), (value)))
+static void RecordStore(unsigned int index, uint8 value);
+
+/* The firmware main() becomes an unused function of the test */
+#define main CapSenseMain
+#include "../CapSense.cydsn/main.c"
+#undef main
+
+TEST_COUNTERS;
+
+/* Buffer states before and after each recorded store */
+static uint8 states[STORE_TRACE_SIZE + 1u][MAILBOX_SIZE];
+static unsigned int stateCount;
+
+/* Payloads and generations published during the simulated run */
+static uint8 published[4u][MAILBOX_SIZE];
+static unsigned int publishedCount;
+
+static unsigned long readsAccepted;
+static unsigned long readsTorn;
+static unsigned long readsInconsistent;
+
+
+static void RecordStore(unsigned int index, uint8 value)
+{
+    i2cBuffer[index] = value;
+    if(storeCount < STORE_TRACE_SIZE)
+    {
+        storeTrace[storeCount].index = (uint8)index;
+        storeTrace[storeCount].value = value;
+        storeCount++;
+    }
+}
+
+static void CopyBuffer(uint8 copy[])
+{
+    unsigned int index;
+
+    for(index = 0u; index < MAILBOX_SIZE; index++)
+    {
+        copy[index] = i2cBuffer[index];
+    }
+}
+
+/* Publishes a snapshot with the given buttons and gesture sequence and keeps
+*  the resulting buffer as one of the valid snapshots */
+static uint8 Publish(uint8 buttons, uint8 sequence)
+{
+    uint8 result;
+
+    mailboxSnapshot[BUTTON_STATUS_INDEX1] = buttons;
+    mailboxSnapshot[SLIDER_GESTURE_INDEX] = GESTURE_TAP;
+    mailboxSnapshot[SLIDER_PARAM_INDEX] = (uint8)(sequence * 16u);
+    mailboxSnapshot[SLIDER_SEQUENCE_INDEX] = sequence;
+    result = PublishMailbox();
+    if(result != 0u)
+    {
+        CopyBuffer(published[publishedCount++]);
+    }
+    return (result);
+}
+
+/* Rebuilds the buffer state after every recorded store, starting from start[] */
+static void BuildStates(const uint8 start[])
+{
+    unsigned int store;
+
+    (void)memcpy(states[0u], start, MAILBOX_SIZE);
+    for(store = 0u; store < storeCount; store++)
+    {
+        (void)memcpy(states[store + 1u], states[store], MAILBOX_SIZE);
+        states[store + 1u][storeTrace[store].index] = storeTrace[store].value;
+    }
+    stateCount = storeCount + 1u;
+}
+
+/* Checks an accepted read against all published snapshots */
+static void CheckRead(const uint8 read[])
+{
+    unsigned int snapshot;
+    unsigned int index;
+    uint8 match;
+
+    if(read[MAILBOX_GEN_HEAD_INDEX] != read[MAILBOX_GEN_TAIL_INDEX])
+    {
+        readsTorn++;
+        return;
+    }
+    readsAccepted++;
+    for(snapshot = 0u; snapshot < publishedCount; snapshot++)
+    {
+        match = 1u;
+        for(index = MAILBOX_GEN_HEAD_INDEX; index <= MAILBOX_GEN_TAIL_INDEX; index++)
+        {
+            if(read[index] != published[snapshot][index])
+            {
+                match = 0u;
+            }
+        }
+        if(match != 0u)
+        {
+            return;
+        }
+    }
+    readsInconsistent++;
+}
+
+/* Enumerates the reads: byte index is read at a buffer state no earlier than
+*  the state of the byte before it */
+static void Read(uint8 read[], unsigned int index, unsigned int firstState)
+{
+    unsigned int state;
+
+    if(index == MAILBOX_SIZE)
+    {
+        CheckRead(read);
+        return;
+    }
+    for(state = firstState; state < stateCount; state++)
+    {
+        read[index] = states[state][index];
+        Read(read, index + 1u, state);
+    }
+}
+
+static void SimulateReads(void)
+{
+    uint8 read[MAILBOX_SIZE];
+
+    readsAccepted = 0u;
+    readsTorn = 0u;
+    readsInconsistent = 0u;
+    Read(read, 0u, 0u);
+}
+
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+static void TestUnchangedSnapshotIsNotPublished(void)
+{
+    publishedCount = 0u;
+    (void)Publish(0x01u, 1u);
+    storeCount = 0u;
+    TEST_CHECK_EQUAL(0u, Publish(0x01u, 1u));
+    TEST_CHECK_EQUAL(0u, storeCount);
+}
+
+static void TestGenerationCopiesMatchAfterPublication(void)
+{
+    publishedCount = 0u;
+    TEST_CHECK_EQUAL(1u, Publish(0x02u, 2u));
+    TEST_CHECK_EQUAL(i2cBuffer[MAILBOX_GEN_HEAD_INDEX], i2cBuffer[MAILBOX_GEN_TAIL_INDEX]);
+    TEST_CHECK_EQUAL(0x02u, i2cBuffer[BUTTON_STATUS_INDEX1]);
+    TEST_CHECK_EQUAL(2u, i2cBuffer[SLIDER_SEQUENCE_INDEX]);
+}
+
+/* A read overlapping one publication either sees one snapshot or is torn */
+static void TestReadDuringOnePublication(void)
+{
+    uint8 start[MAILBOX_SIZE];
+
+    publishedCount = 0u;
+    (void)Publish(0x01u, 10u);
+    CopyBuffer(start);
+    storeCount = 0u;
+    (void)Publish(0x06u, 11u);
+    BuildStates(start);
+    SimulateReads();
+    TEST_CHECK_EQUAL(0u, readsInconsistent);
+    TEST_CHECK(readsTorn != 0u);
+    TEST_CHECK(readsAccepted != 0u);
+}
+
+/* Two publications back to back while the master reads, the case where
+*  the head of the first and the tail of the second could pair up */
+static void TestReadDuringTwoPublications(void)
+{
+    uint8 start[MAILBOX_SIZE];
+
+    publishedCount = 0u;
+    (void)Publish(0x00u, 20u);
+    CopyBuffer(start);
+    storeCount = 0u;
+    (void)Publish(0x07u, 21u);
+    (void)Publish(0x03u, 22u);
+    BuildStates(start);
+    SimulateReads();
+    TEST_CHECK_EQUAL(0u, readsInconsistent);
+    TEST_CHECK(readsTorn != 0u);
+}
+
+/* The 8-bit generation wraps; head and tail must still match afterwards */
+static void TestGenerationWraps(void)
+{
+    unsigned int count;
+    uint8 start[MAILBOX_SIZE];
+
+    for(count = 0u; count < 300u; count++)
+    {
+        publishedCount = 0u;
+        (void)Publish((uint8)(count & 0x07u), (uint8)count);
+        TEST_CHECK_EQUAL(i2cBuffer[MAILBOX_GEN_HEAD_INDEX], i2cBuffer[MAILBOX_GEN_TAIL_INDEX]);
+    }
+    CopyBuffer(start);
+    storeCount = 0u;
+    (void)Publish(0x05u, 0xAAu);
+    BuildStates(start);
+    SimulateReads();
+    TEST_CHECK_EQUAL(0u, readsInconsistent);
+}
+
+
+int main(void)
+{
+    TEST_RUN(TestUnchangedSnapshotIsNotPublished);
+    TEST_RUN(TestGenerationCopiesMatchAfterPublication);
+    TEST_RUN(TestReadDuringOnePublication);
+    TEST_RUN(TestReadDuringTwoPublications);
+    TEST_RUN(TestGenerationWraps);
+    return (TEST_RESULT());
+}
+
+
+/* [] END OF FILE */
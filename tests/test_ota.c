@@ -0,0 +1,167 @@
+/*******************************************************************************
+* File Name: test_ota.c
+*
+* Version 1.0
+*
+* Description:
+*  Host tests of the over-the-air update image packer: the CRC, the header,
+*  the padding and the chunks at several MTUs.
+*
+*******************************************************************************/
+
+#include <string.h>
+#include "ota/ota.h"
+#include "test.h"
+
+#define IMAGE_SIZE                  (1000u)     /* Not a whole number of rows */
+
+TEST_COUNTERS;
+
+static uint8_t image[IMAGE_SIZE];
+static uint8_t packed[OTA_HEADER_SIZE + IMAGE_SIZE + OTA_ROW_SIZE];
+
+static uint32_t Pack(void)
+{
+    uint32_t index;
+
+    for(index = 0u; index < IMAGE_SIZE; index++)
+    {
+        image[index] = (uint8_t)(index + 1u);
+    }
+    (void)memset(packed, 0xA5, sizeof(packed));
+    return (OtaPack(image, IMAGE_SIZE, 0x0102u, packed, sizeof(packed)));
+}
+
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+/* The check value of CRC-32, also computed in two parts */
+static void TestCrc(void)
+{
+    static const uint8_t check[] = "123456789";
+
+    TEST_CHECK(OtaCrc32(check, 9u, 0u) == 0xCBF43926u);
+    TEST_CHECK(OtaCrc32(&check[4u], 5u, OtaCrc32(check, 4u, 0u)) == 0xCBF43926u);
+    TEST_CHECK(OtaCrc32(check, 0u, 0u) == 0u);
+}
+
+/* The header reads back, the last row is padded with zeros */
+static void TestPack(void)
+{
+    OTA_HEADER_T header;
+    uint32_t length = Pack();
+    uint32_t index;
+    uint8_t padded = 1u;
+
+    TEST_CHECK_EQUAL(OTA_HEADER_SIZE + (8u * OTA_ROW_SIZE), length);
+    TEST_CHECK_EQUAL(length, OtaPackedSize(IMAGE_SIZE));
+    TEST_CHECK(OtaParseHeader(packed, &header) != 0u);
+    TEST_CHECK(header.magic == OTA_MAGIC);
+    TEST_CHECK_EQUAL(0x0102u, header.version);
+    TEST_CHECK_EQUAL(OTA_ROW_SIZE, header.rowSize);
+    TEST_CHECK_EQUAL(IMAGE_SIZE, header.size);
+    TEST_CHECK(header.crc == OtaCrc32(image, IMAGE_SIZE, 0u));
+    TEST_CHECK(memcmp(&packed[OTA_HEADER_SIZE], image, IMAGE_SIZE) == 0);
+    for(index = OTA_HEADER_SIZE + IMAGE_SIZE; index < length; index++)
+    {
+        padded = (uint8_t)(padded && (packed[index] == 0u));
+    }
+    TEST_CHECK(padded != 0u);
+    TEST_CHECK(OtaVerify(&packed[OTA_HEADER_SIZE], &header) != 0u);
+}
+
+/* An empty image, or one without room, is not packed */
+static void TestPackLimits(void)
+{
+    TEST_CHECK_EQUAL(0u, OtaPack(image, 0u, 1u, packed, sizeof(packed)));
+    TEST_CHECK_EQUAL(0u, OtaPack(image, IMAGE_SIZE, 1u, packed, OTA_HEADER_SIZE + IMAGE_SIZE));
+}
+
+/* A wrong magic, row size or an empty image is not a header */
+static void TestHeaderRejected(void)
+{
+    OTA_HEADER_T header;
+
+    (void)Pack();
+    packed[0u] ^= 0x01u;
+    TEST_CHECK_EQUAL(0u, OtaParseHeader(packed, &header));
+    (void)Pack();
+    packed[6u] = 0u;
+    TEST_CHECK_EQUAL(0u, OtaParseHeader(packed, &header));
+    (void)Pack();
+    (void)memset(&packed[8u], 0, 4u);
+    TEST_CHECK_EQUAL(0u, OtaParseHeader(packed, &header));
+}
+
+/* The chunks at each MTU put the packed image back together, only the last is short */
+static void TestChunks(void)
+{
+    static const uint16_t mtus[] = {23u, 64u, 158u, 247u, 512u};
+    uint8_t rebuilt[sizeof(packed)];
+    uint8_t chunk[512u];
+    uint32_t length = Pack();
+    uint32_t offset;
+    uint32_t count;
+    uint16_t size;
+    uint8_t mtu;
+
+    for(mtu = 0u; mtu < (sizeof(mtus) / sizeof(mtus[0u])); mtu++)
+    {
+        (void)memset(rebuilt, 0, sizeof(rebuilt));
+        offset = 0u;
+        count = 0u;
+        while((size = OtaChunk(packed, length, mtus[mtu], offset, chunk)) != 0u)
+        {
+            TEST_CHECK(size <= (mtus[mtu] - OTA_ATT_WRITE_HEADER));
+            TEST_CHECK_EQUAL(offset, OtaChunkOffset(chunk));
+            if((offset + OtaChunkPayload(mtus[mtu])) < length)
+            {
+                TEST_CHECK_EQUAL(mtus[mtu] - OTA_ATT_WRITE_HEADER, size);
+            }
+            (void)memcpy(&rebuilt[offset], &chunk[OTA_CHUNK_HEADER], size - OTA_CHUNK_HEADER);
+            offset += (uint32_t)size - OTA_CHUNK_HEADER;
+            count++;
+        }
+        TEST_CHECK_EQUAL(length, offset);
+        TEST_CHECK_EQUAL(OtaChunkCount(length, mtus[mtu]), count);
+        TEST_CHECK(memcmp(rebuilt, packed, length) == 0);
+    }
+}
+
+/* A flipped bit in the written image fails the check */
+static void TestCorruptImage(void)
+{
+    OTA_HEADER_T header;
+
+    (void)Pack();
+    (void)OtaParseHeader(packed, &header);
+    packed[OTA_HEADER_SIZE + IMAGE_SIZE - 1u] ^= 0x80u;
+    TEST_CHECK_EQUAL(0u, OtaVerify(&packed[OTA_HEADER_SIZE], &header));
+}
+
+static void TestAck(void)
+{
+    uint8_t ack[OTA_ACK_SIZE];
+
+    OtaAck(OTA_STATUS_DONE, 0x00012345u, ack);
+    TEST_CHECK_EQUAL(OTA_STATUS_DONE, ack[0u]);
+    TEST_CHECK_EQUAL(0x00012345u, OtaAckOffset(ack));
+}
+
+
+int main(void)
+{
+    TEST_RUN(TestCrc);
+    TEST_RUN(TestPack);
+    TEST_RUN(TestPackLimits);
+    TEST_RUN(TestHeaderRejected);
+    TEST_RUN(TestChunks);
+    TEST_RUN(TestCorruptImage);
+    TEST_RUN(TestAck);
+    printf("%u checks, %u failed\n", testChecks, testFailures);
+    return (TEST_RESULT());
+}
+
+
+/* [] END OF FILE */
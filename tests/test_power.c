@@ -0,0 +1,177 @@
+/*******************************************************************************
+* File Name: test_power.c
+*
+* Version 1.0
+*
+* Description:
+*  Host tests of the battery power bands: the band thresholds and their
+*  hysteresis, a simulated coin cell discharge with measurement noise, and
+*  the settings each band applies.
+*
+*******************************************************************************/
+
+#include "common.h"
+#include "connparam.h"
+#include "power.h"
+#include "test.h"
+
+#define SETTLE_SAMPLES              (40u)       /* Samples for the level filter to settle */
+
+TEST_COUNTERS;
+
+static uint32 noiseSeed = 1u;
+
+
+/* Feeds a constant level until the filter has settled */
+static void Settle(uint8 level)
+{
+    uint32 sample;
+
+    for(sample = 0u; sample < SETTLE_SAMPLES; sample++)
+    {
+        PowerUpdate(level);
+    }
+}
+
+/* Measurement noise of +-amplitude percent */
+static int32 Noise(uint32 amplitude)
+{
+    noiseSeed = (noiseSeed * 1103515245u) + 12345u;
+    return ((int32)((noiseSeed >> 16u) % ((2u * amplitude) + 1u)) - (int32)amplitude);
+}
+
+/* Coin cell discharge in percent after minute of 1000: flat to the knee at
+*  30 %, then falling faster to the cut-off */
+static uint8 Discharge(uint32 minute)
+{
+    return (uint8)((minute < 700u) ? (100u - ((minute * 70u) / 700u)) : (30u - (((minute - 700u) * 30u) / 300u)));
+}
+
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+static void TestBandThresholds(void)
+{
+    Settle(100u);
+    TEST_CHECK_EQUAL(POWER_BAND_NORMAL, powerBand);
+    Settle(POWER_SAVER_LEVEL);
+    TEST_CHECK_EQUAL(POWER_BAND_NORMAL, powerBand);
+    Settle(POWER_SAVER_LEVEL - 1u);
+    TEST_CHECK_EQUAL(POWER_BAND_SAVER, powerBand);
+    Settle(POWER_CRITICAL_LEVEL);
+    TEST_CHECK_EQUAL(POWER_BAND_SAVER, powerBand);
+    Settle(POWER_CRITICAL_LEVEL - 1u);
+    TEST_CHECK_EQUAL(POWER_BAND_CRITICAL, powerBand);
+}
+
+/* A band is left only once the level is POWER_HYSTERESIS above its threshold */
+static void TestHysteresis(void)
+{
+    Settle(POWER_CRITICAL_LEVEL - 1u);
+    TEST_CHECK_EQUAL(POWER_BAND_CRITICAL, powerBand);
+    Settle(POWER_CRITICAL_LEVEL + POWER_HYSTERESIS - 1u);
+    TEST_CHECK_EQUAL(POWER_BAND_CRITICAL, powerBand);
+    Settle(POWER_CRITICAL_LEVEL + POWER_HYSTERESIS);
+    TEST_CHECK_EQUAL(POWER_BAND_SAVER, powerBand);
+    Settle(POWER_SAVER_LEVEL + POWER_HYSTERESIS - 1u);
+    TEST_CHECK_EQUAL(POWER_BAND_SAVER, powerBand);
+    Settle(POWER_SAVER_LEVEL + POWER_HYSTERESIS);
+    TEST_CHECK_EQUAL(POWER_BAND_NORMAL, powerBand);
+
+    /* A fresh cell brings the band back to normal */
+    Settle(POWER_CRITICAL_LEVEL - 1u);
+    Settle(100u);
+    TEST_CHECK_EQUAL(POWER_BAND_NORMAL, powerBand);
+}
+
+/* A noisy discharge passes each band once, in order, without toggling */
+static void TestNoisyDischarge(void)
+{
+    uint32 minute;
+    uint32 changes = 0u;
+    uint32 saverAt = 0u;
+    uint32 criticalAt = 0u;
+    uint8 band;
+    int32 level;
+
+    Settle(100u);
+    band = powerBand;
+    for(minute = 0u; minute <= 1000u; minute++)
+    {
+        level = (int32)Discharge(minute) + Noise(3u);
+        level = (level < 0) ? 0 : ((level > 100) ? 100 : level);
+        PowerUpdate((uint8)level);
+        if(powerBand != band)
+        {
+            changes++;
+            TEST_CHECK(powerBand > band);
+            band = powerBand;
+            if(band == POWER_BAND_SAVER)
+            {
+                saverAt = minute;
+            }
+            if(band == POWER_BAND_CRITICAL)
+            {
+                criticalAt = minute;
+            }
+        }
+    }
+    TEST_CHECK_EQUAL(2u, changes);
+    TEST_CHECK_EQUAL(POWER_BAND_CRITICAL, powerBand);
+
+    /* Close to where the curve crosses 30 % and 10 % */
+    printf("  saver at minute %lu, critical at minute %lu\n", (unsigned long)saverAt, (unsigned long)criticalAt);
+    TEST_CHECK((saverAt >= 690u) && (saverAt <= 720u));
+    TEST_CHECK((criticalAt >= 890u) && (criticalAt <= 920u));
+}
+
+/* Each band change writes the scan tier and LED setting for the CapSense
+*  MCU and hands the idle connection parameters of the band to the policy */
+static void TestBandSettings(void)
+{
+    Settle(100u);
+    TEST_CHECK_EQUAL(1u, PowerGetProfile()->fastOnApproach);
+
+    FakeBleReset();
+    ConnParamInit();
+    ConnParamUpdate(0u);
+    TEST_CHECK_EQUAL(CONN_SLOW_INTERVAL_MAX, fakeConnParam.connIntvMax);
+    ConnParamEventHandler(CYBLE_EVT_L2CAP_CONN_PARAM_UPDATE_RSP, NULL);
+
+    Settle(POWER_SAVER_LEVEL - 1u);
+    TEST_CHECK_EQUAL(ENABLED, capSenseConfigPending);
+    TEST_CHECK_EQUAL(CAPSENSE_SCAN_20MS, (capSenseConfig & CAPSENSE_SCAN_TIER_MASK) >> CAPSENSE_SCAN_TIER_SHIFT);
+    TEST_CHECK(0u != (capSenseConfig & CAPSENSE_LED_OFF));
+    TEST_CHECK_EQUAL(CAPSENSE_FILTER_PROFILE | CAPSENSE_CONFIG_WRITTEN, capSenseConfig & ~(CAPSENSE_SCAN_TIER_MASK | CAPSENSE_LED_OFF));
+    ConnParamUpdate(0u);
+    TEST_CHECK_EQUAL(2u, fakeConnParamRequests);
+    TEST_CHECK_EQUAL(PowerGetProfile()->slowIntervalMax, fakeConnParam.connIntvMax);
+    TEST_CHECK(fakeConnParam.connIntvMax > CONN_SLOW_INTERVAL_MAX);
+    ConnParamEventHandler(CYBLE_EVT_L2CAP_CONN_PARAM_UPDATE_RSP, NULL);
+
+    /* No fast interval on approach in the critical band */
+    Settle(POWER_CRITICAL_LEVEL - 1u);
+    TEST_CHECK_EQUAL(CAPSENSE_SCAN_50MS, (capSenseConfig & CAPSENSE_SCAN_TIER_MASK) >> CAPSENSE_SCAN_TIER_SHIFT);
+    ConnParamUpdate(1u);
+    TEST_CHECK_EQUAL(3u, fakeConnParamRequests);
+    TEST_CHECK_EQUAL(PowerGetProfile()->slowIntervalMax, fakeConnParam.connIntvMax);
+    TEST_CHECK_EQUAL(0u, PowerGetProfile()->batteryRepeat);
+
+    Settle(100u);
+    TEST_CHECK_EQUAL(CAPSENSE_SCAN_CONTINUOUS, (capSenseConfig & CAPSENSE_SCAN_TIER_MASK) >> CAPSENSE_SCAN_TIER_SHIFT);
+    TEST_CHECK_EQUAL(0u, capSenseConfig & CAPSENSE_LED_OFF);
+}
+
+
+int main(void)
+{
+    TEST_RUN(TestBandThresholds);
+    TEST_RUN(TestHysteresis);
+    TEST_RUN(TestNoisyDischarge);
+    TEST_RUN(TestBandSettings);
+    return (TEST_RESULT());
+}
+
+
+/* [] END OF FILE */
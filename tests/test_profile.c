@@ -0,0 +1,186 @@
+/*******************************************************************************
+* File Name: test_profile.c
+*
+* Version 1.0
+*
+* Description:
+*  Host tests of the micro-profilers of both firmwares, built once against
+*  each profile.c with PROFILE_ENABLE set. fakeSysTickCount stands for the
+*  SysTick down counter. The BLE profiler counts through the 24 bits of
+*  SysTick and starts a new period when ProfileShow() prints the scopes; the
+*  CapSense one adds the 1 ms gesture timestamp and keeps its scopes for the
+*  debugger until Profile_Init().
+*
+*******************************************************************************/
+
+#include "profile.h"
+#include "test.h"
+
+#if defined(PROFILE_HANDLE_CAPSENSE)
+    #define Init()                  ProfileInit()
+    #define Add(scope, cycles)      ProfileAdd((scope), (cycles))
+    #define scopes                  profileScopes
+    #define SCOPE                   PROFILE_SEND_KEYBOARD
+    #define OTHER_SCOPE             PROFILE_LOW_POWER
+#else
+    #define Init()                  Profile_Init()
+    #define Add(scope, cycles)      Profile_Add((scope), (cycles))
+    #define scopes                  Profile_scopes
+    #define SCOPE                   PROFILE_GESTURE
+    #define OTHER_SCOPE             PROFILE_PROCESS_WIDGET
+
+    #define PROFILE_PERIOD          (48000u)    /* Reload of the fake SysTick + 1 */
+#endif /* defined(PROFILE_HANDLE_CAPSENSE) */
+
+TEST_COUNTERS;
+
+
+/* A scope as Init() leaves it */
+static uint8 IsCleared(uint8 scope)
+{
+    return ((uint8)((scopes[scope].calls == 0u) && (scopes[scope].min == 0xFFFFFFFFu) &&
+                    (scopes[scope].max == 0u) && (scopes[scope].total == 0u)));
+}
+
+#if !defined(PROFILE_HANDLE_CAPSENSE)
+/* Sets the gesture timestamp and the SysTick count inside that millisecond */
+static void SetTime(uint32 ms, uint32 count)
+{
+    CapSense_dsRam.timestamp = ms;
+    fakeSysTickCount = count;
+}
+#endif /* !defined(PROFILE_HANDLE_CAPSENSE) */
+
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+/* Each duration adds a call, the sum and the extremes of its scope only */
+static void TestAccumulation(void)
+{
+    uint8 scope;
+
+    Init();
+    for(scope = 0u; scope < PROFILE_SCOPE_COUNT; scope++)
+    {
+        TEST_CHECK(IsCleared(scope));
+    }
+    Add(SCOPE, 300u);
+    TEST_CHECK_EQUAL(300u, scopes[SCOPE].min);
+    TEST_CHECK_EQUAL(300u, scopes[SCOPE].max);
+    Add(SCOPE, 100u);
+    Add(SCOPE, 0xFFFFFF00u);
+    Add(SCOPE, 0xFFFFFF00u);
+    TEST_CHECK_EQUAL(4u, scopes[SCOPE].calls);
+    TEST_CHECK_EQUAL(100u, scopes[SCOPE].min);
+    TEST_CHECK_EQUAL(0xFFFFFF00u, scopes[SCOPE].max);
+    /* The sum passes 32 bits */
+    TEST_CHECK(scopes[SCOPE].total == (400u + (2u * (uint64)0xFFFFFF00u)));
+    TEST_CHECK(IsCleared(OTHER_SCOPE));
+}
+
+#if defined(PROFILE_HANDLE_CAPSENSE)
+/* SysTick counts down through 24 bits: a scope across the reload still
+*  measures the cycles between its ends */
+static void TestWraparound(void)
+{
+    Init();
+    TEST_CHECK_EQUAL(PROFILE_COUNTER_MASK, fakeSysTickReload);
+
+    fakeSysTickCount = 0x000500u;
+    {
+        PROFILE_BEGIN(SCOPE);
+        fakeSysTickCount = 0x000200u;
+        PROFILE_END(SCOPE);
+    }
+    TEST_CHECK_EQUAL(0x300u, scopes[SCOPE].max);
+
+    fakeSysTickCount = 0x000010u;
+    {
+        PROFILE_BEGIN(SCOPE);
+        fakeSysTickCount = 0xFFFFF0u;
+        PROFILE_END(SCOPE);
+    }
+    TEST_CHECK_EQUAL(2u, scopes[SCOPE].calls);
+    TEST_CHECK_EQUAL(0x20u, scopes[SCOPE].min);
+}
+
+/* ProfileShow() ends the period: every scope, printed or not, starts again */
+static void TestResetOnRead(void)
+{
+    Init();
+    Add(SCOPE, 50u);
+    Add(OTHER_SCOPE, 70u);
+    ProfileShow();
+    TEST_CHECK(IsCleared(SCOPE));
+    TEST_CHECK(IsCleared(OTHER_SCOPE));
+
+    Add(SCOPE, 90u);
+    TEST_CHECK_EQUAL(1u, scopes[SCOPE].calls);
+    TEST_CHECK_EQUAL(90u, scopes[SCOPE].min);
+    TEST_CHECK(scopes[SCOPE].total == 90u);
+    ProfileShow();
+    ProfileShow();
+    TEST_CHECK(IsCleared(SCOPE));
+}
+#else
+/* The time is the timestamp in SysTick periods plus the count down inside
+*  the current millisecond, modulo 2^32 */
+static void TestWraparound(void)
+{
+    Init();
+    SetTime(5u, PROFILE_PERIOD - 1u);
+    TEST_CHECK_EQUAL(5u * PROFILE_PERIOD, Profile_Now());
+    SetTime(5u, 0u);
+    TEST_CHECK_EQUAL((6u * PROFILE_PERIOD) - 1u, Profile_Now());
+
+    /* Across a millisecond */
+    SetTime(5u, 100u);
+    {
+        PROFILE_BEGIN(SCOPE);
+        SetTime(6u, PROFILE_PERIOD - 101u);
+        PROFILE_END(SCOPE);
+    }
+    TEST_CHECK_EQUAL(201u, scopes[SCOPE].max);
+
+    /* Across 2^32 cycles, after 89478 ms at 48 MHz */
+    SetTime(89478u, PROFILE_PERIOD - 1u);
+    {
+        PROFILE_BEGIN(SCOPE);
+        SetTime(89479u, PROFILE_PERIOD - 1u);
+        TEST_CHECK(Profile_Now() < profileStartSCOPE);
+        PROFILE_END(SCOPE);
+    }
+    TEST_CHECK_EQUAL(2u, scopes[SCOPE].calls);
+    TEST_CHECK_EQUAL(PROFILE_PERIOD, scopes[SCOPE].max);
+}
+
+/* Reading the scopes does not change them, only Profile_Init() clears */
+static void TestResetOnRead(void)
+{
+    PROFILE_SCOPE_T read;
+
+    Init();
+    Add(SCOPE, 50u);
+    read = scopes[SCOPE];
+    Add(SCOPE, 70u);
+    TEST_CHECK_EQUAL(1u, read.calls);
+    TEST_CHECK_EQUAL(2u, scopes[SCOPE].calls);
+    TEST_CHECK(scopes[SCOPE].total == 120u);
+    Init();
+    TEST_CHECK(IsCleared(SCOPE));
+}
+#endif /* defined(PROFILE_HANDLE_CAPSENSE) */
+
+
+int main(void)
+{
+    TEST_RUN(TestAccumulation);
+    TEST_RUN(TestWraparound);
+    TEST_RUN(TestResetOnRead);
+    printf("%u checks, %u failed\n", testChecks, testFailures);
+    return (TEST_RESULT());
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,178 @@
+/*******************************************************************************
+* File Name: test_tuning.c
+*
+* Version 1.0
+*
+* Description:
+*  Host tests of the CapSense tuning cache: the validation of a cache read
+*  from flash, the raw count sanity check, and the cache a first start
+*  calibrates and writes.
+*
+*******************************************************************************/
+
+#include <string.h>
+#include "project.h"
+#include "tuning.h"
+#include "test.h"
+
+TEST_COUNTERS;
+
+
+/* A cache as the calibration would save it */
+static void MakeCache(TUNING_CACHE_T *cache)
+{
+    uint8 index;
+
+    (void)memset(cache, 0, sizeof(*cache));
+    cache->configId = CapSense_CONFIG_ID;
+    cache->size = sizeof(TUNING_CACHE_T);
+    for(index = 0u; index < TUNING_SENSOR_COUNT; index++)
+    {
+        cache->raw[index] = (uint16)(3000u + (index * 100u));
+        cache->idacComp[index] = (uint8)(20u + index);
+    }
+    for(index = 0u; index < TUNING_WIDGET_COUNT; index++)
+    {
+        cache->widget[index].resolution = 12u;
+        cache->widget[index].snsClk = 4u;
+        cache->widget[index].fingerTh = 100u;
+        cache->widget[index].idacMod = (uint8)(30u + index);
+    }
+    cache->crc = Tuning_Crc(cache);
+}
+
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+static void TestValidCache(void)
+{
+    TUNING_CACHE_T cache;
+
+    MakeCache(&cache);
+    TEST_CHECK_EQUAL(1u, Tuning_Validate(&cache, CapSense_CONFIG_ID));
+}
+
+/* Erased or never written flash is no cache */
+static void TestBlankFlashRejected(void)
+{
+    TUNING_CACHE_T cache;
+
+    (void)memset(&cache, 0, sizeof(cache));
+    TEST_CHECK_EQUAL(0u, Tuning_Validate(&cache, CapSense_CONFIG_ID));
+    (void)memset(&cache, 0xFF, sizeof(cache));
+    TEST_CHECK_EQUAL(0u, Tuning_Validate(&cache, CapSense_CONFIG_ID));
+}
+
+/* A cache of another CapSense configuration or layout is not restored */
+static void TestOtherDesignRejected(void)
+{
+    TUNING_CACHE_T cache;
+
+    MakeCache(&cache);
+    TEST_CHECK_EQUAL(0u, Tuning_Validate(&cache, CapSense_CONFIG_ID + 1u));
+
+    cache.size = sizeof(TUNING_CACHE_T) - 2u;
+    cache.crc = Tuning_Crc(&cache);
+    TEST_CHECK_EQUAL(0u, Tuning_Validate(&cache, CapSense_CONFIG_ID));
+}
+
+/* The CRC covers every byte after the crc field, the header included: a
+*  flipped bit anywhere must fail the CRC even when the header still matches */
+static void TestCrcCoversHeaderAndData(void)
+{
+    TUNING_CACHE_T cache;
+    uint8 *bytes = (uint8 *)&cache;
+    uint32 offset;
+    uint8 bit;
+    uint32 undetected = 0u;
+
+    MakeCache(&cache);
+    for(offset = sizeof(cache.crc); offset < sizeof(cache); offset++)
+    {
+        for(bit = 0u; bit < 8u; bit++)
+        {
+            bytes[offset] ^= (uint8)(1u << bit);
+            if(Tuning_Crc(&cache) == cache.crc)
+            {
+                undetected++;
+            }
+            bytes[offset] ^= (uint8)(1u << bit);
+        }
+    }
+    TEST_CHECK_EQUAL(0u, undetected);
+    TEST_CHECK_EQUAL(1u, Tuning_Validate(&cache, CapSense_CONFIG_ID));
+}
+
+/* Every raw count must stay within 1/8 of the calibrated one, both ways */
+static void TestRawSanityCheck(void)
+{
+    uint16 expected[TUNING_SENSOR_COUNT];
+    uint16 measured[TUNING_SENSOR_COUNT];
+    uint8 sensor;
+
+    for(sensor = 0u; sensor < TUNING_SENSOR_COUNT; sensor++)
+    {
+        expected[sensor] = 4000u;
+        measured[sensor] = 4000u;
+    }
+    TEST_CHECK_EQUAL(1u, Tuning_CheckRaw(expected, measured));
+
+    measured[TUNING_SENSOR_COUNT - 1u] = 4000u + (4000u >> TUNING_RAW_TOLERANCE_SHIFT);
+    TEST_CHECK_EQUAL(1u, Tuning_CheckRaw(expected, measured));
+    measured[TUNING_SENSOR_COUNT - 1u]++;
+    TEST_CHECK_EQUAL(0u, Tuning_CheckRaw(expected, measured));
+
+    measured[TUNING_SENSOR_COUNT - 1u] = 4000u;
+    measured[0u] = 4000u - (4000u >> TUNING_RAW_TOLERANCE_SHIFT);
+    TEST_CHECK_EQUAL(1u, Tuning_CheckRaw(expected, measured));
+    measured[0u]--;
+    TEST_CHECK_EQUAL(0u, Tuning_CheckRaw(expected, measured));
+}
+
+/* With blank flash the first start calibrates and writes a cache that the
+*  next start accepts, holding the tuned parameters and raw counts */
+static void TestFirstStartSavesCache(void)
+{
+    TUNING_CACHE_T cache;
+    uint8 sensor;
+
+    for(sensor = 0u; sensor < 6u; sensor++)
+    {
+        CapSense_dsRam.snsList.linearslider0[sensor].raw[0u] = (uint16)(2000u + sensor);
+        CapSense_dsRam.snsList.linearslider0[sensor].idacComp[0u] = (uint8)(40u + sensor);
+    }
+    CapSense_dsRam.snsList.btn1[0u].raw[0u] = 1500u;
+    CapSense_dsRam.wdgtList.btn2.fingerTh = 120u;
+    CapSense_dsRam.wdgtList.linearslider0.idacMod[0u] = 33u;
+    fakeCapSenseStarts = 0u;
+    fakeFlashWrites = 0u;
+
+    Tuning_Start();
+    TEST_CHECK_EQUAL(TUNING_SOURCE_NO_CACHE, Tuning_source);
+    TEST_CHECK_EQUAL(1u, fakeCapSenseStarts);
+    TEST_CHECK(fakeFlashWrites != 0u);
+
+    (void)memcpy(&cache, fakeFlash, sizeof(cache));
+    TEST_CHECK_EQUAL(1u, Tuning_Validate(&cache, CapSense_CONFIG_ID));
+    TEST_CHECK_EQUAL(1500u, cache.raw[1u]);
+    TEST_CHECK_EQUAL(2005u, cache.raw[TUNING_BUTTON_COUNT + 5u]);
+    TEST_CHECK_EQUAL(45u, cache.idacComp[TUNING_BUTTON_COUNT + 5u]);
+    TEST_CHECK_EQUAL(120u, cache.widget[CapSense_BTN2_WDGT_ID].fingerTh);
+    TEST_CHECK_EQUAL(33u, cache.widget[CapSense_LINEARSLIDER0_WDGT_ID].idacMod);
+}
+
+
+int main(void)
+{
+    TEST_RUN(TestValidCache);
+    TEST_RUN(TestBlankFlashRejected);
+    TEST_RUN(TestOtherDesignRejected);
+    TEST_RUN(TestCrcCoversHeaderAndData);
+    TEST_RUN(TestRawSanityCheck);
+    TEST_RUN(TestFirstStartSavesCache);
+    return (TEST_RESULT());
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,150 @@
+/*******************************************************************************
+* File Name: test_work.c
+*
+* Version 1.0
+*
+* Description:
+*  Host tests of the pending-work scheduler of the BLE main loop: the
+*  WORK_xxx bits the interrupts and stack callbacks set, the take of all
+*  bits in one critical section, and a bit set after the take, which has to
+*  wait for the next pass instead of being lost. main.c runs on the
+*  simulation, an interrupt raised inside a critical section runs at its
+*  end through simBleInterrupt.
+*
+*******************************************************************************/
+
+#include "common.h"
+#include "bas.h"
+#include "link.h"
+#include "sim/ble.h"
+#include "test.h"
+
+TEST_COUNTERS;
+
+/* Of main.c, called by the hardware */
+extern volatile uint32 pendingWork;
+void Timer_Interrupt(void);
+
+static uint32 interruptWork;
+
+
+/* An interrupt that requests interruptWork */
+static void Interrupt(void)
+{
+    SetPendingWork(interruptWork);
+}
+
+/* Raises an interrupt inside the next critical section */
+static void RaiseInterrupt(uint32 work)
+{
+    interruptWork = work;
+    simBleInterrupt = Interrupt;
+}
+
+static void Clear(void)
+{
+    simBleInterrupt = NULL;
+    (void)TakePendingWork();
+}
+
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+/* The timer tick polls CapSense, the battery and RSSI periods add theirs */
+static void TestTimerInterrupt(void)
+{
+    uint32 work = 0u;
+    uint32 tick;
+
+    Clear();
+    Timer_Interrupt();
+    TEST_CHECK((TakePendingWork() & WORK_CAPSENSE) != 0u);
+    for(tick = 0u; tick < (BATTERY_TIMEOUT * LINK_TIMEOUT); tick++)
+    {
+        Timer_Interrupt();
+        work |= TakePendingWork();
+    }
+    TEST_CHECK_EQUAL(WORK_CAPSENSE | WORK_BATTERY | WORK_LINK, work & (WORK_CAPSENSE | WORK_BATTERY | WORK_LINK));
+}
+
+/* The stack callbacks request the work they can not do themselves */
+static void TestCallbacks(void)
+{
+    uint8 state = CYBLE_STACK_STATE_FREE;
+
+    Clear();
+    AppCallBack(CYBLE_EVT_STACK_BUSY_STATUS, &state);
+    TEST_CHECK_EQUAL(WORK_HID, TakePendingWork());
+    state = CYBLE_STACK_STATE_BUSY;
+    AppCallBack(CYBLE_EVT_STACK_BUSY_STATUS, &state);
+    TEST_CHECK_EQUAL(0u, TakePendingWork());
+    AppCallBack(CYBLE_EVT_HARDWARE_ERROR, NULL);
+    TEST_CHECK_EQUAL(WORK_STACK, TakePendingWork());
+    AppCallBack(CYBLE_EVT_PENDING_FLASH_WRITE, NULL);
+    TEST_CHECK_EQUAL(WORK_FLASH, TakePendingWork());
+}
+
+/* Bits add up until taken, the take returns all of them once */
+static void TestTakeClears(void)
+{
+    Clear();
+    SetPendingWork(WORK_I2C);
+    SetPendingWork(WORK_HID);
+    SetPendingWork(WORK_I2C);
+    TEST_CHECK_EQUAL(WORK_I2C | WORK_HID, TakePendingWork());
+    TEST_CHECK_EQUAL(0u, pendingWork);
+    TEST_CHECK_EQUAL(0u, TakePendingWork());
+}
+
+/* An interrupt during the take runs after the clear: its bit is not
+*  returned and not cleared, the next take gets it */
+static void TestTakeAtomic(void)
+{
+    Clear();
+    SetPendingWork(WORK_HID);
+    RaiseInterrupt(WORK_I2C);
+    TEST_CHECK_EQUAL(WORK_HID, TakePendingWork());
+    TEST_CHECK_EQUAL(WORK_I2C, pendingWork);
+    TEST_CHECK_EQUAL(WORK_I2C, TakePendingWork());
+}
+
+/* An interrupt during a set keeps the bits set by both */
+static void TestSetAtomic(void)
+{
+    Clear();
+    RaiseInterrupt(WORK_I2C);
+    SetPendingWork(WORK_HID);
+    TEST_CHECK_EQUAL(WORK_I2C | WORK_HID, TakePendingWork());
+}
+
+/* A bit set between the take and the dispatch is left pending, so the loop
+*  does not sleep and serves it on the next pass */
+static void TestSetAfterTake(void)
+{
+    uint32 work;
+
+    Clear();
+    Timer_Interrupt();
+    work = TakePendingWork();
+    SetPendingWork(WORK_I2C);       /* I2C interrupt */
+    TEST_CHECK_EQUAL(0u, work & WORK_I2C);
+    TEST_CHECK(pendingWork != 0u);
+    TEST_CHECK_EQUAL(WORK_I2C, TakePendingWork());
+}
+
+
+int main(void)
+{
+    TEST_RUN(TestTimerInterrupt);
+    TEST_RUN(TestCallbacks);
+    TEST_RUN(TestTakeClears);
+    TEST_RUN(TestTakeAtomic);
+    TEST_RUN(TestSetAtomic);
+    TEST_RUN(TestSetAfterTake);
+    printf("%u checks, %u failed\n", testChecks, testFailures);
+    return (TEST_RESULT());
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,704 @@
+/*******************************************************************************
+* File Name: uhid_loopback.c
+*
+* Version 1.0
+*
+* Description:
+*  Replays the keyboard reports of the BLE benchmark into a real Linux input
+*  device. The tool registers a HID device with the keyboard report layout of
+*  hidreport.h through /dev/uhid, the way BlueZ registers a HOGP keyboard, injects
+*  each report of build/bench_ble_<session>.reports and reads the key events
+*  back from the evdev node of the device.
+*
+*  It checks that every report gives the key presses and releases its keycodes
+*  should give, and measures the time from injection to the evdev event. Added
+*  to the simulated time from the script step to the report on air, this gives
+*  the latency from the touch to the key event in the OS. The keycodes the
+*  firmware uses are printed with the Linux key they arrive as, so a function
+*  sent with the wrong usage, e.g. a keyboard F key for a volume change that
+*  needs a consumer usage, shows up here.
+*
+*  The report map of the BLE component is not part of the sources, so the tool
+*  builds one from the HID_KEYBOARD_REPORT items of hidreport.h, the layout
+*  HidsEncodeKeyboard() fills.
+*
+*  Needs Linux with uhid and write access to /dev/uhid and /dev/input, usually
+*  root. Exits with 77 when the device can not be created, so the make target
+*  can report the test as skipped.
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/input.h>
+#include <linux/uhid.h>
+#include "hidreport.h"
+
+#define LOOPBACK_EXIT_SKIP          (77)
+#define LOOPBACK_NAME               "BLE HID Keyboard loopback"
+#define LOOPBACK_VENDOR             (0x04B4u)   /* Cypress */
+#define LOOPBACK_PRODUCT            (0x0001u)
+
+#define LOOPBACK_MAX_LINES          (1024u)
+#define LOOPBACK_MAX_EVENTS         (16u)
+#define LOOPBACK_MAX_GAP            (100000u)   /* us, longer pauses of the script are shortened */
+#define LOOPBACK_EVENT_TIMEOUT      (200)       /* ms to wait for the events of a report */
+#define LOOPBACK_OPEN_TIMEOUT       (2000u)     /* ms to wait for the input device */
+
+/* Keyboard report, see HID_KEYBOARD_REPORT of hidreport.h */
+#define REPORT_SIZE                 (KEYBOARD_DATA_SIZE)
+#define REPORT_MODIFIERS            (HID_KEYBOARD_MODIFIERS_OFFSET)
+#define REPORT_KEYCODES             (HID_KEYBOARD_KEYCODES_OFFSET)
+#define REPORT_KEYCODE_COUNT        (HID_KEYBOARD_KEYCODES_SIZE)
+#define USAGE_MODIFIER_FIRST        (0xE0u)
+
+/* Keyboard report map: the input fields of the firmware report, then the
+*  LED output report of the boot keyboard, HID 1.11 appendix B.1 */
+static const uint8_t reportMap[] =
+{
+    0x05u, 0x01u,           /* Usage Page (Generic Desktop) */
+    0x09u, 0x06u,           /* Usage (Keyboard) */
+    0xA1u, 0x01u,           /* Collection (Application) */
+    0x05u, 0x07u,           /*   Usage Page (Keyboard) */
+    HID_KEYBOARD_REPORT(HID_REPORT_FIELD_ITEMS)
+    0x05u, 0x08u,           /*   Usage Page (LEDs) */
+    0x19u, 0x01u,           /*   Usage Minimum (Num Lock) */
+    0x29u, 0x05u,           /*   Usage Maximum (Kana) */
+    0x25u, 0x01u,           /*   Logical Maximum (1) */
+    0x75u, 0x01u,           /*   Report Size (1) */
+    0x95u, 0x05u,           /*   Report Count (5) */
+    0x91u, 0x02u,           /*   Output (Data, Variable, Absolute), LEDs */
+    0x75u, 0x03u,           /*   Report Size (3) */
+    0x95u, 0x01u,           /*   Report Count (1) */
+    0x91u, 0x01u,           /*   Output (Constant), padding */
+    0xC0u                   /* End Collection */
+};
+
+/* Keyboard page usages and the Linux keys hid-input maps them to */
+typedef struct
+{
+    uint8_t usage;
+    uint16_t key;
+    const char *name;
+} LOOPBACK_USAGE_T;
+
+#define USAGE(usage, key)           {(usage), (key), #key}
+
+static const LOOPBACK_USAGE_T usages[] =
+{
+    USAGE(0x04u, KEY_A), USAGE(0x05u, KEY_B), USAGE(0x06u, KEY_C), USAGE(0x07u, KEY_D),
+    USAGE(0x08u, KEY_E), USAGE(0x09u, KEY_F), USAGE(0x0Au, KEY_G), USAGE(0x0Bu, KEY_H),
+    USAGE(0x0Cu, KEY_I), USAGE(0x0Du, KEY_J), USAGE(0x0Eu, KEY_K), USAGE(0x0Fu, KEY_L),
+    USAGE(0x10u, KEY_M), USAGE(0x11u, KEY_N), USAGE(0x12u, KEY_O), USAGE(0x13u, KEY_P),
+    USAGE(0x14u, KEY_Q), USAGE(0x15u, KEY_R), USAGE(0x16u, KEY_S), USAGE(0x17u, KEY_T),
+    USAGE(0x18u, KEY_U), USAGE(0x19u, KEY_V), USAGE(0x1Au, KEY_W), USAGE(0x1Bu, KEY_X),
+    USAGE(0x1Cu, KEY_Y), USAGE(0x1Du, KEY_Z), USAGE(0x1Eu, KEY_1), USAGE(0x1Fu, KEY_2),
+    USAGE(0x20u, KEY_3), USAGE(0x21u, KEY_4), USAGE(0x22u, KEY_5), USAGE(0x23u, KEY_6),
+    USAGE(0x24u, KEY_7), USAGE(0x25u, KEY_8), USAGE(0x26u, KEY_9), USAGE(0x27u, KEY_0),
+    USAGE(0x28u, KEY_ENTER), USAGE(0x29u, KEY_ESC), USAGE(0x2Au, KEY_BACKSPACE), USAGE(0x2Bu, KEY_TAB),
+    USAGE(0x2Cu, KEY_SPACE), USAGE(0x2Du, KEY_MINUS), USAGE(0x2Eu, KEY_EQUAL), USAGE(0x2Fu, KEY_LEFTBRACE),
+    USAGE(0x30u, KEY_RIGHTBRACE), USAGE(0x31u, KEY_BACKSLASH), USAGE(0x32u, KEY_BACKSLASH),
+    USAGE(0x33u, KEY_SEMICOLON), USAGE(0x34u, KEY_APOSTROPHE), USAGE(0x35u, KEY_GRAVE),
+    USAGE(0x36u, KEY_COMMA), USAGE(0x37u, KEY_DOT), USAGE(0x38u, KEY_SLASH), USAGE(0x39u, KEY_CAPSLOCK),
+    USAGE(0x3Au, KEY_F1), USAGE(0x3Bu, KEY_F2), USAGE(0x3Cu, KEY_F3), USAGE(0x3Du, KEY_F4),
+    USAGE(0x3Eu, KEY_F5), USAGE(0x3Fu, KEY_F6), USAGE(0x40u, KEY_F7), USAGE(0x41u, KEY_F8),
+    USAGE(0x42u, KEY_F9), USAGE(0x43u, KEY_F10), USAGE(0x44u, KEY_F11), USAGE(0x45u, KEY_F12),
+    USAGE(0x46u, KEY_SYSRQ), USAGE(0x47u, KEY_SCROLLLOCK), USAGE(0x48u, KEY_PAUSE), USAGE(0x49u, KEY_INSERT),
+    USAGE(0x4Au, KEY_HOME), USAGE(0x4Bu, KEY_PAGEUP), USAGE(0x4Cu, KEY_DELETE), USAGE(0x4Du, KEY_END),
+    USAGE(0x4Eu, KEY_PAGEDOWN), USAGE(0x4Fu, KEY_RIGHT), USAGE(0x50u, KEY_LEFT), USAGE(0x51u, KEY_DOWN),
+    USAGE(0x52u, KEY_UP), USAGE(0x53u, KEY_NUMLOCK), USAGE(0x54u, KEY_KPSLASH), USAGE(0x55u, KEY_KPASTERISK),
+    USAGE(0x56u, KEY_KPMINUS), USAGE(0x57u, KEY_KPPLUS), USAGE(0x58u, KEY_KPENTER), USAGE(0x59u, KEY_KP1),
+    USAGE(0x5Au, KEY_KP2), USAGE(0x5Bu, KEY_KP3), USAGE(0x5Cu, KEY_KP4), USAGE(0x5Du, KEY_KP5),
+    USAGE(0x5Eu, KEY_KP6), USAGE(0x5Fu, KEY_KP7), USAGE(0x60u, KEY_KP8), USAGE(0x61u, KEY_KP9),
+    USAGE(0x62u, KEY_KP0), USAGE(0x63u, KEY_KPDOT), USAGE(0x64u, KEY_102ND), USAGE(0x65u, KEY_COMPOSE),
+    USAGE(0xE0u, KEY_LEFTCTRL), USAGE(0xE1u, KEY_LEFTSHIFT), USAGE(0xE2u, KEY_LEFTALT), USAGE(0xE3u, KEY_LEFTMETA),
+    USAGE(0xE4u, KEY_RIGHTCTRL), USAGE(0xE5u, KEY_RIGHTSHIFT), USAGE(0xE6u, KEY_RIGHTALT),
+    USAGE(0xE7u, KEY_RIGHTMETA),
+};
+
+/* What the firmware means with the keycodes of hids.h, and the key it needs */
+typedef struct
+{
+    uint8_t usage;
+    const char *function;
+    uint16_t key;
+    const char *name;
+    const char *needs;              /* Usage that gives the key, NULL if the keycode does */
+} LOOPBACK_FUNCTION_T;
+
+static const LOOPBACK_FUNCTION_T functions[] =
+{
+    {0x4Bu, "PAGE_UP", KEY_PAGEUP, "KEY_PAGEUP", NULL},
+    {0x4Eu, "PAGE_DOWN", KEY_PAGEDOWN, "KEY_PAGEDOWN", NULL},
+    {0x3Bu, "SOUND_LOW", KEY_VOLUMEDOWN, "KEY_VOLUMEDOWN", "consumer usage 0xEA"},
+    {0x3Cu, "SOUND_HIGH", KEY_VOLUMEUP, "KEY_VOLUMEUP", "consumer usage 0xE9"},
+    {0x3Eu, "LIGHT_LOW", KEY_BRIGHTNESSDOWN, "KEY_BRIGHTNESSDOWN", "consumer usage 0x70"},
+    {0x3Fu, "LIGHT_HIGH", KEY_BRIGHTNESSUP, "KEY_BRIGHTNESSUP", "consumer usage 0x6F"},
+};
+
+/* A line of the reports file */
+typedef struct
+{
+    uint8_t step;                   /* A script step, otherwise a report */
+    uint64_t at;                    /* us simulated */
+    uint8_t report[REPORT_SIZE];
+} LOOPBACK_LINE_T;
+
+typedef struct
+{
+    uint16_t key;
+    uint8_t value;                  /* 1 press, 0 release */
+} LOOPBACK_EVENT_T;
+
+static LOOPBACK_LINE_T lines[LOOPBACK_MAX_LINES];
+static uint32_t lineCount;
+static uint8_t usedUsages[256u];
+
+
+/*******************************************************************************
+* Function Name: Now()
+********************************************************************************
+*
+* Summary:
+*   Returns CLOCK_MONOTONIC in us, the clock the evdev node stamps events with.
+*
+*******************************************************************************/
+static uint64_t Now(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (((uint64_t)now.tv_sec * 1000000u) + ((uint64_t)now.tv_nsec / 1000u));
+}
+
+
+/*******************************************************************************
+* Function Name: Sleep()
+*******************************************************************************/
+static void Sleep(uint64_t us)
+{
+    struct timespec time;
+
+    time.tv_sec = (time_t)(us / 1000000u);
+    time.tv_nsec = (long)((us % 1000000u) * 1000u);
+    (void)nanosleep(&time, NULL);
+}
+
+
+/*******************************************************************************
+* Function Name: FindUsage()
+*******************************************************************************/
+static const LOOPBACK_USAGE_T *FindUsage(uint8_t usage)
+{
+    uint32_t index;
+
+    for(index = 0u; index < (sizeof(usages) / sizeof(usages[0u])); index++)
+    {
+        if(usages[index].usage == usage)
+        {
+            return (&usages[index]);
+        }
+    }
+    return (NULL);
+}
+
+
+/*******************************************************************************
+* Function Name: ReadReports()
+********************************************************************************
+*
+* Summary:
+*   Reads a reports file of bench_ble into lines[].
+*
+* Return:
+*   0 on success, -1 when the file can not be read or has a bad line.
+*
+*******************************************************************************/
+static int ReadReports(const char *path)
+{
+    FILE *file;
+    char text[128];
+    unsigned long long at;
+    unsigned int bytes[REPORT_SIZE];
+    uint8_t index;
+
+    file = fopen(path, "r");
+    if(file == NULL)
+    {
+        printf("%s: %s\n", path, strerror(errno));
+        return (-1);
+    }
+    lineCount = 0u;
+    while((fgets(text, sizeof(text), file) != NULL) && (lineCount < LOOPBACK_MAX_LINES))
+    {
+        if(sscanf(text, "step %llu", &at) == 1)
+        {
+            lines[lineCount].step = 1u;
+        }
+        else if(sscanf(text, "report %llu %x %x %x %x %x %x %x %x", &at, &bytes[0u], &bytes[1u], &bytes[2u],
+                       &bytes[3u], &bytes[4u], &bytes[5u], &bytes[6u], &bytes[7u]) == 9)
+        {
+            lines[lineCount].step = 0u;
+            for(index = 0u; index < REPORT_SIZE; index++)
+            {
+                lines[lineCount].report[index] = (uint8_t)bytes[index];
+            }
+        }
+        else
+        {
+            printf("%s: bad line %lu\n", path, (unsigned long)lineCount + 1u);
+            (void)fclose(file);
+            return (-1);
+        }
+        lines[lineCount].at = at;
+        lineCount++;
+    }
+    (void)fclose(file);
+    return (0);
+}
+
+
+/*******************************************************************************
+* Function Name: UhidWrite()
+*******************************************************************************/
+static int UhidWrite(int uhid, const struct uhid_event *event)
+{
+    return ((write(uhid, event, sizeof(*event)) == (ssize_t)sizeof(*event)) ? 0 : -1);
+}
+
+
+/*******************************************************************************
+* Function Name: UhidPump()
+********************************************************************************
+*
+* Summary:
+*   Handles the pending events of the kernel. The keyboard has no feature
+*   reports, so GET_REPORT and SET_REPORT fail the way an unknown report of a
+*   HOGP device would. Output reports, the LEDs, are ignored.
+*
+* Return:
+*   1 once the kernel opened the device, 0 otherwise, -1 on errors.
+*
+*******************************************************************************/
+static int UhidPump(int uhid)
+{
+    struct uhid_event event;
+    struct uhid_event reply;
+    int opened = 0;
+
+    while(read(uhid, &event, sizeof(event)) > 0)
+    {
+        (void)memset(&reply, 0, sizeof(reply));
+        switch(event.type)
+        {
+            case UHID_OPEN:
+                opened = 1;
+                break;
+
+            case UHID_GET_REPORT:
+                reply.type = UHID_GET_REPORT_REPLY;
+                reply.u.get_report_reply.id = event.u.get_report.id;
+                reply.u.get_report_reply.err = EIO;
+                if(UhidWrite(uhid, &reply) != 0)
+                {
+                    return (-1);
+                }
+                break;
+
+            case UHID_SET_REPORT:
+                reply.type = UHID_SET_REPORT_REPLY;
+                reply.u.set_report_reply.id = event.u.set_report.id;
+                reply.u.set_report_reply.err = EIO;
+                if(UhidWrite(uhid, &reply) != 0)
+                {
+                    return (-1);
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+    return (((errno == EAGAIN) || (errno == EWOULDBLOCK)) ? opened : -1);
+}
+
+
+/*******************************************************************************
+* Function Name: OpenEvdev()
+********************************************************************************
+*
+* Summary:
+*   Finds the evdev node of the uhid device by its name and opens it, grabbed
+*   so the keys do not reach the desktop, with monotonic event times.
+*
+* Return:
+*   The file descriptor, -1 when the node did not appear in time.
+*
+*******************************************************************************/
+static int OpenEvdev(int uhid)
+{
+    DIR *dir;
+    struct dirent *entry;
+    char path[280];
+    char name[64];
+    int clock = CLOCK_MONOTONIC;
+    int evdev = -1;
+    uint64_t start = Now();
+
+    while((evdev < 0) && ((Now() - start) < (LOOPBACK_OPEN_TIMEOUT * 1000u)))
+    {
+        if(UhidPump(uhid) < 0)
+        {
+            return (-1);
+        }
+        dir = opendir("/dev/input");
+        while((dir != NULL) && (evdev < 0) && ((entry = readdir(dir)) != NULL))
+        {
+            if(strncmp(entry->d_name, "event", 5u) != 0)
+            {
+                continue;
+            }
+            (void)snprintf(path, sizeof(path), "/dev/input/%s", entry->d_name);
+            evdev = open(path, O_RDONLY | O_NONBLOCK);
+            (void)memset(name, 0, sizeof(name));
+            if((evdev >= 0) && ((ioctl(evdev, EVIOCGNAME(sizeof(name) - 1u), name) < 0) ||
+                                (strcmp(name, LOOPBACK_NAME) != 0)))
+            {
+                (void)close(evdev);
+                evdev = -1;
+            }
+        }
+        if(dir != NULL)
+        {
+            (void)closedir(dir);
+        }
+        if(evdev < 0)
+        {
+            Sleep(10000u);
+        }
+    }
+    if((evdev >= 0) && ((ioctl(evdev, EVIOCGRAB, 1) != 0) || (ioctl(evdev, EVIOCSCLOCKID, &clock) != 0)))
+    {
+        (void)close(evdev);
+        evdev = -1;
+    }
+    return (evdev);
+}
+
+
+/*******************************************************************************
+* Function Name: ExpectedEvents()
+********************************************************************************
+*
+* Summary:
+*   Returns the key events a report gives after the previous one: modifier
+*   changes, then released keycodes, then pressed keycodes, the order
+*   hid-input reports them in.
+*
+*******************************************************************************/
+static uint8_t ExpectedEvents(const uint8_t *previous, const uint8_t *report, LOOPBACK_EVENT_T *events)
+{
+    const LOOPBACK_USAGE_T *usage;
+    uint8_t count = 0u;
+    uint8_t bit;
+    uint8_t index;
+    uint8_t value;
+
+    for(bit = 0u; bit < 8u; bit++)
+    {
+        value = (report[REPORT_MODIFIERS] >> bit) & 1u;
+        if(value != ((previous[REPORT_MODIFIERS] >> bit) & 1u))
+        {
+            usedUsages[USAGE_MODIFIER_FIRST + bit] = 1u;
+            events[count].key = FindUsage(USAGE_MODIFIER_FIRST + bit)->key;
+            events[count++].value = value;
+        }
+    }
+    for(value = 0u; value < 2u; value++)
+    {
+        const uint8_t *from = (value == 0u) ? previous : report;
+        const uint8_t *to = (value == 0u) ? report : previous;
+
+        for(index = REPORT_KEYCODES; index < (REPORT_KEYCODES + REPORT_KEYCODE_COUNT); index++)
+        {
+            if((from[index] == 0u) || (memchr(&to[REPORT_KEYCODES], from[index], REPORT_KEYCODE_COUNT) != NULL))
+            {
+                continue;
+            }
+            usedUsages[from[index]] = 1u;
+            usage = FindUsage(from[index]);
+            events[count].key = (usage != NULL) ? usage->key : KEY_UNKNOWN;
+            events[count++].value = value;
+        }
+    }
+    return (count);
+}
+
+
+/*******************************************************************************
+* Function Name: ReadEvents()
+********************************************************************************
+*
+* Summary:
+*   Reads the key events of one report, up to its SYN_REPORT. Autorepeat
+*   events are skipped. *time is set to the time stamp of the first event.
+*
+* Return:
+*   The number of key events, 0 when nothing arrived in time.
+*
+*******************************************************************************/
+static uint8_t ReadEvents(int evdev, LOOPBACK_EVENT_T *events, uint64_t *time)
+{
+    struct input_event event;
+    struct pollfd fd = {evdev, POLLIN, 0};
+    uint8_t count = 0u;
+    uint8_t first = 1u;
+
+    while(poll(&fd, 1u, LOOPBACK_EVENT_TIMEOUT) > 0)
+    {
+        while(read(evdev, &event, sizeof(event)) == (ssize_t)sizeof(event))
+        {
+            if(first != 0u)
+            {
+                *time = ((uint64_t)event.input_event_sec * 1000000u) + (uint64_t)event.input_event_usec;
+                first = 0u;
+            }
+            if((event.type == EV_KEY) && (event.value != 2) && (count < LOOPBACK_MAX_EVENTS))
+            {
+                events[count].key = event.code;
+                events[count++].value = (uint8_t)event.value;
+            }
+            else if((event.type == EV_SYN) && (event.code == SYN_REPORT))
+            {
+                return (count);
+            }
+        }
+    }
+    return (count);
+}
+
+
+/*******************************************************************************
+* Function Name: Replay()
+********************************************************************************
+*
+* Summary:
+*   Injects the reports of lines[] with their simulated spacing, pauses
+*   shortened to LOOPBACK_MAX_GAP, and checks the events that come back.
+*
+* Return:
+*   The number of reports with wrong events.
+*
+*******************************************************************************/
+static uint32_t Replay(const char *path, int uhid, int evdev)
+{
+    static const uint8_t released[REPORT_SIZE] = {0u};
+    struct uhid_event input;
+    LOOPBACK_EVENT_T expected[LOOPBACK_MAX_EVENTS];
+    LOOPBACK_EVENT_T received[LOOPBACK_MAX_EVENTS];
+    const uint8_t *previous = released;
+    uint64_t replayAt = Now();
+    uint64_t lastAt = 0u;
+    uint64_t stepAt = 0u;
+    uint64_t sent;
+    uint64_t time = 0u;
+    uint64_t kernelSum = 0u;
+    uint64_t kernelMax = 0u;
+    uint64_t touchSum = 0u;
+    uint64_t touchMax = 0u;
+    uint32_t reports = 0u;
+    uint32_t measured = 0u;
+    uint32_t events = 0u;
+    uint32_t steps = 0u;
+    uint32_t failed = 0u;
+    uint32_t index;
+    uint8_t expectedCount;
+    uint8_t count;
+    uint8_t stepOpen = 0u;
+
+    for(index = 0u; index < lineCount; index++)
+    {
+        replayAt += ((lines[index].at - lastAt) < LOOPBACK_MAX_GAP) ? (lines[index].at - lastAt) : LOOPBACK_MAX_GAP;
+        lastAt = lines[index].at;
+        if(lines[index].step != 0u)
+        {
+            stepAt = lines[index].at;
+            stepOpen = 1u;
+            continue;
+        }
+        while(Now() < replayAt)
+        {
+            Sleep(replayAt - Now());
+        }
+
+        (void)memset(&input, 0, sizeof(input));
+        input.type = UHID_INPUT2;
+        input.u.input2.size = REPORT_SIZE;
+        (void)memcpy(input.u.input2.data, lines[index].report, REPORT_SIZE);
+        sent = Now();
+        if(UhidWrite(uhid, &input) != 0)
+        {
+            printf("  %s: uhid write failed: %s\n", path, strerror(errno));
+            return (failed + 1u);
+        }
+        reports++;
+
+        (void)memset(expected, 0, sizeof(expected));
+        (void)memset(received, 0, sizeof(received));
+        expectedCount = ExpectedEvents(previous, lines[index].report, expected);
+        count = (expectedCount != 0u) ? ReadEvents(evdev, received, &time) : 0u;
+        previous = lines[index].report;
+        (void)UhidPump(uhid);
+        if((count != expectedCount) || (memcmp(received, expected, count * sizeof(expected[0u])) != 0))
+        {
+            printf("  %s: report at %.3f ms gave %u key events, %u expected\n", path,
+                   (double)lines[index].at / 1000.0, count, expectedCount);
+            failed++;
+            continue;
+        }
+        if(count == 0u)
+        {
+            continue;
+        }
+        events += count;
+        measured++;
+        time = (time > sent) ? (time - sent) : 0u;
+        kernelSum += time;
+        kernelMax = (time > kernelMax) ? time : kernelMax;
+        if(stepOpen != 0u)
+        {
+            time += lines[index].at - stepAt;
+            touchSum += time;
+            touchMax = (time > touchMax) ? time : touchMax;
+            steps++;
+            stepOpen = 0u;
+        }
+    }
+
+    printf("%-28s %7lu %6lu %8.3f %8.3f %5lu %9.2f %9.2f %6lu\n", path, (unsigned long)reports,
+           (unsigned long)events, (measured != 0u) ? ((double)kernelSum / measured / 1000.0) : 0.0,
+           (double)kernelMax / 1000.0, (unsigned long)steps,
+           (steps != 0u) ? ((double)touchSum / steps / 1000.0) : 0.0, (double)touchMax / 1000.0,
+           (unsigned long)failed);
+    return (failed);
+}
+
+
+/*******************************************************************************
+* Function Name: PrintKeys()
+********************************************************************************
+*
+* Summary:
+*   Prints the Linux key of each keycode the reports used, and where the key
+*   differs from what the firmware function behind the keycode needs.
+*
+*******************************************************************************/
+static void PrintKeys(void)
+{
+    const LOOPBACK_USAGE_T *usage;
+    uint32_t code;
+    uint32_t index;
+
+    printf("keycode  linux key          firmware function\n");
+    for(code = 0u; code < 256u; code++)
+    {
+        if(usedUsages[code] == 0u)
+        {
+            continue;
+        }
+        usage = FindUsage((uint8_t)code);
+        printf("0x%02lx     %-18s", (unsigned long)code, (usage != NULL) ? usage->name : "KEY_UNKNOWN");
+        for(index = 0u; index < (sizeof(functions) / sizeof(functions[0u])); index++)
+        {
+            if(functions[index].usage != code)
+            {
+                continue;
+            }
+            printf(" %s", functions[index].function);
+            if((usage == NULL) || (usage->key != functions[index].key))
+            {
+                printf(", the host needs %s with %s", functions[index].name, functions[index].needs);
+            }
+        }
+        printf("\n");
+    }
+}
+
+
+int main(int argc, char *argv[])
+{
+    struct uhid_event create;
+    struct uhid_event destroy;
+    uint32_t failed = 0u;
+    int uhid;
+    int evdev;
+    int arg;
+
+    if(argc < 2)
+    {
+        printf("usage: %s <bench_ble_session.reports>...\n", argv[0u]);
+        return (2);
+    }
+
+    uhid = open("/dev/uhid", O_RDWR | O_CLOEXEC | O_NONBLOCK);
+    if(uhid < 0)
+    {
+        printf("uhid_loopback skipped, /dev/uhid: %s\n", strerror(errno));
+        return (LOOPBACK_EXIT_SKIP);
+    }
+
+    (void)memset(&create, 0, sizeof(create));
+    create.type = UHID_CREATE2;
+    (void)snprintf((char *)create.u.create2.name, sizeof(create.u.create2.name), "%s", LOOPBACK_NAME);
+    (void)snprintf((char *)create.u.create2.uniq, sizeof(create.u.create2.uniq), "loopback-%ld", (long)getpid());
+    create.u.create2.rd_size = sizeof(reportMap);
+    create.u.create2.bus = BUS_BLUETOOTH;
+    create.u.create2.vendor = LOOPBACK_VENDOR;
+    create.u.create2.product = LOOPBACK_PRODUCT;
+    (void)memcpy(create.u.create2.rd_data, reportMap, sizeof(reportMap));
+    if(UhidWrite(uhid, &create) != 0)
+    {
+        printf("uhid_loopback skipped, UHID_CREATE2: %s\n", strerror(errno));
+        (void)close(uhid);
+        return (LOOPBACK_EXIT_SKIP);
+    }
+
+    evdev = OpenEvdev(uhid);
+    if(evdev < 0)
+    {
+        printf("uhid_loopback skipped, no evdev node for the uhid device\n");
+        (void)close(uhid);
+        return (LOOPBACK_EXIT_SKIP);
+    }
+
+    printf("%-28s %7s %6s %8s %8s %5s %9s %9s %6s\n", "reports", "sent", "events", "krn avg", "krn max",
+           "steps", "touch avg", "touch max", "failed");
+    for(arg = 1; arg < argc; arg++)
+    {
+        failed += (ReadReports(argv[arg]) == 0) ? Replay(argv[arg], uhid, evdev) : 1u;
+    }
+    PrintKeys();
+
+    (void)memset(&destroy, 0, sizeof(destroy));
+    destroy.type = UHID_DESTROY;
+    (void)UhidWrite(uhid, &destroy);
+    (void)close(evdev);
+    (void)close(uhid);
+
+    printf("%lu reports with wrong key events\n", (unsigned long)failed);
+    return ((failed == 0u) ? 0 : 1);
+}
+
+
+/* [] END OF FILE */